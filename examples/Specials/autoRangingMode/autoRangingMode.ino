@@ -0,0 +1,89 @@
+/*!
+ * @file autoRangingMode.ino(This demo is only suport TMF8701 sensor)
+ * @brief Switch the ranging mode of TMF8701 while it is measuring, without restarting the measurement.
+ * @n The sensor runs in PROXIMITY mode when the object is near, and in DISTANCE mode when it is far away.
+ * @n note: TMF8801 only suport one mode, PROXIMITY and DISTANCE hybrid mode.
+ * *
+ * --------------------------------------------------------------------------------|
+ * |  Type     |   suport ranging mode     |  ranging ranges |  Accuracy           |
+ * |---------------------------------------|-----------------|---------------------|
+ * |  TMF8801  | PROXIMITY and DISTANCE    |                 |  20~100mm: +/-15mm  |
+ * |           |  hybrid mode(only one)    |    20~240cm     |  100~200mm: +/-10mm |
+ * |           |                           |                 |   >=200: +/-%5      |
+ * |---------------------------------------|-----------------|---------------------|
+ * |           |     PROXIMITY mode        |    0~10cm       |                     |
+ * |           |---------------------------|-----------------|   >=200: +/-%5      |
+ * |  TMF8701  |     DISTANCE mode         |    10~60cm      |  100~200mm: +/-10mm |
+ * |           |---------------------------|-----------------|                     | 
+ * |           | PROXIMITY and DISTANCE    |    0~60cm       |                     |
+ * |           |      hybrid mode          |                 |                     |
+ * |---------------------------------------|-----------------|----------------------
+ * *
+ * @n hardware conneted table:
+ * ------------------------------------------
+ * |  TMF8x01  |            MCU              |
+ * |-----------------------------------------|
+ * |    I2C    |       I2C Interface         |
+ * |-----------------------------------------|
+ * |    EN     |   not connected, floating   |
+ * |-----------------------------------------|
+ * |    INT    |   not connected, floating   |
+ * |-----------------------------------------|
+ * |    PIN0   |   not connected, floating   |
+ * |-----------------------------------------|
+ * |    PIN1   |    not connected, floating  |
+ * |-----------------------------------------|
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data   2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+
+#include "DFRobot_TMF8x01.h"
+
+#define EN       -1                      //EN pin of of TMF8x01 module is floating, not used in this demo
+#define INT      -1                      //INT pin of of TMF8x01 module is floating, not used in this demo
+
+DFRobot_TMF8701 tof(/*enPin =*/EN,/*intPin=*/INT);
+
+uint8_t lastMode;
+
+void setup() {
+  Serial.begin(115200);                                                                               //Serial Initialization
+  while(!Serial){                                                                                     //Wait for serial port to connect. Needed for native USB port only
+  }
+
+  Serial.print("Initialization ranging sensor TMF8x01......");
+  while(tof.begin() != 0){                                                                        //Initialization sensor,sucess return 0, fail return -1
+      Serial.println("failed.");
+      delay(1000);
+  }
+  Serial.println("done.");
+
+  tof.startMeasurement(/*cailbMode =*/tof.eModeCalib, /*disMode =*/tof.eDISTANCE);
+/**
+ * @brief Pick PROXIMITY or DISTANCE mode automatically from recent distances.
+ * @param enable: true enable automatic mode, false disable it.
+ * @param proximityMm: switch to PROXIMITY mode when the distance is below this value, unit mm.
+ * @param distanceMm: switch to DISTANCE mode when the distance is above this value or no target in PROXIMITY mode, unit mm.
+ */
+  tof.setAutoRangingMode(/*enable =*/true, /*proximityMm =*/90, /*distanceMm =*/110);
+  lastMode = tof.getRangingMode();
+}
+
+void loop() {
+  if (tof.isDataReady()) {                                                                        //Is check measuring data vaild, if vaild that print measurement data to USB Serial COM.
+      Serial.print("Distance = ");
+      Serial.print(tof.getDistance_mm());                                                         //Print measurement data to USB Serial COM, unit mm.
+      Serial.println(" mm");
+  }
+  if(tof.getRangingMode() != lastMode){
+      lastMode = tof.getRangingMode();
+      Serial.println((lastMode == tof.ePROXIMITY) ? "switch to PROXIMITY mode" : "switch to DISTANCE mode");
+  }
+
+  /*The mode can also be changed by hand at any time, e.g. tof.setRangingMode(tof.ePROXIMITY);*/
+}
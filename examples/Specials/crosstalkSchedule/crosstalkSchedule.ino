@@ -0,0 +1,86 @@
+/*!
+ * @file crosstalkSchedule.ino
+ * @brief Sensors mounted in a row see the VCSEL light of the sensors next to them. The manager splits them into time slots,
+ * @n sensors in one slot are not neighbors, and every slot measures once with single shot measurement before the next
+ * @n slot starts. The samples per second of every sensor is printed every 5s.
+ * *
+ * @n hardware conneted table:
+ * -------------------------------------------------------
+ * |  TMF8x01  |            MCU                           |
+ * |------------------------------------------------------|
+ * |    I2C    |       I2C Interface, shared by sensors   |
+ * |------------------------------------------------------|
+ * |    EN     |   IO pin of enPins[n]                    |
+ * |------------------------------------------------------|
+ * |    INT    |   not connected, floating                |
+ * |------------------------------------------------------|
+ * |    PIN0   |    not connected, floating               |
+ * |------------------------------------------------------|
+ * |    PIN1   |    not connected, floating               |
+ * |------------------------------------------------------|
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_Manager.h"
+
+#define NUM_OF_SENSOR   8
+#define MAX_RATE        80                                                     //samples per second of all sensors together, 0: as fast as possible
+#define REPORT_TIME     5000
+
+const int enPins[NUM_OF_SENSOR] = {2, 3, 4, 5, 6, 7, 8, 9};
+DFRobot_TMF8801 tof[NUM_OF_SENSOR] = {
+  DFRobot_TMF8801(enPins[0]), DFRobot_TMF8801(enPins[1]), DFRobot_TMF8801(enPins[2]), DFRobot_TMF8801(enPins[3]),
+  DFRobot_TMF8801(enPins[4]), DFRobot_TMF8801(enPins[5]), DFRobot_TMF8801(enPins[6]), DFRobot_TMF8801(enPins[7]),
+};
+DFRobot_TMF8x01_Manager manager(/*baseAddr =*/0x42);
+uint16_t distance[NUM_OF_SENSOR];
+uint32_t reportTime;
+
+void setup() {
+  Serial.begin(115200);                                                        //Serial Initialization
+  while(!Serial){                                                              //Wait for serial port to connect. Needed for native USB port only
+  }
+
+  for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+      manager.addSensor(&tof[i]);
+  }
+  Serial.print("Initialization ranging sensors......");
+  Serial.print("ready mask 0x");
+  Serial.println(manager.begin(), HEX);
+  for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+      tof[i].setSingleShotIterations(/*kIterations =*/400);                   //shorter measurement, shorter slot
+  }
+
+  for(uint8_t i = 0; i + 1 < NUM_OF_SENSOR; i++){                              //sensor i sees sensor i + 1
+      manager.setNeighbors(i, manager.getNeighbors(i) | (1 << (i + 1)));
+  }
+  Serial.print("slots: ");
+  Serial.println(manager.beginSchedule(/*maxRate =*/MAX_RATE));
+  reportTime = millis();
+}
+
+void loop() {
+  uint16_t mask = manager.schedule();                                          //never blocks
+  for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+      if(mask & (1 << i)) distance[i] = manager.getDistance_mm(i);
+  }
+  if((millis() - reportTime) > REPORT_TIME){
+      reportTime = millis();
+      for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+          Serial.print("sensor ");
+          Serial.print(i);
+          Serial.print(": ");
+          Serial.print(distance[i]);
+          Serial.print(" mm, ");
+          Serial.print(manager.getScheduledRate(i));
+          Serial.println(" samples/s");
+      }
+  }
+}
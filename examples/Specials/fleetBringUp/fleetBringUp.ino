@@ -0,0 +1,95 @@
+/*!
+ * @file fleetBringUp.ino
+ * @brief Compare the time to bring up and start several sensors one by one(begin() + startMeasurement()) with 
+ * @n beginOverlapped(), which serves the other sensors while one sensor waits for power on, APP0 or its first result.
+ * @n Then the time of every step of every sensor is printed.
+ * *
+ * @n hardware conneted table:
+ * -------------------------------------------------------
+ * |  TMF8x01  |            MCU                           |
+ * |------------------------------------------------------|
+ * |    I2C    |       I2C Interface, shared by sensors   |
+ * |------------------------------------------------------|
+ * |    EN     |   IO pin of enPins[n]                    |
+ * |------------------------------------------------------|
+ * |    INT    |   not connected, floating                |
+ * |------------------------------------------------------|
+ * |    PIN0   |    not connected, floating               |
+ * |------------------------------------------------------|
+ * |    PIN1   |    not connected, floating               |
+ * |------------------------------------------------------|
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_Manager.h"
+
+#define NUM_OF_SENSOR   8
+
+const int enPins[NUM_OF_SENSOR] = {2, 3, 4, 5, 6, 7, 8, 9};
+DFRobot_TMF8801 tof[NUM_OF_SENSOR] = {
+  DFRobot_TMF8801(enPins[0]), DFRobot_TMF8801(enPins[1]), DFRobot_TMF8801(enPins[2]), DFRobot_TMF8801(enPins[3]),
+  DFRobot_TMF8801(enPins[4]), DFRobot_TMF8801(enPins[5]), DFRobot_TMF8801(enPins[6]), DFRobot_TMF8801(enPins[7]),
+};
+DFRobot_TMF8x01_Manager manager(/*baseAddr =*/0x42);
+
+void setup() {
+  uint32_t t;
+  uint16_t ready;
+  Serial.begin(115200);                                                        //Serial Initialization
+  while(!Serial){                                                              //Wait for serial port to connect. Needed for native USB port only
+  }
+
+  for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+      manager.addSensor(&tof[i]);
+  }
+
+  Serial.print("One by one: ");
+  t = millis();
+  manager.begin();
+  ready = manager.startMeasurement(tof[0].eModeCalib);
+  Serial.print(millis() - t);
+  Serial.print(" ms, measuring mask 0x");
+  Serial.println(ready, HEX);
+  manager.stopMeasurement();
+
+  Serial.print("Overlapped: ");
+  t = millis();
+  ready = manager.beginOverlapped(/*startMeasure =*/true, tof[0].eModeCalib);   //bit n is 1 if sensor n is measuring
+  Serial.print(millis() - t);
+  Serial.print(" ms, measuring mask 0x");
+  Serial.println(ready, HEX);
+
+  Serial.println("sensor slotWait power patch app address start total(ms)");
+  for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+      DFRobot_TMF8x01_Manager::sBootReport_t report;
+      manager.getBootReport(i, &report);
+      Serial.print(i);                Serial.print("      ");
+      Serial.print(report.slotWait);  Serial.print("      ");
+      Serial.print(report.power);     Serial.print("     ");
+      Serial.print(report.patch);     Serial.print("    ");
+      Serial.print(report.app);       Serial.print("   ");
+      Serial.print(report.address);   Serial.print("       ");
+      Serial.print(report.start);     Serial.print("     ");
+      Serial.println(report.total);
+  }
+}
+
+void loop() {
+  uint16_t mask = manager.isDataReady();
+  for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+      if(mask & (1 << i)){
+          Serial.print("sensor ");
+          Serial.print(i);
+          Serial.print(": ");
+          Serial.print(manager.getDistance_mm(i));
+          Serial.println(" mm");
+      }
+  }
+}
@@ -0,0 +1,80 @@
+/*!
+ * @file histogramDump.ino
+ * @brief Read the raw TDC histograms of every measurement and print the frames per second.
+ * @n One frame is HISTOGRAM_BLOCK_NUM blocks of 128 bytes, it needs more RAM than Arduino UNO has, please use ESP32 or M0.
+ * @n Every complete frame is handed to a callback, which switches between 2 buffers to make a small ring.
+ * *
+ * @n hardware conneted table:
+ * ------------------------------------------
+ * |  TMF8x01  |            MCU              |
+ * |-----------------------------------------|
+ * |    I2C    |       I2C Interface         |
+ * |-----------------------------------------|
+ * |    EN     |   not connected, floating   |
+ * |-----------------------------------------|
+ * |    INT    |   not connected, floating   |
+ * |-----------------------------------------|
+ * |    PIN0   |   not connected, floating   |
+ * |-----------------------------------------|
+ * |    PIN1   |    not connected, floating  |
+ * |-----------------------------------------|
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+
+#include "DFRobot_TMF8x01.h"
+
+#define EN       -1                      //EN pin of of TMF8x01 module is floating, not used in this demo
+#define INT      -1                      //INT pin of of TMF8x01 module is floating, not used in this demo
+
+DFRobot_TMF8801 tof(/*enPin =*/EN,/*intPin=*/INT);
+//DFRobot_TMF8701 tof(/*enPin =*/EN,/*intPin=*/INT);
+
+#define FRAME_SIZE   (HISTOGRAM_BLOCK_SIZE * HISTOGRAM_BLOCK_NUM)
+
+uint8_t frameBuf[2][FRAME_SIZE];
+uint8_t current = 0;
+uint32_t frames = 0;
+uint32_t lastT = 0;
+
+void frameDone(uint8_t *frame, uint16_t len){
+  frames++;
+  current ^= 1;                                                                //let the next frame go to the other buffer
+  tof.setHistogramBuffer(frameBuf[current], FRAME_SIZE, frameDone);
+}
+
+void setup() {
+  Serial.begin(115200);                                                        //Serial Initialization
+  while(!Serial){                                                              //Wait for serial port to connect. Needed for native USB port only
+  }
+
+  Serial.print("Initialization ranging sensor TMF8x01......");
+  while(tof.begin() != 0){                                                 //Initialization sensor,sucess return 0, fail return -1
+      Serial.println("failed.");
+      delay(1000);
+  }
+  Serial.println("done.");
+
+  tof.setHistogramBuffer(frameBuf[current], FRAME_SIZE, frameDone);
+  tof.enableHistogramDump(tof.eHistogramDistance);
+  tof.startMeasurement(/*cailbMode =*/tof.eModeCalib);
+  lastT = millis();
+}
+
+void loop() {
+  if(tof.isDataReady()){
+      tof.getDistance_mm();
+      tof.readHistogram();                                                 //read the histograms of this measurement
+  }
+  if((millis() - lastT) >= 1000){
+      Serial.print("frames per second: ");
+      Serial.println(frames * 1000.0 / (millis() - lastT));
+      frames = 0;
+      lastT = millis();
+  }
+}
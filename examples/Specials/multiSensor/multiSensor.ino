@@ -0,0 +1,96 @@
+/*!
+ * @file multiSensor.ino
+ * @brief Run several sensors on one I2C bus. Every sensor's EN pin is connected to its own IO pin of MCU,
+ * @n the manager brings them up one at a time and moves sensor n to I2C address 0x42 + n.
+ * @n With PIN0 of every sensor connected to an IO pin of MCU too, beginBroadcast() downloads the RAM patch once for all sensors.
+ * @n Then the samples per second of the bus is printed for NUM_OF_SENSOR down to 1 measuring sensors.
+ * *
+ * @n hardware conneted table:
+ * -------------------------------------------------------
+ * |  TMF8x01  |            MCU                           |
+ * |------------------------------------------------------|
+ * |    I2C    |       I2C Interface, shared by sensors   |
+ * |------------------------------------------------------|
+ * |    EN     |   IO pin of enPins[n]                    |
+ * |------------------------------------------------------|
+ * |    INT    |   not connected, floating                |
+ * |------------------------------------------------------|
+ * |    PIN0   |   IO pin of selPins[n], or floating      |
+ * |------------------------------------------------------|
+ * |    PIN1   |    not connected, floating               |
+ * |------------------------------------------------------|
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_Manager.h"
+
+#define NUM_OF_SENSOR   8
+#define TEST_TIME       2000                                                   //count samples for 2000ms
+
+#define BROADCAST       1                                                      //1: PIN0 of sensors are connected to selPins, 0: not connected
+
+const int enPins[NUM_OF_SENSOR] = {2, 3, 4, 5, 6, 7, 8, 9};
+const int selPins[NUM_OF_SENSOR] = {10, 11, 12, 13, A0, A1, A2, A3};
+DFRobot_TMF8801 tof[NUM_OF_SENSOR] = {
+  DFRobot_TMF8801(enPins[0]), DFRobot_TMF8801(enPins[1]), DFRobot_TMF8801(enPins[2]), DFRobot_TMF8801(enPins[3]),
+  DFRobot_TMF8801(enPins[4]), DFRobot_TMF8801(enPins[5]), DFRobot_TMF8801(enPins[6]), DFRobot_TMF8801(enPins[7]),
+};
+DFRobot_TMF8x01_Manager manager(/*baseAddr =*/0x42);
+
+void setup() {
+  Serial.begin(115200);                                                        //Serial Initialization
+  while(!Serial){                                                              //Wait for serial port to connect. Needed for native USB port only
+  }
+
+  for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+      manager.addSensor(&tof[i], /*selPin =*/BROADCAST ? selPins[i] : -1);
+  }
+  Serial.print("Initialization ranging sensors......");
+  uint32_t t = millis();
+  uint16_t ready = manager.beginBroadcast();                                   //bit n is 1 if sensor n is ready, the same as begin() without selPins
+  Serial.print(millis() - t);
+  Serial.print(" ms, ");
+  Serial.print("ready mask 0x");
+  Serial.println(ready, HEX);
+  manager.startMeasurement(tof[0].eModeCalib);
+
+  for(int n = NUM_OF_SENSOR; n > 0; n--){
+      uint32_t samples = 0;
+      uint32_t t = millis();
+      while((millis() - t) < TEST_TIME){
+          uint16_t mask = manager.isDataReady();
+          for(uint8_t i = 0; i < n; i++){
+              if(mask & (1 << i)){
+                  manager.getDistance_mm(i);
+                  samples++;
+              }
+          }
+      }
+      Serial.print(n);
+      Serial.print(" sensors: ");
+      Serial.print(samples * 1000.0 / TEST_TIME);
+      Serial.println(" samples/s");
+      tof[n - 1].stopMeasurement();
+  }
+  manager.startMeasurement(tof[0].eModeCalib);
+}
+
+void loop() {
+  uint16_t mask = manager.isDataReady();
+  for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+      if(mask & (1 << i)){
+          Serial.print("sensor ");
+          Serial.print(i);
+          Serial.print(": ");
+          Serial.print(manager.getDistance_mm(i));
+          Serial.println(" mm");
+      }
+  }
+}
@@ -0,0 +1,94 @@
+/*!
+ * @file sharedInterrupt.ino
+ * @brief The open-drain INT pins of several sensors are wired together to one external interrupt pin of MCU.
+ * @n On every falling edge the manager checks INT_STATUS of the sensors, fetches the ones which fired and clears them.
+ * @n The interrupt to sample latency of every sensor is printed every 5s.
+ * *
+ * @n hardware conneted table:
+ * -------------------------------------------------------
+ * |  TMF8x01  |            MCU                           |
+ * |------------------------------------------------------|
+ * |    I2C    |       I2C Interface, shared by sensors   |
+ * |------------------------------------------------------|
+ * |    EN     |   IO pin of enPins[n]                    |
+ * |------------------------------------------------------|
+ * |    INT    |   shared, external interrupt pin INT     |
+ * |------------------------------------------------------|
+ * |    PIN0   |    not connected, floating               |
+ * |------------------------------------------------------|
+ * |    PIN1   |    not connected, floating               |
+ * |------------------------------------------------------|
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_Manager.h"
+
+#define NUM_OF_SENSOR   6
+#define INT             2                                                      //the shared INT line, UNO(2)
+#define REPORT_TIME     5000
+
+const int enPins[NUM_OF_SENSOR] = {4, 5, 6, 7, 8, 9};
+DFRobot_TMF8801 tof[NUM_OF_SENSOR] = {
+  DFRobot_TMF8801(enPins[0]), DFRobot_TMF8801(enPins[1]), DFRobot_TMF8801(enPins[2]),
+  DFRobot_TMF8801(enPins[3]), DFRobot_TMF8801(enPins[4]), DFRobot_TMF8801(enPins[5]),
+};
+DFRobot_TMF8x01_Manager manager(/*baseAddr =*/0x42);
+uint32_t reportTime;
+
+void notifyFun(){
+  manager.notifyInt();
+}
+
+void setup() {
+  Serial.begin(115200);                                                        //Serial Initialization
+  while(!Serial){                                                              //Wait for serial port to connect. Needed for native USB port only
+  }
+
+  for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+      manager.addSensor(&tof[i]);
+  }
+  Serial.print("Initialization ranging sensors......");
+  Serial.print("ready mask 0x");
+  Serial.println(manager.begin(), HEX);
+  manager.startMeasurement(tof[0].eModeCalib);
+
+  Serial.print("candidate mask 0x");
+  Serial.println(manager.beginSharedInt(/*intPin =*/INT, /*candidateMask =*/0xFFFF, /*order =*/manager.eIntRoundRobin), HEX);
+  attachInterrupt(/*Interrupt NO=*/digitalPinToInterrupt(INT),notifyFun,FALLING);
+  reportTime = millis();
+}
+
+void loop() {
+  uint16_t mask = manager.handleSharedInt();                                   //returns at once without interrupt
+  for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+      if(mask & (1 << i)){
+          Serial.print("sensor ");
+          Serial.print(i);
+          Serial.print(": ");
+          Serial.print(manager.getLastDistance_mm(i));
+          Serial.println(" mm");
+      }
+  }
+  if((millis() - reportTime) > REPORT_TIME){
+      reportTime = millis();
+      for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+          DFRobot_TMF8x01_Manager::sIntLatency_t latency;
+          manager.getIntLatency(i, &latency);
+          Serial.print("sensor ");
+          Serial.print(i);
+          Serial.print(" samples: ");   Serial.print(latency.count);
+          Serial.print(", latency min/avg/max: ");
+          Serial.print(latency.minUs);  Serial.print("/");
+          Serial.print(latency.avgUs);  Serial.print("/");
+          Serial.print(latency.maxUs);  Serial.println(" us");
+      }
+      manager.resetIntLatency();
+  }
+}
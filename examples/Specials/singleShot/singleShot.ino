@@ -0,0 +1,72 @@
+/*!
+ * @file singleShot.ino
+ * @brief Measure the distance only when it is needed. measureOnce() starts one measurement, waits for the result
+ * @n and leaves the sensor idle, so there is no I2C traffic between two measurements.
+ * @n The INT pin is used to wait for the result if it is connected, or the result register is polled.
+ * *
+ * @n hardware conneted table:
+ * -------------------------------------------------------
+ * |  TMF8x01  |            MCU                           |
+ * |------------------------------------------------------|
+ * |    I2C    |       I2C Interface                      |
+ * |------------------------------------------------------|
+ * |    EN     |   not connected, floating                |
+ * |------------------------------------------------------|
+ * |    INT    |   connected to IO pin 2 or floating      |
+ * |------------------------------------------------------|
+ * |    PIN0   |   not connected, floating                |
+ * |------------------------------------------------------|
+ * |    PIN1   |    not connected, floating               |
+ * |------------------------------------------------------|
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+
+#include "DFRobot_TMF8x01.h"
+
+#define EN       -1                      //EN pin of of TMF8x01 module is floating, not used in this demo
+#define INT      2                       //INT pin of of TMF8x01 module, set it to -1 if it is floating
+
+DFRobot_TMF8801 tof(/*enPin =*/EN,/*intPin=*/INT);
+//DFRobot_TMF8701 tof(/*enPin =*/EN,/*intPin=*/INT);
+
+void setup() {
+  Serial.begin(115200);                                                        //Serial Initialization
+  while(!Serial){                                                              //Wait for serial port to connect. Needed for native USB port only
+  }
+
+  Serial.print("Initialization ranging sensor TMF8x01......");
+  while(tof.begin() != 0){                                                 //Initialization sensor,sucess return 0, fail return -1
+      Serial.println("failed.");
+      delay(1000);
+  }
+  Serial.println("done.");
+
+  if(INT > -1) tof.enableIntPin();                                        //wait for the INT pin instead of polling the I2C bus
+/**
+ * @brief Set the iterations of single shot measurement. Fewer iterations give a shorter measurement and a lower accuracy.
+ * @param kIterations: the iterations in unit of 1000, 0 means using the same iterations as startMeasurement.
+ */
+  tof.setSingleShotIterations(/*kIterations =*/0);
+}
+
+void loop() {
+  uint16_t distance;
+  uint32_t t = micros();
+  if(tof.measureOnce(&distance)){                                         //one measurement, the sensor is idle after it
+      t = micros() - t;
+      Serial.print("Distance = ");
+      Serial.print(distance);
+      Serial.print(" mm, latency = ");
+      Serial.print(t);
+      Serial.println(" us");
+  }else{
+      Serial.println("measure failed.");
+  }
+  delay(1000);
+}
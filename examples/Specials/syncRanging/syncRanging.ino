@@ -0,0 +1,92 @@
+/*!
+ * @file syncRanging.ino
+ * @brief Pace a light curtain of sensors by one sync line, no I2C command is needed per sample. The PIN0 of all sensors
+ * @n is connected together. The even sensors measure while the line is high and the odd sensors while it is low,
+ * @n so two sensors next to each other never emit at the same time.
+ * @n MCU_MASTER 1: the line is driven by SYNC_PIN of MCU, switched every HALF_PERIOD ms.
+ * @n MCU_MASTER 0: the line is driven by the VCSEL signal of sensor 0, the other sensors follow it.
+ * *
+ * @n hardware conneted table:
+ * -------------------------------------------------------
+ * |  TMF8x01  |            MCU                           |
+ * |------------------------------------------------------|
+ * |    I2C    |       I2C Interface, shared by sensors   |
+ * |------------------------------------------------------|
+ * |    EN     |   IO pin of enPins[n]                    |
+ * |------------------------------------------------------|
+ * |    INT    |   not connected, floating                |
+ * |------------------------------------------------------|
+ * |    PIN0   |   sync line, connected to SYNC_PIN       |
+ * |------------------------------------------------------|
+ * |    PIN1   |    not connected, floating               |
+ * |------------------------------------------------------|
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_Manager.h"
+
+#define NUM_OF_SENSOR   4
+#define MCU_MASTER      1
+#define SYNC_PIN        10                                                     //not connected when MCU_MASTER is 0
+#define HALF_PERIOD     50                                                     //ms
+
+const int enPins[NUM_OF_SENSOR] = {2, 3, 4, 5};
+DFRobot_TMF8801 tof[NUM_OF_SENSOR] = {
+  DFRobot_TMF8801(enPins[0]), DFRobot_TMF8801(enPins[1]), DFRobot_TMF8801(enPins[2]), DFRobot_TMF8801(enPins[3]),
+};
+DFRobot_TMF8x01_Manager manager(/*baseAddr =*/0x42);
+uint32_t gateTime;
+bool gate = true;
+
+void setup() {
+  uint16_t even = 0, odd = 0;
+  Serial.begin(115200);                                                        //Serial Initialization
+  while(!Serial){                                                              //Wait for serial port to connect. Needed for native USB port only
+  }
+
+  for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+      manager.addSensor(&tof[i]);
+      if(i & 1) odd |= (1 << i);
+      else even |= (1 << i);
+  }
+  Serial.print("Initialization ranging sensors......");
+  Serial.print("ready mask 0x");
+  Serial.println(manager.begin(), HEX);
+
+#if MCU_MASTER
+  manager.setSyncMasterPin(/*mcuPin =*/SYNC_PIN, /*pin =*/tof[0].ePIN0);
+#else
+  manager.setSyncMaster(/*index =*/0, /*pin =*/tof[0].ePIN0);                 //sensor 0 emits while the line is high
+#endif
+  manager.beginSync(/*followerMask =*/even, manager.eSyncInPhase);
+  Serial.print("sync mask 0x");
+  Serial.println(manager.beginSync(/*followerMask =*/odd, manager.eSyncAntiPhase), HEX);
+  gateTime = millis();
+}
+
+void loop() {
+#if MCU_MASTER
+  if((millis() - gateTime) >= HALF_PERIOD){
+      gateTime += HALF_PERIOD;
+      gate = !gate;
+      manager.setSyncGate(gate);
+  }
+#endif
+  uint16_t mask = manager.isDataReady();
+  for(uint8_t i = 0; i < NUM_OF_SENSOR; i++){
+      if(mask & (1 << i)){
+          Serial.print("sensor ");
+          Serial.print(i);
+          Serial.print(": ");
+          Serial.print(manager.getDistance_mm(i));
+          Serial.println(" mm");
+      }
+  }
+}
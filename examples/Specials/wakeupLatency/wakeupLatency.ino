@@ -0,0 +1,115 @@
+/*!
+ * @file wakeupLatency.ino
+ * @brief Benchmark of wake-to-first-sample time for the 3 low power ways of the sensor:
+ * @n standby: enterStandby()/exitStandby(), the RAM patch is kept.
+ * @n sleep:   sleep()/wakeup(), the cpu is reset and the RAM patch is downloaded again.
+ * @n EN:      powerDown by EN pin, then begin() and startMeasurement() again.
+ * *
+ * @n hardware conneted table:
+ * ------------------------------------------
+ * |  TMF8x01  |            MCU              |
+ * |-----------------------------------------|
+ * |    I2C    |       I2C Interface         |
+ * |-----------------------------------------|
+ * |    EN     |   connected to IO pin 4     |
+ * |-----------------------------------------|
+ * |    INT    |   not connected, floating   |
+ * |-----------------------------------------|
+ * |    PIN0   |   not connected, floating   |
+ * |-----------------------------------------|
+ * |    PIN1   |    not connected, floating  |
+ * |-----------------------------------------|
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+
+#include "DFRobot_TMF8x01.h"
+
+#define EN       4                       //EN pin of of TMF8x01 module, set it to -1 to skip the EN benchmark
+#define INT      -1                      //INT pin of of TMF8x01 module is floating, not used in this demo
+
+DFRobot_TMF8801 tof(/*enPin =*/EN,/*intPin=*/INT);
+//DFRobot_TMF8701 tof(/*enPin =*/EN,/*intPin=*/INT);
+
+#define NUM_OF_ROUND   5                                                       //wakeup 5 times for every way
+#define SLEEP_TIME     1000                                                    //sleep 1000ms
+
+uint32_t waitFirstSample(uint32_t t){
+  uint32_t start = millis();
+  while(!tof.isDataReady()){
+      if((millis() - start) > 5000) return 0;                                  //timeout
+  }
+  tof.getDistance_mm();
+  return micros() - t;
+}
+
+void printResult(const char *name, uint32_t sum, uint32_t maxT){
+  Serial.print(name);
+  Serial.print(": average = ");
+  Serial.print(sum / NUM_OF_ROUND);
+  Serial.print(" us, max = ");
+  Serial.print(maxT);
+  Serial.println(" us");
+}
+
+void setup() {
+  uint32_t t, sum, maxT;
+  Serial.begin(115200);                                                        //Serial Initialization
+  while(!Serial){                                                              //Wait for serial port to connect. Needed for native USB port only
+  }
+
+  Serial.print("Initialization ranging sensor TMF8x01......");
+  while(tof.begin() != 0){                                                 //Initialization sensor,sucess return 0, fail return -1
+      Serial.println("failed.");
+      delay(1000);
+  }
+  Serial.println("done.");
+  tof.startMeasurement(/*cailbMode =*/tof.eModeCalib);
+
+  sum = maxT = 0;
+  for(uint8_t i = 0; i < NUM_OF_ROUND; i++){
+      tof.enterStandby();
+      delay(SLEEP_TIME);
+      t = micros();
+      tof.exitStandby();
+      t = waitFirstSample(t);
+      sum += t;
+      if(t > maxT) maxT = t;
+  }
+  printResult("standby", sum, maxT);
+
+  sum = maxT = 0;
+  for(uint8_t i = 0; i < NUM_OF_ROUND; i++){
+      tof.sleep();
+      delay(SLEEP_TIME);
+      t = micros();
+      tof.wakeup();
+      t = waitFirstSample(t);
+      sum += t;
+      if(t > maxT) maxT = t;
+  }
+  printResult("sleep", sum, maxT);
+
+  if(EN < 0) return;
+  sum = maxT = 0;
+  for(uint8_t i = 0; i < NUM_OF_ROUND; i++){
+      tof.stopMeasurement();
+      digitalWrite(EN, LOW);
+      delay(SLEEP_TIME);
+      t = micros();
+      tof.begin();                                                         //begin() holds EN pin low and high for 1s each
+      tof.startMeasurement(/*cailbMode =*/tof.eModeCalib);
+      t = waitFirstSample(t);
+      sum += t;
+      if(t > maxT) maxT = t;
+  }
+  printResult("EN power down", sum, maxT);
+}
+
+void loop() {
+}
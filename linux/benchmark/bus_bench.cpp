@@ -0,0 +1,156 @@
+/*!
+ * @file bus_bench.cpp
+ * @brief Runs the unchanged Arduino driver on the simulated bus, and measures the cost of the bus interface.
+ * @n 1. TMF8801 and TMF8701 in virtual time: begin()(power on, RAM patch download, APP0), startMeasurement() with
+ * @n    calibration, then the results are read by polling isDataReady(). The distances must match the simulator.
+ * @n 2. The same register read through the virtual bus interface and through a direct inline call, to show what
+ * @n    the indirection costs next to the time of one transfer on a 400kHz bus.
+ * @n usage: ./bus_bench [results] [calls]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_FakeBus.h"
+
+#define EN_PIN    4
+#define INT_PIN   5
+
+//a bus which only copies registers, so the time is the call and nothing else.
+class MemBus: public DFRobot_TMF8x01_Bus{
+public:
+  MemBus(){ memset(regs, 0, sizeof(regs)); }
+  void begin(){}
+  bool probe(uint8_t addr){ (void)addr; return true; }
+  void writeReg(uint8_t addr, uint8_t reg, const void *pBuf, size_t size){
+    (void)addr;
+    memcpy(&regs[reg], pBuf, size);
+  }
+  uint8_t readReg(uint8_t addr, uint8_t reg, void *pBuf, size_t size){
+    (void)addr;
+    memcpy(pBuf, &regs[reg], size);
+    return size;
+  }
+  uint8_t regs[512];
+};
+
+static inline uint8_t directReadReg(MemBus *bus, uint8_t reg, void *pBuf, size_t size){
+  memcpy(pBuf, &bus->regs[reg], size);
+  return size;
+}
+
+static double nowNs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+template<class T>
+static int runSensor(T &tof, DFRobot_TMF8x01_FakeBus &bus, uint16_t index, uint16_t mm, int results, const char *name){
+  int errors = 0, got = 0;
+  uint64_t t0, t1, busUs;
+  uint32_t transfers;
+  uint16_t tol = mm / 50 + 2;
+
+  bus.setDistance(index, mm);
+  t0 = bus.now();
+  busUs = bus.getBusTimeUs();
+  transfers = bus.getTransferCount();
+  if(tof.begin() != 0){
+      printf("%s: begin failed\n", name);
+      return 1;
+  }
+  t1 = bus.now();
+  printf("%s: begin %.1f ms(bus %.1f ms, %u transfers), model %s, version %s\n", name, (t1 - t0) / 1000.0,
+         (bus.getBusTimeUs() - busUs) / 1000.0, (unsigned)(bus.getTransferCount() - transfers),
+         tof.getSensorModel().c_str(), tof.getSoftwareVersion().c_str());
+  if(strcmp(tof.getSensorModel().c_str(), name) != 0) errors++;
+
+  t0 = bus.now();
+  if(!tof.startMeasurement(DFRobot_TMF8x01::eModeCalib)){
+      printf("%s: startMeasurement failed\n", name);
+      return errors + 1;
+  }
+  t1 = bus.now();
+  printf("%s: startMeasurement %.1f ms\n", name, (t1 - t0) / 1000.0);
+
+  t0 = bus.now();
+  while((got < results) && ((bus.now() - t0) < (uint64_t)results * 100000)){
+      if(!tof.isDataReady()){
+          delay(1);
+          continue;
+      }
+      uint16_t d = tof.getDistance_mm();
+      //+-1mm noise, and the drift correction of the driver works on millis() and truncates. The first window of
+      //the correction holds a warm-up sample read late by the 600ms delay of startMeasurement(), so it is skipped.
+      if(got && ((d + tol < mm) || (d > mm + tol))) errors++;
+      got++;
+  }
+  t1 = bus.now();
+  if(got < results) errors++;
+  printf("%s: %d results in %.1f ms virtual time, %u produced\n", name, got, (t1 - t0) / 1000.0,
+         (unsigned)bus.getResultCount(index));
+  tof.stopMeasurement();
+  return errors;
+}
+
+int main(int argc, char **argv){
+  int results = (argc > 1) ? atoi(argv[1]) : 50;
+  long calls = (argc > 2) ? atol(argv[2]) : 10000000;
+  int errors = 0;
+  uint8_t buf[13];
+  volatile uint8_t sink = 0;
+  double t0, virt, direct;
+
+  if(results < 1) results = 1;
+  if(calls < 1) calls = 1;
+
+  {
+      DFRobot_TMF8x01_FakeBus bus;
+      bus.addSensor(EN_PIN, INT_PIN, DFRobot_TMF8x01_FakeBus::eFakeTMF8801);
+      bus.attach(true);
+      DFRobot_TMF8801 tof(bus, EN_PIN, INT_PIN);
+      errors += runSensor(tof, bus, 0, 321, results, "TMF8801");
+  }
+  {
+      DFRobot_TMF8x01_FakeBus bus;
+      bus.addSensor(EN_PIN, INT_PIN, DFRobot_TMF8x01_FakeBus::eFakeTMF8701);
+      bus.attach(true);
+      DFRobot_TMF8701 tof(bus, EN_PIN, INT_PIN);
+      errors += runSensor(tof, bus, 0, 57, results, "TMF8701");
+  }
+  setArduinoHooks(NULL);
+
+  MemBus mem;
+  DFRobot_TMF8x01_Bus *pBus = &mem;
+  //the volatile pointer keeps the compiler from devirtualizing the call.
+  DFRobot_TMF8x01_Bus *volatile pv = pBus;
+  t0 = nowNs();
+  for(long i = 0; i < calls; i++){
+      pv->readReg(0x41, 0x1D, buf, sizeof(buf));
+      sink += buf[2];
+      mem.regs[0x1F]++;
+  }
+  virt = (nowNs() - t0) / calls;
+  t0 = nowNs();
+  for(long i = 0; i < calls; i++){
+      directReadReg(&mem, 0x1D, buf, sizeof(buf));
+      sink += buf[2];
+      mem.regs[0x1F]++;
+  }
+  direct = (nowNs() - t0) / calls;
+  printf("13 byte result read: virtual %.2f ns, direct %.2f ns, difference %.2f ns per call\n", virt, direct, virt - direct);
+  printf("one result read on a 400kHz bus takes %.1f us, the interface costs %.4f%% of it\n",
+         (16 * 9 + 2) * 2.5, 100.0 * (virt - direct) / ((16 * 9 + 2) * 2500.0));
+  (void)sink;
+
+  printf("%s\n", errors ? "FAIL" : "PASS");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,213 @@
+/*!
+ * @file coro_bench.cpp
+ * @brief Thousands of sensor coroutines on one thread against one thread per sensor.
+ * @n Every sensor is a simulated TMF8801 on its own DFRobot_TMF8x01_FakeBus in real time. A task per sensor runs
+ * @n co_await begin(), calibrate(), startMeasurement() and then a number of nextSample(), all tasks on one
+ * @n DFRobot_TMF8x01_EpollExecutor. The same work is then done by the blocking driver with one thread per sensor.
+ * @n The INT path is checked with an eventfd: a coroutine waits on it, another one triggers it.
+ * @n usage: ./coro_bench [sensors] [samples] [threads]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <sys/resource.h>
+#include "DFRobot_TMF8x01_Coro.h"
+#include "DFRobot_TMF8x01_FakeBus.h"
+
+typedef struct{
+  uint32_t ok;
+  uint32_t failed;
+  uint32_t samples;
+  uint32_t wrong;
+}sStats_t;
+
+typedef struct{
+  double wallMs;
+  double cpuMs;
+  long rssKb;
+}sUsage_t;
+
+static uint64_t clockNs(clockid_t id){
+  struct timespec ts;
+  clock_gettime(id, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static long maxRssKb(){
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_maxrss;
+}
+
+static uint16_t distanceOf(int i){
+  return 100 + (i % 900);
+}
+
+static bool near(uint16_t d, uint16_t mm){
+  //+-1mm noise, and the drift correction of the driver works on millis() and truncates.
+  uint16_t tol = mm / 50 + 2;
+  return (d + tol >= mm) && (d <= mm + tol);
+}
+
+static DFRobot_TMF8x01_VoidTask sensorTask(DFRobot_TMF8x01_Coro *c, uint16_t mm, int samples, sStats_t *st){
+  uint8_t calib[SENSOR_MTF8x01_CALIBRATION_SIZE];
+  if(co_await c->begin() != 0){
+      st->failed++;
+      co_return;
+  }
+  if(!co_await c->calibrate(calib)){
+      st->failed++;
+      co_return;
+  }
+  if(!co_await c->startMeasurement()){
+      st->failed++;
+      co_return;
+  }
+  for(int k = 0; k < samples; k++){
+      DFRobot_TMF8x01_Coro::sCoSample_t s = co_await c->nextSample(1000);
+      if(!s.valid){
+          st->failed++;
+          co_return;
+      }
+      st->samples++;
+      //the first result after the warm-up has the stale clock window of the driver, see bus_bench.
+      if(k && !near(s.distance, mm)) st->wrong++;
+  }
+  co_await c->stopMeasurement();
+  st->ok++;
+}
+
+static void sensorThread(DFRobot_TMF8801 *tof, uint16_t mm, int samples, sStats_t *st){
+  uint8_t calib[SENSOR_MTF8x01_CALIBRATION_SIZE];
+  if((tof->begin() != 0) || !tof->getCalibrationData(calib) || !tof->startMeasurement()){
+      __atomic_fetch_add(&st->failed, 1, __ATOMIC_RELAXED);
+      return;
+  }
+  for(int k = 0; k < samples; k++){
+      uint32_t t = millis();
+      while(!tof->isDataReady()){
+          if((millis() - t) > 1000){
+              __atomic_fetch_add(&st->failed, 1, __ATOMIC_RELAXED);
+              return;
+          }
+          delay(1);
+      }
+      uint16_t d = tof->getDistance_mm();
+      __atomic_fetch_add(&st->samples, 1, __ATOMIC_RELAXED);
+      if(k && !near(d, mm)) __atomic_fetch_add(&st->wrong, 1, __ATOMIC_RELAXED);
+  }
+  tof->stopMeasurement();
+  __atomic_fetch_add(&st->ok, 1, __ATOMIC_RELAXED);
+}
+
+static DFRobot_TMF8x01_VoidTask intWaiter(DFRobot_TMF8x01_CoExecutor *ex, DFRobot_TMF8x01_LinuxInt *irq, int *result){
+  uint64_t t = ex->nowUs();
+  //no edge: the deadline wakes it.
+  if(co_await ex->waitFd(irq->getFd(), 20)) *result |= 1;
+  if((ex->nowUs() - t) < 20000) *result |= 2;
+  //the edge of the other task wakes it before the deadline.
+  t = ex->nowUs();
+  if(!co_await ex->waitFd(irq->getFd(), 1000)) *result |= 4;
+  if(irq->consume() != 1) *result |= 8;
+  if((ex->nowUs() - t) > 500000) *result |= 16;
+}
+
+static DFRobot_TMF8x01_VoidTask intTrigger(DFRobot_TMF8x01_CoExecutor *ex, DFRobot_TMF8x01_LinuxInt *irq){
+  co_await ex->sleepMs(50);
+  irq->trigger();
+}
+
+int main(int argc, char **argv){
+  int n = (argc > 1) ? atoi(argv[1]) : 2000;
+  int samples = (argc > 2) ? atoi(argv[2]) : 10;
+  int threads = (argc > 3) ? atoi(argv[3]) : 200;
+  int errors = 0;
+  sStats_t co, th;
+  sUsage_t cu, tu;
+  long rss0;
+  uint64_t wall0, cpu0;
+
+  if(n < 1) n = 1;
+  if(samples < 1) samples = 1;
+  if(threads < 0) threads = 0;
+  memset(&co, 0, sizeof(co));
+  memset(&th, 0, sizeof(th));
+
+  {
+      DFRobot_TMF8x01_EpollExecutor ex;
+      DFRobot_TMF8x01_LinuxInt irq;
+      int result = 0;
+      if(irq.beginEventfd() != 0) errors++;
+      ex.spawn(intWaiter(&ex, &irq, &result));
+      ex.spawn(intTrigger(&ex, &irq));
+      ex.run();
+      if(result) errors++;
+      printf("INT wait: %s(%d)\n", result ? "failed" : "ok", result);
+  }
+
+  {
+      //deque: the elements never move, the sensors keep pointers to their bus.
+      std::deque<DFRobot_TMF8x01_FakeBus> bus;
+      std::deque<DFRobot_TMF8801> tof;
+      std::deque<DFRobot_TMF8x01_Coro> coro;
+      DFRobot_TMF8x01_EpollExecutor ex;
+      rss0 = maxRssKb();
+      for(int i = 0; i < n; i++){
+          bus.emplace_back();
+          bus[i].setDistance(bus[i].addSensor(), distanceOf(i));
+          tof.emplace_back(bus[i]);
+          coro.emplace_back(tof[i], ex);
+      }
+      wall0 = clockNs(CLOCK_MONOTONIC);
+      cpu0 = clockNs(CLOCK_PROCESS_CPUTIME_ID);
+      for(int i = 0; i < n; i++) ex.spawn(sensorTask(&coro[i], distanceOf(i), samples, &co));
+      ex.run();
+      cu.wallMs = (clockNs(CLOCK_MONOTONIC) - wall0) / 1e6;
+      cu.cpuMs = (clockNs(CLOCK_PROCESS_CPUTIME_ID) - cpu0) / 1e6;
+      cu.rssKb = maxRssKb() - rss0;
+      printf("coroutines: %d sensors on 1 thread, %u ok, %u failed, %u samples, %u wrong\n", n, co.ok, co.failed, co.samples, co.wrong);
+      printf("coroutines: %.0f ms, cpu %.0f ms(%.1f%% of one core), %.1f samples/s, %llu resumptions, +%ld kB RSS\n",
+             cu.wallMs, cu.cpuMs, 100 * cu.cpuMs / cu.wallMs, 1000.0 * co.samples / cu.wallMs,
+             (unsigned long long)ex.getResumeCount(), cu.rssKb);
+      if((co.ok != (uint32_t)n) || co.failed || co.wrong) errors++;
+  }
+
+  if(threads > 0){
+      std::deque<DFRobot_TMF8x01_FakeBus> bus;
+      std::deque<DFRobot_TMF8801> tof;
+      std::vector<std::thread> t;
+      rss0 = maxRssKb();
+      for(int i = 0; i < threads; i++){
+          bus.emplace_back();
+          bus[i].setDistance(bus[i].addSensor(), distanceOf(i));
+          tof.emplace_back(bus[i]);
+      }
+      wall0 = clockNs(CLOCK_MONOTONIC);
+      cpu0 = clockNs(CLOCK_PROCESS_CPUTIME_ID);
+      for(int i = 0; i < threads; i++) t.push_back(std::thread(sensorThread, &tof[i], distanceOf(i), samples, &th));
+      for(int i = 0; i < threads; i++) t[i].join();
+      tu.wallMs = (clockNs(CLOCK_MONOTONIC) - wall0) / 1e6;
+      tu.cpuMs = (clockNs(CLOCK_PROCESS_CPUTIME_ID) - cpu0) / 1e6;
+      tu.rssKb = maxRssKb() - rss0;
+      printf("threads:    %d sensors on %d threads, %u ok, %u failed, %u samples, %u wrong\n", threads, threads, th.ok, th.failed, th.samples, th.wrong);
+      printf("threads:    %.0f ms, cpu %.0f ms, %.1f samples/s, +%ld kB RSS\n",
+             tu.wallMs, tu.cpuMs, 1000.0 * th.samples / tu.wallMs, tu.rssKb);
+      printf("cpu per sample: coroutines %.1f us, threads %.1f us\n",
+             1000 * cu.cpuMs / (co.samples ? co.samples : 1), 1000 * tu.cpuMs / (th.samples ? th.samples : 1));
+      if((th.ok != (uint32_t)threads) || th.failed) errors++;
+  }
+
+  printf("%s\n", errors ? "FAIL" : "PASS");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,316 @@
+/*!
+ * @file eventloop_bench.cpp
+ * @brief 256 simulated sensors on 4 buses served by one thread with DFRobot_TMF8x01_EventLoop.
+ * @n A simulator thread stands in for the sensors: every sensor produces a result each period(phases spread over the
+ * @n period), sets INT_STATUS and raises its INT through an eventfd, only if INT_STATUS was clear, as the edge of a
+ * @n real line. The buses are fake i2c-dev adapters(ioctl hook), every transfer is charged the time of a 1MHz bus.
+ * @n Every sensor has a driver object, moved from 0x41 to its address by modifyI2CAddress(), the loop hands each
+ * @n result to it: the results of a driver(getSampleCount(), getDistance_mm()) must be the ones the loop delivered.
+ * @n One sensor does not answer, it must fail alone. One sensor loses every LOSSY_EVERY th INT clear and one has
+ * @n its INT low before it is added, both must keep delivering.
+ * @n The loop thread is compared with polling all sensors round robin over the same buses.
+ * @n usage: ./eventloop_bench [sensors] [period ms] [seconds]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "DFRobot_TMF8x01_EventLoop.h"
+#include "DFRobot_TMF8x01_LinuxBus.h"
+
+#define BUS_NUM       4
+#define BASE_ADDR     0x10
+#define BOOT_ADDR     0x41                 //TMF8x01_I2C_ADDR, the address of a sensor after power on
+#define MAX_SENSORS   (BUS_NUM * 96)
+#define BUS_HZ        1000000.0
+#define MISSING       5                    //this sensor does not answer
+#define LOSSY         6                    //this sensor loses some INT clears
+#define LOSSY_EVERY   3
+#define STUCK         7                    //INT of this sensor is low before addSensor()
+
+typedef struct{
+  std::mutex lock;
+  uint8_t regs[128][256];
+  uint8_t ptr[128];
+  bool present[128];
+  uint8_t lossyAddr;
+  uint32_t clears;
+  double busUs;
+}sSimBus_t;
+
+typedef struct{
+  sSimBus_t bus[BUS_NUM];
+  DFRobot_TMF8x01_LinuxInt irq[MAX_SENSORS];
+  std::atomic<uint64_t> stamp[MAX_SENSORS];
+  std::atomic<bool> stop;
+  int n;
+  int periodMs;
+}sSim_t;
+
+typedef struct{
+  sSim_t *sim;
+  uint32_t got;
+  uint32_t missed;
+  uint8_t lastTid[MAX_SENSORS];
+  bool seen[MAX_SENSORS];
+  double sumUs;
+  double maxUs;
+}sStats_t;
+
+static uint64_t clockNs(clockid_t id){
+  struct timespec ts;
+  clock_gettime(id, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int simIoctl(void *ctx, int fd, unsigned long request, void *arg){
+  sSimBus_t *bus = (sSimBus_t *)ctx;
+  (void)fd;
+  if(request == I2C_FUNCS){
+      *(unsigned long *)arg = I2C_FUNC_I2C;
+      return 0;
+  }
+  if(request != I2C_RDWR){
+      errno = ENOTTY;
+      return -1;
+  }
+  struct i2c_rdwr_ioctl_data *data = (struct i2c_rdwr_ioctl_data *)arg;
+  std::lock_guard<std::mutex> guard(bus->lock);
+  bus->busUs += 1 * 1e6 / BUS_HZ;
+  for(uint32_t i = 0; i < data->nmsgs; i++){
+      struct i2c_msg *m = &data->msgs[i];
+      uint8_t a = m->addr & 0x7F;
+      bus->busUs += (10 + m->len * 9) * 1e6 / BUS_HZ;
+      if(!bus->present[a] && (a != BOOT_ADDR)){
+          errno = ENXIO;
+          return -1;
+      }
+      if(m->flags & I2C_M_RD){
+          for(uint16_t k = 0; k < m->len; k++) m->buf[k] = bus->regs[a][bus->ptr[a]++];
+      }else{
+          bus->ptr[a] = m->buf[0];
+          for(uint16_t k = 1; k < m->len; k++){
+              uint8_t r = bus->ptr[a]++;
+              //INT_STATUS is write 1 to clear.
+              if(r == 0xE1){
+                  if((a == bus->lossyAddr) && ((++bus->clears % LOSSY_EVERY) == 0)) continue;
+                  bus->regs[a][r] &= ~m->buf[k];
+              }
+              else bus->regs[a][r] = m->buf[k];
+              //command 0x49: the sensor at the boot address moves to the address in cmd_data0.
+              if((a == BOOT_ADDR) && (r == 0x10) && (m->buf[k] == 0x49)){
+                  uint8_t to = bus->regs[a][0x0F] >> 1;
+                  bus->regs[to][0x00] = 0xC0;
+                  bus->regs[to][0x11] = 0x49;
+                  bus->present[to] = true;
+              }
+          }
+      }
+  }
+  return data->nmsgs;
+}
+
+static void simulate(sSim_t *sim){
+  uint64_t start = clockNs(CLOCK_MONOTONIC);
+  uint64_t periodNs = (uint64_t)sim->periodMs * 1000000ULL;
+  std::vector<uint64_t> next(sim->n);
+  struct timespec tick = {0, 250000};
+  for(int i = 0; i < sim->n; i++) next[i] = start + periodNs * i / sim->n;
+  while(!sim->stop.load()){
+      uint64_t now = clockNs(CLOCK_MONOTONIC);
+      for(int i = 0; i < sim->n; i++){
+          if(next[i] > now) continue;
+          next[i] += periodNs;
+          sSimBus_t *bus = &sim->bus[i % BUS_NUM];
+          uint8_t a = BASE_ADDR + i / BUS_NUM;
+          bool edge;
+          {
+              std::lock_guard<std::mutex> guard(bus->lock);
+              uint8_t *r = bus->regs[a];
+              r[0x1E] = 0x55;
+              r[0x1F]++;
+              r[0x22] = (100 + i) & 0xFF;
+              r[0x23] = (100 + i) >> 8;
+              //the line is low already: no edge.
+              edge = !(r[0xE1] & 0x01);
+              r[0xE1] |= 0x01;
+          }
+          sim->stamp[i].store(now);
+          if(edge) sim->irq[i].trigger();
+      }
+      nanosleep(&tick, NULL);
+  }
+}
+
+static void onResult(void *ctx, const DFRobot_TMF8x01_EventLoop::sEventResult_t *r){
+  sStats_t *st = (sStats_t *)ctx;
+  double us = (r->fetchNs - st->sim->stamp[r->sensor].load()) / 1000.0;
+  if(st->seen[r->sensor]) st->missed += (uint8_t)(r->tid - st->lastTid[r->sensor] - 1);
+  st->seen[r->sensor] = true;
+  st->lastTid[r->sensor] = r->tid;
+  if(r->distance != 100 + r->sensor) st->missed += 1000;
+  st->got++;
+  st->sumUs += us;
+  if(us > st->maxUs) st->maxUs = us;
+}
+
+int main(int argc, char **argv){
+  static sSim_t sim;
+  static sStats_t st;
+  int n = (argc > 1) ? atoi(argv[1]) : 256;
+  int periodMs = (argc > 2) ? atoi(argv[2]) : 100;
+  double seconds = (argc > 3) ? atof(argv[3]) : 2;
+  char dev[] = "/tmp/fake-i2c-XXXXXX";
+  int fd, errors = 0;
+  uint32_t ioctls = 0, pollIoctls = 0, pollGot = 0;
+  uint64_t cpu0, wall0;
+  double loopCpu, loopWall, pollCpu, pollWall, busUs = 0;
+
+  if(n < BUS_NUM * 2) n = BUS_NUM * 2;
+  if(n > MAX_SENSORS) n = MAX_SENSORS;
+  if(periodMs < 1) periodMs = 1;
+  fd = mkstemp(dev);
+  if(fd < 0){
+      perror("mkstemp");
+      return 1;
+  }
+  close(fd);
+  sim.n = n;
+  sim.periodMs = periodMs;
+  for(int b = 0; b < BUS_NUM; b++) sim.bus[b].regs[BOOT_ADDR][0x00] = 0xC0;
+  for(int i = 0; i < n; i++){
+      if(sim.irq[i].beginEventfd() != 0) errors++;
+  }
+
+  std::vector<DFRobot_TMF8x01_LinuxI2C *> i2c;
+  std::vector<DFRobot_TMF8x01_LinuxBus *> tofBus;
+  std::deque<DFRobot_TMF8801> tof;
+  DFRobot_TMF8x01_EventLoop loop;
+  loop.begin();
+  loop.setCallback(onResult, &st);
+  for(int b = 0; b < BUS_NUM; b++){
+      i2c.push_back(new DFRobot_TMF8x01_LinuxI2C(dev));
+      i2c[b]->setIoctl(simIoctl, &sim.bus[b]);
+      if(i2c[b]->begin() != 0) errors++;
+      tofBus.push_back(new DFRobot_TMF8x01_LinuxBus(*i2c[b]));
+      loop.addBus(*i2c[b]);
+  }
+  unlink(dev);
+  //one sensor at a time at the boot address, as their EN pins would bring them up.
+  for(int i = 0; i < n; i++){
+      tof.emplace_back(*tofBus[i % BUS_NUM]);
+      if(!tof[i].modifyI2CAddress(BASE_ADDR + i / BUS_NUM)) errors++;
+  }
+  sim.bus[MISSING % BUS_NUM].present[BASE_ADDR + MISSING / BUS_NUM] = false;
+  sim.bus[LOSSY % BUS_NUM].lossyAddr = BASE_ADDR + LOSSY / BUS_NUM;
+  sim.bus[STUCK % BUS_NUM].regs[BASE_ADDR + STUCK / BUS_NUM][0xE1] = 0x01;
+  for(int i = 0; i < n; i++){
+      if(loop.addSensor(i % BUS_NUM, tof[i], sim.irq[i]) != i) errors++;
+  }
+
+  //event loop
+  st.sim = &sim;
+  sim.stop = false;
+  cpu0 = clockNs(CLOCK_THREAD_CPUTIME_ID);
+  wall0 = clockNs(CLOCK_MONOTONIC);
+  std::thread t(simulate, &sim);
+  while((clockNs(CLOCK_MONOTONIC) - wall0) < seconds * 1e9){
+      if(loop.run(100) < 0) errors++;
+  }
+  sim.stop = true;
+  t.join();
+  loopCpu = (clockNs(CLOCK_THREAD_CPUTIME_ID) - cpu0) / 1e6;
+  loopWall = (clockNs(CLOCK_MONOTONIC) - wall0) / 1e6;
+  for(int b = 0; b < BUS_NUM; b++){
+      ioctls += i2c[b]->getIoctlCount();
+      busUs += sim.bus[b].busUs;
+      sim.bus[b].busUs = 0;
+  }
+
+  double expect = (n - 1) * loopWall / periodMs;
+  printf("%d sensors on %d buses, period %d ms, %.1f s\n", n, BUS_NUM, periodMs, loopWall / 1000);
+  printf("event loop: %u results(%.0f expected), %u missed, latency avg %.1f us max %.1f us\n",
+         st.got, expect, st.missed, st.got ? st.sumUs / st.got : 0, st.maxUs);
+  printf("event loop: cpu %.1f ms(%.1f%%), %.2f ioctls per result, bus time needed %.1f%% of each bus\n",
+         loopCpu, 100 * loopCpu / loopWall, st.got ? (double)ioctls / st.got : 0, 100 * busUs / BUS_NUM / 1000 / loopWall);
+  if(st.got < expect * 0.95) errors++;
+  if(st.missed) errors++;
+  if(loop.getResultCount(MISSING) || !loop.getErrorCount(MISSING)) errors++;
+  for(int i = 0; i < n; i++){
+      if((i != MISSING) && (loop.getResultCount(i) == 0)) errors++;
+  }
+  printf("missing sensor: %u results, %u errors\n", loop.getResultCount(MISSING), loop.getErrorCount(MISSING));
+  printf("sensor losing 1/%d INT clears: %u results, sensor with INT low at start: %u results\n", LOSSY_EVERY,
+         loop.getResultCount(LOSSY), loop.getResultCount(STUCK));
+  if(loop.getResultCount(LOSSY) < loopWall / periodMs * 0.9) errors++;
+  if(loop.getResultCount(STUCK) < loopWall / periodMs * 0.9) errors++;
+  {
+      int bad = 0;
+      for(int i = 0; i < n; i++){
+          if(tof[i].getSampleCount() != loop.getResultCount(i)) bad++;
+          else if((i != MISSING) && (tof[i].getDistance_mm() != 100 + i)) bad++;
+      }
+      printf("driver objects: %d of %d differ from the results of the loop\n", bad, n);
+      if(bad) errors++;
+  }
+
+  //polling round robin, the same work without INT
+  {
+      std::vector<uint8_t> tid(n, 0);
+      uint8_t buf[EVENTLOOP_RESULT_SIZE];
+      uint8_t clear = 0x01;
+      busUs = 0;
+      ioctls = 0;
+      for(int b = 0; b < BUS_NUM; b++) ioctls += i2c[b]->getIoctlCount();
+      sim.stop = false;
+      cpu0 = clockNs(CLOCK_THREAD_CPUTIME_ID);
+      wall0 = clockNs(CLOCK_MONOTONIC);
+      std::thread p(simulate, &sim);
+      while((clockNs(CLOCK_MONOTONIC) - wall0) < seconds * 1e9){
+          for(int i = 0; i < n; i++){
+              DFRobot_TMF8x01_LinuxI2C *bus = i2c[i % BUS_NUM];
+              uint8_t a = BASE_ADDR + i / BUS_NUM;
+              if(bus->readReg(a, 0x1D, buf, sizeof(buf)) != (int)sizeof(buf)) continue;
+              if(buf[2] == tid[i]) continue;
+              tid[i] = buf[2];
+              bus->writeReg(a, 0xE1, &clear, 1);
+              pollGot++;
+          }
+      }
+      sim.stop = true;
+      p.join();
+      pollCpu = (clockNs(CLOCK_THREAD_CPUTIME_ID) - cpu0) / 1e6;
+      pollWall = (clockNs(CLOCK_MONOTONIC) - wall0) / 1e6;
+      for(int b = 0; b < BUS_NUM; b++){
+          pollIoctls += i2c[b]->getIoctlCount();
+          busUs += sim.bus[b].busUs;
+      }
+      pollIoctls -= ioctls;
+      printf("polling:    %u results, cpu %.1f ms(%.1f%%), %.2f ioctls per result, bus time needed %.1f%% of each bus\n",
+             pollGot, pollCpu, 100 * pollCpu / pollWall, pollGot ? (double)pollIoctls / pollGot : 0,
+             100 * busUs / BUS_NUM / 1000 / pollWall);
+  }
+
+  for(int b = 0; b < BUS_NUM; b++){
+      delete tofBus[b];
+      delete i2c[b];
+  }
+  printf("%s\n", errors ? "FAIL" : "PASS");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,101 @@
+/*!
+ * @file histogram_bench.cpp
+ * @brief Frames per second per core of the histogram processing, SIMD code against scalar code.
+ * @n The synthetic frames have 2 targets(glass, then the wall behind it), crosstalk and noise. The peaks of the SIMD
+ * @n code must be the ones of the scalar code in every frame.
+ * @n usage: ./histogram_bench [frames per batch] [batches]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "DFRobot_TMF8x01_Histogram.h"
+
+#define BINS   128
+#define TOL    1e-3f          //relative, the SIMD code may round in another order
+
+static double now(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool near(float a, float b){
+  return fabsf(a - b) <= TOL * (fabsf(a) + fabsf(b) + 1.0f);
+}
+
+static double run(DFRobot_TMF8x01_Histogram &hist, uint32_t frames, int batches, DFRobot_TMF8x01_Histogram::sPeaks_t *peaks){
+  double t = now();
+  for(int i = 0; i < batches; i++){
+      hist.process(frames, peaks);
+  }
+  return frames * (double)batches / (now() - t);
+}
+
+int main(int argc, char **argv){
+  uint32_t frames = (argc > 1) ? atoi(argv[1]) : 1024;
+  int batches = (argc > 2) ? atoi(argv[2]) : 200;
+  float ref[BINS], frame[BINS];
+  DFRobot_TMF8x01_Histogram hist(BINS, frames);
+  DFRobot_TMF8x01_Histogram::sPeaks_t *peaks = new DFRobot_TMF8x01_Histogram::sPeaks_t[frames];
+  DFRobot_TMF8x01_Histogram::sPeaks_t *scalarPeaks = new DFRobot_TMF8x01_Histogram::sPeaks_t[frames];
+  uint32_t differ = 0;
+
+  srand(1);
+  for(int b = 0; b < BINS; b++){
+      ref[b] = 20.0f * expf(-b / 6.0f);                                        //crosstalk close to the sensor
+  }
+  for(uint32_t f = 0; f < frames; f++){
+      float glass = 30 + (f % 7), wall = 70 + (f % 23);
+      for(int b = 0; b < BINS; b++){
+          frame[b] = ref[b] + 5 + (rand() % 3)
+                   + 60 * expf(-(b - glass) * (b - glass) / 4.0f)
+                   + 150 * expf(-(b - wall) * (b - wall) / 6.0f);
+      }
+      hist.setFrame(f, frame);
+  }
+  hist.setReference(ref);
+  hist.setSmoothing(1);
+  hist.setThreshold(30);
+  hist.setDistanceScale(/*mmPerBin =*/10.0f, /*zeroBin =*/0);
+
+  hist.setSimd(false);
+  double scalar = run(hist, frames, batches, scalarPeaks);
+  hist.setSimd(true);
+  double simd = run(hist, frames, batches, peaks);
+  for(uint32_t f = 0; f < frames; f++){
+      bool same = (peaks[f].num == scalarPeaks[f].num);
+      for(int i = 0; same && (i < peaks[f].num); i++){
+          same = near(peaks[f].peak[i].distanceMm, scalarPeaks[f].peak[i].distanceMm) &&
+                 near(peaks[f].peak[i].amplitude, scalarPeaks[f].peak[i].amplitude);
+      }
+      if(!same) differ++;
+  }
+
+  printf("bins %d, frames per batch %u, batches %d\n", BINS, frames, batches);
+  printf("scalar: %.0f frames/s\n", scalar);
+#if defined(__AVX2__)
+  printf("AVX2  : %.0f frames/s (x%.2f)\n", simd, simd / scalar);
+#elif defined(__SSE2__)
+  printf("SSE2  : %.0f frames/s (x%.2f)\n", simd, simd / scalar);
+#else
+  printf("no SIMD code for this target\n");
+#endif
+  printf("frame 0: %d peaks", peaks[0].num);
+  for(int i = 0; i < peaks[0].num; i++){
+      printf(", %.1f mm(%.0f)", peaks[0].peak[i].distanceMm, peaks[0].peak[i].amplitude);
+  }
+  printf("\n");
+  printf("peaks of SIMD and scalar code: %u of %u frames differ\n", differ, frames);
+  delete[] peaks;
+  delete[] scalarPeaks;
+  printf("%s\n", differ ? "FAIL" : "PASS");
+  return differ ? 1 : 0;
+}
@@ -0,0 +1,213 @@
+/*!
+ * @file i2cdev_bench.cpp
+ * @brief Polling the result registers of several sensors through the i2c-dev transport, against a fake device file.
+ * @n The ioctl hook emulates the register map of the sensors and charges the time of a 400kHz bus plus the kernel
+ * @n overhead of every ioctl, so the 3 ways can be compared without hardware:
+ * @n   split:    write register address, STOP, then read(what readReg() of Arduino does), 2 ioctls per read
+ * @n   combined: readReg(), write-read with repeated start, 1 ioctl per read
+ * @n   batched:  transfer(), the reads of all sensors in as few ioctls as possible
+ * @n The short read check removes a sensor from the fake bus and expects its access to fail alone, in a batch of
+ * @n writes(INT clear) and reads every write must reach its sensor exactly once.
+ * @n usage: ./i2cdev_bench [sensors] [polls] [ioctl overhead us]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "DFRobot_TMF8x01_LinuxI2C.h"
+
+#define BASE_ADDR     0x42
+#define MAX_SENSORS   112
+#define REG_STATUS    0x1D
+#define RESULT_SIZE   13                   //STATUS .. sysclock, the block isDataReady() reads
+
+typedef struct{
+  uint8_t regs[256];
+  uint8_t ptr;
+  bool present;
+  uint32_t writes;                         //write messages with data
+}sFakeSensor_t;
+
+typedef struct{
+  sFakeSensor_t sensor[128];
+  double busUs;                            //virtual time of the bus and the kernel
+  double ioctlUs;
+}sFakeBus_t;
+
+static int fakeIoctl(void *ctx, int fd, unsigned long request, void *arg){
+  sFakeBus_t *bus = (sFakeBus_t *)ctx;
+  (void)fd;
+  if(request == I2C_FUNCS){
+      *(unsigned long *)arg = I2C_FUNC_I2C;
+      return 0;
+  }
+  if(request != I2C_RDWR){
+      errno = ENOTTY;
+      return -1;
+  }
+  struct i2c_rdwr_ioctl_data *data = (struct i2c_rdwr_ioctl_data *)arg;
+  bus->busUs += bus->ioctlUs + 1 * 2.5;    //STOP
+  for(uint32_t i = 0; i < data->nmsgs; i++){
+      struct i2c_msg *m = &data->msgs[i];
+      sFakeSensor_t *s = &bus->sensor[m->addr & 0x7F];
+      bus->busUs += 10 * 2.5;              //START + address + ACK
+      if(!s->present){
+          errno = ENXIO;                   //address NACK
+          return -1;
+      }
+      bus->busUs += m->len * 9 * 2.5;
+      if(m->flags & I2C_M_RD){
+          for(uint16_t k = 0; k < m->len; k++) m->buf[k] = s->regs[s->ptr++];
+      }else{
+          s->ptr = m->buf[0];
+          if(m->len > 1) s->writes++;
+          for(uint16_t k = 1; k < m->len; k++) s->regs[s->ptr++] = m->buf[k];
+      }
+  }
+  return data->nmsgs;
+}
+
+static void fill(sFakeBus_t *bus, int n, uint8_t tid){
+  for(int i = 0; i < n; i++){
+      uint8_t *r = bus->sensor[BASE_ADDR + i].regs;
+      r[0x1E] = 0x55;
+      r[0x1F] = tid;
+      r[0x21] = (100 + i) & 0xFF;
+  }
+}
+
+int main(int argc, char **argv){
+  int n = (argc > 1) ? atoi(argv[1]) : 16;
+  int polls = (argc > 2) ? atoi(argv[2]) : 1000;
+  double ioctlUs = (argc > 3) ? atof(argv[3]) : 60;
+  static sFakeBus_t bus;
+  static uint8_t out[MAX_SENSORS][RESULT_SIZE];
+  DFRobot_TMF8x01_LinuxI2C::sTransfer_t xfer[MAX_SENSORS];
+  char dev[] = "/tmp/fake-i2c-XXXXXX";
+  int fd, ret, errors = 0;
+  double split, combined, batched;
+  uint32_t ioctls;
+
+  if(n < 1) n = 1;
+  if(n > MAX_SENSORS - 1) n = MAX_SENSORS - 1;
+  //any file can be opened as the device, the hook does the transfers.
+  fd = mkstemp(dev);
+  if(fd < 0){
+      perror("mkstemp");
+      return 1;
+  }
+  close(fd);
+  memset(&bus, 0, sizeof(bus));
+  bus.ioctlUs = ioctlUs;
+  for(int i = 0; i < n; i++) bus.sensor[BASE_ADDR + i].present = true;
+
+  DFRobot_TMF8x01_LinuxI2C i2c(dev);
+  i2c.setIoctl(fakeIoctl, &bus);
+  ret = i2c.begin();
+  unlink(dev);
+  if(ret != 0){
+      printf("begin failed: %s\n", strerror(-ret));
+      return 1;
+  }
+
+  for(int i = 0; i < n; i++){
+      xfer[i].addr = BASE_ADDR + i;
+      xfer[i].reg = REG_STATUS;
+      xfer[i].read = true;
+      xfer[i].buf = out[i];
+      xfer[i].len = RESULT_SIZE;
+  }
+
+  bus.busUs = 0;
+  for(int p = 0; p < polls; p++){
+      fill(&bus, n, p);
+      for(int i = 0; i < n; i++){
+          uint8_t reg = REG_STATUS;
+          i2c.writeReg(BASE_ADDR + i, reg, NULL, 0);
+          struct i2c_msg m = {(uint16_t)(BASE_ADDR + i), I2C_M_RD, RESULT_SIZE, out[i]};
+          struct i2c_rdwr_ioctl_data d = {&m, 1};
+          fakeIoctl(&bus, -1, I2C_RDWR, &d);
+      }
+  }
+  split = bus.busUs;
+
+  bus.busUs = 0;
+  ioctls = i2c.getIoctlCount();
+  for(int p = 0; p < polls; p++){
+      fill(&bus, n, p);
+      for(int i = 0; i < n; i++){
+          if(i2c.readReg(BASE_ADDR + i, REG_STATUS, out[i], RESULT_SIZE) != RESULT_SIZE) errors++;
+          if(out[i][2] != (uint8_t)p) errors++;
+      }
+  }
+  combined = bus.busUs;
+  printf("combined: %u ioctls per poll\n", (unsigned)((i2c.getIoctlCount() - ioctls) / polls));
+
+  bus.busUs = 0;
+  ioctls = i2c.getIoctlCount();
+  for(int p = 0; p < polls; p++){
+      fill(&bus, n, p);
+      if(i2c.transfer(xfer, n) != n) errors++;
+      for(int i = 0; i < n; i++){
+          if(out[i][2] != (uint8_t)p) errors++;
+      }
+  }
+  batched = bus.busUs;
+  printf("batched:  %u ioctls per poll\n", (unsigned)((i2c.getIoctlCount() - ioctls) / polls));
+
+  printf("%d sensors, %d polls, %.0fus kernel overhead per ioctl, 400kHz\n", n, polls, ioctlUs);
+  printf("split:    %8.1f us per poll, %7.1f polls/s\n", split / polls, 1e6 * polls / split);
+  printf("combined: %8.1f us per poll, %7.1f polls/s\n", combined / polls, 1e6 * polls / combined);
+  printf("batched:  %8.1f us per poll, %7.1f polls/s, x%.2f of split\n", batched / polls, 1e6 * polls / batched, split / batched);
+
+  //a sensor drops off the bus: only its access fails, the data of the others is still read.
+  bus.sensor[BASE_ADDR + n / 2].present = false;
+  fill(&bus, n, 0xA5);
+  ret = i2c.transfer(xfer, n);
+  if(ret != n - 1) errors++;
+  if(xfer[n / 2].result != -ENXIO) errors++;
+  for(int i = 0; i < n; i++){
+      if((i != n / 2) && (out[i][2] != 0xA5)) errors++;
+  }
+  if(i2c.readReg(BASE_ADDR + n / 2, REG_STATUS, out[0], RESULT_SIZE) != -ENXIO) errors++;
+  printf("missing sensor: %d of %d accesses ok, result %d\n", ret, n, xfer[n / 2].result);
+
+  //the same with a write in front of every read, as the event loop clears INT_STATUS: the writes before the missing
+  //sensor were done by the failed ioctl and must not be sent again.
+  {
+      static DFRobot_TMF8x01_LinuxI2C::sTransfer_t mixed[MAX_SENSORS * 2];
+      uint8_t clear = 0x01;
+      int dup = 0, lost = 0;
+      for(int i = 0; i < n; i++){
+          mixed[i * 2].addr = BASE_ADDR + i;
+          mixed[i * 2].reg = 0xE1;
+          mixed[i * 2].read = false;
+          mixed[i * 2].buf = &clear;
+          mixed[i * 2].len = 1;
+          mixed[i * 2 + 1] = xfer[i];
+          bus.sensor[BASE_ADDR + i].writes = 0;
+      }
+      fill(&bus, n, 0x5A);
+      ret = i2c.transfer(mixed, n * 2);
+      for(int i = 0; i < n; i++){
+          uint32_t w = bus.sensor[BASE_ADDR + i].writes;
+          if(i == n / 2) continue;
+          if(w > 1) dup++;
+          if((w == 0) || (mixed[i * 2].result != 1) || (out[i][2] != 0x5A)) lost++;
+      }
+      if((ret != n * 2 - 2) || dup || lost) errors++;
+      printf("missing sensor, writes and reads: %d of %d accesses ok, %d writes sent twice, %d lost\n", ret, n * 2, dup, lost);
+  }
+  printf("%s\n", errors ? "FAIL" : "PASS");
+  return errors ? 1 : 0;
+}
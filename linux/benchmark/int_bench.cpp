@@ -0,0 +1,127 @@
+/*!
+ * @file int_bench.cpp
+ * @brief CPU time of waiting for a result: polling against sleeping on the INT file descriptor.
+ * @n A producer thread stands in for the sensor, it publishes a result every period and raises INT through the
+ * @n eventfd of DFRobot_TMF8x01_LinuxInt. The consumer gets every result either by spinning on the result(what a
+ * @n loop around isDataReady() does) or by wait()/consume(). The CPU time of the consumer thread and the latency from
+ * @n the result to the consumer are compared.
+ * @n If a GPIO chip is given, begin() on the line is checked too.
+ * @n usage: ./int_bench [results] [period us] [gpiochip] [line]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "DFRobot_TMF8x01_LinuxInt.h"
+
+typedef struct{
+  double cpuMs;
+  double wallMs;
+  double avgUs;
+  double maxUs;
+  int got;
+}sRun_t;
+
+static uint64_t clockNs(clockid_t id){
+  struct timespec ts;
+  clock_gettime(id, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void produce(std::atomic<uint32_t> *seq, std::vector<uint64_t> *stamp, DFRobot_TMF8x01_LinuxInt *irq, int results, int periodUs){
+  struct timespec ts;
+  ts.tv_sec = periodUs / 1000000;
+  ts.tv_nsec = (periodUs % 1000000) * 1000L;
+  for(int i = 0; i < results; i++){
+      nanosleep(&ts, NULL);
+      (*stamp)[i] = clockNs(CLOCK_MONOTONIC);
+      seq->store(i + 1, std::memory_order_release);
+      if(irq) irq->trigger();
+  }
+}
+
+static sRun_t run(bool useInt, int results, int periodUs){
+  std::atomic<uint32_t> seq(0);
+  std::vector<uint64_t> stamp(results);
+  DFRobot_TMF8x01_LinuxInt irq;
+  sRun_t r;
+  uint32_t last = 0;
+  double sum = 0;
+  uint64_t cpu0, wall0;
+
+  memset(&r, 0, sizeof(r));
+  if(useInt && (irq.beginEventfd() != 0)) return r;
+  cpu0 = clockNs(CLOCK_THREAD_CPUTIME_ID);
+  wall0 = clockNs(CLOCK_MONOTONIC);
+  std::thread t(produce, &seq, &stamp, useInt ? &irq : NULL, results, periodUs);
+  while(last < (uint32_t)results){
+      uint32_t s = seq.load(std::memory_order_acquire);
+      if(s == last){
+          if(useInt){
+              if(irq.wait(1000) > 0) irq.consume();
+          }
+          continue;
+      }
+      double us = (clockNs(CLOCK_MONOTONIC) - stamp[s - 1]) / 1000.0;
+      sum += us;
+      if(us > r.maxUs) r.maxUs = us;
+      r.got += s - last;
+      last = s;
+  }
+  r.cpuMs = (clockNs(CLOCK_THREAD_CPUTIME_ID) - cpu0) / 1e6;
+  r.wallMs = (clockNs(CLOCK_MONOTONIC) - wall0) / 1e6;
+  r.avgUs = sum / results;
+  t.join();
+  return r;
+}
+
+int main(int argc, char **argv){
+  int results = (argc > 1) ? atoi(argv[1]) : 200;
+  int periodUs = (argc > 2) ? atoi(argv[2]) : 10000;
+  int errors = 0;
+  sRun_t poll, wait;
+
+  if(results < 1) results = 1;
+  if(periodUs < 1) periodUs = 1;
+
+  poll = run(false, results, periodUs);
+  wait = run(true, results, periodUs);
+  if((poll.got != results) || (wait.got != results)) errors++;
+  printf("%d results, period %d us\n", results, periodUs);
+  printf("polling: cpu %8.1f ms of %8.1f ms(%5.1f%%), latency avg %6.1f us, max %7.1f us\n",
+         poll.cpuMs, poll.wallMs, 100 * poll.cpuMs / poll.wallMs, poll.avgUs, poll.maxUs);
+  printf("epoll:   cpu %8.1f ms of %8.1f ms(%5.1f%%), latency avg %6.1f us, max %7.1f us\n",
+         wait.cpuMs, wait.wallMs, 100 * wait.cpuMs / wait.wallMs, wait.avgUs, wait.maxUs);
+
+  {
+      //edges are counted, not lost, while nobody waits.
+      DFRobot_TMF8x01_LinuxInt irq;
+      if(irq.beginEventfd() != 0) errors++;
+      if(irq.wait(0) != 0) errors++;
+      for(int i = 0; i < 3; i++) irq.trigger();
+      if(irq.wait(0) != 1) errors++;
+      if(irq.consume() != 3) errors++;
+      if(irq.wait(0) != 0) errors++;
+      if(irq.read() != -EOPNOTSUPP) errors++;
+  }
+
+  if(argc > 3){
+      DFRobot_TMF8x01_LinuxInt irq(argv[3], (argc > 4) ? atoi(argv[4]) : 0);
+      int ret = irq.begin();
+      if(ret == 0) printf("%s line %d: source %d, level %d\n", argv[3], (argc > 4) ? atoi(argv[4]) : 0, irq.getSource(), irq.read());
+      else printf("%s: %s\n", argv[3], strerror(-ret));
+  }
+
+  printf("%s\n", errors ? "FAIL" : "PASS");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,233 @@
+/*!
+ * @file latency_bench.cpp
+ * @brief The latency histograms of DFRobot_TMF8x01_Latency against the known delays of a simulated system.
+ * @n 1. A TMF8801 with a sensor clock drift of 0, +5% and -3% runs on the simulated bus in virtual time. After each
+ * @n    INT edge the bench waits a random delay before onInt()(interrupt service), another before isDataReady()
+ * @n    (scheduling) and another before onDelivery()(queue to the consumer), each with a rare long tail.
+ * @n 2. The true latencies come from the 64 bit clock of the bus and the drift which was set. Capture to INT and
+ * @n    capture to delivery are taken above the same best case as the tracker takes: the fastest sample of the
+ * @n    segment of LATENCY_SEGMENT results before and of the one being filled. p50..p99.9 and max of every histogram
+ * @n    must be the true ones within the bucket width. The drift of the tracker must be the one set.
+ * @n 3. The cost of record() and onFetch(), and the RAM of a tracker.
+ * @n usage: ./latency_bench [results per drift]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_FakeBus.h"
+#include "DFRobot_TMF8x01_Latency.h"
+
+#define EN_PIN    4
+#define INT_PIN   5
+#define POLL_US   5                     //the INT line is polled in this step, the edge is known within it
+#define PERIOD_US 100000                //the measurement period of the driver
+//the clock mapping: poll step, the slope of the tracker from the best samples of two segments against the exact one.
+#define SLACK_US  40
+
+typedef DFRobot_TMF8x01_Latency Lat;
+
+static double cpuNs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint32_t rnd(uint64_t *state){
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return *state >> 33;
+}
+
+//base + exponential(mean), and with a chance of tailPerMille a long delay of tailMin..tailMax.
+static uint32_t delayUs(uint64_t *state, uint32_t base, uint32_t mean, uint32_t tailPerMille, uint32_t tailMin, uint32_t tailMax){
+  double u = (rnd(state) + 1.0) / 2147483649.0;
+  if((rnd(state) % 1000) < tailPerMille) return tailMin + rnd(state) % (tailMax - tailMin);
+  return base - mean * log(u);
+}
+
+//the best case of result n as DFRobot_TMF8x01_Latency::onFetch() takes it: the fastest of the last complete segment
+//and of the one being filled, or only of the segment which result n completes.
+static double bestCase(const std::vector<double> &residual, size_t n){
+  size_t seg = n / LATENCY_SEGMENT, first = seg * LATENCY_SEGMENT;
+  double best = residual[n];
+  if((n + 1) % LATENCY_SEGMENT == 0){
+      for(size_t i = first; i <= n; i++) best = std::min(best, residual[i]);
+      return best;
+  }
+  for(size_t i = first - LATENCY_SEGMENT; i <= n; i++) best = std::min(best, residual[i]);
+  return best;
+}
+
+static uint32_t truePercentile(std::vector<double> &v, float percent){
+  size_t rank = (size_t)((double)percent * v.size() / 100);
+  if((double)rank < (double)percent * v.size() / 100) rank++;
+  if(rank == 0) rank = 1;
+  std::nth_element(v.begin(), v.begin() + rank - 1, v.end());
+  return v[rank - 1] + 0.5;
+}
+
+//the histogram gives the upper end of the bucket: at most 1/8 above the true value.
+static int check(const char *name, Lat &lat, Lat::eLatencyStage_t stage, std::vector<double> &truth, double slackUs){
+  static const float pct[] = {50, 90, 99, 99.9, 100};
+  Lat::sLatencySummary_t s;
+  uint32_t got[5], want[5];
+  int bad = 0;
+  lat.getSummary(stage, &s);
+  got[0] = s.p50Us; got[1] = s.p90Us; got[2] = s.p99Us; got[3] = s.p999Us; got[4] = s.maxUs;
+  for(int i = 0; i < 5; i++){
+      want[i] = truePercentile(truth, pct[i]);
+      if((got[i] + slackUs < want[i]) || (got[i] > want[i] * (1.0 + 1.0 / (1 << LATENCY_SUB_BITS)) + slackUs)) bad++;
+  }
+  if(s.count != truth.size()) bad++;
+  printf("  %-18s %6u %7u %7u %7u %7u %7u  true p99 %7u p99.9 %7u max %7u  %s\n", name, (unsigned)s.count,
+         (unsigned)s.meanUs, (unsigned)s.p50Us, (unsigned)s.p90Us, (unsigned)s.p99Us, (unsigned)s.p999Us,
+         (unsigned)want[2], (unsigned)want[3], (unsigned)want[4], bad ? "FAIL" : "ok");
+  return bad;
+}
+
+static int runDrift(int32_t ppm, int results){
+  DFRobot_TMF8x01_FakeBus bus;
+  Lat lat;
+  DFRobot_TMF8x01::sSample_t s;
+  std::vector<double> capInt, intFetch, fetchDel, capDel;
+  std::vector<double> residual;           //INT minus capture of every result since the start, the best case not taken out
+  std::vector<int> index;                 //the result of a recorded sample
+  std::vector<uint64_t> intAt, deliverAt;
+  uint64_t seed = 0x1234 + ppm, edge = 0, lastEdge = 0, ticks = 0;
+  uint32_t lastSysclock = 0;
+  int errors = 0, warmup = LATENCY_SEGMENT * 2 + 8;
+  int32_t drift = 0;
+
+  printf("drift %+d ppm:\n", (int)ppm);
+  bus.addSensor(EN_PIN, INT_PIN, DFRobot_TMF8x01_FakeBus::eFakeTMF8801);
+  bus.setClockDrift(0, ppm);
+  bus.attach(true);
+  DFRobot_TMF8801 tof(bus, EN_PIN, INT_PIN);
+  if(tof.begin() != 0){
+      printf("  begin failed\n");
+      setArduinoHooks(NULL);
+      return 1;
+  }
+  tof.enableIntPin();
+  tof.setLatency(&lat);
+  tof.startMeasurement(DFRobot_TMF8x01::eModeNoCalib);
+
+  for(int n = 0; n < warmup + results; n++){
+      uint32_t intUs, deliverUs;
+      uint64_t intNow, deliverNow;
+      double capture;
+      //close to the next result, then poll the INT line.
+      if(lastEdge && (bus.now() + 2000 < lastEdge + PERIOD_US)) bus.advance(lastEdge + PERIOD_US - 2000 - bus.now());
+      while(digitalRead(INT_PIN) == HIGH) bus.advance(POLL_US);
+      edge = bus.now();
+      lastEdge = edge;
+      bus.advance(delayUs(&seed, 10, 20, 10, 2000, 8000));
+      intUs = micros();
+      intNow = bus.now();
+      lat.onInt(intUs);
+      bus.advance(delayUs(&seed, 0, 150, 5, 5000, 20000));
+      if(!tof.isDataReady()){
+          errors++;
+          continue;
+      }
+      tof.getDistance_mm();
+      tof.getLatestSample(&s);
+      bus.advance(delayUs(&seed, 0, 400, 2, 20000, 40000));
+      deliverUs = micros();
+      deliverNow = bus.now();
+      lat.onDelivery(s, deliverUs);
+      //the bus clock at the capture: the stamp(it wraps after 859 s) without the drift, from the first result on like
+      //the segments of the tracker. micros() wraps after 71 minutes, so the truth is on the 64 bit clock of the bus.
+      ticks += lastSysclock ? (uint32_t)(s.sysclock - lastSysclock) : 0;
+      lastSysclock = s.sysclock;
+      capture = ticks / 5.0 / (1.0 + ppm * 1e-6);
+      residual.push_back(intNow - capture);
+      if(n == warmup - 1){
+          //the mapping is settled: from here on every stage is recorded, and compared.
+          lat.reset();
+          if(lat.getHistogram(Lat::eCaptureToDelivery)->getCount() != 0) errors++;
+          continue;
+      }
+      if(n < warmup) continue;
+      if(!s.hasCapture) errors++;
+      index.push_back(residual.size() - 1);
+      intAt.push_back(intNow);
+      deliverAt.push_back(deliverNow);
+      intFetch.push_back((uint32_t)(s.fetchUs - intUs));
+      fetchDel.push_back((uint32_t)(deliverUs - s.fetchUs));
+  }
+  //stopMeasurement() makes the tracker forget the mapping.
+  if(!lat.getDriftPpm(&drift) || (abs(drift - ppm) > 50)) errors++;
+  tof.stopMeasurement();
+  tof.setLatency(NULL);
+  setArduinoHooks(NULL);
+  for(size_t i = 0; i < index.size(); i++){
+      double lat = residual[index[i]] - bestCase(residual, index[i]);
+      capInt.push_back(lat);
+      capDel.push_back(deliverAt[i] - intAt[i] + lat);
+  }
+
+  printf("  %-18s %6s %7s %7s %7s %7s %7s  (us)\n", "stage", "count", "mean", "p50", "p90", "p99", "p99.9");
+  errors += check("capture->INT", lat, Lat::eCaptureToInt, capInt, SLACK_US);
+  errors += check("INT->fetch", lat, Lat::eIntToFetch, intFetch, 1);
+  errors += check("fetch->delivery", lat, Lat::eFetchToDelivery, fetchDel, 1);
+  errors += check("capture->delivery", lat, Lat::eCaptureToDelivery, capDel, SLACK_US);
+  printf("  drift of the tracker %+d ppm, set %+d ppm\n", (int)drift, (int)ppm);
+  return errors;
+}
+
+int main(int argc, char **argv){
+  int results = (argc > 1) ? atoi(argv[1]) : 20000;
+  static const int32_t drift[] = {0, 50000, -30000};
+  int errors = 0;
+  double c0, ns;
+
+  if(results < 1000) results = 1000;
+  for(size_t i = 0; i < sizeof(drift) / sizeof(drift[0]); i++){
+      errors += runDrift(drift[i], results);
+  }
+
+  {
+      DFRobot_TMF8x01_LatencyHistogram h;
+      uint64_t seed = 99;
+      volatile uint32_t sink = 0;
+      const int n = 20000000;
+      c0 = cpuNs();
+      for(int i = 0; i < n; i++) h.record(rnd(&seed) >> (rnd(&seed) & 31));
+      ns = (cpuNs() - c0) / n;
+      printf("record            : %.1f ns(random values, the generator included)\n", ns);
+      c0 = cpuNs();
+      for(int i = 0; i < 100000; i++) sink += h.getPercentile(99.9);
+      printf("getPercentile     : %.1f ns\n", (cpuNs() - c0) / 100000);
+      (void)sink;
+  }
+  {
+      Lat lat;
+      uint32_t sysclock = 1, host = 0;
+      const int n = 10000000;
+      c0 = cpuNs();
+      for(int i = 0; i < n; i++){
+          host += 100000 + (i & 63);
+          sysclock += 500000;
+          lat.onInt(host - 50);
+          lat.onFetch(sysclock, host);
+      }
+      printf("onInt + onFetch   : %.1f ns per result\n", (cpuNs() - c0) / n);
+  }
+  printf("RAM               : %u bytes per histogram, %u bytes per tracker(%d buckets, values within 1/%d)\n",
+         (unsigned)sizeof(DFRobot_TMF8x01_LatencyHistogram), (unsigned)sizeof(DFRobot_TMF8x01_Latency), LATENCY_BUCKETS,
+         1 << LATENCY_SUB_BITS);
+
+  printf("%s\n", errors ? "FAIL" : "PASS");
+  return errors ? 1 : 0;
+}
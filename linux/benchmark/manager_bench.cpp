@@ -0,0 +1,425 @@
+/*!
+ * @file manager_bench.cpp
+ * @brief DFRobot_TMF8x01_Manager of the Arduino library on the simulated bus, every sensor with its own EN pin.
+ * @n 1. N = 1..MANAGER_MAX_SENSORS TMF8801: begin() must bring up all of them, each at baseAddr + n(0x42 + n) on the
+ * @n    bus, then startMeasurement() and isDataReady() polled. Every sensor must give its own distance.
+ * @n    Boot time and samples/s are in virtual time.
+ * @n 2. beginBroadcast() of 8 sensors: one RAM patch download on the bus for all of them, every sensor took every record
+ * @n    of it and is at 0x42..0x49, against begin() which downloads the patch once per sensor.
+ * @n 3. beginOverlapped() of 8 sensors against begin() and startMeasurement(): it must bring up and start all of them,
+ * @n    at 0x42..0x49, in less virtual time.
+ * @n 4. beginSchedule() and schedule() of 5 sensors in a row, each a neighbor of the next, and one sensor without
+ * @n    neighbors: two neighbors must never measure at the same time, the sensor without neighbors runs in every slot.
+ * @n 5. beginSync() of a leader driving the sync line by its VCSEL signal, a follower in phase and one in anti phase: the
+ * @n    in phase follower must start emitting on the rising edge of the leader and never emit without it, the anti phase
+ * @n    follower on the falling edge and never together with it. Every sensor keeps giving its distance.
+ * @n 6. beginSharedInt() of 4 sensors with their open drain INT wired together: with all of them asserting at once one
+ * @n    handleSharedInt() fetches all, maxFetch 1 fetches one per call in priority order, and polled every ms no result
+ * @n    is lost against the results the simulator made.
+ * @n 7. The limit: MANAGER_MAX_SENSORS sensors are taken, one more is refused(16, 8 on AVR).
+ * @n usage: ./manager_bench [seconds of measurement]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+#include <vector>
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_Manager.h"
+#include "DFRobot_TMF8x01_FakeBus.h"
+
+#define EN_PIN      10        //EN of sensor n is EN_PIN + n
+#define SEL_PIN     40        //PIN0 of sensor n is SEL_PIN + n
+#define INT_PIN     5         //shared by all sensors
+#define SYNC_PIN    60        //the sync line of beginSync()
+#define BASE_ADDR   0x42
+
+//N simulated sensors, the driver objects and a manager holding all of them.
+class Rig{
+public:
+  //syncPin: the PIN0 of all sensors is wired to this one line, no sensor has a selPin then.
+  Rig(uint8_t n, int syncPin = -1)
+    :mgr(BASE_ADDR){
+    for(uint8_t i = 0; i < n; i++){
+        bus.addSensor(EN_PIN + i, INT_PIN, DFRobot_TMF8x01_FakeBus::eFakeTMF8801, (syncPin < 0) ? SEL_PIN + i : syncPin);
+        bus.setDistance(i, distance(i));
+    }
+    bus.attach(true);
+    for(uint8_t i = 0; i < n; i++){
+        tof.emplace_back(bus, EN_PIN + i, INT_PIN);
+        mgr.addSensor(&tof[i], (syncPin < 0) ? SEL_PIN + i : -1);
+    }
+  }
+  ~Rig(){
+    setArduinoHooks(NULL);
+  }
+  static uint16_t distance(uint8_t i){ return 100 + 150 * i; }
+  uint32_t all(){ return (1UL << tof.size()) - 1; }
+
+  //every sensor is at BASE_ADDR + n on the bus and in the driver.
+  int checkAddresses(){
+    int bad = 0;
+    for(uint8_t i = 0; i < tof.size(); i++){
+        if(bus.getAddress(i) != BASE_ADDR + i) bad++;
+    }
+    return bad;
+  }
+
+  //poll isDataReady() of the manager for ms, count the samples of every sensor and the distances off by more than 2%.
+  //The clock correction of the driver spans 5 results, so the results read late while the other sensors were started
+  //spoil the distances of the first second, it is only counted with check false.
+  int measure(uint32_t ms, std::vector<uint32_t> &count, bool check = true){
+    int bad = 0;
+    uint64_t t0 = bus.now();
+    count.assign(tof.size(), 0);
+    while(bus.now() - t0 < (uint64_t)ms * 1000){
+        uint16_t ready = mgr.isDataReady();
+        if(!ready){
+            delay(1);
+            continue;
+        }
+        for(uint8_t i = 0; i < tof.size(); i++){
+            if(!(ready & (1 << i))) continue;
+            uint16_t mm = distance(i), tol = mm / 50 + 2;
+            uint16_t d = mgr.getDistance_mm(i);
+            if(check && ((d + tol < mm) || (d > mm + tol))) bad++;
+            count[i]++;
+        }
+    }
+    return bad;
+  }
+
+  DFRobot_TMF8x01_FakeBus bus;
+  DFRobot_TMF8x01_Manager mgr;
+  std::deque<DFRobot_TMF8801> tof;      //never moved, the manager holds pointers
+};
+
+static int checkBroadcast(uint8_t n){
+  uint32_t records, seqWrites, writes;
+  uint64_t seqUs, t0;
+  uint32_t ready;
+  int bad = 0;
+  {
+      Rig rig(n);
+      t0 = rig.bus.now();
+      if(rig.mgr.begin() != rig.all()) bad++;
+      seqUs = rig.bus.now() - t0;
+      seqWrites = rig.bus.getPatchWriteCount();
+      records = rig.bus.getPatchRecordCount(0);
+  }
+  Rig rig(n);
+  t0 = rig.bus.now();
+  ready = rig.mgr.beginBroadcast();
+  writes = rig.bus.getPatchWriteCount();
+  printf("beginBroadcast() of %u sensors: %.1f ms, %u patch record writes(begin() %.1f ms, %u writes)\n", n,
+         (rig.bus.now() - t0) / 1000.0, writes, seqUs / 1000.0, seqWrites);
+  //one download: every record went out once and reached every sensor.
+  if((records == 0) || (writes != records) || (seqWrites != n * records)) bad++;
+  for(uint8_t i = 0; i < n; i++){
+      bool ok = (ready & (1 << i)) && (rig.bus.getAddress(i) == BASE_ADDR + i) && (rig.bus.getPatchRecordCount(i) == records);
+      printf("  sensor %2u: 0x%02X, %u of %u records: %s\n", i, rig.bus.getAddress(i), rig.bus.getPatchRecordCount(i),
+             records, ok ? "ok" : "FAIL");
+      if(!ok) bad++;
+  }
+  if(rig.mgr.startMeasurement() != rig.all()) bad++;
+  std::vector<uint32_t> count;
+  rig.measure(1000, count, /*check =*/false);
+  bad += rig.measure(1000, count);
+  for(uint8_t i = 0; i < n; i++){
+      if(count[i] == 0) bad++;
+  }
+  rig.mgr.stopMeasurement();
+  return bad;
+}
+
+static int checkOverlapped(uint8_t n){
+  uint64_t seqUs, t0, us;
+  uint32_t ready;
+  int bad = 0;
+  {
+      Rig rig(n);
+      t0 = rig.bus.now();
+      if(rig.mgr.begin() != rig.all()) bad++;
+      if(rig.mgr.startMeasurement() != rig.all()) bad++;
+      seqUs = rig.bus.now() - t0;
+  }
+  Rig rig(n);
+  t0 = rig.bus.now();
+  ready = rig.mgr.beginOverlapped(/*startMeasure =*/true);
+  us = rig.bus.now() - t0;
+  printf("beginOverlapped() of %u sensors: %.1f ms, begin() and startMeasurement() %.1f ms: %s\n", n, us / 1000.0,
+         seqUs / 1000.0, (us < seqUs) ? "ok" : "FAIL");
+  if(us >= seqUs) bad++;
+  if((ready != rig.all()) || rig.checkAddresses()) bad++;
+  printf("   n  slotWait  power  patch  app  address  start  total\n");
+  for(uint8_t i = 0; i < n; i++){
+      DFRobot_TMF8x01_Manager::sBootReport_t r;
+      rig.mgr.getBootReport(i, &r);
+      printf("  %2u %9u %6u %6u %4u %8u %6u %6u\n", i, r.slotWait, r.power, r.patch, r.app, r.address, r.start, r.total);
+  }
+  std::vector<uint32_t> count;
+  rig.measure(1000, count, /*check =*/false);
+  bad += rig.measure(1000, count);
+  for(uint8_t i = 0; i < n; i++){
+      if(count[i] == 0) bad++;
+  }
+  rig.mgr.stopMeasurement();
+  return bad;
+}
+
+static int checkSchedule(){
+  const uint8_t n = 6, row = 5;
+  uint32_t overlap = 0, least = 0xFFFFFFFF;
+  std::vector<uint32_t> count(n, 0);
+  uint8_t slots;
+  uint64_t t0;
+  int bad = 0;
+  Rig rig(n);
+  if(rig.mgr.beginBroadcast() != rig.all()) return 1;
+  for(uint8_t i = 0; i < row; i++){
+      uint16_t mask = ((i > 0) ? (1 << (i - 1)) : 0) | ((i + 1 < row) ? (1 << (i + 1)) : 0);
+      rig.mgr.setNeighbors(i, mask);
+  }
+  slots = rig.mgr.beginSchedule(/*maxRate =*/0, /*slotTimeoutMs =*/200);
+  t0 = rig.bus.now();
+  while(rig.bus.now() - t0 < 3000000ULL){
+      uint16_t ready = rig.mgr.schedule();
+      for(uint8_t i = 0; i < n; i++){
+          if(ready & (1 << i)) count[i]++;
+          for(uint8_t j = i + 1; j < n; j++){
+              if((rig.mgr.getNeighbors(i) & (1 << j)) && rig.bus.isMeasuring(i) && rig.bus.isMeasuring(j)) overlap++;
+          }
+      }
+      delay(1);
+  }
+  rig.mgr.endSchedule();
+  for(uint8_t i = 0; i < row; i++){
+      if(count[i] < least) least = count[i];
+  }
+  printf("schedule() of %u sensors in a row and 1 alone, %u slots, 3 s: two neighbors measuring in %u steps of 1 ms\n", row, slots,
+         overlap);
+  for(uint8_t i = 0; i < n; i++){
+      printf("  sensor %u: neighbors 0x%02X, %4u samples, %5.1f/s\n", i, rig.mgr.getNeighbors(i), count[i],
+             rig.mgr.getScheduledRate(i));
+  }
+  //a row needs 2 slots, the sensor alone gets a sample in each of them.
+  if((slots != 2) || (overlap != 0) || (least == 0)) bad++;
+  if(count[row] < slots * least){
+      printf("  sensor %u runs in %.2f slots of %u: FAIL\n", row, (double)count[row] / least, slots);
+      bad++;
+  }
+  return bad;
+}
+
+static int checkSync(){
+  const uint8_t n = 3;
+  const uint32_t step = 100;                //sampling of the VCSEL, unit us
+  bool last[n] = {false, false, false};
+  uint64_t rise = 0, fall = 0, prev = 0, gap = 0;
+  uint32_t edges[n] = {0, 0, 0}, wrong[n] = {0, 0, 0};
+  uint64_t offset[n] = {0, 0, 0}, latest[n] = {0, 0, 0};
+  uint16_t inPhase, all;
+  std::vector<uint32_t> count(n, 0);
+  uint64_t t0;
+  int bad = 0;
+  Rig rig(n, SYNC_PIN);
+  if(rig.mgr.beginOverlapped(/*startMeasure =*/false) != rig.all()) return 1;
+  rig.mgr.setSyncMaster(0, DFRobot_TMF8x01::ePIN0);
+  inPhase = rig.mgr.beginSync(1 << 1, DFRobot_TMF8x01_Manager::eSyncInPhase);
+  all = rig.mgr.beginSync(1 << 2, DFRobot_TMF8x01_Manager::eSyncAntiPhase);
+  if((inPhase != 0x03) || (all != 0x07)) bad++;
+  //the results read late while the followers were started.
+  rig.measure(1000, count, /*check =*/false);
+  count.assign(n, 0);
+  t0 = rig.bus.now();
+  while(rig.bus.now() - t0 < 2000000ULL){
+      uint16_t ready;
+      for(uint32_t k = 0; k < 1000; k += step){
+          bool on[n];
+          //the reads of isDataReady() also take time on the bus, an edge is seen up to the longest gap late.
+          if(prev && (rig.bus.now() - prev > gap)) gap = rig.bus.now() - prev;
+          prev = rig.bus.now();
+          for(uint8_t i = 0; i < n; i++) on[i] = rig.bus.isEmitting(i);
+          if(on[0] && !last[0]) rise = rig.bus.now();
+          if(!on[0] && last[0]) fall = rig.bus.now();
+          for(uint8_t i = 1; i < n; i++){
+              uint64_t edge = (i == 1) ? rise : fall;
+              //the in phase follower emits only with the leader, the anti phase one only without it.
+              if(on[i] && (on[0] != (i == 1))) wrong[i]++;
+              if(!on[i] || last[i] || (edge == 0)) continue;
+              edges[i]++;
+              offset[i] += rig.bus.now() - edge;
+              if(rig.bus.now() - edge > latest[i]) latest[i] = rig.bus.now() - edge;
+          }
+          if(on[0] && !last[0]) edges[0]++;
+          memcpy(last, on, sizeof(last));
+          rig.bus.advance(step);
+      }
+      ready = rig.mgr.isDataReady();
+      for(uint8_t i = 0; i < n; i++){
+          if(!(ready & (1 << i))) continue;
+          uint16_t mm = Rig::distance(i), d = rig.mgr.getDistance_mm(i);
+          if((d + mm / 50 + 2 < mm) || (d > mm + mm / 50 + 2)) bad++;
+          count[i]++;
+      }
+  }
+  rig.mgr.endSync();
+  rig.mgr.stopMeasurement();
+  printf("beginSync() of a leader, a follower in phase and one in anti phase, 2 s:\n");
+  printf("  leader:      %2u VCSEL windows, %2u samples, edges sampled every %u us at most\n", edges[0], count[0], (unsigned)gap);
+  for(uint8_t i = 1; i < n; i++){
+      //a start is seen at most one sampling gap and one 50us step of the gated sensor after the edge.
+      bool ok = (edges[i] + 1 >= edges[0]) && (latest[i] <= gap + 50) && (wrong[i] == 0) && (count[i] + 1 >= count[0]);
+      printf("  %-12s %2u starts %.0f us(at most %u us) after the %s edge, %.1f ms emitting out of phase, %2u samples: %s\n",
+             (i == 1) ? "in phase:" : "anti phase:", edges[i], edges[i] ? (double)offset[i] / edges[i] : 0.0,
+             (unsigned)latest[i], (i == 1) ? "rising" : "falling", wrong[i] * step / 1000.0, count[i], ok ? "ok" : "FAIL");
+      if(!ok) bad++;
+  }
+  if(edges[0] == 0) bad++;
+  return bad;
+}
+
+//the shared INT line is held low long enough for every sensor to assert, the return of handleSharedInt() per call.
+static std::vector<uint16_t> burst(Rig &rig, uint8_t maxFetch){
+  std::vector<uint16_t> calls;
+  delay(150);
+  rig.mgr.notifyInt();
+  while((digitalRead(INT_PIN) == LOW) && (calls.size() < 16)) calls.push_back(rig.mgr.handleSharedInt(maxFetch));
+  return calls;
+}
+
+static int checkSharedInt(){
+  const uint8_t n = 4;
+  std::vector<uint32_t> got(n, 0), made(n, 0);
+  std::vector<uint16_t> calls;
+  uint32_t edges = 0, twice = 0;
+  uint64_t t0;
+  bool high = true;
+  int bad = 0;
+  Rig rig(n);
+  if((rig.mgr.beginBroadcast() != rig.all()) || (rig.mgr.startMeasurement() != rig.all())) return 1;
+  if(rig.mgr.beginSharedInt(INT_PIN, 0xFFFF, DFRobot_TMF8x01_Manager::eIntPriority) != rig.all()) return 1;
+  printf("handleSharedInt() of %u sensors on one INT line:\n", n);
+
+  //serve every falling edge of the line within 1 ms, the first second is the warm-up of the clock correction.
+  for(int pass = 0; pass < 2; pass++){
+      for(uint8_t i = 0; i < n; i++) made[i] = rig.bus.getResultCount(i);
+      got.assign(n, 0);
+      rig.mgr.resetIntLatency();
+      t0 = rig.bus.now();
+      while(rig.bus.now() - t0 < (pass ? 3000000ULL : 1000000ULL)){
+          bool low = (digitalRead(INT_PIN) == LOW);
+          uint16_t ready;
+          if(low && high){
+              rig.mgr.notifyInt();
+              edges++;
+          }
+          high = !low;
+          ready = rig.mgr.handleSharedInt();
+          uint8_t bits = 0;
+          for(uint8_t i = 0; i < n; i++){
+              if(!(ready & (1 << i))) continue;
+              uint16_t mm = Rig::distance(i), d = rig.mgr.getLastDistance_mm(i);
+              if(pass && ((d + mm / 50 + 2 < mm) || (d > mm + mm / 50 + 2))) bad++;
+              got[i]++;
+              bits++;
+          }
+          if(bits > 1) twice++;
+          delay(1);
+      }
+  }
+  for(uint8_t i = 0; i < n; i++){
+      DFRobot_TMF8x01_Manager::sIntLatency_t l;
+      made[i] = rig.bus.getResultCount(i) - made[i];
+      rig.mgr.getIntLatency(i, &l);
+      //the last result may still be on the line.
+      bool ok = (got[i] > 0) && (got[i] + 1 >= made[i]) && (got[i] <= made[i]) && (l.count == got[i]);
+      printf("  sensor %u: %2u of %2u results fetched, INT to sample %u/%u/%u us(min/avg/max): %s\n", i, got[i], made[i],
+             l.minUs, l.avgUs, l.maxUs, ok ? "ok" : "FAIL");
+      if(!ok) bad++;
+  }
+
+  //every sensor asserts before the line is served.
+  calls = burst(rig, 0);
+  printf("  all asserting, maxFetch 0: %u call(s), first 0x%X: %s\n", (unsigned)calls.size(), calls.size() ? calls[0] : 0,
+         (!calls.empty() && (calls[0] == rig.all())) ? "ok" : "FAIL");
+  if(calls.empty() || (calls[0] != rig.all())) bad++;
+  calls = burst(rig, 1);
+  {
+      bool ok = (calls.size() == n);
+      printf("  all asserting, maxFetch 1: %u calls,", (unsigned)calls.size());
+      for(size_t k = 0; k < calls.size(); k++){
+          printf(" 0x%X", calls[k]);
+          //one sensor per call, the lower index first.
+          if(calls[k] != (1 << k)) ok = false;
+      }
+      printf(": %s\n", ok ? "ok" : "FAIL");
+      if(!ok) bad++;
+  }
+  printf("  %u edges, %u calls served several sensors\n", edges, twice);
+  rig.mgr.stopMeasurement();
+  return bad;
+}
+
+static int checkLimit(){
+  DFRobot_TMF8x01_FakeBus bus;
+  DFRobot_TMF8x01_Manager mgr;
+  std::deque<DFRobot_TMF8801> tof;
+  int taken = 0;
+  for(int i = 0; i <= MANAGER_MAX_SENSORS; i++){
+      tof.emplace_back(bus, EN_PIN + i, INT_PIN);
+      if(mgr.addSensor(&tof[i])) taken++;
+  }
+  printf("MANAGER_MAX_SENSORS %d: %d of %d sensors taken, getSensorNum() %u: %s\n", MANAGER_MAX_SENSORS, taken,
+         MANAGER_MAX_SENSORS + 1, mgr.getSensorNum(), ((taken == MANAGER_MAX_SENSORS) && (mgr.getSensorNum() == taken)) ? "ok" : "FAIL");
+  return ((taken == MANAGER_MAX_SENSORS) && (mgr.getSensorNum() == taken)) ? 0 : 1;
+}
+
+int main(int argc, char **argv){
+  int seconds = (argc > 1) ? atoi(argv[1]) : 1;
+  int errors = 0;
+
+  if(seconds < 1) seconds = 1;
+  printf("begin() of N sensors, then %d s of isDataReady(), virtual time:\n", seconds);
+  printf("   N  boot ms  ms/sensor  addresses  samples/s  least/sensor  bad\n");
+  for(uint8_t n = 1; n <= MANAGER_MAX_SENSORS; n++){
+      Rig rig(n);
+      std::vector<uint32_t> count;
+      uint64_t t0 = rig.bus.now();
+      uint32_t ready = rig.mgr.begin();
+      double bootMs = (rig.bus.now() - t0) / 1000.0;
+      int addr = rig.checkAddresses();
+      int bad = 0;
+      uint32_t sum = 0, least = 0xFFFFFFFF;
+
+      if(ready != rig.all()) bad++;
+      if(rig.mgr.startMeasurement() != rig.all()) bad++;
+      rig.measure(1000, count, /*check =*/false);
+      bad += rig.measure(seconds * 1000, count);
+      for(uint8_t i = 0; i < n; i++){
+          sum += count[i];
+          if(count[i] < least) least = count[i];
+      }
+      //a sensor which never gives a sample is an error even if all the others do.
+      if(least == 0) bad++;
+      rig.mgr.stopMeasurement();
+      printf("  %2u %8.1f %10.1f %10s %10.1f %13.1f %4d\n", n, bootMs, bootMs / n, addr ? "FAIL" : "ok",
+             (double)sum / seconds, (double)least / seconds, bad);
+      errors += bad + addr;
+  }
+  errors += checkBroadcast((MANAGER_MAX_SENSORS < 8) ? MANAGER_MAX_SENSORS : 8);
+  errors += checkOverlapped((MANAGER_MAX_SENSORS < 8) ? MANAGER_MAX_SENSORS : 8);
+  errors += checkSchedule();
+  errors += checkSync();
+  errors += checkSharedInt();
+  errors += checkLimit();
+
+  printf("%s\n", errors ? "FAIL" : "PASS");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+/*!
+ * @file readout_bench.cpp
+ * @brief The histogram readout of the Arduino driver on the simulated bus: enableHistogramDump() and readHistogram().
+ * @n 1. A TMF8801 in virtual time at distances whose peak falls in the first, a middle and the last block. Every
+ * @n    frame must be the one the simulator makes(a base of 8, a peak of 160 at bin distance / 25, 3 bins on each
+ * @n    side falling by 40), in the buffer set, with one callback per frame.
+ * @n 2. A ring of two buffers switched in the callback, a frame of fewer blocks, and the calls which must fail: no
+ * @n    buffer, a buffer too small for the blocks.
+ * @n 3. Transfers, bus time at 400kHz and 1MHz and host CPU per frame.
+ * @n usage: ./readout_bench [frames]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_FakeBus.h"
+
+#define EN_PIN      4
+#define INT_PIN     5
+#define FRAME_SIZE  (HISTOGRAM_BLOCK_SIZE * HISTOGRAM_BLOCK_NUM)
+
+static uint8_t ring[2][FRAME_SIZE];
+static uint8_t *lastFrame;
+static uint16_t lastLen;
+static uint32_t frames;
+static bool useRing;
+
+static double cpuNs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static DFRobot_TMF8801 *sensor;
+
+static void onFrame(uint8_t *frame, uint16_t len){
+  lastFrame = frame;
+  lastLen = len;
+  frames++;
+  //the next frame goes to the other buffer while this one is used.
+  if(useRing) sensor->setHistogramBuffer(ring[frames & 1], FRAME_SIZE, onFrame);
+}
+
+//the frame of the simulator, see DFRobot_TMF8x01_FakeBus::command().
+static void expected(uint16_t mm, uint8_t *frame, uint8_t blocks){
+  int32_t peak = mm / 25;
+  for(int32_t bin = 0; bin < blocks * HISTOGRAM_BLOCK_SIZE; bin++){
+      int32_t d = bin - peak;
+      frame[bin] = 8 + (((d > -4) && (d < 4)) ? (4 - (d < 0 ? -d : d)) * 40 : 0);
+  }
+}
+
+static int checkFrame(const char *name, const uint8_t *buf, uint16_t mm, uint8_t blocks){
+  uint8_t want[FRAME_SIZE];
+  int bad = 0, first = -1;
+  expected(mm, want, blocks);
+  for(int i = 0; i < blocks * HISTOGRAM_BLOCK_SIZE; i++){
+      if(buf[i] == want[i]) continue;
+      if(first < 0) first = i;
+      bad++;
+  }
+  if((lastFrame != buf) || (lastLen != blocks * HISTOGRAM_BLOCK_SIZE)) bad++;
+  printf("  %-24s %4u mm, peak bin %3u: %s", name, mm, mm / 25, bad ? "FAIL" : "ok");
+  if(first >= 0) printf("(bin %d is %u, not %u)", first, buf[first], want[first]);
+  printf("\n");
+  return bad ? 1 : 0;
+}
+
+int main(int argc, char **argv){
+  int n = (argc > 1) ? atoi(argv[1]) : 1000;
+  static const uint16_t dist[] = {60, 16000, 31990};   //peak in block 0, across blocks 4 and 5, in block 9
+  static const uint32_t busHz[] = {400000, 1000000};
+  uint8_t small[FRAME_SIZE - 1];
+  int errors = 0;
+
+  if(n < 1) n = 1;
+  printf("readHistogram() against the simulator:\n");
+  {
+      DFRobot_TMF8x01_FakeBus bus;
+      bus.addSensor(EN_PIN, INT_PIN, DFRobot_TMF8x01_FakeBus::eFakeTMF8801);
+      bus.attach(true);
+      DFRobot_TMF8801 tof(bus, EN_PIN, INT_PIN);
+      sensor = &tof;
+      if(tof.begin() != 0){
+          printf("  begin failed\nFAIL\n");
+          setArduinoHooks(NULL);
+          return 1;
+      }
+      if(tof.readHistogram()){
+          printf("  readHistogram() without a buffer: FAIL\n");
+          errors++;
+      }
+      if(!tof.enableHistogramDump(DFRobot_TMF8x01::eHistogramDistance)){
+          printf("  enableHistogramDump: FAIL\n");
+          errors++;
+      }
+      tof.setHistogramBuffer(ring[0], FRAME_SIZE, onFrame);
+      for(size_t i = 0; i < sizeof(dist) / sizeof(dist[0]); i++){
+          char name[32];
+          bus.setDistance(0, dist[i]);
+          memset(ring[0], 0, FRAME_SIZE);
+          snprintf(name, sizeof(name), "frame of %d blocks", HISTOGRAM_BLOCK_NUM);
+          if(!tof.readHistogram()) errors++;
+          errors += checkFrame(name, ring[0], dist[i], HISTOGRAM_BLOCK_NUM);
+      }
+      bus.setDistance(0, dist[0]);
+      memset(ring[0], 0, FRAME_SIZE);
+      if(!tof.readHistogram(3)) errors++;
+      errors += checkFrame("frame of 3 blocks", ring[0], dist[0], 3);
+
+      useRing = true;
+      frames = 0;
+      memset(ring, 0, sizeof(ring));
+      for(int i = 0; i < 4; i++){
+          uint8_t *buf = ring[frames & 1];
+          bus.setDistance(0, dist[i % 3]);
+          if(!tof.readHistogram()) errors++;
+          errors += checkFrame("ring of 2 buffers", buf, dist[i % 3], HISTOGRAM_BLOCK_NUM);
+      }
+      useRing = false;
+
+      tof.setHistogramBuffer(small, sizeof(small), onFrame);
+      frames = 0;
+      if(tof.readHistogram() || (frames != 0)){
+          printf("  a buffer too small: FAIL\n");
+          errors++;
+      }
+      tof.setHistogramBuffer(NULL, 0);
+      setArduinoHooks(NULL);
+  }
+
+  printf("cost of a frame(%d blocks of %d bytes):\n", HISTOGRAM_BLOCK_NUM, HISTOGRAM_BLOCK_SIZE);
+  for(size_t i = 0; i < sizeof(busHz) / sizeof(busHz[0]); i++){
+      DFRobot_TMF8x01_FakeBus bus(busHz[i]);
+      uint64_t busUs;
+      uint32_t transfers;
+      double c0, ns;
+      bus.addSensor(EN_PIN, INT_PIN, DFRobot_TMF8x01_FakeBus::eFakeTMF8801);
+      bus.setDistance(0, 1500);
+      bus.attach(true);
+      DFRobot_TMF8801 tof(bus, EN_PIN, INT_PIN);
+      sensor = &tof;
+      if((tof.begin() != 0) || !tof.enableHistogramDump(DFRobot_TMF8x01::eHistogramDistance)){
+          printf("  %7u Hz: begin failed\n", (unsigned)busHz[i]);
+          errors++;
+          setArduinoHooks(NULL);
+          continue;
+      }
+      tof.setHistogramBuffer(ring[0], FRAME_SIZE, onFrame);
+      frames = 0;
+      busUs = bus.getBusTimeUs();
+      transfers = bus.getTransferCount();
+      c0 = cpuNs();
+      for(int k = 0; k < n; k++){
+          if(!tof.readHistogram()) errors++;
+      }
+      ns = (cpuNs() - c0) / n;
+      if(frames != (uint32_t)n) errors++;
+      errors += checkFrame("last frame", ring[0], 1500, HISTOGRAM_BLOCK_NUM);
+      printf("  %7u Hz: %.1f transfers, bus %.2f ms, %.0f frames/s at most, host cpu %.1f us\n", (unsigned)busHz[i],
+             (double)(bus.getTransferCount() - transfers) / n, (double)(bus.getBusTimeUs() - busUs) / n / 1000,
+             n * 1e6 / (bus.getBusTimeUs() - busUs), ns / 1000);
+      tof.setHistogramBuffer(NULL, 0);
+      setArduinoHooks(NULL);
+  }
+
+  printf("%s\n", errors ? "FAIL" : "PASS");
+  return errors ? 1 : 0;
+}
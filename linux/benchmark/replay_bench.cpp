@@ -0,0 +1,186 @@
+/*!
+ * @file replay_bench.cpp
+ * @brief Records the driver on the simulated bus, then replays the log to the driver, faster than real time.
+ * @n 1. A TMF8801 with a sensor clock drift of 0, +5% and -5% runs begin(), startMeasurement() and reads the results in
+ * @n    virtual time through DFRobot_TMF8x01_Recorder. The corrected distances must undo the drift.
+ * @n 2. The log is replayed by DFRobot_TMF8x01_ReplayBus to a new driver object: every sample(distance, raw distance,
+ * @n    host time, sensor time) must be the same as recorded and every record used, with no mismatch.
+ * @n 3. The replay is repeated and timed: the CPU time is the driver and the replay bus only, no simulator and no
+ * @n    waiting, next to the time the recording took on the bus.
+ * @n usage: ./replay_bench [results] [repeats] [log file]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_FakeBus.h"
+#include "DFRobot_TMF8x01_Recorder.h"
+
+#define EN_PIN    4
+#define INT_PIN   5
+#define DISTANCE  500
+//the correction takes the drift over 4 periods, after the first 5 results.
+#define WARMUP    5
+
+static double cpuNs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double nowNs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//the program recorded and replayed: the same calls in the same order.
+static int runDriver(DFRobot_TMF8x01_Bus &bus, int results, std::vector<DFRobot_TMF8x01::sSample_t> &out){
+  DFRobot_TMF8801 tof(bus, EN_PIN, INT_PIN);
+  DFRobot_TMF8x01::sSample_t s;
+  uint32_t t0;
+
+  out.clear();
+  if(tof.begin() != 0) return -1;
+  if(!tof.startMeasurement(DFRobot_TMF8x01::eModeNoCalib)) return -1;
+  t0 = millis();
+  while(((int)out.size() < results) && ((millis() - t0) < (uint32_t)results * 100)){
+      if(!tof.isDataReady()){
+          delay(1);
+          continue;
+      }
+      tof.getDistance_mm();
+      if(tof.getLatestSample(&s)) out.push_back(s);
+  }
+  tof.stopMeasurement();
+  return out.size();
+}
+
+static int checkCorrection(const std::vector<DFRobot_TMF8x01::sSample_t> &rec, int32_t ppm){
+  int errors = 0;
+  double worst = 0;
+  for(size_t i = WARMUP; i < rec.size(); i++){
+      double expect = rec[i].rawDistance / (1.0 + ppm * 1e-6);
+      double diff = rec[i].distance - expect;
+      if(diff < 0) diff = -diff;
+      if(diff > worst) worst = diff;
+      //millis() over 4 periods and the truncation of the driver.
+      if(diff > rec[i].rawDistance / 100.0 + 2) errors++;
+  }
+  printf("  correction: worst %.1f mm off raw/(1%+.2f%%), %d out of tolerance\n", worst, ppm / 1e4, errors);
+  return errors;
+}
+
+static int compare(const std::vector<DFRobot_TMF8x01::sSample_t> &a, const std::vector<DFRobot_TMF8x01::sSample_t> &b){
+  int errors = (a.size() == b.size()) ? 0 : 1;
+  for(size_t i = 0; (i < a.size()) && (i < b.size()); i++){
+      if((a[i].distance != b[i].distance) || (a[i].rawDistance != b[i].rawDistance) || (a[i].hostMs != b[i].hostMs) ||
+         (a[i].sysclock != b[i].sysclock) || (a[i].tid != b[i].tid)){
+          if(!errors) printf("  sample %u differs: %u mm at %u ms, recorded %u mm at %u ms\n", (unsigned)i,
+                             a[i].distance, (unsigned)a[i].hostMs, b[i].distance, (unsigned)b[i].hostMs);
+          errors++;
+      }
+  }
+  return errors;
+}
+
+static int runDrift(int32_t ppm, int results, int repeats, const char *path, bool dump){
+  std::vector<DFRobot_TMF8x01::sSample_t> rec, rep;
+  DFRobot_TMF8x01_ReplayBus replay;
+  int errors = 0, ret;
+  double c0, w0, simNs, cpu, wall;
+
+  printf("drift %+d ppm:\n", (int)ppm);
+  {
+      DFRobot_TMF8x01_FakeBus bus;
+      bus.addSensor(EN_PIN, INT_PIN, DFRobot_TMF8x01_FakeBus::eFakeTMF8801);
+      bus.setDistance(0, DISTANCE);
+      bus.setClockDrift(0, ppm);
+      bus.attach(true);
+      DFRobot_TMF8x01_Recorder recorder(bus);
+      if((ret = recorder.open(path)) != 0){
+          printf("  open %s failed: %d\n", path, ret);
+          return 1;
+      }
+      recorder.attach();
+      uint64_t t0 = bus.now();
+      c0 = cpuNs();
+      runDriver(recorder, results, rec);
+      simNs = cpuNs() - c0;
+      recorder.close();
+      printf("  recorded %u results in %.1f ms virtual time, %u records, %llu bytes(%.1f per result)\n",
+             (unsigned)rec.size(), (bus.now() - t0) / 1000.0, (unsigned)recorder.getRecordCount(),
+             (unsigned long long)recorder.getLogSize(), (double)recorder.getLogSize() / (rec.size() ? rec.size() : 1));
+  }
+  setArduinoHooks(NULL);
+  if((int)rec.size() < results) errors++;
+  errors += checkCorrection(rec, ppm);
+
+  if((ret = replay.load(path)) != 0){
+      printf("  load %s failed: %d\n", path, ret);
+      return errors + 1;
+  }
+  if(dump){
+      printf("  first records:\n");
+      replay.dump(stdout, 12);
+  }
+  replay.attach();
+  runDriver(replay, results, rep);
+  ret = compare(rep, rec);
+  printf("  replay: %u samples, %d differ, %u records used, %u mismatches, %s\n", (unsigned)rep.size(), ret,
+         (unsigned)replay.getPosition(), (unsigned)replay.getMismatchCount(), replay.isEnd() ? "whole log" : "log left");
+  errors += ret + replay.getMismatchCount() + (replay.isEnd() ? 0 : 1);
+
+  c0 = cpuNs();
+  w0 = nowNs();
+  for(int i = 0; i < repeats; i++){
+      replay.rewind();
+      runDriver(replay, results, rep);
+      if(replay.getMismatchCount()) errors++;
+  }
+  cpu = (cpuNs() - c0) / repeats;
+  wall = (nowNs() - w0) / repeats;
+  printf("  replay x%d: %.1f us cpu per run, %.2f us per result, %.0fx real time, simulator run %.1f us cpu\n",
+         repeats, cpu / 1000, cpu / 1000 / (rep.size() ? rep.size() : 1), replay.getDurationUs() * 1000.0 / wall,
+         simNs / 1000);
+  setArduinoHooks(NULL);
+  return errors;
+}
+
+int main(int argc, char **argv){
+  int results = (argc > 1) ? atoi(argv[1]) : 200;
+  int repeats = (argc > 2) ? atoi(argv[2]) : 100;
+  const char *path = (argc > 3) ? argv[3] : "/tmp/tmf8x01_replay.bin";
+  static const int32_t drift[] = {0, 50000, -50000};
+  int errors = 0;
+
+  if(results < WARMUP + 1) results = WARMUP + 1;
+  if(repeats < 1) repeats = 1;
+  for(size_t i = 0; i < sizeof(drift) / sizeof(drift[0]); i++){
+      errors += runDrift(drift[i], results, repeats, path, i == 0);
+  }
+
+  //a log which is not the program of the replay: the first different access stops it.
+  {
+      DFRobot_TMF8x01_ReplayBus replay;
+      uint8_t buf[11];
+      if(replay.load(path) == 0){
+          replay.attach();
+          replay.readReg(0x41, 0x1D, buf, sizeof(buf));
+          printf("foreign access: %u mismatch, stopped %s\n", (unsigned)replay.getMismatchCount(), replay.isEnd() ? "yes" : "no");
+          if((replay.getMismatchCount() != 1) || !replay.isEnd()) errors++;
+      }else errors++;
+      setArduinoHooks(NULL);
+  }
+
+  printf("%s\n", errors ? "FAIL" : "PASS");
+  return errors ? 1 : 0;
+}
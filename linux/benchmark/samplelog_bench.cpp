@@ -0,0 +1,272 @@
+/*!
+ * @file samplelog_bench.cpp
+ * @brief Writer throughput and time range queries of DFRobot_TMF8x01_SampleLog.
+ * @n 1. A 100Hz sensor is generated sample by sample(host time with jitter, sensor time, distance, reliability,
+ * @n    status) and appended to a new log, then the same stream as text lines to show what the text loggers cost.
+ * @n 2. The log is mapped by a reader: sample count and random samples must match the generator.
+ * @n 3. Random time ranges of 1 s to 1 day are queried(count, min, max, mean distance), with and without a
+ * @n    reliability filter, some of them checked against a scan of the generator. A scan of the text file gives the
+ * @n    cost of the same query without the log.
+ * @n 4. A log is reopened after samples were written behind the header(a crash before the header write), those
+ * @n    samples must be gone from the summary of the block too.
+ * @n usage: ./samplelog_bench [samples] [queries per range] [log file]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "DFRobot_TMF8x01_SampleLog.h"
+
+#define PERIOD_US     10000ULL          //100Hz
+#define BASE_US       1790000000000000ULL
+#define TEXT_SAMPLES  10000000ULL       //text lines written, enough for a rate
+#define CHECKED       20                //queries per range checked against the generator
+
+static double nowNs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static inline uint32_t mix(uint64_t x){
+  x ^= x >> 33;
+  x *= 0xFF51AFD7ED558CCDULL;
+  x ^= x >> 33;
+  x *= 0xC4CEB9FE1A85EC53ULL;
+  return x >> 32;
+}
+
+//sample i of the stream, the same every time it is asked for.
+static inline void gen(uint64_t i, sLogSample_t *s){
+  uint32_t h = mix(i);
+  s->hostUs = BASE_US + i * PERIOD_US + h % 2000;
+  s->sysclock = (uint32_t)(i * PERIOD_US * 5);
+  s->distance = 200 + ((i / 3000) * 37) % 1800 + (h >> 8) % 7;
+  s->reliability = 20 + (h >> 16) % 44;
+  s->status = ((h >> 24) & 0x3F) ? 0 : 1;
+}
+
+static uint64_t rnd(uint64_t *state){
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return *state >> 11;
+}
+
+static int bruteForce(uint64_t from, uint64_t to, uint8_t minRel, const sLogStats_t &st, uint64_t total){
+  sLogSample_t s;
+  uint64_t count = 0, sum = 0, first = total, end = total;
+  uint16_t dmin = 0xFFFF, dmax = 0;
+  //the generator keeps the samples of a range within one period of from/PERIOD_US.
+  uint64_t i = (from > BASE_US) ? (from - BASE_US) / PERIOD_US : 0;
+  if(i) i--;
+  for(; i < total; i++){
+      gen(i, &s);
+      if(s.hostUs < from) continue;
+      if(first == total) first = i;
+      if(s.hostUs >= to){
+          end = i;
+          break;
+      }
+      if(s.reliability < minRel) continue;
+      count++;
+      sum += s.distance;
+      if(s.distance < dmin) dmin = s.distance;
+      if(s.distance > dmax) dmax = s.distance;
+  }
+  if((count != st.count) || (first != st.firstIndex) || (end != st.endIndex)) return 1;
+  if(count && ((dmin != st.distMin) || (dmax != st.distMax) || ((double)sum / count != st.distMean))) return 1;
+  return 0;
+}
+
+//10 samples of 100mm flushed, 5 of 60000mm written but the header of the 10 put back, then 1 of 100mm after reopen.
+static int reopenCheck(const char *path){
+  DFRobot_TMF8x01_SampleLogWriter writer;
+  DFRobot_TMF8x01_SampleLogReader reader;
+  sLogHeader_t hdr;
+  sLogSample_t s;
+  sLogStats_t st;
+  int fd, bad = 0;
+  memset(&s, 0, sizeof(s));
+  s.reliability = 63;
+  unlink(path);
+  if(writer.begin(path, 64) != 0) return 1;
+  for(int i = 0; i < 16; i++){
+      s.hostUs = BASE_US + i * PERIOD_US;
+      s.distance = (i < 10) ? 100 : 60000;
+      s.status = (i < 10) ? 0 : 5;
+      if(i == 10){
+          writer.flush();
+          fd = open(path, O_RDONLY);
+          if((fd < 0) || (pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr))) bad++;
+          if(fd >= 0) close(fd);
+      }
+      if(i < 15) writer.append(s);
+  }
+  writer.end();
+  fd = open(path, O_WRONLY);
+  if((fd < 0) || (pwrite(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr))) bad++;
+  if(fd >= 0) close(fd);
+  s.hostUs = BASE_US + 15 * PERIOD_US;
+  s.distance = 100;
+  s.status = 0;
+  if((writer.begin(path) != 0) || (writer.append(s) != 0)) bad++;
+  writer.end();
+  if(reader.begin(path) != 0){
+      unlink(path);
+      return bad + 1;
+  }
+  reader.query(0, UINT64_MAX, &st);
+  if((st.count != 11) || (st.distMin != 100) || (st.distMax != 100) || (st.distMean != 100)) bad++;
+  if(reader.getBlock(0)->statusMask != 0x01) bad++;
+  printf("reopen    : %llu samples, min %u max %u mean %.1f after samples behind the header were dropped %s\n",
+         (unsigned long long)st.count, st.distMin, st.distMax, st.distMean, bad ? "FAIL" : "ok");
+  reader.end();
+  unlink(path);
+  return bad;
+}
+
+int main(int argc, char **argv){
+  uint64_t total = (argc > 1) ? strtoull(argv[1], NULL, 0) : 300000000ULL;
+  int queries = (argc > 2) ? atoi(argv[2]) : 10000;
+  const char *path = (argc > 3) ? argv[3] : "/tmp/tmf8x01_samples.log";
+  static const struct{ const char *name; uint64_t us; } range[] = {
+      {"1 s", 1000000ULL}, {"1 min", 60000000ULL}, {"1 h", 3600000000ULL}, {"1 day", 86400000000ULL},
+  };
+  char textPath[256];
+  DFRobot_TMF8x01_SampleLogWriter writer;
+  DFRobot_TMF8x01_SampleLogReader reader;
+  sLogSample_t s, r;
+  sLogStats_t st;
+  uint64_t seed = 12345, textN, firstUs, lastUs;
+  double t0, dt, logRate, textRate, textScanRate;
+  struct stat fst;
+  int errors = 0, ret;
+  FILE *fp;
+
+  if(total < 1000) total = 1000;
+  if(queries < CHECKED) queries = CHECKED;
+  snprintf(textPath, sizeof(textPath), "%s.csv", path);
+
+  //1. writing
+  unlink(path);
+  if((ret = writer.begin(path)) != 0){
+      printf("begin %s failed: %d\n", path, ret);
+      return 1;
+  }
+  t0 = nowNs();
+  for(uint64_t i = 0; i < total; i++){
+      gen(i, &s);
+      if(writer.append(s) != 0){
+          errors++;
+          break;
+      }
+  }
+  writer.end();
+  dt = (nowNs() - t0) / 1e9;
+  logRate = total / dt;
+  if(stat(path, &fst) != 0) fst.st_size = 0;
+  printf("log write : %llu samples in %.2f s, %.1f M samples/s, %.0f MB/s, %.2f bytes per sample\n",
+         (unsigned long long)total, dt, logRate / 1e6, fst.st_size / dt / 1e6, (double)fst.st_size / total);
+
+  textN = (total < TEXT_SAMPLES) ? total : TEXT_SAMPLES;
+  fp = fopen(textPath, "w");
+  if(!fp){
+      printf("open %s failed\n", textPath);
+      return 1;
+  }
+  t0 = nowNs();
+  for(uint64_t i = 0; i < textN; i++){
+      gen(i, &s);
+      fprintf(fp, "%llu,%u,%u,%u,%u\n", (unsigned long long)s.hostUs, (unsigned)s.sysclock, s.distance, s.reliability, s.status);
+  }
+  fclose(fp);
+  dt = (nowNs() - t0) / 1e9;
+  textRate = textN / dt;
+  if(stat(textPath, &fst) != 0) fst.st_size = 0;
+  printf("text write: %llu samples in %.2f s, %.1f M samples/s, %.2f bytes per sample, the log writes %.1fx faster\n",
+         (unsigned long long)textN, dt, textRate / 1e6, (double)fst.st_size / textN, logRate / textRate);
+
+  //2. reading
+  if((ret = reader.begin(path)) != 0){
+      printf("reader begin failed: %d\n", ret);
+      return 1;
+  }
+  if(reader.getSampleCount() != total) errors++;
+  for(int k = 0; k < 1000; k++){
+      uint64_t i = rnd(&seed) % total;
+      gen(i, &s);
+      if((reader.read(i, &r, 1) != 1) || (r.hostUs != s.hostUs) || (r.sysclock != s.sysclock) ||
+         (r.distance != s.distance) || (r.reliability != s.reliability) || (r.status != s.status)) errors++;
+  }
+  reader.getTimeRange(&firstUs, &lastUs);
+  printf("reader    : %llu samples in %llu blocks, %.1f days, random reads %s\n", (unsigned long long)reader.getSampleCount(),
+         (unsigned long long)reader.getBlockCount(), (lastUs - firstUs) / 86400e6, errors ? "FAIL" : "match");
+
+  //3. queries
+  for(size_t k = 0; k < sizeof(range) / sizeof(range[0]); k++){
+      for(int f = 0; f < 2; f++){
+          uint8_t minRel = f ? 40 : 0;
+          uint64_t summary = 0, scanned = 0, samples = 0;
+          int bad = 0;
+          if(range[k].us >= lastUs - firstUs) continue;
+          t0 = nowNs();
+          for(int q = 0; q < queries; q++){
+              uint64_t from = firstUs + rnd(&seed) % (lastUs - firstUs - range[k].us);
+              reader.query(from, from + range[k].us, &st, minRel);
+              summary += st.blocksSummary;
+              scanned += st.blocksScanned;
+              samples += st.endIndex - st.firstIndex;
+          }
+          dt = (nowNs() - t0) / queries;
+          //the same random starts again, a few checked by a scan.
+          for(int q = 0; q < CHECKED; q++){
+              uint64_t from = firstUs + rnd(&seed) % (lastUs - firstUs - range[k].us);
+              reader.query(from, from + range[k].us, &st, minRel);
+              bad += bruteForce(from, from + range[k].us, minRel, st, total);
+          }
+          errors += bad;
+          printf("query %-5s%s: %8.2f us, %9.0f samples, %6.1f blocks by summary, %.1f scanned, %d/%d checked wrong\n",
+                 range[k].name, f ? " rel>=40" : "        ", dt / 1000, (double)samples / queries, (double)summary / queries,
+                 (double)scanned / queries, bad, CHECKED);
+      }
+  }
+
+  //the same kind of query on the text file: every line up to the range is parsed.
+  fp = fopen(textPath, "r");
+  if(fp){
+      char line[96];
+      uint64_t n = 0, sum = 0;
+      t0 = nowNs();
+      while(fgets(line, sizeof(line), fp)){
+          char *p;
+          unsigned long long host = strtoull(line, &p, 10);
+          strtoul(p + 1, &p, 10);
+          sum += strtoul(p + 1, &p, 10);
+          n += (host != 0);
+      }
+      fclose(fp);
+      dt = (nowNs() - t0) / 1e9;
+      textScanRate = n / dt;
+      printf("text scan : %.1f M samples/s, a query in the middle of this log would parse %.0f s of text\n",
+             textScanRate / 1e6, total / 2 / textScanRate);
+      (void)sum;
+  }
+  reader.end();
+  unlink(textPath);
+
+  //4. reopen
+  snprintf(textPath, sizeof(textPath), "%s.reopen", path);
+  errors += reopenCheck(textPath);
+
+  printf("%s\n", errors ? "FAIL" : "PASS");
+  return errors ? 1 : 0;
+}
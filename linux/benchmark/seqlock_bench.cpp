@@ -0,0 +1,155 @@
+/*!
+ * @file seqlock_bench.cpp
+ * @brief One acquisition thread and many reader threads sharing a sensor.
+ * @n The owner runs the driver on a simulated TMF8801(DFRobot_TMF8x01_FakeBus in virtual time, every loop advances one
+ * @n period) as fast as it can. The readers call getLatestSample() in a loop and compare every sample with the copy the
+ * @n owner kept, a torn sample is a mismatch. The same is done with a mutex around a shared copy for comparison.
+ * @n usage: ./seqlock_bench [max readers] [ms per run]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_FakeBus.h"
+
+#define PERIOD_US     100000               //the period of startMeasurement
+#define HISTORY_SIZE  (1 << 20)            //ring of the samples kept by the owner
+
+typedef DFRobot_TMF8x01::sSample_t sSample_t;
+
+typedef struct{
+  DFRobot_TMF8x01_FakeBus *bus;
+  DFRobot_TMF8801 *tof;
+  bool useMutex;
+  bool stop;
+  std::mutex lock;
+  sSample_t shared;                        //the mutex variant
+  sSample_t *history;                      //history[count % HISTORY_SIZE], written by the owner
+  uint32_t *kept;                          //kept[i]: the count of history[i] after it is written
+  uint32_t samples;
+}sShared_t;
+
+typedef struct{
+  uint64_t reads;
+  uint64_t checked;
+  uint64_t torn;
+}sReader_t;
+
+static uint64_t clockNs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void owner(sShared_t *sh){
+  sSample_t s;
+  while(!__atomic_load_n(&sh->stop, __ATOMIC_RELAXED)){
+      sh->bus->advance(PERIOD_US);
+      if(!sh->tof->isDataReady()) continue;
+      //the owner's own read never waits, only it writes.
+      sh->tof->getLatestSample(&s);
+      if(sh->useMutex){
+          std::lock_guard<std::mutex> guard(sh->lock);
+          sh->shared = s;
+      }
+      __atomic_store_n(&sh->kept[s.count % HISTORY_SIZE], 0, __ATOMIC_RELAXED);
+      __atomic_thread_fence(__ATOMIC_RELEASE);
+      sh->history[s.count % HISTORY_SIZE] = s;
+      __atomic_store_n(&sh->kept[s.count % HISTORY_SIZE], s.count, __ATOMIC_RELEASE);
+      sh->samples++;
+  }
+}
+
+static void reader(sShared_t *sh, sReader_t *r){
+  sSample_t s;
+  while(!__atomic_load_n(&sh->stop, __ATOMIC_RELAXED)){
+      if(sh->useMutex){
+          std::lock_guard<std::mutex> guard(sh->lock);
+          s = sh->shared;
+      }else if(!sh->tof->getLatestSample(&s)){
+          continue;
+      }
+      r->reads++;
+      //the owner may not have kept it yet or already reused the slot, it is checked only when the slot holds it.
+      uint32_t i = s.count % HISTORY_SIZE;
+      if(__atomic_load_n(&sh->kept[i], __ATOMIC_ACQUIRE) != s.count) continue;
+      bool same = !memcmp(&s, &sh->history[i], sizeof(s));
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if(__atomic_load_n(&sh->kept[i], __ATOMIC_RELAXED) != s.count) continue;
+      r->checked++;
+      if(!same) r->torn++;
+  }
+}
+
+static int run(sShared_t *sh, int readers, int ms, bool useMutex){
+  std::vector<std::thread> t;
+  std::vector<sReader_t> r(readers);
+  uint32_t samples0 = sh->samples;
+  uint64_t reads = 0, checked = 0, torn = 0;
+  memset(r.data(), 0, sizeof(sReader_t) * readers);
+  sh->useMutex = useMutex;
+  sh->stop = false;
+  uint64_t t0 = clockNs();
+  std::thread w(owner, sh);
+  for(int i = 0; i < readers; i++) t.push_back(std::thread(reader, sh, &r[i]));
+  struct timespec d = {ms / 1000, (ms % 1000) * 1000000L};
+  nanosleep(&d, NULL);
+  __atomic_store_n(&sh->stop, true, __ATOMIC_RELAXED);
+  w.join();
+  for(int i = 0; i < readers; i++) t[i].join();
+  double s = (clockNs() - t0) / 1e9;
+  for(int i = 0; i < readers; i++){
+      reads += r[i].reads;
+      checked += r[i].checked;
+      torn += r[i].torn;
+  }
+  printf("%-7s %3d readers: owner %9.0f samples/s, readers %11.0f reads/s, %llu checked, %llu torn\n",
+         useMutex ? "mutex" : "seqlock", readers, (sh->samples - samples0) / s, reads / s,
+         (unsigned long long)checked, (unsigned long long)torn);
+  return torn ? 1 : 0;
+}
+
+int main(int argc, char **argv){
+  static sShared_t sh;
+  int maxReaders = (argc > 1) ? atoi(argv[1]) : 16;
+  int ms = (argc > 2) ? atoi(argv[2]) : 500;
+  int errors = 0;
+  DFRobot_TMF8x01_FakeBus bus;
+  bus.setDistance(bus.addSensor(), 500);
+  bus.attach(true);
+  DFRobot_TMF8801 tof(bus);
+  sSample_t s;
+
+  if(ms < 10) ms = 10;
+  if(tof.getLatestSample(&s) || tof.getSampleCount()) errors++;
+  if((tof.begin() != 0) || !tof.startMeasurement()){
+      printf("sensor init failed\n");
+      return 1;
+  }
+  if(!tof.getLatestSample(&s) || (s.count != tof.getSampleCount()) || (s.distance != tof.getDistance_mm())) errors++;
+  sh.bus = &bus;
+  sh.tof = &tof;
+  sh.history = new sSample_t[HISTORY_SIZE];
+  sh.kept = new uint32_t[HISTORY_SIZE];
+  memset(sh.kept, 0, sizeof(uint32_t) * HISTORY_SIZE);
+  printf("%u cpus\n", std::thread::hardware_concurrency());
+  for(int n = 0; n <= maxReaders; n = n ? n * 2 : 1){
+      errors += run(&sh, n, ms, false);
+      errors += run(&sh, n, ms, true);
+  }
+  delete[] sh.history;
+  delete[] sh.kept;
+  printf("%s\n", errors ? "FAIL" : "PASS");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,189 @@
+/*!
+ * @file shm_bench.cpp
+ * @brief Throughput and latency of the shared-memory sample ring with several reader processes.
+ * @n The readers are forked processes which tail the ring with DFRobot_TMF8x01_ShmReader, one of them is slow(it sleeps
+ * @n after every batch) and must be overrun. First a burst as fast as the publisher can go, then a paced stream.
+ * @n Every reader checks that read + overrun = published, that the indexes only go up and the samples are not torn.
+ * @n usage: ./shm_bench [readers] [burst samples] [paced rate Hz] [paced seconds]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <signal.h>
+#include <vector>
+#include <sys/wait.h>
+#include "DFRobot_TMF8x01_Shm.h"
+
+#define RING_NAME     "/tmf8x01-shm-bench"
+#define RING_SIZE     4096
+#define BATCH         64
+#define LAT_BUCKETS   10000                 //1us buckets, the last one is 10ms and more
+
+typedef struct{
+  uint64_t read;
+  uint64_t overrun;
+  uint64_t bad;
+  uint64_t p50Us;
+  uint64_t p99Us;
+  uint64_t maxUs;
+  double sumUs;
+}sReaderStats_t;
+
+static uint64_t clockNs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+//a sample carries itself twice, a torn copy does not match.
+static void fill(sShmSample_t *s, uint64_t n){
+  memset(s, 0, sizeof(*s));
+  s->sensor = n % 64;
+  s->distance = 100 + n % 900;
+  s->rawDistance = s->distance;
+  s->tid = n;
+  s->sysclock = (uint32_t)n * 2 + 1;
+  s->hostMs = (uint32_t)n;
+}
+
+static bool valid(const sShmSample_t *s){
+  uint64_t n = s->index;
+  return (s->sensor == n % 64) && (s->distance == 100 + n % 900) && (s->rawDistance == s->distance) &&
+         (s->tid == (uint8_t)n) && (s->sysclock == (uint32_t)n * 2 + 1) && (s->hostMs == (uint32_t)n);
+}
+
+static uint64_t percentile(const uint32_t *hist, uint64_t total, double p){
+  uint64_t want = total * p, sum = 0;
+  for(int i = 0; i < LAT_BUCKETS; i++){
+      sum += hist[i];
+      if(sum > want) return i;
+  }
+  return LAT_BUCKETS;
+}
+
+static void readerProcess(int ready, int out, bool slow){
+  static uint32_t hist[LAT_BUCKETS];
+  DFRobot_TMF8x01_ShmReader r;
+  sShmSample_t s[BATCH];
+  sReaderStats_t st;
+  struct timespec nap = {0, 2000000};
+  uint64_t last = 0;
+  bool first = true;
+  char c = 1;
+  memset(&st, 0, sizeof(st));
+  if(r.begin(RING_NAME, true) != 0) _exit(1);
+  if(write(ready, &c, 1) != 1) _exit(1);
+  while(1){
+      uint32_t n = r.read(s, BATCH);
+      if(n == 0){
+          if(r.isClosed() && (r.getLag() == 0)) break;
+          sched_yield();
+          continue;
+      }
+      uint64_t now = clockNs();
+      for(uint32_t i = 0; i < n; i++){
+          uint64_t us = (now - s[i].publishNs) / 1000;
+          if(!valid(&s[i]) || (!first && (s[i].index <= last))) st.bad++;
+          first = false;
+          last = s[i].index;
+          hist[(us < LAT_BUCKETS) ? us : (LAT_BUCKETS - 1)]++;
+          st.sumUs += us;
+          if(us > st.maxUs) st.maxUs = us;
+      }
+      if(slow) nanosleep(&nap, NULL);
+  }
+  st.read = r.getReadCount();
+  st.overrun = r.getOverrunCount();
+  st.p50Us = percentile(hist, st.read, 0.5);
+  st.p99Us = percentile(hist, st.read, 0.99);
+  if(write(out, &st, sizeof(st)) != sizeof(st)) _exit(1);
+  _exit(0);
+}
+
+static int phase(const char *title, int readers, uint64_t total, double rateHz){
+  DFRobot_TMF8x01_ShmPublisher pub;
+  sShmSample_t s;
+  int ready[2], out[2], errors = 0;
+  std::vector<pid_t> pid;
+  char c;
+
+  if(pub.begin(RING_NAME, RING_SIZE) != 0){
+      printf("shm_open failed\n");
+      return 1;
+  }
+  if((pipe(ready) < 0) || (pipe(out) < 0)) return 1;
+  for(int i = 0; i < readers; i++){
+      pid_t p = fork();
+      if(p == 0) readerProcess(ready[1], out[1], i == readers - 1);
+      pid.push_back(p);
+  }
+  for(int i = 0; i < readers; i++){
+      if(read(ready[0], &c, 1) != 1) errors++;
+  }
+
+  uint64_t t0 = clockNs();
+  uint64_t periodNs = (rateHz > 0) ? (uint64_t)(1e9 / rateHz) : 0;
+  for(uint64_t n = 0; n < total; n++){
+      if(periodNs){
+          uint64_t due = t0 + n * periodNs;
+          while(clockNs() < due){
+              struct timespec ts = {0, 50000};
+              nanosleep(&ts, NULL);
+          }
+      }
+      fill(&s, n);
+      pub.publish(s);
+  }
+  double sec = (clockNs() - t0) / 1e9;
+  pub.end();
+
+  printf("%s: %llu samples in %.3f s, %.0f samples/s, ring %u\n", title, (unsigned long long)total, sec, total / sec, RING_SIZE);
+  for(int i = 0; i < readers; i++){
+      sReaderStats_t st;
+      if(read(out[0], &st, sizeof(st)) != sizeof(st)){
+          errors++;
+          continue;
+      }
+      //the reports come in the order the readers finish, the slow one is the one with overruns or the last.
+      printf("  reader: %9llu read, %9llu overrun, %llu bad, latency avg %.1f us p50 %llu us p99 %llu us max %llu us\n",
+             (unsigned long long)st.read, (unsigned long long)st.overrun, (unsigned long long)st.bad,
+             st.read ? st.sumUs / st.read : 0, (unsigned long long)st.p50Us, (unsigned long long)st.p99Us,
+             (unsigned long long)st.maxUs);
+      if(st.read + st.overrun != total) errors++;
+      if(st.bad) errors++;
+  }
+  for(size_t i = 0; i < pid.size(); i++){
+      int status = 0;
+      waitpid(pid[i], &status, 0);
+      if(!WIFEXITED(status) || WEXITSTATUS(status)) errors++;
+  }
+  close(ready[0]);
+  close(ready[1]);
+  close(out[0]);
+  close(out[1]);
+  return errors;
+}
+
+int main(int argc, char **argv){
+  int readers = (argc > 1) ? atoi(argv[1]) : 4;
+  uint64_t burst = (argc > 2) ? strtoull(argv[2], NULL, 0) : 2000000;
+  double rate = (argc > 3) ? atof(argv[3]) : 10000;
+  double seconds = (argc > 4) ? atof(argv[4]) : 1;
+  int errors = 0;
+  if(readers < 2) readers = 2;
+  printf("%d readers(the last one sleeps 2ms after every batch), %ld cpus\n", readers, sysconf(_SC_NPROCESSORS_ONLN));
+  errors += phase("burst", readers, burst, 0);
+  errors += phase("paced", readers, (uint64_t)(rate * seconds), rate);
+  printf("%s\n", errors ? "FAIL" : "PASS");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,113 @@
+/*!
+ * @file Arduino.h
+ * @brief The part of the Arduino API used by the driver, so src/ builds on Linux unchanged.
+ * @n Time and GPIO go through hooks: by default millis()/delay() use CLOCK_MONOTONIC and the GPIO functions do nothing,
+ * @n a simulator installs its own hooks with setArduinoHooks() to run the driver in virtual time.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_LINUX_ARDUINO_H
+#define __DFROBOT_LINUX_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#ifndef ARDUINO
+#define ARDUINO 100
+#endif
+
+#define HIGH          1
+#define LOW           0
+#define INPUT         0
+#define OUTPUT        1
+#define INPUT_PULLUP  2
+#define CHANGE        1
+#define FALLING       2
+#define RISING        3
+#define HEX           16
+#define DEC           10
+#define PROGMEM
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+/**
+ * @struct sArduinoHooks_t
+ * @brief Replacements of time and GPIO functions, a NULL member keeps the default.
+ */
+typedef struct{
+    uint64_t (*micros)(void *ctx);                               /**< current time, unit us*/
+    void (*delayUs)(void *ctx, uint32_t us);                     /**< wait, a simulator advances its clock*/
+    void (*pinMode)(void *ctx, uint8_t pin, uint8_t mode);
+    void (*digitalWrite)(void *ctx, uint8_t pin, uint8_t val);
+    int (*digitalRead)(void *ctx, uint8_t pin);
+    void *ctx;                                                   /**< passed to every hook*/
+}sArduinoHooks_t;
+
+/**
+ * @fn setArduinoHooks
+ * @brief Install the hooks, NULL restores all defaults. The struct is copied.
+ */
+void setArduinoHooks(const sArduinoHooks_t *hooks);
+
+/**
+ * @fn getArduinoHooks
+ * @brief get the hooks in use, the defaults in place of the NULL members, so a wrapper such as a recorder can chain them.
+ */
+void getArduinoHooks(sArduinoHooks_t *hooks);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+inline void noInterrupts(){}
+inline void interrupts(){}
+
+inline uint8_t pgm_read_byte(const void *addr){ return *(const uint8_t *)addr; }
+inline void *memcpy_P(void *dest, const void *src, size_t n){ return memcpy(dest, src, n); }
+
+class String{
+public:
+  String(const char *str = ""):_s(str ? str : ""){}
+  explicit String(char c):_s(1, c){}
+  explicit String(int value):_s(std::to_string(value)){}
+  const char *c_str() const { return _s.c_str(); }
+  unsigned int length() const { return _s.size(); }
+  char operator[](unsigned int index) const { return (index < _s.size()) ? _s[index] : 0; }
+  String &operator+=(const String &str){ _s += str._s; return *this; }
+  String &operator+=(const char *str){ _s += str; return *this; }
+  String &operator+=(char c){ _s += c; return *this; }
+  bool operator==(const char *str) const { return _s == str; }
+  int indexOf(char c) const { size_t p = _s.find(c); return (p == std::string::npos) ? -1 : (int)p; }
+  String substring(unsigned int begin) const { return String(_s.substr(begin < _s.size() ? begin : _s.size()).c_str()); }
+  String substring(unsigned int begin, unsigned int end) const {
+    if(begin > _s.size()) begin = _s.size();
+    if(end < begin) end = begin;
+    return String(_s.substr(begin, end - begin).c_str());
+  }
+  void toUpperCase(){ for(size_t i = 0; i < _s.size(); i++) if((_s[i] >= 'a') && (_s[i] <= 'z')) _s[i] -= 'a' - 'A'; }
+  void trim(){
+    size_t b = _s.find_first_not_of(" \t\r\n");
+    size_t e = _s.find_last_not_of(" \t\r\n");
+    _s = (b == std::string::npos) ? std::string() : _s.substr(b, e - b + 1);
+  }
+  long toInt() const { return atol(_s.c_str()); }
+private:
+  std::string _s;
+};
+
+#include "HardwareSerial.h"
+
+#endif
@@ -0,0 +1,36 @@
+/*!
+ * @file HardwareSerial.h
+ * @brief Serial prints to stdout, enough for the DBG macro of the driver.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_LINUX_HARDWARESERIAL_H
+#define __DFROBOT_LINUX_HARDWARESERIAL_H
+
+#include "Arduino.h"
+
+class HardwareSerial{
+public:
+  void begin(unsigned long){}
+  operator bool(){ return true; }
+  void print(const String &str){ fputs(str.c_str(), stdout); }
+  void print(const char *str){ fputs(str, stdout); }
+  void print(char c){ putchar(c); }
+  void print(long value, int base = DEC){ printf(base == HEX ? "%lX" : "%ld", value); }
+  void print(unsigned long value, int base = DEC){ printf(base == HEX ? "%lX" : "%lu", value); }
+  void print(int value, int base = DEC){ print((long)value, base); }
+  void print(unsigned int value, int base = DEC){ print((unsigned long)value, base); }
+  void print(double value, int digits = 2){ printf("%.*f", digits, value); }
+  template <typename T> void println(T value){ print(value); putchar('\n'); }
+  template <typename T> void println(T value, int format){ print(value, format); putchar('\n'); }
+  void println(){ putchar('\n'); }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,12 @@
+/*!
+ * @file WProgram.h
+ * @brief Old name of Arduino.h, included by the driver when ARDUINO is not defined by the compiler.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include "Arduino.h"
@@ -0,0 +1,32 @@
+/*!
+ * @file Wire.h
+ * @brief TwoWire without a bus behind it, every transfer fails. On Linux the driver is constructed with a
+ * @n DFRobot_TMF8x01_Bus, such as DFRobot_TMF8x01_LinuxBus or DFRobot_TMF8x01_FakeBus.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_LINUX_WIRE_H
+#define __DFROBOT_LINUX_WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire{
+public:
+  void begin(){}
+  void beginTransmission(uint8_t){}
+  size_t write(uint8_t){ return 0; }
+  size_t write(const uint8_t *, size_t){ return 0; }
+  uint8_t endTransmission(bool = true){ return 2; }
+  uint8_t requestFrom(uint8_t, uint8_t){ return 0; }
+  int read(){ return -1; }
+  int available(){ return 0; }
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,106 @@
+/*!
+ * @file Arduino.cpp
+ * @brief Linux implementation of the Arduino functions in include/Arduino.h.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include "Arduino.h"
+#include "Wire.h"
+#include <time.h>
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+static sArduinoHooks_t hooks;
+
+void setArduinoHooks(const sArduinoHooks_t *h){
+  if(h) hooks = *h;
+  else memset(&hooks, 0, sizeof(hooks));
+}
+
+static uint64_t monotonicUs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static uint64_t defaultMicros(void *ctx){
+  (void)ctx;
+  return monotonicUs();
+}
+
+static void defaultDelayUs(void *ctx, uint32_t us){
+  (void)ctx;
+  struct timespec ts;
+  ts.tv_sec = us / 1000000;
+  ts.tv_nsec = (us % 1000000) * 1000L;
+  while(nanosleep(&ts, &ts) != 0);
+}
+
+static void defaultPinMode(void *ctx, uint8_t pin, uint8_t mode){
+  (void)ctx; (void)pin; (void)mode;
+}
+
+static void defaultDigitalWrite(void *ctx, uint8_t pin, uint8_t val){
+  (void)ctx; (void)pin; (void)val;
+}
+
+static int defaultDigitalRead(void *ctx, uint8_t pin){
+  (void)ctx; (void)pin;
+  return HIGH;
+}
+
+void getArduinoHooks(sArduinoHooks_t *h){
+  *h = hooks;
+  if(!h->micros) h->micros = defaultMicros;
+  if(!h->delayUs) h->delayUs = defaultDelayUs;
+  if(!h->pinMode) h->pinMode = defaultPinMode;
+  if(!h->digitalWrite) h->digitalWrite = defaultDigitalWrite;
+  if(!h->digitalRead) h->digitalRead = defaultDigitalRead;
+}
+
+unsigned long micros(){
+  //wraps like on a MCU, the driver only uses differences.
+  if(hooks.micros) return (uint32_t)hooks.micros(hooks.ctx);
+  return (uint32_t)monotonicUs();
+}
+
+unsigned long millis(){
+  if(hooks.micros) return (uint32_t)(hooks.micros(hooks.ctx) / 1000);
+  return (uint32_t)(monotonicUs() / 1000);
+}
+
+void delayMicroseconds(unsigned int us){
+  if(hooks.delayUs){
+      hooks.delayUs(hooks.ctx, us);
+      return;
+  }
+  defaultDelayUs(NULL, us);
+}
+
+void delay(unsigned long ms){
+  while(ms > 1000){
+      delayMicroseconds(1000000);
+      ms -= 1000;
+  }
+  delayMicroseconds(ms * 1000);
+}
+
+void pinMode(uint8_t pin, uint8_t mode){
+  if(hooks.pinMode) hooks.pinMode(hooks.ctx, pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val){
+  if(hooks.digitalWrite) hooks.digitalWrite(hooks.ctx, pin, val);
+}
+
+int digitalRead(uint8_t pin){
+  //an unconnected INT line idles high.
+  if(hooks.digitalRead) return hooks.digitalRead(hooks.ctx, pin);
+  return HIGH;
+}
@@ -0,0 +1,296 @@
+/*!
+ * @file DFRobot_TMF8x01_Coro.cpp
+ * @brief C++20 coroutine API of the driver for Linux.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include "DFRobot_TMF8x01_Coro.h"
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <functional>
+#include <sys/epoll.h>
+
+#define REG_MTF8x01_ENABLE          0xE0
+#define REG_MTF8x01_COMMAND         0x10
+#define REG_MTF8x01_RESULT_NUMBER   0x20
+#define CORO_WAIT_INC_MS            5
+#define CORO_PATCH_YIELD            16      //patch records between two yields
+#define CORO_MAX_EVENTS             64
+
+namespace{
+/*
+ * The frame of a spawned task: it starts the task, counts it down when it returns and frees itself.
+ */
+struct sDetached_t{
+  struct promise_type{
+      sDetached_t get_return_object(){ return sDetached_t{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      std::suspend_never final_suspend() noexcept { return {}; }
+      void return_void(){}
+      void unhandled_exception(){ std::terminate(); }
+  };
+  std::coroutine_handle<promise_type> h;
+};
+
+sDetached_t runDetached(DFRobot_TMF8x01_VoidTask task, uint32_t *tasks){
+  co_await task;
+  (*tasks)--;
+}
+}
+
+void DFRobot_TMF8x01_CoExecutor::spawn(DFRobot_TMF8x01_VoidTask task){
+  sDetached_t d = runDetached(std::move(task), &_tasks);
+  _tasks++;
+  post(d.h);
+}
+
+DFRobot_TMF8x01_EpollExecutor::DFRobot_TMF8x01_EpollExecutor()
+  :_epfd(epoll_create1(EPOLL_CLOEXEC)),_stop(false),_nextId(1),_resumes(0){
+}
+
+DFRobot_TMF8x01_EpollExecutor::~DFRobot_TMF8x01_EpollExecutor(){
+  if(_epfd >= 0) close(_epfd);
+}
+
+uint64_t DFRobot_TMF8x01_EpollExecutor::nowUs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+void DFRobot_TMF8x01_EpollExecutor::post(std::coroutine_handle<> h){
+  _ready.push_back(h);
+}
+
+void DFRobot_TMF8x01_EpollExecutor::resumeAt(uint64_t us, std::coroutine_handle<> h){
+  uint64_t id = _nextId++;
+  sWaiter_t w = {h, -1, NULL};
+  _waiters[id] = w;
+  _timers.push_back(std::make_pair(us, id));
+  std::push_heap(_timers.begin(), _timers.end(), std::greater<std::pair<uint64_t, uint64_t> >());
+}
+
+void DFRobot_TMF8x01_EpollExecutor::resumeOnFd(int fd, uint64_t deadlineUs, std::coroutine_handle<> h, bool *ready){
+  struct epoll_event ev;
+  uint64_t id = _nextId++;
+  sWaiter_t w = {h, fd, ready};
+  int op = _fdAdded[fd] ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+  int ret;
+  memset(&ev, 0, sizeof(ev));
+  //one shot, the fd is disarmed once it wakes its waiter.
+  ev.events = EPOLLIN | EPOLLONESHOT;
+  ev.data.fd = fd;
+  ret = epoll_ctl(_epfd, op, fd, &ev);
+  //a closed fd left the set by itself, the number may be back as a new fd.
+  if((ret < 0) && (op == EPOLL_CTL_MOD) && (errno == ENOENT)) ret = epoll_ctl(_epfd, EPOLL_CTL_ADD, fd, &ev);
+  if(ret < 0){
+      //not pollable, only the deadline wakes it.
+      w.fd = -1;
+      _fdAdded.erase(fd);
+  }else{
+      _fdAdded[fd] = true;
+      _fdWaiter[fd] = id;
+  }
+  _waiters[id] = w;
+  _timers.push_back(std::make_pair(deadlineUs, id));
+  std::push_heap(_timers.begin(), _timers.end(), std::greater<std::pair<uint64_t, uint64_t> >());
+}
+
+void DFRobot_TMF8x01_EpollExecutor::wake(uint64_t id, bool ready){
+  std::map<uint64_t, sWaiter_t>::iterator it = _waiters.find(id);
+  //the other one of fd and deadline came first.
+  if(it == _waiters.end()) return;
+  sWaiter_t w = it->second;
+  _waiters.erase(it);
+  if(w.fd >= 0){
+      _fdWaiter.erase(w.fd);
+      if(!ready){
+          struct epoll_event ev;
+          memset(&ev, 0, sizeof(ev));
+          ev.data.fd = w.fd;
+          epoll_ctl(_epfd, EPOLL_CTL_MOD, w.fd, &ev);
+      }
+  }
+  if(w.ready) *w.ready = ready;
+  _ready.push_back(w.h);
+}
+
+int DFRobot_TMF8x01_EpollExecutor::runOnce(int timeoutMs){
+  struct epoll_event ev[CORO_MAX_EVENTS];
+  std::deque<std::coroutine_handle<> > ready;
+  int resumed = 0, wait = timeoutMs, n;
+  uint64_t now = nowUs();
+
+  while(!_timers.empty() && (_timers.front().first <= now)){
+      uint64_t id = _timers.front().second;
+      std::pop_heap(_timers.begin(), _timers.end(), std::greater<std::pair<uint64_t, uint64_t> >());
+      _timers.pop_back();
+      wake(id, false);
+  }
+  //the coroutines made ready by these run in the next turn, so fds and timers are not starved.
+  ready.swap(_ready);
+  while(!ready.empty()){
+      std::coroutine_handle<> h = ready.front();
+      ready.pop_front();
+      h.resume();
+      resumed++;
+  }
+  _resumes += resumed;
+
+  if(!_ready.empty()){
+      wait = 0;
+  }else if(!_timers.empty()){
+      now = nowUs();
+      uint64_t t = (_timers.front().first > now) ? (_timers.front().first - now + 999) / 1000 : 0;
+      if((wait < 0) || (t < (uint64_t)wait)) wait = t;
+  }
+  n = epoll_wait(_epfd, ev, CORO_MAX_EVENTS, wait);
+  for(int i = 0; i < n; i++){
+      std::map<int, uint64_t>::iterator it = _fdWaiter.find(ev[i].data.fd);
+      if(it != _fdWaiter.end()) wake(it->second, true);
+  }
+  return resumed;
+}
+
+void DFRobot_TMF8x01_EpollExecutor::run(){
+  _stop = false;
+  while(!_stop && (_tasks > 0)){
+      runOnce(1000);
+  }
+}
+
+void DFRobot_TMF8x01_EpollExecutor::stop(){
+  _stop = true;
+}
+
+uint64_t DFRobot_TMF8x01_EpollExecutor::getResumeCount(){
+  return _resumes;
+}
+
+DFRobot_TMF8x01_Coro::DFRobot_TMF8x01_Coro(DFRobot_TMF8x01 &tof, DFRobot_TMF8x01_CoExecutor &ex, DFRobot_TMF8x01_LinuxInt *irq)
+  :_tof(&tof),_ex(&ex),_irq(irq),_lastUs(0){
+}
+
+DFRobot_TMF8x01_Task<bool> DFRobot_TMF8x01_Coro::waitCpuReady(){
+  for(uint8_t t = 0; t < 100; t += CORO_WAIT_INC_MS){
+      co_await _ex->sleepMs(CORO_WAIT_INC_MS);
+      if(_tof->getCPUState() == 0x41) co_return true;
+  }
+  co_return false;
+}
+
+DFRobot_TMF8x01_Task<bool> DFRobot_TMF8x01_Coro::waitContents(uint8_t contents, uint32_t timeoutMs){
+  for(uint32_t t = 0; t < timeoutMs; t += CORO_WAIT_INC_MS){
+      co_await _ex->sleepMs(CORO_WAIT_INC_MS);
+      if(_tof->getRegContents() == contents) co_return true;
+  }
+  co_return false;
+}
+
+DFRobot_TMF8x01_Task<int> DFRobot_TMF8x01_Coro::begin(){
+  DFRobot_TMF8x01 *s = _tof;
+  s->_initialize = false;
+  //gpioInit() of the driver, the EN delays are timers.
+  if(s->_en > -1){
+      s->_addr = TMF8x01_I2C_ADDR;
+      pinMode(s->_en, OUTPUT);
+      digitalWrite(s->_en, LOW);
+      co_await _ex->sleepMs(1000);
+      digitalWrite(s->_en, HIGH);
+      co_await _ex->sleepMs(1000);
+  }
+  if(!s->startCpu()) co_return -1;
+  if(!co_await waitCpuReady()) co_return -1;
+  if(s->getAppId() == 0x80){
+      const uint8_t *record = s->getRamPatch();
+      int8_t ret;
+      uint16_t n = 0;
+      if(!s->startPatch(/*ack =*/true)) co_return -1;
+      //the download is bus work only, the yields let the other sensors go on meanwhile.
+      while((ret = s->writePatchRecord(&record, /*ack =*/true)) > 0){
+          if((++n % CORO_PATCH_YIELD) == 0) co_await _ex->yield();
+      }
+      if(ret < 0) co_return -1;
+      if(!s->finishPatch(/*ack =*/true)) co_return -1;
+      if(!co_await waitCpuReady()) co_return -1;
+      if(s->getAppId() != 0xC0) co_return -1;
+  }
+  s->_initialize = true;
+  co_return 0;
+}
+
+DFRobot_TMF8x01_Task<bool> DFRobot_TMF8x01_Coro::startMeasurement(DFRobot_TMF8x01::eCalibModeConfig_t cailbMode){
+  DFRobot_TMF8x01 *s = _tof;
+  if((!s->_initialize) || s->_measureCmdFlag) co_return false;
+  s->_count = 0;
+  _lastUs = 0;
+  s->writeMeasureCmd(cailbMode);
+  co_await _ex->sleepMs(600);
+  if(!co_await waitContents(0x55, 1000)) co_return false;
+  //the same 4 warm-up results as setCaibrationMode, they feed the clock correction.
+  while(s->_count < 4){
+      sCoSample_t sample = co_await nextSample(1000);
+      if(!sample.valid) co_return false;
+  }
+  s->_measureCmdFlag = true;
+  co_return true;
+}
+
+DFRobot_TMF8x01_Task<DFRobot_TMF8x01_Coro::sCoSample_t> DFRobot_TMF8x01_Coro::nextSample(uint32_t timeoutMs){
+  DFRobot_TMF8x01 *s = _tof;
+  sCoSample_t sample;
+  uint64_t now = _ex->nowUs();
+  uint64_t deadline = now + (uint64_t)timeoutMs * 1000;
+  memset(&sample, 0, sizeof(sample));
+  while(1){
+      if(s->isDataReady()){
+          sample.valid = true;
+          sample.tid = s->_result.tid;
+          sample.distance = s->getDistance_mm();
+          sample.hostUs = _lastUs = _ex->nowUs();
+          co_return sample;
+      }
+      now = _ex->nowUs();
+      if(now >= deadline) co_return sample;
+      if(_irq && (_irq->getFd() >= 0)){
+          if(co_await _ex->waitFd(_irq->getFd(), (deadline - now + 999) / 1000)) _irq->consume();
+          continue;
+      }
+      //without INT the next result is due one period after the last one, then it is checked every ms.
+      uint64_t due = _lastUs + (uint64_t)s->_measureCmdSet[CMDSET_INDEX_PERIOD] * 1000;
+      uint64_t at = (_lastUs && (due > now)) ? due : now + 1000;
+      if(at > deadline) at = deadline;
+      co_await _ex->sleepUntil(at);
+  }
+}
+
+DFRobot_TMF8x01_Task<bool> DFRobot_TMF8x01_Coro::calibrate(uint8_t *data){
+  DFRobot_TMF8x01 *s = _tof;
+  uint8_t cmd = 0x0A;
+  if((!s->_initialize) || (data == NULL)) co_return false;
+  if(s->getAppId() != 0xC0) co_return false;
+  s->writeReg(REG_MTF8x01_COMMAND, &cmd, 1);
+  if(!co_await waitContents(0x0A, 1000)) co_return false;
+  s->readReg(REG_MTF8x01_RESULT_NUMBER, data, SENSOR_MTF8x01_CALIBRATION_SIZE);
+  cmd = 0xFF;
+  s->writeReg(REG_MTF8x01_COMMAND, &cmd, 1);
+  co_await _ex->sleepMs(50);
+  co_return true;
+}
+
+DFRobot_TMF8x01_Task<bool> DFRobot_TMF8x01_Coro::stopMeasurement(){
+  DFRobot_TMF8x01 *s = _tof;
+  uint8_t cmd = 0xFF;
+  s->writeReg(REG_MTF8x01_COMMAND, &cmd, 1);
+  co_await _ex->sleepMs(50);
+  s->resetMeasurement();
+  co_return true;
+}
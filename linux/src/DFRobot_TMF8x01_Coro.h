@@ -0,0 +1,333 @@
+/*!
+ * @file DFRobot_TMF8x01_Coro.h
+ * @brief C++20 coroutine API of the driver for Linux: co_await sensor.begin(), co_await sensor.nextSample(),
+ * @n co_await sensor.calibrate(). The coroutines do the same register accesses as the blocking driver, but every wait
+ * @n of it(EN delays, cpu ready, the 600ms of the first result, the next result) suspends the coroutine instead of
+ * @n calling delay() or polling. The executor resumes it on a timer or on the INT fd of the sensor, so one thread runs
+ * @n thousands of sensors.
+ * @n The executor is an interface, DFRobot_TMF8x01_EpollExecutor is the default: a timer heap and one epoll set.
+ * @n Build with -std=gnu++20.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_CORO_H
+#define __DFROBOT_TMF8X01_CORO_H
+
+#include <stdint.h>
+#include <exception>
+#include <coroutine>
+#include <utility>
+#include <vector>
+#include <deque>
+#include <map>
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_LinuxInt.h"
+
+/**
+ * @brief A lazily started coroutine returning T, it runs when it is awaited and resumes the awaiting coroutine when
+ * @n it returns. The driver does not use exceptions, an exception ends the program.
+ */
+template<class T>
+class DFRobot_TMF8x01_Task{
+public:
+  struct promise_type{
+      T value{};
+      std::coroutine_handle<> continuation;
+      DFRobot_TMF8x01_Task get_return_object(){
+        return DFRobot_TMF8x01_Task(std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      struct FinalAwaiter{
+          bool await_ready() noexcept { return false; }
+          std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+            if(h.promise().continuation) return h.promise().continuation;
+            return std::noop_coroutine();
+          }
+          void await_resume() noexcept {}
+      };
+      FinalAwaiter final_suspend() noexcept { return {}; }
+      void return_value(T v){ value = std::move(v); }
+      void unhandled_exception(){ std::terminate(); }
+  };
+
+  DFRobot_TMF8x01_Task(DFRobot_TMF8x01_Task &&other) noexcept :_h(other._h){ other._h = nullptr; }
+  DFRobot_TMF8x01_Task(const DFRobot_TMF8x01_Task &) = delete;
+  ~DFRobot_TMF8x01_Task(){ if(_h) _h.destroy(); }
+
+  bool await_ready() noexcept { return false; }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+    _h.promise().continuation = awaiting;
+    return _h;
+  }
+  T await_resume(){ return std::move(_h.promise().value); }
+
+private:
+  explicit DFRobot_TMF8x01_Task(std::coroutine_handle<promise_type> h):_h(h){}
+  std::coroutine_handle<promise_type> _h;
+};
+
+/**
+ * @brief The coroutine type of tasks without a result, such as the task of one sensor given to spawn().
+ */
+class DFRobot_TMF8x01_VoidTask{
+public:
+  struct promise_type{
+      std::coroutine_handle<> continuation;
+      DFRobot_TMF8x01_VoidTask get_return_object(){
+        return DFRobot_TMF8x01_VoidTask(std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      struct FinalAwaiter{
+          bool await_ready() noexcept { return false; }
+          std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+            if(h.promise().continuation) return h.promise().continuation;
+            return std::noop_coroutine();
+          }
+          void await_resume() noexcept {}
+      };
+      FinalAwaiter final_suspend() noexcept { return {}; }
+      void return_void(){}
+      void unhandled_exception(){ std::terminate(); }
+  };
+
+  DFRobot_TMF8x01_VoidTask(DFRobot_TMF8x01_VoidTask &&other) noexcept :_h(other._h){ other._h = nullptr; }
+  DFRobot_TMF8x01_VoidTask(const DFRobot_TMF8x01_VoidTask &) = delete;
+  ~DFRobot_TMF8x01_VoidTask(){ if(_h) _h.destroy(); }
+
+  bool await_ready() noexcept { return false; }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+    _h.promise().continuation = awaiting;
+    return _h;
+  }
+  void await_resume(){}
+
+private:
+  explicit DFRobot_TMF8x01_VoidTask(std::coroutine_handle<promise_type> h):_h(h){}
+  std::coroutine_handle<promise_type> _h;
+};
+
+/**
+ * @brief Where suspended coroutines are resumed. A program with its own loop implements it, the coroutines of the
+ * @n driver only use these functions.
+ */
+class DFRobot_TMF8x01_CoExecutor{
+public:
+  virtual ~DFRobot_TMF8x01_CoExecutor(){}
+
+  /**
+   * @fn nowUs
+   * @brief get the time of the executor, unit us.
+   */
+  virtual uint64_t nowUs() = 0;
+
+  /**
+   * @fn post
+   * @brief Resume the coroutine from the loop, after the ones already ready.
+   */
+  virtual void post(std::coroutine_handle<> h) = 0;
+
+  /**
+   * @fn resumeAt
+   * @brief Resume the coroutine at a time.
+   * @param us: The time, see nowUs().
+   */
+  virtual void resumeAt(uint64_t us, std::coroutine_handle<> h) = 0;
+
+  /**
+   * @fn resumeOnFd
+   * @brief Resume the coroutine when the fd is readable or at the deadline, whichever comes first.
+   * @param fd: The fd, such as getFd() of DFRobot_TMF8x01_LinuxInt. One waiter per fd.
+   * @param deadlineUs: The deadline, see nowUs().
+   * @param ready: set to true if the fd became readable, false on the deadline.
+   */
+  virtual void resumeOnFd(int fd, uint64_t deadlineUs, std::coroutine_handle<> h, bool *ready) = 0;
+
+  /**
+   * @fn spawn
+   * @brief Start a task, it runs on the executor and frees itself when it returns.
+   */
+  void spawn(DFRobot_TMF8x01_VoidTask task);
+
+  /**
+   * @fn getTaskNum
+   * @brief get the number of spawned tasks which have not returned.
+   */
+  uint32_t getTaskNum(){ return _tasks; }
+
+  /**
+   * @brief co_await sleepMs(ms): resume after ms, co_await sleepUntil(us): resume at the time of nowUs().
+   */
+  struct SleepAwaiter{
+      DFRobot_TMF8x01_CoExecutor *ex;
+      uint64_t at;
+      bool await_ready(){ return false; }
+      void await_suspend(std::coroutine_handle<> h){ ex->resumeAt(at, h); }
+      void await_resume(){}
+  };
+  SleepAwaiter sleepMs(uint32_t ms){ return SleepAwaiter{this, nowUs() + (uint64_t)ms * 1000}; }
+  SleepAwaiter sleepUntil(uint64_t us){ return SleepAwaiter{this, us}; }
+
+  /**
+   * @brief co_await yield(): let the other ready coroutines run first.
+   */
+  struct YieldAwaiter{
+      DFRobot_TMF8x01_CoExecutor *ex;
+      bool await_ready(){ return false; }
+      void await_suspend(std::coroutine_handle<> h){ ex->post(h); }
+      void await_resume(){}
+  };
+  YieldAwaiter yield(){ return YieldAwaiter{this}; }
+
+  /**
+   * @brief co_await waitFd(fd, ms): true if the fd became readable, false on timeout.
+   */
+  struct FdAwaiter{
+      DFRobot_TMF8x01_CoExecutor *ex;
+      int fd;
+      uint64_t deadline;
+      bool ready;
+      bool await_ready(){ return false; }
+      void await_suspend(std::coroutine_handle<> h){ ex->resumeOnFd(fd, deadline, h, &ready); }
+      bool await_resume(){ return ready; }
+  };
+  FdAwaiter waitFd(int fd, uint32_t timeoutMs){ return FdAwaiter{this, fd, nowUs() + (uint64_t)timeoutMs * 1000, false}; }
+
+protected:
+  uint32_t _tasks = 0;
+};
+
+/**
+ * @brief The default executor: ready queue, timer heap and one epoll set, run() in one thread. Time is
+ * @n CLOCK_MONOTONIC, the same as millis() of the driver.
+ */
+class DFRobot_TMF8x01_EpollExecutor: public DFRobot_TMF8x01_CoExecutor{
+public:
+  DFRobot_TMF8x01_EpollExecutor();
+  ~DFRobot_TMF8x01_EpollExecutor();
+
+  uint64_t nowUs();
+  void post(std::coroutine_handle<> h);
+  void resumeAt(uint64_t us, std::coroutine_handle<> h);
+  void resumeOnFd(int fd, uint64_t deadlineUs, std::coroutine_handle<> h, bool *ready);
+
+  /**
+   * @fn run
+   * @brief Run until every spawned task has returned or stop() is called.
+   */
+  void run();
+
+  /**
+   * @fn runOnce
+   * @brief Resume the ready coroutines, then wait for the next timer or fd at most timeoutMs.
+   * @return The number of coroutines resumed.
+   */
+  int runOnce(int timeoutMs);
+
+  /**
+   * @fn stop
+   * @brief Make run() return.
+   */
+  void stop();
+
+  /**
+   * @fn getResumeCount
+   * @brief get the number of resumptions, for benchmarks.
+   */
+  uint64_t getResumeCount();
+
+private:
+  typedef struct{
+      std::coroutine_handle<> h;
+      int fd;              //-1 for a timer
+      bool *ready;
+  }sWaiter_t;
+
+  void wake(uint64_t id, bool ready);
+
+  int _epfd;
+  bool _stop;
+  uint64_t _nextId;
+  uint64_t _resumes;
+  std::deque<std::coroutine_handle<> > _ready;
+  std::vector<std::pair<uint64_t, uint64_t> > _timers;      //(time, waiter id), min heap
+  std::map<uint64_t, sWaiter_t> _waiters;
+  std::map<int, uint64_t> _fdWaiter;
+  std::map<int, bool> _fdAdded;
+};
+
+class DFRobot_TMF8x01_Coro{
+public:
+  /**
+   * @struct sCoSample_t
+   * @brief A result of nextSample().
+   */
+  typedef struct{
+      bool valid;           /**< false: timeout*/
+      uint16_t distance;    /**< unit mm, corrected for clock drift like getDistance_mm()*/
+      uint8_t tid;          /**< transaction ID of the result*/
+      uint64_t hostUs;      /**< time the result was read, see nowUs() of the executor*/
+  }sCoSample_t;
+
+  /**
+   * @fn DFRobot_TMF8x01_Coro
+   * @brief Constructor.
+   * @param tof: The sensor, constructed with its bus and pins.
+   * @param ex: The executor.
+   * @param irq: The INT source of the sensor, NULL: nextSample() sleeps until the next result is due by the period.
+   */
+  DFRobot_TMF8x01_Coro(DFRobot_TMF8x01 &tof, DFRobot_TMF8x01_CoExecutor &ex, DFRobot_TMF8x01_LinuxInt *irq = NULL);
+
+  /**
+   * @fn begin
+   * @brief The same as begin() of the driver: reset, RAM patch download, APP0.
+   * @return 0: success, -1: failed.
+   */
+  DFRobot_TMF8x01_Task<int> begin();
+
+  /**
+   * @fn startMeasurement
+   * @brief The same as startMeasurement() of the driver, the first results are waited for without blocking.
+   * @n For TMF8701 set the ranging mode by setRangingMode() first.
+   * @return true: measuring, false: failed.
+   */
+  DFRobot_TMF8x01_Task<bool> startMeasurement(DFRobot_TMF8x01::eCalibModeConfig_t cailbMode = DFRobot_TMF8x01::eModeCalib);
+
+  /**
+   * @fn nextSample
+   * @brief Wait for the next result of the sensor.
+   * @param timeoutMs: The longest wait.
+   * @return The sample, valid is false on timeout.
+   */
+  DFRobot_TMF8x01_Task<sCoSample_t> nextSample(uint32_t timeoutMs = 1000);
+
+  /**
+   * @fn calibrate
+   * @brief The same as getCalibrationData() of the driver, read the factory calibration data of the sensor.
+   * @n Call it when the sensor is not measuring, setCalibrationData() of the driver takes the data.
+   * @param data: Buffer of SENSOR_MTF8x01_CALIBRATION_SIZE bytes.
+   * @return true: success, false: failed.
+   */
+  DFRobot_TMF8x01_Task<bool> calibrate(uint8_t *data);
+
+  /**
+   * @fn stopMeasurement
+   * @brief The same as stopMeasurement() of the driver.
+   */
+  DFRobot_TMF8x01_Task<bool> stopMeasurement();
+
+private:
+  DFRobot_TMF8x01_Task<bool> waitCpuReady();
+  DFRobot_TMF8x01_Task<bool> waitContents(uint8_t contents, uint32_t timeoutMs);
+
+  DFRobot_TMF8x01 *_tof;
+  DFRobot_TMF8x01_CoExecutor *_ex;
+  DFRobot_TMF8x01_LinuxInt *_irq;
+  uint64_t _lastUs;
+};
+
+#endif
@@ -0,0 +1,267 @@
+/*!
+ * @file DFRobot_TMF8x01_EventLoop.cpp
+ * @brief One thread serving many sensors on several i2c-dev buses.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include "DFRobot_TMF8x01_EventLoop.h"
+#include "DFRobot_TMF8x01_Latency.h"
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+#define REG_MTF8x01_STATUS      0x1D
+#define REG_MTF8x01_INT_STATUS  0xE1
+#define EVENTLOOP_MAX_EVENTS    64
+
+static uint64_t monotonicNs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+DFRobot_TMF8x01_EventLoop::DFRobot_TMF8x01_EventLoop()
+  :_epfd(-1),_cb(NULL),_ctx(NULL),_clear(0x01){
+}
+
+DFRobot_TMF8x01_EventLoop::~DFRobot_TMF8x01_EventLoop(){
+  if(_epfd >= 0) close(_epfd);
+}
+
+int DFRobot_TMF8x01_EventLoop::begin(){
+  if(_epfd >= 0) close(_epfd);
+  _epfd = epoll_create1(EPOLL_CLOEXEC);
+  if(_epfd < 0) return -errno;
+  return 0;
+}
+
+uint8_t DFRobot_TMF8x01_EventLoop::addBus(DFRobot_TMF8x01_LinuxI2C &i2c, uint8_t batch){
+  sLoopBus_t bus;
+  bus.i2c = &i2c;
+  bus.batch = ((batch == 0) || (batch > EVENTLOOP_BATCH)) ? EVENTLOOP_BATCH : batch;
+  _bus.push_back(bus);
+  return _bus.size() - 1;
+}
+
+int DFRobot_TMF8x01_EventLoop::addSensor(uint8_t bus, DFRobot_TMF8x01 &tof, DFRobot_TMF8x01_LinuxInt &irq){
+  sLoopSensor_t s;
+  struct epoll_event ev;
+  if((_epfd < 0) || (bus >= _bus.size()) || (irq.getFd() < 0)) return -EINVAL;
+  memset(&s, 0, sizeof(s));
+  s.tof = &tof;
+  s.bus = bus;
+  s.irq = &irq;
+  s.level = (irq.read() >= 0);
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.u32 = _sensor.size();
+  if(epoll_ctl(_epfd, EPOLL_CTL_ADD, irq.getFd(), &ev) < 0) return -errno;
+  _sensor.push_back(s);
+  //an INT which went low before the fd was watched gives no edge, the first fetch clears it.
+  queue(_sensor.size() - 1);
+  return _sensor.size() - 1;
+}
+
+void DFRobot_TMF8x01_EventLoop::setCallback(pResultCallback_t cb, void *ctx){
+  _cb = cb;
+  _ctx = ctx;
+}
+
+int DFRobot_TMF8x01_EventLoop::getFd(){
+  return _epfd;
+}
+
+int DFRobot_TMF8x01_EventLoop::run(int timeoutMs){
+  struct epoll_event ev[EVENTLOOP_MAX_EVENTS];
+  bool pending = false;
+  int n, delivered = 0;
+  uint64_t now;
+  if(_epfd < 0) return -EBADF;
+  for(size_t b = 0; b < _bus.size(); b++){
+      if(!_bus[b].queue.empty()) pending = true;
+  }
+  //queued fetches go first, only an idle loop sleeps, and not past the next retry.
+  if(!pending && !_retry.empty()){
+      uint64_t first = UINT64_MAX;
+      now = monotonicNs();
+      for(size_t i = 0; i < _retry.size(); i++){
+          if(_sensor[_retry[i]].retryNs < first) first = _sensor[_retry[i]].retryNs;
+      }
+      int64_t waitMs = (first > now) ? (first - now + 999999) / 1000000 : 0;
+      if((timeoutMs < 0) || (waitMs < timeoutMs)) timeoutMs = waitMs;
+  }
+  n = epoll_wait(_epfd, ev, EVENTLOOP_MAX_EVENTS, pending ? 0 : timeoutMs);
+  if((n < 0) && (errno != EINTR)) return -errno;
+  for(int i = 0; i < n; i++){
+      handleEvent(ev[i].data.u32);
+  }
+  now = monotonicNs();
+  for(size_t i = 0; i < _retry.size();){
+      sLoopSensor_t *s = &_sensor[_retry[i]];
+      //an edge queued it already.
+      if(s->waiting && (s->retryNs > now)){
+          i++;
+          continue;
+      }
+      if(s->waiting){
+          s->waiting = false;
+          queue(_retry[i]);
+      }
+      _retry[i] = _retry.back();
+      _retry.pop_back();
+  }
+  for(size_t b = 0; b < _bus.size(); b++){
+      delivered += processBus(b);
+  }
+  return delivered;
+}
+
+void DFRobot_TMF8x01_EventLoop::handleEvent(uint16_t sensor){
+  sLoopSensor_t *s;
+  if(sensor >= _sensor.size()) return;
+  s = &_sensor[sensor];
+  if(s->irq->consume() <= 0) return;
+  s->intNs = s->irq->getLastEventNs();
+  s->waiting = false;
+  queue(sensor);
+}
+
+void DFRobot_TMF8x01_EventLoop::queue(uint16_t sensor){
+  sLoopSensor_t *s = &_sensor[sensor];
+  //more edges before the fetch still mean one fetch, the result registers only hold the last result.
+  if(s->queued) return;
+  s->queued = true;
+  _bus[s->bus].queue.push_back(sensor);
+}
+
+void DFRobot_TMF8x01_EventLoop::retry(uint16_t sensor, uint64_t now){
+  sLoopSensor_t *s = &_sensor[sensor];
+  uint32_t ms = EVENTLOOP_RETRY_MS;
+  if(s->queued || s->waiting) return;
+  for(uint8_t i = 0; (i < s->retries) && (ms < EVENTLOOP_RETRY_MAX_MS); i++) ms *= 2;
+  if(ms > EVENTLOOP_RETRY_MAX_MS) ms = EVENTLOOP_RETRY_MAX_MS;
+  if(ms < EVENTLOOP_RETRY_MAX_MS) s->retries++;
+  s->retryNs = now + (uint64_t)ms * 1000000ULL;
+  s->waiting = true;
+  _retry.push_back(sensor);
+}
+
+int DFRobot_TMF8x01_EventLoop::processBus(uint8_t bus){
+  DFRobot_TMF8x01_LinuxI2C::sTransfer_t xfer[EVENTLOOP_BATCH * 3];
+  DFRobot_TMF8x01::sResult_t result[EVENTLOOP_BATCH];
+  uint16_t index[EVENTLOOP_BATCH];
+  uint8_t first[EVENTLOOP_BATCH + 1];
+  sLoopBus_t *b;
+  uint8_t num = 0, count = 0, msgs = 0;
+  int delivered = 0;
+  if(bus >= _bus.size()) return 0;
+  b = &_bus[bus];
+  while((num < b->batch) && !b->queue.empty()){
+      sLoopSensor_t *s = &_sensor[b->queue.front()];
+      DFRobot_TMF8x01_LinuxI2C::sTransfer_t *x = &xfer[count];
+      //a line without a level reads INT_STATUS back, the batch still fits one ioctl.
+      if((msgs + (s->level ? 3 : 5)) > LINUXI2C_MAX_MSGS) break;
+      index[num] = b->queue.front();
+      b->queue.pop_front();
+      s->queued = false;
+      first[num] = count;
+      //INT clear, then the result block: a result between the two raises INT again and is not lost.
+      x[0].addr = s->tof->_addr;
+      x[0].reg = REG_MTF8x01_INT_STATUS;
+      x[0].read = false;
+      x[0].buf = &_clear;
+      x[0].len = 1;
+      x[1].addr = s->tof->_addr;
+      x[1].reg = REG_MTF8x01_STATUS;
+      x[1].read = true;
+      x[1].buf = (uint8_t *)&result[num];
+      x[1].len = sizeof(result[num]);
+      count += 2;
+      msgs += 3;
+      if(!s->level){
+          x[2].addr = s->tof->_addr;
+          x[2].reg = REG_MTF8x01_INT_STATUS;
+          x[2].read = true;
+          x[2].buf = &s->intStatus;
+          x[2].len = 1;
+          count++;
+          msgs += 2;
+      }
+      num++;
+  }
+  if(num == 0) return 0;
+  first[num] = count;
+  b->i2c->transfer(xfer, count);
+  uint64_t now = monotonicNs();
+  uint32_t ms = millis();
+  for(uint8_t i = 0; i < num; i++){
+      sLoopSensor_t *s = &_sensor[index[i]];
+      DFRobot_TMF8x01_LinuxI2C::sTransfer_t *x = &xfer[first[i]];
+      bool fresh = false, low;
+      if((x[0].result != 1) || (x[1].result != (int)sizeof(result[i])) || (!s->level && (x[2].result != 1))){
+          //the clear may be lost and no edge comes any more, fetch it again later.
+          s->errors++;
+          retry(index[i], now);
+          continue;
+      }
+#if TMF8x01_USE_LATENCY
+      if(s->tof->_pLatency && s->intNs) s->tof->_pLatency->onInt((uint32_t)(s->intNs / 1000));
+#endif
+      if(s->tof->takeResult(result[i], ms)){
+          DFRobot_TMF8x01 *tof = s->tof;
+          fresh = true;
+          s->results++;
+          delivered++;
+          if(_cb){
+              sEventResult_t e;
+              e.sensor = index[i];
+              e.tid = tof->_result.tid;
+              e.reliability = tof->_result.resultInfo.reliability;
+              e.rawDistance = tof->getRawDistance();
+              e.distance = e.rawDistance * tof->_timestamp;
+              e.sysclock = tof->getResultSysclock();
+              e.intNs = s->intNs;
+              e.fetchNs = now;
+              _cb(_ctx, &e);
+          }
+      }
+      low = s->level ? (s->irq->read() == LOW) : (s->intStatus & 0x01);
+      if(!low){
+          s->retries = 0;
+      }else if(fresh){
+          //a newer result came after the clear, its edge may be gone already.
+          s->retries = 0;
+          queue(index[i]);
+      }else{
+          //the line stays low without a new result.
+          retry(index[i], now);
+      }
+  }
+  return delivered;
+}
+
+uint16_t DFRobot_TMF8x01_EventLoop::getQueueDepth(uint8_t bus){
+  if(bus >= _bus.size()) return 0;
+  return _bus[bus].queue.size();
+}
+
+uint32_t DFRobot_TMF8x01_EventLoop::getResultCount(uint16_t sensor){
+  if(sensor >= _sensor.size()) return 0;
+  return _sensor[sensor].results;
+}
+
+uint32_t DFRobot_TMF8x01_EventLoop::getErrorCount(uint16_t sensor){
+  if(sensor >= _sensor.size()) return 0;
+  return _sensor[sensor].errors;
+}
+
+uint16_t DFRobot_TMF8x01_EventLoop::getSensorNum(){
+  return _sensor.size();
+}
@@ -0,0 +1,183 @@
+/*!
+ * @file DFRobot_TMF8x01_EventLoop.h
+ * @brief One thread serving many sensors on several i2c-dev buses. Every sensor has an INT file descriptor
+ * @n (DFRobot_TMF8x01_LinuxInt), all of them are in one epoll set. An INT edge only queues a fetch of the sensor,
+ * @n handleEvent() never touches the bus. Each bus has its own queue, run() takes a batch from every bus in turn and
+ * @n reads the results of the batch in one ioctl(INT clear, then the result block), so a busy bus or a sensor which
+ * @n stopped answering does not hold up the sensors of other buses, and fails only its own access.
+ * @n The INT line is an edge source: a lost INT clear, or a line which is already low when the sensor is added, gives
+ * @n no edge any more. So every fetch checks the line after the clear(the level of a GPIO line, or INT_STATUS read
+ * @n back in the same ioctl for an eventfd), a sensor added is fetched once at start, and a failed fetch or a line
+ * @n which stays low is fetched again after EVENTLOOP_RETRY_MS, doubling up to EVENTLOOP_RETRY_MAX_MS.
+ * @n The sensors are set up and started by the normal driver first(begin(), enableIntPin(), startMeasurement()),
+ * @n the loop only fetches results. A result read is handed to its driver object as isDataReady() does(clock
+ * @n correction, latency tracker, getLatestSample()), so the driver object belongs to the loop thread while it runs.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_EVENTLOOP_H
+#define __DFROBOT_TMF8X01_EVENTLOOP_H
+
+#include <stdint.h>
+#include <vector>
+#include <deque>
+#include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_LinuxI2C.h"
+#include "DFRobot_TMF8x01_LinuxInt.h"
+
+class DFRobot_TMF8x01_EventLoop{
+public:
+  #define EVENTLOOP_RESULT_SIZE   11      //STATUS .. sysclock3, sResult_t of the driver
+  #define EVENTLOOP_BATCH         14      //3 messages each(5 with INT_STATUS read back), 42 messages in one ioctl
+  #define EVENTLOOP_RETRY_MS      1       //first retry of a failed fetch
+  #define EVENTLOOP_RETRY_MAX_MS  1000    //the retries never stop, they slow down to this
+
+  /**
+   * @struct sEventResult_t
+   * @brief A result delivered by the loop.
+   */
+  typedef struct{
+      uint16_t sensor;       /**< index from addSensor()*/
+      uint8_t tid;           /**< transaction ID of the result*/
+      uint8_t reliability;   /**< 0..63, 63 is best*/
+      uint16_t distance;     /**< unit mm, corrected for clock drift as getDistance_mm()*/
+      uint16_t rawDistance;  /**< unit mm, as the sensor measured it*/
+      uint32_t sysclock;     /**< sensor time stamp, unit 0.2us, bit 0 set means valid*/
+      uint64_t intNs;        /**< time of the INT edge, CLOCK_MONOTONIC in ns*/
+      uint64_t fetchNs;      /**< time the result was read*/
+  }sEventResult_t;
+
+  /**
+   * @brief The type of the result callback, called from run().
+   */
+  typedef void (*pResultCallback_t)(void *ctx, const sEventResult_t *result);
+
+  DFRobot_TMF8x01_EventLoop();
+  ~DFRobot_TMF8x01_EventLoop();
+
+  /**
+   * @fn begin
+   * @brief Create the epoll set.
+   * @return 0: success, -errno: failed.
+   */
+  int begin();
+
+  /**
+   * @fn addBus
+   * @brief Add a bus, opened by its begin().
+   * @param i2c: The adapter.
+   * @param batch: The number of sensors read in one ioctl, at most EVENTLOOP_BATCH.
+   * @return The index of the bus.
+   */
+  uint8_t addBus(DFRobot_TMF8x01_LinuxI2C &i2c, uint8_t batch = EVENTLOOP_BATCH);
+
+  /**
+   * @fn addSensor
+   * @brief Add a sensor, its INT fd joins the epoll set. Its first fetch is queued, its INT may be low already.
+   * @param bus: The index of the bus.
+   * @param tof: The driver of the sensor, at its I2C address on this bus.
+   * @param irq: The INT source of the sensor, started by begin() or beginEventfd().
+   * @return The index of the sensor, -errno: failed.
+   */
+  int addSensor(uint8_t bus, DFRobot_TMF8x01 &tof, DFRobot_TMF8x01_LinuxInt &irq);
+
+  /**
+   * @fn setCallback
+   * @brief Set the function which gets every new result.
+   */
+  void setCallback(pResultCallback_t cb, void *ctx = NULL);
+
+  /**
+   * @fn getFd
+   * @brief get the epoll fd, it is readable while any sensor has an edge. A program with its own loop adds it to
+   * @n its epoll set and calls run(0) when it is readable.
+   */
+  int getFd();
+
+  /**
+   * @fn run
+   * @brief One turn of the loop: wait for INT edges(only if no fetch is queued, at most until the next retry), queue
+   * @n the fetches and the retries which are due, then read one batch of every bus.
+   * @param timeoutMs: The longest wait, -1 forever.
+   * @return The number of results delivered, -errno: failed.
+   */
+  int run(int timeoutMs);
+
+  /**
+   * @fn handleEvent
+   * @brief The INT step of a sensor: read its edges and queue one fetch on its bus. It does no I2C transfer.
+   * @param sensor: The index of the sensor.
+   */
+  void handleEvent(uint16_t sensor);
+
+  /**
+   * @fn processBus
+   * @brief Read one batch of the queue of a bus.
+   * @param bus: The index of the bus.
+   * @return The number of results delivered.
+   */
+  int processBus(uint8_t bus);
+
+  /**
+   * @fn getQueueDepth
+   * @brief get the number of fetches waiting on a bus.
+   */
+  uint16_t getQueueDepth(uint8_t bus);
+
+  /**
+   * @fn getResultCount
+   * @brief get the number of results delivered of a sensor.
+   */
+  uint32_t getResultCount(uint16_t sensor);
+
+  /**
+   * @fn getErrorCount
+   * @brief get the number of failed fetches of a sensor, each one is retried.
+   */
+  uint32_t getErrorCount(uint16_t sensor);
+
+  /**
+   * @fn getSensorNum
+   */
+  uint16_t getSensorNum();
+
+private:
+  typedef struct{
+      DFRobot_TMF8x01 *tof;  //the results and their tid
+      uint8_t bus;
+      DFRobot_TMF8x01_LinuxInt *irq;
+      bool level;            //irq->read() gives the level of the line, else INT_STATUS is read back
+      bool queued;
+      bool waiting;          //in _retry
+      uint8_t retries;
+      uint64_t retryNs;
+      uint8_t intStatus;
+      uint64_t intNs;
+      uint32_t results;
+      uint32_t errors;
+  }sLoopSensor_t;
+
+  typedef struct{
+      DFRobot_TMF8x01_LinuxI2C *i2c;
+      uint8_t batch;
+      std::deque<uint16_t> queue;
+  }sLoopBus_t;
+
+  void queue(uint16_t sensor);
+  void retry(uint16_t sensor, uint64_t now);
+
+  int _epfd;
+  std::vector<sLoopSensor_t> _sensor;
+  std::vector<sLoopBus_t> _bus;
+  std::vector<uint16_t> _retry;
+  pResultCallback_t _cb;
+  void *_ctx;
+  uint8_t _clear;
+};
+
+#endif
@@ -0,0 +1,497 @@
+/*!
+ * @file DFRobot_TMF8x01_FakeBus.cpp
+ * @brief An in-memory I2C bus with simulated TMF8801/TMF8701 sensors.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include "DFRobot_TMF8x01_FakeBus.h"
+#include <time.h>
+
+#define FAKE_DEFAULT_ADDR   0x41
+#define FAKE_CPU_READY_US   500       //pon to cpu ready
+#define FAKE_APP_START_US   2000      //bootloader reset to APP0
+#define FAKE_FIRST_RESULT_US 5000     //measure command to the first integration
+#define FAKE_US_PER_KITER   30        //integration time of 1000 iterations
+#define FAKE_MAX_INTEGRATION_US 100000
+#define FAKE_GATE_STEP_US   50        //time step of a sensor gated by PIN0
+
+static const uint8_t fakeCalibData[14] = {0x41,0x57,0x01,0xFD,0x04,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04};
+
+static uint64_t fakeMonotonicUs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static uint64_t fakeMicros(void *ctx){
+  return ((DFRobot_TMF8x01_FakeBus *)ctx)->now();
+}
+
+static void fakeDelayUs(void *ctx, uint32_t us){
+  ((DFRobot_TMF8x01_FakeBus *)ctx)->advance(us);
+}
+
+static void fakePinMode(void *ctx, uint8_t pin, uint8_t mode){
+  (void)ctx; (void)pin; (void)mode;
+}
+
+static void fakeDigitalWrite(void *ctx, uint8_t pin, uint8_t val){
+  ((DFRobot_TMF8x01_FakeBus *)ctx)->pinWrite(pin, val);
+}
+
+static int fakeDigitalRead(void *ctx, uint8_t pin){
+  return ((DFRobot_TMF8x01_FakeBus *)ctx)->pinRead(pin);
+}
+
+DFRobot_TMF8x01_FakeBus::DFRobot_TMF8x01_FakeBus(uint32_t busHz)
+  :_pin(256, LOW),_busHz(busHz ? busHz : 400000),_virtual(false),_now(0),_busUs(0),_transfers(0),_patchWrites(0){
+}
+
+uint16_t DFRobot_TMF8x01_FakeBus::addSensor(int enPin, int intPin, eFakeModel_t model, int pin0){
+  sFakeSensor_t s;
+  memset(&s, 0, sizeof(s));
+  s.model = model;
+  s.enPin = (enPin < 256) ? enPin : -1;
+  s.intPin = (intPin < 256) ? intPin : -1;
+  s.pin0 = (pin0 < 256) ? pin0 : -1;
+  s.distance = 500;
+  s.seed = 0x9E3779B9u + _sensor.size();
+  powerUp(&s);
+  _sensor.push_back(s);
+  return _sensor.size() - 1;
+}
+
+void DFRobot_TMF8x01_FakeBus::setDistance(uint16_t index, uint16_t mm){
+  if(index < _sensor.size()) _sensor[index].distance = mm;
+}
+
+void DFRobot_TMF8x01_FakeBus::setClockDrift(uint16_t index, int32_t ppm){
+  if(index < _sensor.size()) _sensor[index].ppm = ppm;
+}
+
+uint16_t DFRobot_TMF8x01_FakeBus::getSensorNum(){
+  return _sensor.size();
+}
+
+uint8_t DFRobot_TMF8x01_FakeBus::getAddress(uint16_t index){
+  if(index >= _sensor.size()) return 0;
+  return _sensor[index].addr;
+}
+
+uint32_t DFRobot_TMF8x01_FakeBus::getResultCount(uint16_t index){
+  if(index >= _sensor.size()) return 0;
+  return _sensor[index].results;
+}
+
+bool DFRobot_TMF8x01_FakeBus::isMeasuring(uint16_t index){
+  if(index >= _sensor.size()) return false;
+  sFakeSensor_t *s = &_sensor[index];
+  if(!powered(s)) return false;
+  update(s);
+  return s->measuring;
+}
+
+bool DFRobot_TMF8x01_FakeBus::isEmitting(uint16_t index){
+  if(index >= _sensor.size()) return false;
+  sFakeSensor_t *s = &_sensor[index];
+  if(!powered(s)) return false;
+  update(s);
+  if(!s->measuring) return false;
+  if(gated(s)) return !s->armed && gateOpen(s, now());
+  return emitsAt(s, now());
+}
+
+uint32_t DFRobot_TMF8x01_FakeBus::getPatchRecordCount(uint16_t index){
+  if(index >= _sensor.size()) return 0;
+  return _sensor[index].patchRecords;
+}
+
+uint32_t DFRobot_TMF8x01_FakeBus::getPatchWriteCount(){
+  return _patchWrites;
+}
+
+void DFRobot_TMF8x01_FakeBus::attach(bool virtualTime){
+  sArduinoHooks_t hooks;
+  memset(&hooks, 0, sizeof(hooks));
+  if(virtualTime != _virtual){
+      //keep the clock continuous when switching.
+      _now = virtualTime ? now() : (fakeMonotonicUs() - now());
+      _virtual = virtualTime;
+  }
+  if(_virtual){
+      hooks.micros = fakeMicros;
+      hooks.delayUs = fakeDelayUs;
+  }
+  hooks.pinMode = fakePinMode;
+  hooks.digitalWrite = fakeDigitalWrite;
+  hooks.digitalRead = fakeDigitalRead;
+  hooks.ctx = this;
+  setArduinoHooks(&hooks);
+}
+
+uint64_t DFRobot_TMF8x01_FakeBus::now(){
+  //in real time _now is the offset of the monotonic clock.
+  if(_virtual) return _now;
+  return fakeMonotonicUs() - _now;
+}
+
+void DFRobot_TMF8x01_FakeBus::advance(uint64_t us){
+  if(_virtual) _now += us;
+}
+
+uint64_t DFRobot_TMF8x01_FakeBus::getBusTimeUs(){
+  return _busUs;
+}
+
+uint32_t DFRobot_TMF8x01_FakeBus::getTransferCount(){
+  return _transfers;
+}
+
+void DFRobot_TMF8x01_FakeBus::busTime(size_t bytes){
+  //9 bits per byte with ACK, plus START and STOP.
+  uint64_t us = ((uint64_t)bytes * 9 + 2) * 1000000ULL / _busHz;
+  _busUs += us;
+  _transfers++;
+  advance(us);
+}
+
+void DFRobot_TMF8x01_FakeBus::pinWrite(uint8_t pin, uint8_t val){
+  uint8_t old = _pin[pin];
+  if(old == (val ? HIGH : LOW)) return;
+  //the sensors gated by the line run until now at the old level.
+  for(size_t i = 0; i < _sensor.size(); i++){
+      if((_sensor[i].pin0 == pin) && powered(&_sensor[i])) update(&_sensor[i]);
+  }
+  _pin[pin] = val ? HIGH : LOW;
+  for(size_t i = 0; i < _sensor.size(); i++){
+      sFakeSensor_t *s = &_sensor[i];
+      //a rising EN is a power on reset, the sensor is back at 0x41 in the bootloader.
+      if((s->enPin == pin) && val) powerUp(s);
+  }
+}
+
+int DFRobot_TMF8x01_FakeBus::pinRead(uint8_t pin){
+  bool isInt = false;
+  for(size_t i = 0; i < _sensor.size(); i++){
+      sFakeSensor_t *s = &_sensor[i];
+      if(s->intPin != pin) continue;
+      isInt = true;
+      if(!powered(s)) continue;
+      update(s);
+      //open drain, any sensor with a pending interrupt pulls the line low.
+      if(s->regs[0xE1] & s->regs[0xE2] & 0x01) return LOW;
+  }
+  if(isInt) return HIGH;
+  return _pin[pin];
+}
+
+void DFRobot_TMF8x01_FakeBus::begin(){
+}
+
+bool DFRobot_TMF8x01_FakeBus::probe(uint8_t addr){
+  busTime(1);
+  for(size_t i = 0; i < _sensor.size(); i++){
+      if((_sensor[i].addr == addr) && powered(&_sensor[i])) return true;
+  }
+  return false;
+}
+
+void DFRobot_TMF8x01_FakeBus::writeReg(uint8_t addr, uint8_t reg, const void *pBuf, size_t size){
+  const uint8_t *buf = (const uint8_t *)pBuf;
+  bool record = false;
+  busTime(2 + size);
+  //every sensor at the address takes the write, this is the broadcast of the manager.
+  for(size_t i = 0; i < _sensor.size(); i++){
+      sFakeSensor_t *s = &_sensor[i];
+      if((s->addr != addr) || !powered(s)) continue;
+      update(s);
+      for(size_t k = 0; k < size; k++){
+          uint8_t r = reg + k;
+          switch(r){
+              case 0xE0:{
+                   uint8_t v = buf[k];
+                   if(v & 0x80){
+                       s->app = 0x80;
+                       s->measuring = false;
+                       s->readyAt = now() + FAKE_CPU_READY_US;
+                   }else{
+                       if((v & 0x01) && !s->pon) s->readyAt = now() + FAKE_CPU_READY_US;
+                       s->pon = v & 0x01;
+                       if(!s->pon) s->measuring = false;
+                   }
+                   break;
+              }
+              case 0xE1:
+                   s->regs[0xE1] &= ~buf[k];
+                   break;
+              case 0x02:
+                   if(buf[k] == 0xC0) s->app = 0xC0;
+                   else if(buf[k] == 0x80) s->app = 0x80;
+                   break;
+              default:
+                   s->regs[r] = buf[k];
+                   break;
+          }
+      }
+      if(onWrite(s, reg, size)) record = true;
+  }
+  if(record) _patchWrites++;
+}
+
+uint8_t DFRobot_TMF8x01_FakeBus::readReg(uint8_t addr, uint8_t reg, void *pBuf, size_t size){
+  uint8_t *buf = (uint8_t *)pBuf;
+  bool ack = false;
+  busTime(3 + size);
+  memset(buf, 0xFF, size);
+  for(size_t i = 0; i < _sensor.size(); i++){
+      sFakeSensor_t *s = &_sensor[i];
+      if((s->addr != addr) || !powered(s)) continue;
+      update(s);
+      ack = true;
+      //wired-AND of all sensors answering at the address.
+      for(size_t k = 0; k < size; k++) buf[k] &= readByte(s, reg + k);
+  }
+  if(!ack){
+      memset(buf, 0, size);
+      return 0;
+  }
+  return size;
+}
+
+bool DFRobot_TMF8x01_FakeBus::powered(sFakeSensor_t *s){
+  return (s->enPin < 0) || (_pin[s->enPin] == HIGH);
+}
+
+void DFRobot_TMF8x01_FakeBus::powerUp(sFakeSensor_t *s){
+  memset(s->regs, 0, sizeof(s->regs));
+  s->addr = FAKE_DEFAULT_ADDR;
+  s->app = 0x80;
+  s->pon = false;
+  s->readyAt = 0;
+  s->measuring = false;
+  s->gpio = 0;
+  s->patchRecords = 0;
+  s->clockStart = now();
+  s->regs[0x01] = 0x01;               //version of APP0
+  s->regs[0x12] = 0x0B;
+  s->regs[0x13] = 0x00;
+  s->regs[0xE3] = 0x09;
+  s->regs[0xE4] = 0x00;
+}
+
+uint8_t DFRobot_TMF8x01_FakeBus::readByte(sFakeSensor_t *s, uint8_t reg){
+  bool ready = s->pon && (now() >= s->readyAt);
+  switch(reg){
+      case 0xE0:
+           return (s->pon ? 0x01 : 0x00) | (ready ? 0x40 : 0x00);
+      case 0x00:
+           return ready ? s->app : 0x00;
+      default:
+           return s->regs[reg];
+  }
+}
+
+bool DFRobot_TMF8x01_FakeBus::onWrite(sFakeSensor_t *s, uint8_t reg, uint8_t len){
+  if(!s->pon || (now() < s->readyAt)) return false;
+  if(s->app == 0x80){
+      if(reg == 0x08) return bootloader(s);
+      return false;
+  }
+  //the command register is the last byte of every command block.
+  if((reg <= 0x10) && ((reg + len) > 0x10)) command(s, s->regs[0x10]);
+  return false;
+}
+
+bool DFRobot_TMF8x01_FakeBus::bootloader(sFakeSensor_t *s){
+  uint8_t cmd = s->regs[0x08];
+  bool record = (cmd == 0x41);
+  //0x14 init, 0x43 set address, 0x41 write data: only the ACK is emulated, the records of 0x41 are counted.
+  if(record) s->patchRecords++;
+  if(cmd == 0x11){
+      s->app = 0xC0;
+      s->readyAt = now() + FAKE_APP_START_US;
+  }
+  s->regs[0x08] = 0x00;
+  s->regs[0x09] = 0x00;
+  s->regs[0x0A] = 0xFF;
+  return record;
+}
+
+void DFRobot_TMF8x01_FakeBus::command(sFakeSensor_t *s, uint8_t cmd){
+  switch(cmd){
+      case 0x02:{
+           uint32_t iter = ((uint32_t)s->regs[0x0E] << 8) | s->regs[0x0F];
+           uint32_t integration = iter * FAKE_US_PER_KITER;
+           s->periodUs = (uint32_t)s->regs[0x0D] * 1000;
+           //0xFFFF iterations of the TMF8701 means as many as fit in the period.
+           if(s->periodUs && (integration > s->periodUs)) integration = s->periodUs;
+           if(integration > FAKE_MAX_INTEGRATION_US) integration = FAKE_MAX_INTEGRATION_US;
+           s->integrationUs = integration;
+           s->measureAt = now() + FAKE_FIRST_RESULT_US;
+           s->nextResult = s->measureAt + integration;
+           s->measuring = true;
+           //cmd_data5 is the GPIO config, a gated sensor waits for the first edge after the start.
+           s->gpio = s->regs[0x0A];
+           s->armed = true;
+           s->gateLast = true;
+           s->gateAt = s->measureAt;
+           s->gateUs = 0;
+           break;
+      }
+      case 0x0F:
+           setGpio(s, s->regs[0x0F]);
+           break;
+      case 0xFF:
+           s->measuring = false;
+           break;
+      case 0x0A:
+           memcpy(&s->regs[0x20], fakeCalibData, sizeof(fakeCalibData));
+           s->regs[0x1E] = 0x0A;
+           break;
+      case 0x47:{
+           uint16_t model = (s->model == eFakeTMF8701) ? 0x5e10 : 0x4120;
+           s->regs[0x28] = s->seed & 0xFF;
+           s->regs[0x29] = (s->seed >> 8) & 0xFF;
+           s->regs[0x2A] = model & 0xFF;
+           s->regs[0x2B] = model >> 8;
+           s->regs[0x1E] = 0x47;
+           break;
+      }
+      case 0x49:{
+           uint8_t cond = s->regs[0x0E];
+           bool pin0 = (s->pin0 >= 0) && (_pin[s->pin0] == HIGH);
+           bool ok = true;
+           if((cond & 0x01) && pin0) ok = false;
+           if((cond & 0x02) && !pin0) ok = false;
+           //PIN1 is not connected and reads low.
+           if(cond & 0x08) ok = false;
+           if(ok) s->addr = s->regs[0x0F] >> 1;
+           break;
+      }
+      default:
+           if((cmd >= 0x80) && (cmd < 0x8A)){
+               //a histogram block with a peak at the distance, 2.5mm per bin like the TMF8801.
+               uint16_t peak = s->distance / 25;
+               for(uint8_t b = 0; b < 128; b++){
+                   int32_t bin = (cmd - 0x80) * 128 + b;
+                   int32_t d = bin - peak;
+                   s->regs[0x20 + b] = 8 + ((d > -4) && (d < 4) ? (4 - (d < 0 ? -d : d)) * 40 : 0);
+               }
+               s->regs[0x1E] = cmd;
+           }
+           break;
+  }
+  s->regs[0x11] = cmd;
+}
+
+void DFRobot_TMF8x01_FakeBus::setGpio(sFakeSensor_t *s, uint8_t gpio){
+  bool was = gated(s);
+  update(s);
+  s->gpio = gpio;
+  if(!s->measuring || (was == gated(s))) return;
+  if(was){
+      //free running again from now.
+      s->nextResult = now() + s->integrationUs;
+  }else{
+      s->armed = true;
+      s->gateAt = now();
+      s->gateLast = gateOpen(s, s->gateAt);
+      s->gateUs = 0;
+  }
+}
+
+bool DFRobot_TMF8x01_FakeBus::gated(sFakeSensor_t *s){
+  uint8_t pin0 = s->gpio & 0x0F;
+  return (s->pin0 >= 0) && ((pin0 == 1) || (pin0 == 2));
+}
+
+bool DFRobot_TMF8x01_FakeBus::gateOpen(sFakeSensor_t *s, uint64_t t){
+  bool driven = false, high = false;
+  //the line is driven by the sensors outputting their VCSEL signal on it, or by the MCU pin.
+  for(size_t i = 0; i < _sensor.size(); i++){
+      sFakeSensor_t *m = &_sensor[i];
+      if((m == s) || (m->pin0 != s->pin0) || ((m->gpio & 0x0F) != 3) || !powered(m)) continue;
+      driven = true;
+      if(emitsAt(m, t)) high = true;
+  }
+  if(!driven) high = (_pin[s->pin0] == HIGH);
+  //1: the VCSEL is stopped while the pin is low, 2: while it is high.
+  return ((s->gpio & 0x0F) == 1) ? high : !high;
+}
+
+void DFRobot_TMF8x01_FakeBus::gate(sFakeSensor_t *s, uint64_t t){
+  while(s->measuring && (s->gateAt + FAKE_GATE_STEP_US <= t)){
+      bool open = gateOpen(s, s->gateAt);
+      //the integration starts on the edge of the line into the level that lets the VCSEL run.
+      if(s->armed && open && !s->gateLast) s->armed = false;
+      s->gateLast = open;
+      s->gateAt += FAKE_GATE_STEP_US;
+      if(s->armed || !open) continue;
+      s->gateUs += FAKE_GATE_STEP_US;
+      if(s->gateUs < s->integrationUs) continue;
+      produce(s, s->gateAt);
+      s->gateUs = 0;
+      s->armed = true;
+      if(s->periodUs == 0) s->measuring = false;
+  }
+}
+
+bool DFRobot_TMF8x01_FakeBus::emitsAt(sFakeSensor_t *s, uint64_t t){
+  uint64_t d;
+  //the integration of every result is the time before it, the first one starts at measureAt.
+  if(!s->measuring || (t < s->measureAt)) return false;
+  if(s->periodUs == 0) return (t + s->integrationUs >= s->nextResult) && (t < s->nextResult);
+  if(t < s->nextResult) d = (s->nextResult - t) % s->periodUs;
+  else d = (s->periodUs - (t - s->nextResult) % s->periodUs) % s->periodUs;
+  return (d > 0) && (d <= s->integrationUs);
+}
+
+void DFRobot_TMF8x01_FakeBus::update(sFakeSensor_t *s){
+  uint64_t t = now();
+  uint32_t n = 0;
+  if(!s->measuring) return;
+  if(gated(s)){
+      gate(s, t);
+      return;
+  }
+  while(s->measuring && (s->nextResult <= t)){
+      produce(s, s->nextResult);
+      if(s->periodUs == 0){
+          s->measuring = false;
+          break;
+      }
+      s->nextResult += s->periodUs;
+      //after a long time without access only the last result is visible anyway.
+      if(++n > 1000) s->nextResult += ((t - s->nextResult) / s->periodUs) * s->periodUs;
+  }
+}
+
+void DFRobot_TMF8x01_FakeBus::produce(sFakeSensor_t *s, uint64_t t){
+  uint64_t clock = (t - s->clockStart) * 5;
+  int32_t noise;
+  uint16_t dis;
+  clock += (int64_t)clock * s->ppm / 1000000;
+  s->seed = s->seed * 1103515245u + 12345u;
+  noise = (int32_t)((s->seed >> 16) % 3) - 1;
+  dis = s->distance + noise;
+  s->results++;
+  s->regs[0x1D] = 0x00;
+  s->regs[0x1E] = 0x55;
+  s->regs[0x1F]++;
+  s->regs[0x20]++;
+  s->regs[0x21] = 63;
+  s->regs[0x22] = dis & 0xFF;
+  s->regs[0x23] = dis >> 8;
+  //bit 0 set means the time stamp is valid.
+  clock |= 1;
+  s->regs[0x24] = clock & 0xFF;
+  s->regs[0x25] = (clock >> 8) & 0xFF;
+  s->regs[0x26] = (clock >> 16) & 0xFF;
+  s->regs[0x27] = (clock >> 24) & 0xFF;
+  if(s->regs[0xE2] & 0x01) s->regs[0xE1] |= 0x01;
+}
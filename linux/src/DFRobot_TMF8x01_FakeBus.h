@@ -0,0 +1,204 @@
+/*!
+ * @file DFRobot_TMF8x01_FakeBus.h
+ * @brief An in-memory I2C bus with simulated TMF8801/TMF8701 sensors, for running the unchanged driver on Linux
+ * @n without hardware. The sensors emulate the part of the register map the driver uses: enable/cpu ready, the
+ * @n bootloader patch download, APP0 commands(measure, stop, calibration, serial number, address change, GPIO,
+ * @n histogram), periodic and single shot results with a drifting sensor clock, INT status and the INT/EN pins.
+ * @n PIN0 follows the GPIO config: a sensor set to output the VCSEL signal drives the line of its pin0 while it emits,
+ * @n a sensor set to an input level integrates only while the line is at the other level, and starts on the edge into it.
+ * @n Sensors sharing an address all take the writes and answer reads wired-AND, like on a real bus.
+ * @n In virtual time delay() only advances the clock of the bus, and every transfer costs its time on the bus.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_FAKEBUS_H
+#define __DFROBOT_TMF8X01_FAKEBUS_H
+
+#include "DFRobot_TMF8x01_Bus.h"
+#include <vector>
+
+class DFRobot_TMF8x01_FakeBus: public DFRobot_TMF8x01_Bus{
+public:
+  typedef enum{
+      eFakeTMF8801 = 0,
+      eFakeTMF8701,
+  }eFakeModel_t;
+
+  /**
+   * @fn DFRobot_TMF8x01_FakeBus
+   * @brief Constructor.
+   * @param busHz: The I2C clock, only used for the transfer time in virtual time.
+   */
+  DFRobot_TMF8x01_FakeBus(uint32_t busHz = 400000);
+
+  /**
+   * @fn addSensor
+   * @brief Add a sensor at address 0x41.
+   * @param enPin: The MCU pin connected to EN, -1 means always powered.
+   * @param intPin: The MCU pin connected to INT, several sensors may share one pin(wire-OR).
+   * @param model: eFakeTMF8801 or eFakeTMF8701.
+   * @param pin0: The MCU pin connected to PIN0, for the address change condition and the sync line, -1 means PIN0 is low.
+   * @n Sensors with the same pin0 share one line.
+   * @return The index of the sensor.
+   */
+  uint16_t addSensor(int enPin = -1, int intPin = -1, eFakeModel_t model = eFakeTMF8801, int pin0 = -1);
+
+  /**
+   * @fn setDistance
+   * @brief Set the distance the sensor measures, the results have +-1mm noise.
+   * @param index: The index of sensor.
+   * @param mm: distance, unit mm.
+   */
+  void setDistance(uint16_t index, uint16_t mm);
+
+  /**
+   * @fn setClockDrift
+   * @brief Set how fast the sensor clock runs against the host clock.
+   * @param index: The index of sensor.
+   * @param ppm: The drift, unit ppm.
+   */
+  void setClockDrift(uint16_t index, int32_t ppm);
+
+  /**
+   * @fn getSensorNum
+   * @return The number of sensors.
+   */
+  uint16_t getSensorNum();
+
+  /**
+   * @fn getAddress
+   * @brief get the current I2C address of sensor n.
+   */
+  uint8_t getAddress(uint16_t index);
+
+  /**
+   * @fn getResultCount
+   * @brief get the number of results produced by sensor n.
+   */
+  uint32_t getResultCount(uint16_t index);
+
+  /**
+   * @fn isMeasuring
+   * @brief The VCSEL of sensor n emits: it is powered and has a measurement running(a single shot until its result).
+   */
+  bool isMeasuring(uint16_t index);
+
+  /**
+   * @fn isEmitting
+   * @brief The VCSEL of sensor n fires now: inside the integration of a result.
+   */
+  bool isEmitting(uint16_t index);
+
+  /**
+   * @fn getPatchRecordCount
+   * @brief get the number of RAM patch records sensor n took in its bootloader since its last power on.
+   */
+  uint32_t getPatchRecordCount(uint16_t index);
+
+  /**
+   * @fn getPatchWriteCount
+   * @brief get the number of RAM patch record writes on the bus since the start, a write taken by several sensors
+   * @n at one address(a broadcast) counts once.
+   */
+  uint32_t getPatchWriteCount();
+
+  /**
+   * @fn attach
+   * @brief Install the GPIO hooks(EN, INT, PIN0) of Arduino.h, and the clock hooks for virtual time.
+   * @param virtualTime: true: millis()/delay() use the clock of the bus, false: the real clock.
+   */
+  void attach(bool virtualTime = true);
+
+  /**
+   * @fn now
+   * @brief get the time of the bus, unit us.
+   */
+  uint64_t now();
+
+  /**
+   * @fn advance
+   * @brief Advance the virtual clock, no effect in real time.
+   * @param us: unit us.
+   */
+  void advance(uint64_t us);
+
+  /**
+   * @fn getBusTimeUs
+   * @brief get the time the bus was busy since the start, unit us.
+   */
+  uint64_t getBusTimeUs();
+
+  /**
+   * @fn getTransferCount
+   * @brief get the number of transfers since the start.
+   */
+  uint32_t getTransferCount();
+
+  void pinWrite(uint8_t pin, uint8_t val);
+  int pinRead(uint8_t pin);
+
+  void begin();
+  bool probe(uint8_t addr);
+  void writeReg(uint8_t addr, uint8_t reg, const void *pBuf, size_t size);
+  uint8_t readReg(uint8_t addr, uint8_t reg, void *pBuf, size_t size);
+
+private:
+  typedef struct{
+      eFakeModel_t model;
+      int enPin;
+      int intPin;
+      int pin0;
+      uint8_t addr;
+      uint8_t regs[256];
+      uint8_t app;
+      bool pon;
+      uint64_t readyAt;
+      bool measuring;
+      uint64_t nextResult;
+      uint32_t periodUs;
+      uint32_t integrationUs;
+      uint64_t measureAt;    //the first integration starts
+      uint8_t gpio;          //PIN1 bits 7:4, PIN0 bits 3:0
+      bool armed;            //gated by PIN0, waiting for the edge
+      bool gateLast;
+      uint64_t gateAt;
+      uint32_t gateUs;
+      uint64_t clockStart;
+      int32_t ppm;
+      uint16_t distance;
+      uint32_t results;
+      uint32_t patchRecords;
+      uint32_t seed;
+  }sFakeSensor_t;
+
+  void powerUp(sFakeSensor_t *s);
+  void update(sFakeSensor_t *s);
+  void produce(sFakeSensor_t *s, uint64_t t);
+  void setGpio(sFakeSensor_t *s, uint8_t gpio);
+  bool gated(sFakeSensor_t *s);
+  bool gateOpen(sFakeSensor_t *s, uint64_t t);
+  void gate(sFakeSensor_t *s, uint64_t t);
+  bool emitsAt(sFakeSensor_t *s, uint64_t t);
+  bool onWrite(sFakeSensor_t *s, uint8_t reg, uint8_t len);
+  void command(sFakeSensor_t *s, uint8_t cmd);
+  bool bootloader(sFakeSensor_t *s);
+  bool powered(sFakeSensor_t *s);
+  uint8_t readByte(sFakeSensor_t *s, uint8_t reg);
+  void busTime(size_t bytes);
+
+  std::vector<sFakeSensor_t> _sensor;
+  std::vector<uint8_t> _pin;
+  uint32_t _busHz;
+  bool _virtual;
+  uint64_t _now;
+  uint64_t _busUs;
+  uint32_t _transfers;
+  uint32_t _patchWrites;
+};
+
+#endif
@@ -0,0 +1,250 @@
+/*!
+ * @file DFRobot_TMF8x01_Histogram.cpp
+ * @brief Define the basic structure of class DFRobot_TMF8x01_Histogram
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "DFRobot_TMF8x01_Histogram.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_LANES   8
+typedef __m256 vfloat_t;
+#define vload(p)       _mm256_load_ps(p)
+#define vstore(p, v)   _mm256_store_ps(p, v)
+#define vset1(x)       _mm256_set1_ps(x)
+#define vadd(a, b)     _mm256_add_ps(a, b)
+#define vsub(a, b)     _mm256_sub_ps(a, b)
+#define vmul(a, b)     _mm256_mul_ps(a, b)
+#define vdiv(a, b)     _mm256_div_ps(a, b)
+#define vmax(a, b)     _mm256_max_ps(a, b)
+#define vand(a, b)     _mm256_and_ps(a, b)
+#define vcmpgt(a, b)   _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+#define vcmpge(a, b)   _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+#define vmask(a)       _mm256_movemask_ps(a)
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SIMD_LANES   4
+typedef __m128 vfloat_t;
+#define vload(p)       _mm_load_ps(p)
+#define vstore(p, v)   _mm_store_ps(p, v)
+#define vset1(x)       _mm_set1_ps(x)
+#define vadd(a, b)     _mm_add_ps(a, b)
+#define vsub(a, b)     _mm_sub_ps(a, b)
+#define vmul(a, b)     _mm_mul_ps(a, b)
+#define vdiv(a, b)     _mm_div_ps(a, b)
+#define vmax(a, b)     _mm_max_ps(a, b)
+#define vand(a, b)     _mm_and_ps(a, b)
+#define vcmpgt(a, b)   _mm_cmpgt_ps(a, b)
+#define vcmpge(a, b)   _mm_cmpge_ps(a, b)
+#define vmask(a)       _mm_movemask_ps(a)
+#endif
+
+static float *allocFloat(size_t n){
+  void *p = NULL;
+  if(posix_memalign(&p, 32, n * sizeof(float)) != 0) return NULL;
+  memset(p, 0, n * sizeof(float));
+  return (float *)p;
+}
+
+DFRobot_TMF8x01_Histogram::DFRobot_TMF8x01_Histogram(uint16_t bins, uint32_t capacity)
+  :_bins(bins),_radius(1),_simd(true),_threshold(0),_mmPerBin(1),_zeroBin(0),_ref(NULL){
+  _stride = (capacity + HISTOGRAM_LANES - 1) / HISTOGRAM_LANES * HISTOGRAM_LANES;
+  _batch = allocFloat((size_t)_bins * _stride);
+  //2 rows per bin: reference subtracted values, then smoothed values.
+  _work = allocFloat((size_t)_bins * _stride * 2);
+  _ref = allocFloat(_bins);
+}
+
+DFRobot_TMF8x01_Histogram::~DFRobot_TMF8x01_Histogram(){
+  free(_batch);
+  free(_work);
+  free(_ref);
+}
+
+float *DFRobot_TMF8x01_Histogram::getBatch(){
+  return _batch;
+}
+
+uint32_t DFRobot_TMF8x01_Histogram::getStride(){
+  return _stride;
+}
+
+void DFRobot_TMF8x01_Histogram::setFrame(uint32_t index, const float *hist){
+  if((index >= _stride) || (hist == NULL) || (_batch == NULL)) return;
+  for(uint16_t b = 0; b < _bins; b++){
+      _batch[(size_t)b * _stride + index] = hist[b];
+  }
+}
+
+void DFRobot_TMF8x01_Histogram::setReference(const float *ref){
+  if(_ref == NULL) return;
+  if(ref == NULL) memset(_ref, 0, _bins * sizeof(float));
+  else memcpy(_ref, ref, _bins * sizeof(float));
+}
+
+void DFRobot_TMF8x01_Histogram::setSmoothing(uint8_t radius){
+  _radius = (radius > 3) ? 3 : radius;
+}
+
+void DFRobot_TMF8x01_Histogram::setThreshold(float threshold){
+  _threshold = threshold;
+}
+
+void DFRobot_TMF8x01_Histogram::setDistanceScale(float mmPerBin, float zeroBin){
+  _mmPerBin = mmPerBin;
+  _zeroBin = zeroBin;
+}
+
+void DFRobot_TMF8x01_Histogram::setSimd(bool enable){
+  _simd = enable;
+}
+
+uint32_t DFRobot_TMF8x01_Histogram::process(uint32_t frames, sPeaks_t *peaks){
+  if((_batch == NULL) || (_work == NULL) || (peaks == NULL) || (_bins < 3)) return 0;
+  if(frames > _stride) frames = _stride;
+  for(uint32_t f = 0; f < frames; f++) peaks[f].num = 0;
+#if defined(__SSE2__)
+  if(_simd){
+      prepareSimd(frames);
+      findPeaksSimd(frames, peaks);
+      return frames;
+  }
+#endif
+  prepareScalar(frames);
+  findPeaksScalar(frames, peaks);
+  return frames;
+}
+
+void DFRobot_TMF8x01_Histogram::prepareScalar(uint32_t frames){
+  float *sub = _work;
+  float *smooth = _work + (size_t)_bins * _stride;
+  float scale = 1.0f / (2 * _radius + 1);
+  for(uint16_t b = 0; b < _bins; b++){
+      const float *in = _batch + (size_t)b * _stride;
+      float *out = sub + (size_t)b * _stride;
+      for(uint32_t f = 0; f < frames; f++){
+          float v = in[f] - _ref[b];
+          out[f] = (v > 0) ? v : 0;
+      }
+  }
+  for(int b = 0; b < _bins; b++){
+      float *out = smooth + (size_t)b * _stride;
+      for(uint32_t f = 0; f < frames; f++){
+          float sum = 0;
+          for(int k = -_radius; k <= _radius; k++){
+              int i = b + k;
+              if(i < 0) i = 0;
+              if(i >= _bins) i = _bins - 1;
+              sum += sub[(size_t)i * _stride + f];
+          }
+          out[f] = sum * scale;
+      }
+  }
+}
+
+void DFRobot_TMF8x01_Histogram::findPeaksScalar(uint32_t frames, sPeaks_t *peaks){
+  const float *smooth = _work + (size_t)_bins * _stride;
+  for(uint16_t b = 1; b < _bins - 1; b++){
+      const float *l = smooth + (size_t)(b - 1) * _stride;
+      const float *c = smooth + (size_t)b * _stride;
+      const float *r = smooth + (size_t)(b + 1) * _stride;
+      for(uint32_t f = 0; f < frames; f++){
+          if((c[f] > l[f]) && (c[f] >= r[f]) && (c[f] > _threshold)){
+              //parabola through the 3 bins gives the sub-bin position.
+              float den = l[f] - 2 * c[f] + r[f];
+              float off = 0.5f * (l[f] - r[f]) / den;
+              addPeak(&peaks[f], b + off, c[f] - 0.25f * (l[f] - r[f]) * off);
+          }
+      }
+  }
+}
+
+#if defined(__SSE2__)
+void DFRobot_TMF8x01_Histogram::prepareSimd(uint32_t frames){
+  float *sub = _work;
+  float *smooth = _work + (size_t)_bins * _stride;
+  uint32_t end = (frames + SIMD_LANES - 1) / SIMD_LANES * SIMD_LANES;
+  vfloat_t zero = vset1(0);
+  vfloat_t scale = vset1(1.0f / (2 * _radius + 1));
+  for(uint16_t b = 0; b < _bins; b++){
+      const float *in = _batch + (size_t)b * _stride;
+      float *out = sub + (size_t)b * _stride;
+      vfloat_t ref = vset1(_ref[b]);
+      for(uint32_t f = 0; f < end; f += SIMD_LANES){
+          vstore(out + f, vmax(vsub(vload(in + f), ref), zero));
+      }
+  }
+  for(int b = 0; b < _bins; b++){
+      const float *rows[7];
+      for(int k = -_radius; k <= _radius; k++){
+          int i = b + k;
+          if(i < 0) i = 0;
+          if(i >= _bins) i = _bins - 1;
+          rows[k + _radius] = sub + (size_t)i * _stride;
+      }
+      float *out = smooth + (size_t)b * _stride;
+      for(uint32_t f = 0; f < end; f += SIMD_LANES){
+          vfloat_t sum = vload(rows[0] + f);
+          for(int k = 1; k <= 2 * _radius; k++) sum = vadd(sum, vload(rows[k] + f));
+          vstore(out + f, vmul(sum, scale));
+      }
+  }
+}
+
+void DFRobot_TMF8x01_Histogram::findPeaksSimd(uint32_t frames, sPeaks_t *peaks){
+  const float *smooth = _work + (size_t)_bins * _stride;
+  uint32_t end = (frames + SIMD_LANES - 1) / SIMD_LANES * SIMD_LANES;
+  vfloat_t thr = vset1(_threshold);
+  vfloat_t half = vset1(0.5f);
+  vfloat_t quarter = vset1(0.25f);
+  vfloat_t two = vset1(2.0f);
+  float offBuf[SIMD_LANES] __attribute__((aligned(32)));
+  float ampBuf[SIMD_LANES] __attribute__((aligned(32)));
+  for(uint16_t b = 1; b < _bins - 1; b++){
+      const float *l = smooth + (size_t)(b - 1) * _stride;
+      const float *c = smooth + (size_t)b * _stride;
+      const float *r = smooth + (size_t)(b + 1) * _stride;
+      for(uint32_t f = 0; f < end; f += SIMD_LANES){
+          vfloat_t vl = vload(l + f), vc = vload(c + f), vr = vload(r + f);
+          int mask = vmask(vand(vand(vcmpgt(vc, vl), vcmpge(vc, vr)), vcmpgt(vc, thr)));
+          if(mask == 0) continue;
+          vfloat_t diff = vsub(vl, vr);
+          vfloat_t off = vdiv(vmul(half, diff), vsub(vadd(vl, vr), vmul(two, vc)));
+          vstore(offBuf, off);
+          vstore(ampBuf, vsub(vc, vmul(quarter, vmul(diff, off))));
+          while(mask){
+              int lane = __builtin_ctz(mask);
+              mask &= mask - 1;
+              if((f + lane) >= frames) break;
+              addPeak(&peaks[f + lane], b + offBuf[lane], ampBuf[lane]);
+          }
+      }
+  }
+}
+#endif
+
+void DFRobot_TMF8x01_Histogram::addPeak(sPeaks_t *peaks, float bin, float amplitude){
+  int i = peaks->num;
+  if(i == HISTOGRAM_MAX_PEAKS){
+      if(amplitude <= peaks->peak[i - 1].amplitude) return;
+      i--;
+  }else{
+      peaks->num++;
+  }
+  //insertion keeps the strongest peak first.
+  while((i > 0) && (peaks->peak[i - 1].amplitude < amplitude)){
+      peaks->peak[i] = peaks->peak[i - 1];
+      i--;
+  }
+  peaks->peak[i].bin = bin;
+  peaks->peak[i].amplitude = amplitude;
+  peaks->peak[i].distanceMm = (bin - _zeroBin) * _mmPerBin;
+}
@@ -0,0 +1,135 @@
+/*!
+ * @file DFRobot_TMF8x01_Histogram.h
+ * @brief Host side processing of the raw TDC histograms read by readHistogram().
+ * @n Crosstalk/reference subtraction, smoothing, peak search with sub-bin interpolation and multi-peak report.
+ * @n Frames are processed in batches, stored in structure-of-arrays layout(all frames of bin 0, then bin 1 ...),
+ * @n so one SIMD register holds the same bin of 8(AVX2) or 4(SSE2) frames. Without SSE2 the scalar code is used.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_HISTOGRAM_H
+#define __DFROBOT_TMF8X01_HISTOGRAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class DFRobot_TMF8x01_Histogram{
+public:
+  #define HISTOGRAM_MAX_PEAKS   4
+  #define HISTOGRAM_LANES       8
+
+  typedef struct{
+      float bin;         /**< Position of the peak in bins, with sub-bin interpolation.*/
+      float distanceMm;  /**< Distance of the peak, unit mm.*/
+      float amplitude;   /**< Height of the peak after reference subtraction and smoothing.*/
+  }sPeak_t;
+
+  typedef struct{
+      uint8_t num;                         /**< Number of valid peaks.*/
+      sPeak_t peak[HISTOGRAM_MAX_PEAKS];   /**< Peaks sorted by amplitude, the strongest first.*/
+  }sPeaks_t;
+
+  /**
+   * @fn DFRobot_TMF8x01_Histogram
+   * @brief Constructor.
+   * @param bins: Number of bins of one histogram.
+   * @param capacity: The max number of frames of one batch.
+   */
+  DFRobot_TMF8x01_Histogram(uint16_t bins, uint32_t capacity);
+  ~DFRobot_TMF8x01_Histogram();
+
+  /**
+   * @fn getBatch
+   * @brief get the batch buffer, the value of bin b of frame f is at getBatch()[b * getStride() + f].
+   * @return Pointer to the batch buffer, NULL if out of memory.
+   */
+  float *getBatch();
+
+  /**
+   * @fn getStride
+   * @brief get the distance between 2 bins of one frame in the batch buffer, it is capacity rounded up to HISTOGRAM_LANES.
+   * @return stride in floats.
+   */
+  uint32_t getStride();
+
+  /**
+   * @fn setFrame
+   * @brief Copy one histogram into the batch buffer.
+   * @param index: The index of frame in the batch.
+   * @param hist: The histogram, bins values.
+   */
+  void setFrame(uint32_t index, const float *hist);
+
+  /**
+   * @fn setReference
+   * @brief Set the crosstalk/reference histogram, it is subtracted from every frame. NULL disable it.
+   * @param ref: The reference histogram, bins values.
+   */
+  void setReference(const float *ref);
+
+  /**
+   * @fn setSmoothing
+   * @brief Set the radius of the box filter, 0 disable smoothing.
+   * @param radius: 0~3, the filter width is 2 * radius + 1.
+   */
+  void setSmoothing(uint8_t radius);
+
+  /**
+   * @fn setThreshold
+   * @brief Set the min amplitude of a peak.
+   * @param threshold: min amplitude.
+   */
+  void setThreshold(float threshold);
+
+  /**
+   * @fn setDistanceScale
+   * @brief Set how to convert the bin position to distance, distance = (bin - zeroBin) * mmPerBin.
+   * @param mmPerBin: mm of one bin.
+   * @param zeroBin: The bin of distance 0.
+   */
+  void setDistanceScale(float mmPerBin, float zeroBin);
+
+  /**
+   * @fn setSimd
+   * @brief Use SIMD code or scalar code, SIMD is used by default if the compiler target has it.
+   * @param enable: false force scalar code.
+   */
+  void setSimd(bool enable);
+
+  /**
+   * @fn process
+   * @brief Process the first frames of the batch buffer.
+   * @param frames: Number of frames, no more than capacity.
+   * @param peaks: Array of frames results.
+   * @return Number of frames processed.
+   */
+  uint32_t process(uint32_t frames, sPeaks_t *peaks);
+
+protected:
+  void prepareScalar(uint32_t frames);
+  void findPeaksScalar(uint32_t frames, sPeaks_t *peaks);
+#if defined(__SSE2__)
+  void prepareSimd(uint32_t frames);
+  void findPeaksSimd(uint32_t frames, sPeaks_t *peaks);
+#endif
+  void addPeak(sPeaks_t *peaks, float bin, float amplitude);
+
+private:
+  uint16_t _bins;
+  uint32_t _stride;
+  uint8_t _radius;
+  bool _simd;
+  float _threshold;
+  float _mmPerBin;
+  float _zeroBin;
+  float *_batch;
+  float *_work;
+  float *_ref;
+};
+
+#endif
@@ -0,0 +1,44 @@
+/*!
+ * @file DFRobot_TMF8x01_LinuxBus.h
+ * @brief The driver transport on a Linux i2c-dev adapter, every register read is one write-read transaction.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_LINUXBUS_H
+#define __DFROBOT_TMF8X01_LINUXBUS_H
+
+#include "DFRobot_TMF8x01_Bus.h"
+#include "DFRobot_TMF8x01_LinuxI2C.h"
+
+class DFRobot_TMF8x01_LinuxBus: public DFRobot_TMF8x01_Bus{
+public:
+  /**
+   * @fn DFRobot_TMF8x01_LinuxBus
+   * @brief Constructor.
+   * @param i2c: The adapter, opened by its begin() before the sensors begin.
+   */
+  DFRobot_TMF8x01_LinuxBus(DFRobot_TMF8x01_LinuxI2C &i2c):_i2c(&i2c){}
+
+  void begin(){}
+  bool probe(uint8_t addr){
+    uint8_t val;
+    return _i2c->readReg(addr, 0x00, &val, 1) == 1;
+  }
+  void writeReg(uint8_t addr, uint8_t reg, const void *pBuf, size_t size){
+    _i2c->writeReg(addr, reg, pBuf, size);
+  }
+  uint8_t readReg(uint8_t addr, uint8_t reg, void *pBuf, size_t size){
+    int ret = _i2c->readReg(addr, reg, pBuf, size);
+    return (ret < 0) ? 0 : ret;
+  }
+
+private:
+  DFRobot_TMF8x01_LinuxI2C *_i2c;
+};
+
+#endif
@@ -0,0 +1,227 @@
+/*!
+ * @file DFRobot_TMF8x01_LinuxI2C.cpp
+ * @brief I2C transport for Linux gateways through /dev/i2c-N.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include "DFRobot_TMF8x01_LinuxI2C.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+DFRobot_TMF8x01_LinuxI2C::DFRobot_TMF8x01_LinuxI2C(const char *dev)
+  :_fd(-1),_ioctl(NULL),_ctx(NULL),_ioctlCount(0),_msgCount(0){
+  strncpy(_dev, dev ? dev : "", sizeof(_dev) - 1);
+  _dev[sizeof(_dev) - 1] = '\0';
+}
+
+DFRobot_TMF8x01_LinuxI2C::~DFRobot_TMF8x01_LinuxI2C(){
+  end();
+}
+
+void DFRobot_TMF8x01_LinuxI2C::setIoctl(pIoctl_t fn, void *ctx){
+  _ioctl = fn;
+  _ctx = ctx;
+}
+
+int DFRobot_TMF8x01_LinuxI2C::begin(){
+  unsigned long funcs = 0;
+  end();
+  _fd = open(_dev, O_RDWR);
+  if(_fd < 0) return -errno;
+  if(doIoctl(I2C_FUNCS, &funcs) < 0){
+      int err = -errno;
+      end();
+      return err;
+  }
+  //I2C_RDWR needs plain I2C transfers, an SMBus only adapter can not do a repeated start of any length.
+  if(!(funcs & I2C_FUNC_I2C)){
+      end();
+      return -EOPNOTSUPP;
+  }
+  _ioctlCount = 0;
+  _msgCount = 0;
+  return 0;
+}
+
+void DFRobot_TMF8x01_LinuxI2C::end(){
+  if(_fd >= 0) close(_fd);
+  _fd = -1;
+}
+
+int DFRobot_TMF8x01_LinuxI2C::doIoctl(unsigned long request, void *arg){
+  if(_ioctl) return _ioctl(_ctx, _fd, request, arg);
+  return ioctl(_fd, request, arg);
+}
+
+int DFRobot_TMF8x01_LinuxI2C::rdwr(struct i2c_msg *msgs, uint16_t num){
+  struct i2c_rdwr_ioctl_data data;
+  int ret;
+  if(_fd < 0) return -EBADF;
+  data.msgs = msgs;
+  data.nmsgs = num;
+  _ioctlCount++;
+  _msgCount += num;
+  ret = doIoctl(I2C_RDWR, &data);
+  if(ret < 0) return -errno;
+  //the adapter stopped early, the rest of the messages were not transferred.
+  if(ret != num) return -EREMOTEIO;
+  return ret;
+}
+
+int DFRobot_TMF8x01_LinuxI2C::readReg(uint8_t addr, uint8_t reg, void *pBuf, size_t size){
+  struct i2c_msg msgs[2];
+  int ret;
+  if((pBuf == NULL) || (size == 0) || (size > 0xFFFF)) return -EINVAL;
+  msgs[0].addr = addr;
+  msgs[0].flags = 0;
+  msgs[0].len = 1;
+  msgs[0].buf = &reg;
+  msgs[1].addr = addr;
+  msgs[1].flags = I2C_M_RD;
+  msgs[1].len = size;
+  msgs[1].buf = (uint8_t *)pBuf;
+  ret = rdwr(msgs, 2);
+  if(ret < 0) return ret;
+  return size;
+}
+
+int DFRobot_TMF8x01_LinuxI2C::writeReg(uint8_t addr, uint8_t reg, const void *pBuf, size_t size){
+  struct i2c_msg msg;
+  int ret;
+  if(((pBuf == NULL) && size) || (size >= 0xFFFF)) return -EINVAL;
+  _wbuf.resize(size + 1);
+  _wbuf[0] = reg;
+  if(size) memcpy(&_wbuf[1], pBuf, size);
+  msg.addr = addr;
+  msg.flags = 0;
+  msg.len = size + 1;
+  msg.buf = &_wbuf[0];
+  ret = rdwr(&msg, 1);
+  if(ret < 0) return ret;
+  return size;
+}
+
+uint16_t DFRobot_TMF8x01_LinuxI2C::msgsOf(const sTransfer_t *xfer){
+  return xfer->read ? 2 : 1;
+}
+
+int DFRobot_TMF8x01_LinuxI2C::runChunk(sTransfer_t *xfer, uint16_t num){
+  struct i2c_msg msgs[LINUXI2C_MAX_MSGS];
+  size_t wlen = 0, pos = 0;
+  uint16_t n = 0;
+  int ret;
+  //the register bytes and write data of all accesses are in one buffer, sized first so the pointers stay valid.
+  for(uint16_t i = 0; i < num; i++){
+      wlen += 1 + (xfer[i].read ? 0 : xfer[i].len);
+  }
+  _wbuf.resize(wlen);
+  for(uint16_t i = 0; i < num; i++){
+      sTransfer_t *x = &xfer[i];
+      _wbuf[pos] = x->reg;
+      msgs[n].addr = x->addr;
+      msgs[n].flags = 0;
+      msgs[n].buf = &_wbuf[pos];
+      if(x->read){
+          msgs[n++].len = 1;
+          pos += 1;
+          msgs[n].addr = x->addr;
+          msgs[n].flags = I2C_M_RD;
+          msgs[n].len = x->len;
+          msgs[n++].buf = x->buf;
+      }else{
+          if(x->len) memcpy(&_wbuf[pos + 1], x->buf, x->len);
+          msgs[n++].len = x->len + 1;
+          pos += x->len + 1;
+      }
+  }
+  ret = rdwr(msgs, n);
+  if(ret < 0) return ret;
+  for(uint16_t i = 0; i < num; i++) xfer[i].result = xfer[i].len;
+  return num;
+}
+
+int DFRobot_TMF8x01_LinuxI2C::recover(sTransfer_t *xfer, uint16_t num){
+  uint8_t alive[16];
+  uint8_t probe;
+  int ok = 0;
+  memset(alive, 0, sizeof(alive));
+  //the kernel stops at the failing message: the writes before it are done, the reads have no data(i2c-dev copies
+  //read data only on success), the accesses after it were not started. Find it without writing anything again.
+  for(uint16_t i = 0; i < num; i++){
+      sTransfer_t *x = &xfer[i];
+      int r;
+      if(x->read){
+          r = runChunk(x, 1);
+      }else if(alive[x->addr >> 3] & (1 << (x->addr & 7))){
+          r = 1;
+      }else{
+          //a read of the same register tells whether the address answers, the write is not repeated.
+          r = readReg(x->addr, x->reg, &probe, 1);
+          if(r > 0) r = 1;
+      }
+      if(r != 1){
+          x->result = r;
+          return ok + transfer(&xfer[i + 1], num - i - 1);
+      }
+      alive[x->addr >> 3] |= 1 << (x->addr & 7);
+      x->result = x->len;
+      ok++;
+  }
+  //every address answers now, the batch failed for another reason: the writes may or may not have been done.
+  for(uint16_t i = 0; i < num; i++){
+      if(xfer[i].read) continue;
+      xfer[i].result = -EIO;
+      ok--;
+  }
+  return ok;
+}
+
+int DFRobot_TMF8x01_LinuxI2C::transfer(sTransfer_t *xfer, uint16_t num){
+  uint16_t start = 0;
+  int ok = 0;
+  if(xfer == NULL) return 0;
+  while(start < num){
+      uint16_t count = 0, msgs = 0;
+      while(((start + count) < num) && ((msgs + msgsOf(&xfer[start + count])) <= LINUXI2C_MAX_MSGS)){
+          if((xfer[start + count].buf == NULL) && xfer[start + count].len){
+              break;
+          }
+          msgs += msgsOf(&xfer[start + count]);
+          count++;
+      }
+      if(count == 0){
+          xfer[start].result = -EINVAL;
+          start++;
+          continue;
+      }
+      int ret = runChunk(&xfer[start], count);
+      if(ret == count){
+          ok += count;
+      }else if(count == 1){
+          xfer[start].result = ret;
+      }else{
+          //one access of the batch failed, usually a sensor which is gone. The others keep their data.
+          ok += recover(&xfer[start], count);
+      }
+      start += count;
+  }
+  return ok;
+}
+
+uint32_t DFRobot_TMF8x01_LinuxI2C::getIoctlCount(){
+  return _ioctlCount;
+}
+
+uint32_t DFRobot_TMF8x01_LinuxI2C::getMsgCount(){
+  return _msgCount;
+}
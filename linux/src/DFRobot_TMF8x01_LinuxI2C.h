@@ -0,0 +1,140 @@
+/*!
+ * @file DFRobot_TMF8x01_LinuxI2C.h
+ * @brief I2C transport for Linux gateways through /dev/i2c-N. A register read is one I2C_RDWR ioctl with two messages
+ * @n (register address write, repeated start, data read), so no other master can get between them. Several register
+ * @n accesses, even of different sensors, are batched into one ioctl. Short transfers are reported as errors.
+ * @n The ioctl can be replaced by a hook, so the transport runs against a fake device without I2C hardware.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_LINUXI2C_H
+#define __DFROBOT_TMF8X01_LINUXI2C_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+struct i2c_msg;
+
+class DFRobot_TMF8x01_LinuxI2C{
+public:
+  #define LINUXI2C_MAX_MSGS     42      //I2C_RDWR_IOCTL_MAX_MSGS of the kernel
+
+  /**
+   * @brief The type of ioctl hook function, the same as ioctl(fd, request, arg) with a user pointer.
+   * @return The same as ioctl: >= 0 on success, -1 and errno on error.
+   */
+  typedef int (*pIoctl_t)(void *ctx, int fd, unsigned long request, void *arg);
+
+  /**
+   * @struct sTransfer_t
+   * @brief One register access of a batch.
+   */
+  typedef struct{
+      uint8_t addr;      /**< 7 bits I2C address of the sensor*/
+      uint8_t reg;       /**< The first register*/
+      bool read;         /**< true: read len bytes from reg, false: write len bytes to reg*/
+      uint8_t *buf;      /**< The data*/
+      uint16_t len;      /**< The length of data*/
+      int result;        /**< set by transfer(): bytes transferred, or -errno*/
+  }sTransfer_t;
+
+  /**
+   * @fn DFRobot_TMF8x01_LinuxI2C
+   * @brief Constructor.
+   * @param dev: The i2c-dev device file, such as "/dev/i2c-1".
+   */
+  DFRobot_TMF8x01_LinuxI2C(const char *dev = "/dev/i2c-1");
+  ~DFRobot_TMF8x01_LinuxI2C();
+
+  /**
+   * @fn setIoctl
+   * @brief Replace ioctl() by a hook, call it before begin().
+   * @param fn: The hook function, NULL means ioctl().
+   * @param ctx: The user pointer passed to the hook.
+   */
+  void setIoctl(pIoctl_t fn, void *ctx = NULL);
+
+  /**
+   * @fn begin
+   * @brief Open the device file and check that the adapter supports combined transfers.
+   * @return 0: success, -errno: failed.
+   */
+  int begin();
+
+  /**
+   * @fn end
+   * @brief Close the device file.
+   */
+  void end();
+
+  /**
+   * @fn readReg
+   * @brief Read registers by a write-read transaction with repeated start.
+   * @param addr: 7 bits I2C address.
+   * @param reg: The first register.
+   * @param pBuf: Pointer to store the data.
+   * @param size: The length of data.
+   * @return size: success, -errno: failed, no part of pBuf is valid.
+   */
+  int readReg(uint8_t addr, uint8_t reg, void *pBuf, size_t size);
+
+  /**
+   * @fn writeReg
+   * @brief Write registers by one write message.
+   * @param addr: 7 bits I2C address.
+   * @param reg: The first register.
+   * @param pBuf: Pointer to the data.
+   * @param size: The length of data.
+   * @return size: success, -errno: failed.
+   */
+  int writeReg(uint8_t addr, uint8_t reg, const void *pBuf, size_t size);
+
+  /**
+   * @fn transfer
+   * @brief Run several register accesses, they are packed into as few ioctls as possible in the order of the list.
+   * @n If an ioctl fails, the failing access is found by running the reads again and probing the address of the
+   * @n writes, a write is never sent twice: the writes before the failing access keep their result, the accesses
+   * @n after it are run again. If no access fails alone, the writes of that ioctl are -EIO(not known whether done).
+   * @param xfer: The list of accesses, result of every access is set.
+   * @param num: The number of accesses.
+   * @return The number of accesses which succeeded.
+   */
+  int transfer(sTransfer_t *xfer, uint16_t num);
+
+  /**
+   * @fn getIoctlCount
+   * @brief get the number of I2C_RDWR ioctls since begin(), for benchmarks.
+   * @return The number of ioctls.
+   */
+  uint32_t getIoctlCount();
+
+  /**
+   * @fn getMsgCount
+   * @brief get the number of I2C messages(a start condition and an address byte each) since begin().
+   * @return The number of messages.
+   */
+  uint32_t getMsgCount();
+
+private:
+  int doIoctl(unsigned long request, void *arg);
+  int rdwr(struct i2c_msg *msgs, uint16_t num);
+  uint16_t msgsOf(const sTransfer_t *xfer);
+  int runChunk(sTransfer_t *xfer, uint16_t num);
+  int recover(sTransfer_t *xfer, uint16_t num);
+
+  char _dev[64];
+  int _fd;
+  pIoctl_t _ioctl;
+  void *_ctx;
+  uint32_t _ioctlCount;
+  uint32_t _msgCount;
+  std::vector<uint8_t> _wbuf;
+};
+
+#endif
@@ -0,0 +1,253 @@
+/*!
+ * @file DFRobot_TMF8x01_LinuxInt.cpp
+ * @brief The INT pin of a sensor on Linux, through the GPIO character device.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include "DFRobot_TMF8x01_LinuxInt.h"
+#include "DFRobot_TMF8x01_Latency.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+#define LINUXINT_CONSUMER   "tmf8x01-int"
+#define LINUXINT_READ_EVENTS 16
+
+static uint64_t monotonicNs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+//the time of a v1 event is CLOCK_REALTIME before Linux 5.7 and CLOCK_MONOTONIC since, the two are decades apart,
+//so the clock closer to it is the one of the kernel, a CLOCK_REALTIME time is moved to CLOCK_MONOTONIC.
+static uint64_t v1EventNs(uint64_t ts){
+  struct timespec rt;
+  uint64_t mono = monotonicNs(), real;
+  clock_gettime(CLOCK_REALTIME, &rt);
+  real = (uint64_t)rt.tv_sec * 1000000000ULL + rt.tv_nsec;
+  if(((ts > mono) ? ts - mono : mono - ts) <= ((ts > real) ? ts - real : real - ts)) return ts;
+  return ts + mono - real;
+}
+
+DFRobot_TMF8x01_LinuxInt::DFRobot_TMF8x01_LinuxInt(const char *chip, uint32_t line, bool pullUp)
+  :_line(line),_pullUp(pullUp),_source(eIntNone),_fd(-1),_epfd(-1),_lastNs(0),_events(0),_wakeups(0){
+  strncpy(_chip, chip ? chip : "", sizeof(_chip) - 1);
+  _chip[sizeof(_chip) - 1] = '\0';
+}
+
+DFRobot_TMF8x01_LinuxInt::~DFRobot_TMF8x01_LinuxInt(){
+  end();
+}
+
+int DFRobot_TMF8x01_LinuxInt::begin(){
+  struct gpio_v2_line_request req;
+  int chip, err;
+  end();
+  chip = open(_chip, O_RDWR | O_CLOEXEC);
+  if(chip < 0) return -errno;
+
+  memset(&req, 0, sizeof(req));
+  req.offsets[0] = _line;
+  req.num_lines = 1;
+  strncpy(req.consumer, LINUXINT_CONSUMER, sizeof(req.consumer) - 1);
+  req.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_FALLING;
+  if(_pullUp) req.config.flags |= GPIO_V2_LINE_FLAG_BIAS_PULL_UP;
+  if(ioctl(chip, GPIO_V2_GET_LINE_IOCTL, &req) == 0){
+      _fd = req.fd;
+      _source = eIntGpioV2;
+  }else if((errno == ENOTTY) || (errno == EINVAL)){
+      //kernel before 5.10, the v1 interface has no bias setting.
+      struct gpioevent_request ev;
+      memset(&ev, 0, sizeof(ev));
+      ev.lineoffset = _line;
+      ev.handleflags = GPIOHANDLE_REQUEST_INPUT;
+      ev.eventflags = GPIOEVENT_REQUEST_FALLING_EDGE;
+      strncpy(ev.consumer_label, LINUXINT_CONSUMER, sizeof(ev.consumer_label) - 1);
+      if(ioctl(chip, GPIO_GET_LINEEVENT_IOCTL, &ev) == 0){
+          _fd = ev.fd;
+          _source = eIntGpioV1;
+      }
+  }
+  err = errno;
+  //the line stays requested through its own fd.
+  close(chip);
+  if(_fd < 0) return -err;
+  fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) | O_NONBLOCK);
+  return addEpoll();
+}
+
+int DFRobot_TMF8x01_LinuxInt::beginEventfd(){
+  end();
+  _fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(_fd < 0) return -errno;
+  _source = eIntEventfd;
+  return addEpoll();
+}
+
+int DFRobot_TMF8x01_LinuxInt::addEpoll(){
+  struct epoll_event ev;
+  int err;
+  _epfd = epoll_create1(EPOLL_CLOEXEC);
+  if(_epfd < 0){
+      err = -errno;
+      end();
+      return err;
+  }
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.fd = _fd;
+  if(epoll_ctl(_epfd, EPOLL_CTL_ADD, _fd, &ev) < 0){
+      err = -errno;
+      end();
+      return err;
+  }
+  _lastNs = 0;
+  _events = 0;
+  _wakeups = 0;
+  return 0;
+}
+
+void DFRobot_TMF8x01_LinuxInt::end(){
+  if(_epfd >= 0) close(_epfd);
+  if(_fd >= 0) close(_fd);
+  _epfd = -1;
+  _fd = -1;
+  _source = eIntNone;
+}
+
+int DFRobot_TMF8x01_LinuxInt::getFd(){
+  return _fd;
+}
+
+DFRobot_TMF8x01_LinuxInt::eIntSource_t DFRobot_TMF8x01_LinuxInt::getSource(){
+  return _source;
+}
+
+int DFRobot_TMF8x01_LinuxInt::wait(int timeoutMs){
+  struct epoll_event ev;
+  int ret;
+  if(_epfd < 0) return -EBADF;
+  ret = epoll_wait(_epfd, &ev, 1, timeoutMs);
+  if(ret < 0){
+      //a signal is not an error of the line, the caller checks again.
+      if(errno == EINTR) return 0;
+      return -errno;
+  }
+  if(ret > 0) _wakeups++;
+  return ret;
+}
+
+int DFRobot_TMF8x01_LinuxInt::consume(){
+  int n = 0;
+  ssize_t ret;
+  switch(_source){
+      case eIntGpioV2:{
+           struct gpio_v2_line_event ev[LINUXINT_READ_EVENTS];
+           while((ret = ::read(_fd, ev, sizeof(ev))) > 0){
+               int k = ret / sizeof(ev[0]);
+               if(k) _lastNs = ev[k - 1].timestamp_ns;
+               n += k;
+           }
+           break;
+      }
+      case eIntGpioV1:{
+           struct gpioevent_data ev[LINUXINT_READ_EVENTS];
+           while((ret = ::read(_fd, ev, sizeof(ev))) > 0){
+               int k = ret / sizeof(ev[0]);
+               if(k) _lastNs = v1EventNs(ev[k - 1].timestamp);
+               n += k;
+           }
+           break;
+      }
+      case eIntEventfd:{
+           uint64_t count;
+           //the counter holds all triggers since the last read.
+           ret = ::read(_fd, &count, sizeof(count));
+           if(ret == sizeof(count)){
+               _lastNs = monotonicNs();
+               n = count;
+           }
+           break;
+      }
+      default:
+           return -EBADF;
+  }
+  if((ret < 0) && (errno != EAGAIN)) return -errno;
+  _events += n;
+  return n;
+}
+
+int DFRobot_TMF8x01_LinuxInt::read(){
+  switch(_source){
+      case eIntGpioV2:{
+           struct gpio_v2_line_values v;
+           v.bits = 0;
+           v.mask = 1;
+           if(ioctl(_fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &v) < 0) return -errno;
+           return (v.bits & 1) ? HIGH : LOW;
+      }
+      case eIntGpioV1:{
+           struct gpiohandle_data d;
+           memset(&d, 0, sizeof(d));
+           if(ioctl(_fd, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &d) < 0) return -errno;
+           return d.values[0] ? HIGH : LOW;
+      }
+      case eIntEventfd:
+           return -EOPNOTSUPP;
+      default:
+           return -EBADF;
+  }
+}
+
+int DFRobot_TMF8x01_LinuxInt::trigger(){
+  uint64_t one = 1;
+  if(_source != eIntEventfd) return (_fd < 0) ? -EBADF : -EOPNOTSUPP;
+  if(::write(_fd, &one, sizeof(one)) != sizeof(one)) return -errno;
+  return 0;
+}
+
+bool DFRobot_TMF8x01_LinuxInt::waitDataReady(DFRobot_TMF8x01 &tof, int timeoutMs){
+  uint64_t start = monotonicNs();
+  int remain = timeoutMs;
+  while(1){
+      //INT is cleared by the driver after the result is read, a result in between gives no new edge.
+      if(tof.isDataReady()) return true;
+      if(timeoutMs >= 0){
+          remain = timeoutMs - (int)((monotonicNs() - start) / 1000000);
+          if(remain <= 0) return false;
+      }
+      int ret = wait(remain);
+      if(ret < 0) return false;
+      if(ret > 0){
+          consume();
+#if TMF8x01_USE_LATENCY
+          //the kernel time of the edge, CLOCK_MONOTONIC as micros().
+          if(tof.getLatency()) tof.getLatency()->onInt(_lastNs / 1000);
+#endif
+      }
+  }
+}
+
+uint64_t DFRobot_TMF8x01_LinuxInt::getLastEventNs(){
+  return _lastNs;
+}
+
+uint32_t DFRobot_TMF8x01_LinuxInt::getEventCount(){
+  return _events;
+}
+
+uint32_t DFRobot_TMF8x01_LinuxInt::getWakeupCount(){
+  return _wakeups;
+}
@@ -0,0 +1,147 @@
+/*!
+ * @file DFRobot_TMF8x01_LinuxInt.h
+ * @brief The INT pin of a sensor on Linux, through the GPIO character device(/dev/gpiochipN). The line is requested
+ * @n with falling edge events, the kernel timestamps every edge and the file descriptor becomes readable, so the
+ * @n program sleeps in epoll_wait()/poll() until the sensor has a result instead of polling the bus.
+ * @n The GPIO v2 interface(Linux 5.10) is used, the v1 line event interface when v2 is missing.
+ * @n beginEventfd() replaces the GPIO by an eventfd which trigger() makes readable, to test without GPIO hardware.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_LINUXINT_H
+#define __DFROBOT_TMF8X01_LINUXINT_H
+
+#include <stdint.h>
+#include "DFRobot_TMF8x01.h"
+
+class DFRobot_TMF8x01_LinuxInt{
+public:
+  typedef enum{
+      eIntNone = 0,      /**< not started*/
+      eIntGpioV2,        /**< GPIO v2 line request*/
+      eIntGpioV1,        /**< GPIO v1 line event request*/
+      eIntEventfd,       /**< eventfd stand-in*/
+  }eIntSource_t;
+
+  /**
+   * @fn DFRobot_TMF8x01_LinuxInt
+   * @brief Constructor.
+   * @param chip: The GPIO chip, such as "/dev/gpiochip0".
+   * @param line: The line offset of the INT pin on the chip.
+   * @param pullUp: true: enable the internal pull-up of the line(v2 only), INT of the sensor is open drain.
+   */
+  DFRobot_TMF8x01_LinuxInt(const char *chip = "/dev/gpiochip0", uint32_t line = 0, bool pullUp = true);
+  ~DFRobot_TMF8x01_LinuxInt();
+
+  /**
+   * @fn begin
+   * @brief Request the line as input with falling edge events.
+   * @return 0: success, -errno: failed.
+   */
+  int begin();
+
+  /**
+   * @fn beginEventfd
+   * @brief Use an eventfd instead of the GPIO line, every trigger() is one edge.
+   * @return 0: success, -errno: failed.
+   */
+  int beginEventfd();
+
+  /**
+   * @fn end
+   * @brief Release the line.
+   */
+  void end();
+
+  /**
+   * @fn getFd
+   * @brief get the file descriptor, it is readable while edges are pending. Add it to an own epoll set with EPOLLIN.
+   * @return The file descriptor, -1 before begin().
+   */
+  int getFd();
+
+  /**
+   * @fn getSource
+   * @return The source of the events, see eIntSource_t.
+   */
+  eIntSource_t getSource();
+
+  /**
+   * @fn wait
+   * @brief Sleep until an edge is pending.
+   * @param timeoutMs: -1 waits forever.
+   * @return 1: edge pending, 0: timeout, -errno: failed.
+   */
+  int wait(int timeoutMs);
+
+  /**
+   * @fn consume
+   * @brief Read the pending edges, so the file descriptor is not readable any more.
+   * @return The number of edges, 0: none, -errno: failed.
+   */
+  int consume();
+
+  /**
+   * @fn read
+   * @brief Read the level of the line.
+   * @return HIGH, LOW, or -errno. The eventfd has no level, -EOPNOTSUPP.
+   */
+  int read();
+
+  /**
+   * @fn trigger
+   * @brief Make the eventfd readable, like a falling edge.
+   * @return 0: success, -EOPNOTSUPP on a GPIO line, -errno: failed.
+   */
+  int trigger();
+
+  /**
+   * @fn waitDataReady
+   * @brief Sleep until the sensor has a new result, then read it by isDataReady().
+   * @n The sensor is checked before sleeping, an edge lost while INT was still low does not block. Enable the INT
+   * @n pin of the sensor by enableIntPin() first. The time of the edge goes to the tracker of tof.setLatency().
+   * @param tof: The sensor.
+   * @param timeoutMs: -1 waits forever.
+   * @return true: getDistance_mm() has the new result, false: timeout or error.
+   */
+  bool waitDataReady(DFRobot_TMF8x01 &tof, int timeoutMs);
+
+  /**
+   * @fn getLastEventNs
+   * @brief get the time of the last edge, CLOCK_MONOTONIC in ns. The kernel time of the edge on a GPIO line,
+   * @n the time of consume() on the eventfd.
+   */
+  uint64_t getLastEventNs();
+
+  /**
+   * @fn getEventCount
+   * @brief get the number of edges since begin().
+   */
+  uint32_t getEventCount();
+
+  /**
+   * @fn getWakeupCount
+   * @brief get the number of times wait() returned with an edge, for benchmarks.
+   */
+  uint32_t getWakeupCount();
+
+private:
+  int addEpoll();
+
+  char _chip[64];
+  uint32_t _line;
+  bool _pullUp;
+  eIntSource_t _source;
+  int _fd;
+  int _epfd;
+  uint64_t _lastNs;
+  uint32_t _events;
+  uint32_t _wakeups;
+};
+
+#endif
@@ -0,0 +1,508 @@
+/*!
+ * @file DFRobot_TMF8x01_Recorder.cpp
+ * @brief Bus traffic recorder and replay bus.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include "DFRobot_TMF8x01_Recorder.h"
+#include <errno.h>
+
+#define REC_TIME_INLINE   15        //bits 4..7 of the first byte, 15: a varint follows
+#define REC_IO_BUFFER     65536
+
+static size_t putVarint(uint8_t *p, uint64_t v){
+  size_t n = 0;
+  while(v >= 0x80){
+      p[n++] = (v & 0x7F) | 0x80;
+      v >>= 7;
+  }
+  p[n++] = v;
+  return n;
+}
+
+static bool getVarint(const uint8_t *p, size_t size, size_t *pos, uint64_t *v){
+  uint64_t x = 0;
+  for(int shift = 0; shift < 64; shift += 7){
+      if(*pos >= size) return false;
+      uint8_t b = p[(*pos)++];
+      x |= (uint64_t)(b & 0x7F) << shift;
+      if(!(b & 0x80)){
+          *v = x;
+          return true;
+      }
+  }
+  return false;
+}
+
+static uint64_t recMicros(void *ctx){
+  return ((DFRobot_TMF8x01_Recorder *)ctx)->clock();
+}
+
+static void recDelayUs(void *ctx, uint32_t us){
+  ((DFRobot_TMF8x01_Recorder *)ctx)->delayUs(us);
+}
+
+static void recPinMode(void *ctx, uint8_t pin, uint8_t mode){
+  ((DFRobot_TMF8x01_Recorder *)ctx)->pinMode(pin, mode);
+}
+
+static void recDigitalWrite(void *ctx, uint8_t pin, uint8_t val){
+  ((DFRobot_TMF8x01_Recorder *)ctx)->pinWrite(pin, val);
+}
+
+static int recDigitalRead(void *ctx, uint8_t pin){
+  return ((DFRobot_TMF8x01_Recorder *)ctx)->pinRead(pin);
+}
+
+DFRobot_TMF8x01_Recorder::DFRobot_TMF8x01_Recorder(DFRobot_TMF8x01_Bus &bus)
+  :_pBus(&bus),_fp(NULL),_attached(false),_last(0),_records(0),_size(0){
+  getArduinoHooks(&_prev);
+}
+
+DFRobot_TMF8x01_Recorder::~DFRobot_TMF8x01_Recorder(){
+  close();
+}
+
+int DFRobot_TMF8x01_Recorder::open(const char *path){
+  uint8_t header[REC_HEADER_SIZE];
+  uint32_t magic = REC_MAGIC;
+  uint16_t version = REC_VERSION, flags = 0;
+
+  close();
+  _fp = fopen(path, "wb");
+  if(!_fp) return -errno;
+  setvbuf(_fp, NULL, _IOFBF, REC_IO_BUFFER);
+  if(!_attached) getArduinoHooks(&_prev);
+  _last = _prev.micros(_prev.ctx);
+  memcpy(header, &magic, 4);
+  memcpy(header + 4, &version, 2);
+  memcpy(header + 6, &flags, 2);
+  memcpy(header + 8, &_last, 8);
+  if(fwrite(header, 1, sizeof(header), _fp) != sizeof(header)){
+      int err = errno;
+      fclose(_fp);
+      _fp = NULL;
+      return -err;
+  }
+  _records = 0;
+  _size = sizeof(header);
+  return 0;
+}
+
+void DFRobot_TMF8x01_Recorder::close(){
+  detach();
+  if(_fp){
+      fclose(_fp);
+      _fp = NULL;
+  }
+}
+
+void DFRobot_TMF8x01_Recorder::attach(){
+  sArduinoHooks_t hooks;
+  if(_attached) return;
+  getArduinoHooks(&_prev);
+  hooks.micros = recMicros;
+  hooks.delayUs = recDelayUs;
+  hooks.pinMode = recPinMode;
+  hooks.digitalWrite = recDigitalWrite;
+  hooks.digitalRead = recDigitalRead;
+  hooks.ctx = this;
+  setArduinoHooks(&hooks);
+  _attached = true;
+}
+
+void DFRobot_TMF8x01_Recorder::detach(){
+  if(!_attached) return;
+  setArduinoHooks(&_prev);
+  _attached = false;
+}
+
+uint32_t DFRobot_TMF8x01_Recorder::getRecordCount(){
+  return _records;
+}
+
+uint64_t DFRobot_TMF8x01_Recorder::getLogSize(){
+  return _size;
+}
+
+void DFRobot_TMF8x01_Recorder::record(eRecType_t type, uint64_t t, const uint8_t *head, size_t headLen, const void *data, size_t dataLen){
+  uint8_t buf[1 + 10 + 32];
+  size_t n;
+  //a clock stepped back by the caller's hooks is written as no time passed.
+  uint64_t dt = (t > _last) ? (t - _last) : 0;
+
+  if(!_fp) return;
+  _last += dt;
+  if(dt < REC_TIME_INLINE){
+      buf[0] = type | (dt << 4);
+      n = 1;
+  }else{
+      buf[0] = type | (REC_TIME_INLINE << 4);
+      n = 1 + putVarint(buf + 1, dt - REC_TIME_INLINE);
+  }
+  memcpy(buf + n, head, headLen);
+  n += headLen;
+  fwrite(buf, 1, n, _fp);
+  if(dataLen) fwrite(data, 1, dataLen, _fp);
+  _size += n + dataLen;
+  _records++;
+}
+
+void DFRobot_TMF8x01_Recorder::begin(){
+  _pBus->begin();
+  record(eRecBegin, _prev.micros(_prev.ctx), NULL, 0, NULL, 0);
+}
+
+bool DFRobot_TMF8x01_Recorder::probe(uint8_t addr){
+  bool ack = _pBus->probe(addr);
+  uint8_t head[2] = {addr, (uint8_t)ack};
+  record(eRecProbe, _prev.micros(_prev.ctx), head, sizeof(head), NULL, 0);
+  return ack;
+}
+
+void DFRobot_TMF8x01_Recorder::writeReg(uint8_t addr, uint8_t reg, const void *pBuf, size_t size){
+  uint8_t head[2 + 10];
+  size_t n;
+  _pBus->writeReg(addr, reg, pBuf, size);
+  head[0] = addr;
+  head[1] = reg;
+  n = 2 + putVarint(head + 2, size);
+  record(eRecWrite, _prev.micros(_prev.ctx), head, n, pBuf, size);
+}
+
+uint8_t DFRobot_TMF8x01_Recorder::readReg(uint8_t addr, uint8_t reg, void *pBuf, size_t size){
+  uint8_t head[2 + 10 + 10];
+  size_t n;
+  uint8_t got = _pBus->readReg(addr, reg, pBuf, size);
+  head[0] = addr;
+  head[1] = reg;
+  n = 2 + putVarint(head + 2, size);
+  n += putVarint(head + n, got);
+  record(eRecRead, _prev.micros(_prev.ctx), head, n, pBuf, got);
+  return got;
+}
+
+uint64_t DFRobot_TMF8x01_Recorder::clock(){
+  uint64_t t = _prev.micros(_prev.ctx);
+  record(eRecClock, t, NULL, 0, NULL, 0);
+  return t;
+}
+
+void DFRobot_TMF8x01_Recorder::delayUs(uint32_t us){
+  //not recorded, the time of the next record shows it.
+  _prev.delayUs(_prev.ctx, us);
+}
+
+void DFRobot_TMF8x01_Recorder::pinMode(uint8_t pin, uint8_t mode){
+  _prev.pinMode(_prev.ctx, pin, mode);
+}
+
+void DFRobot_TMF8x01_Recorder::pinWrite(uint8_t pin, uint8_t val){
+  uint8_t head[2] = {pin, val};
+  _prev.digitalWrite(_prev.ctx, pin, val);
+  record(eRecPinWrite, _prev.micros(_prev.ctx), head, sizeof(head), NULL, 0);
+}
+
+int DFRobot_TMF8x01_Recorder::pinRead(uint8_t pin){
+  int val = _prev.digitalRead(_prev.ctx, pin);
+  uint8_t head[2] = {pin, (uint8_t)val};
+  record(eRecPinRead, _prev.micros(_prev.ctx), head, sizeof(head), NULL, 0);
+  return val;
+}
+
+static uint64_t replayMicros(void *ctx){
+  return ((DFRobot_TMF8x01_ReplayBus *)ctx)->clock();
+}
+
+static void replayDelayUs(void *ctx, uint32_t us){
+  ((DFRobot_TMF8x01_ReplayBus *)ctx)->advance(us);
+}
+
+static void replayPinMode(void *ctx, uint8_t pin, uint8_t mode){
+  (void)ctx; (void)pin; (void)mode;
+}
+
+static void replayDigitalWrite(void *ctx, uint8_t pin, uint8_t val){
+  ((DFRobot_TMF8x01_ReplayBus *)ctx)->pinWrite(pin, val);
+}
+
+static int replayDigitalRead(void *ctx, uint8_t pin){
+  return ((DFRobot_TMF8x01_ReplayBus *)ctx)->pinRead(pin);
+}
+
+DFRobot_TMF8x01_ReplayBus::DFRobot_TMF8x01_ReplayBus()
+  :_start(0),_now(0),_recTime(0),_end(0),_pos(0),_index(0),_mismatch(0),_stopped(true){
+}
+
+int DFRobot_TMF8x01_ReplayBus::load(const char *path){
+  std::vector<uint8_t> buf;
+  uint8_t chunk[REC_IO_BUFFER];
+  size_t n;
+  FILE *fp = fopen(path, "rb");
+  if(!fp) return -errno;
+  while((n = fread(chunk, 1, sizeof(chunk), fp)) > 0){
+      buf.insert(buf.end(), chunk, chunk + n);
+  }
+  if(ferror(fp)){
+      int err = errno;
+      fclose(fp);
+      return -err;
+  }
+  fclose(fp);
+  return load(buf.data(), buf.size());
+}
+
+int DFRobot_TMF8x01_ReplayBus::load(const void *log, size_t size){
+  const uint8_t *p = (const uint8_t *)log;
+  uint32_t magic;
+  uint16_t version;
+  sRecRecord_t r;
+  size_t pos, next;
+  uint64_t t;
+
+  _log.clear();
+  _stopped = true;
+  if(size < REC_HEADER_SIZE) return -EPROTO;
+  memcpy(&magic, p, 4);
+  memcpy(&version, p + 4, 2);
+  if((magic != REC_MAGIC) || (version != REC_VERSION)) return -EPROTO;
+  _log.assign(p, p + size);
+  memcpy(&_start, p + 8, 8);
+  //a recording cut off by a crash keeps the records before the broken one.
+  pos = REC_HEADER_SIZE;
+  t = _start;
+  while(peek(pos, t, &r, &next)){
+      pos = next;
+      t = r.timeUs;
+  }
+  _log.resize(pos);
+  _end = t;
+  rewind();
+  return 0;
+}
+
+void DFRobot_TMF8x01_ReplayBus::rewind(){
+  _pos = REC_HEADER_SIZE;
+  _now = _recTime = _start;
+  _index = 0;
+  _mismatch = 0;
+  _stopped = _log.empty();
+}
+
+void DFRobot_TMF8x01_ReplayBus::attach(){
+  sArduinoHooks_t hooks;
+  hooks.micros = replayMicros;
+  hooks.delayUs = replayDelayUs;
+  hooks.pinMode = replayPinMode;
+  hooks.digitalWrite = replayDigitalWrite;
+  hooks.digitalRead = replayDigitalRead;
+  hooks.ctx = this;
+  setArduinoHooks(&hooks);
+}
+
+uint64_t DFRobot_TMF8x01_ReplayBus::now(){
+  return _now;
+}
+
+bool DFRobot_TMF8x01_ReplayBus::isEnd(){
+  return _stopped || (_pos >= _log.size());
+}
+
+uint32_t DFRobot_TMF8x01_ReplayBus::getPosition(){
+  return _index;
+}
+
+uint32_t DFRobot_TMF8x01_ReplayBus::getMismatchCount(){
+  return _mismatch;
+}
+
+uint64_t DFRobot_TMF8x01_ReplayBus::getDurationUs(){
+  return _end - _start;
+}
+
+bool DFRobot_TMF8x01_ReplayBus::peek(size_t pos, uint64_t t, sRecRecord_t *r, size_t *next){
+  const uint8_t *p = _log.data();
+  size_t size = _log.size();
+  uint64_t dt, v;
+
+  if(pos >= size) return false;
+  r->type = (eRecType_t)(p[pos] & 0x0F);
+  dt = p[pos++] >> 4;
+  if(dt == REC_TIME_INLINE){
+      if(!getVarint(p, size, &pos, &v)) return false;
+      dt += v;
+  }
+  r->timeUs = t + dt;
+  r->addr = r->reg = 0;
+  r->len = r->got = 0;
+  r->data = NULL;
+  switch(r->type){
+      case eRecBegin:
+      case eRecClock:
+          break;
+      case eRecProbe:
+      case eRecPinWrite:
+      case eRecPinRead:
+          if(pos + 2 > size) return false;
+          r->addr = p[pos];
+          r->reg = p[pos + 1];
+          pos += 2;
+          break;
+      case eRecWrite:
+      case eRecRead:
+          if(pos + 2 > size) return false;
+          r->addr = p[pos];
+          r->reg = p[pos + 1];
+          pos += 2;
+          if(!getVarint(p, size, &pos, &v) || (v > 0xFFFF)) return false;
+          r->len = r->got = v;
+          if(r->type == eRecRead){
+              if(!getVarint(p, size, &pos, &v) || (v > r->len)) return false;
+              r->got = v;
+          }
+          if(pos + r->got > size) return false;
+          r->data = p + pos;
+          pos += r->got;
+          break;
+      default:
+          return false;
+  }
+  *next = pos;
+  return true;
+}
+
+bool DFRobot_TMF8x01_ReplayBus::peekBus(eRecType_t type, sRecRecord_t *r, size_t *next){
+  if(_stopped) return false;
+  //the clock and GPIO records the program in replay did not ask for are passed over, only the bus has to match.
+  while(peek(_pos, _recTime, r, next)){
+      if((r->type != eRecClock) && (r->type != eRecPinWrite) && (r->type != eRecPinRead)){
+          if(r->type == type) return true;
+          break;
+      }
+      consume(*r, *next);
+  }
+  mismatch();
+  return false;
+}
+
+void DFRobot_TMF8x01_ReplayBus::consume(const sRecRecord_t &r, size_t next){
+  _pos = next;
+  _recTime = r.timeUs;
+  if(r.timeUs > _now) _now = r.timeUs;
+  _index++;
+}
+
+void DFRobot_TMF8x01_ReplayBus::mismatch(){
+  _mismatch++;
+  _stopped = true;
+}
+
+void DFRobot_TMF8x01_ReplayBus::begin(){
+  sRecRecord_t r;
+  size_t next;
+  if(peekBus(eRecBegin, &r, &next)) consume(r, next);
+}
+
+bool DFRobot_TMF8x01_ReplayBus::probe(uint8_t addr){
+  sRecRecord_t r;
+  size_t next;
+  if(!peekBus(eRecProbe, &r, &next)) return false;
+  if(r.addr != addr){
+      mismatch();
+      return false;
+  }
+  consume(r, next);
+  return r.reg != 0;
+}
+
+void DFRobot_TMF8x01_ReplayBus::writeReg(uint8_t addr, uint8_t reg, const void *pBuf, size_t size){
+  sRecRecord_t r;
+  size_t next;
+  if(!peekBus(eRecWrite, &r, &next)) return;
+  if((r.addr != addr) || (r.reg != reg) || (r.len != size) || memcmp(r.data, pBuf, size)){
+      mismatch();
+      return;
+  }
+  consume(r, next);
+}
+
+uint8_t DFRobot_TMF8x01_ReplayBus::readReg(uint8_t addr, uint8_t reg, void *pBuf, size_t size){
+  sRecRecord_t r;
+  size_t next;
+  if(!peekBus(eRecRead, &r, &next)) return 0;
+  if((r.addr != addr) || (r.reg != reg) || (r.len != size)){
+      mismatch();
+      return 0;
+  }
+  memcpy(pBuf, r.data, r.got);
+  consume(r, next);
+  return r.got;
+}
+
+uint64_t DFRobot_TMF8x01_ReplayBus::clock(){
+  sRecRecord_t r;
+  size_t next;
+  if(!_stopped && peek(_pos, _recTime, &r, &next) && (r.type == eRecClock)) consume(r, next);
+  return _now;
+}
+
+void DFRobot_TMF8x01_ReplayBus::advance(uint32_t us){
+  _now += us;
+}
+
+void DFRobot_TMF8x01_ReplayBus::pinWrite(uint8_t pin, uint8_t val){
+  sRecRecord_t r;
+  size_t next;
+  if(!_stopped && peek(_pos, _recTime, &r, &next) && (r.type == eRecPinWrite) && (r.addr == pin) && (r.reg == val)){
+      consume(r, next);
+  }
+}
+
+int DFRobot_TMF8x01_ReplayBus::pinRead(uint8_t pin){
+  sRecRecord_t r;
+  size_t next;
+  if(!_stopped && peek(_pos, _recTime, &r, &next) && (r.type == eRecPinRead) && (r.addr == pin)){
+      consume(r, next);
+      return r.reg;
+  }
+  //an unconnected INT line idles high.
+  return HIGH;
+}
+
+void DFRobot_TMF8x01_ReplayBus::dump(FILE *out, uint32_t maxRecords){
+  static const char *names[] = {"begin", "probe", "write", "read", "clock", "pin write", "pin read"};
+  sRecRecord_t r;
+  size_t pos = _pos, next;
+  uint64_t t = _recTime;
+
+  for(uint32_t i = 0; (i < maxRecords) && peek(pos, t, &r, &next); i++){
+      fprintf(out, "%12.3f ms  %-9s", (r.timeUs - _start) / 1000.0, names[r.type]);
+      switch(r.type){
+          case eRecProbe:
+              fprintf(out, " 0x%02X %s", r.addr, r.reg ? "ack" : "nack");
+              break;
+          case eRecPinWrite:
+          case eRecPinRead:
+              fprintf(out, " pin %u = %u", r.addr, r.reg);
+              break;
+          case eRecWrite:
+          case eRecRead:
+              fprintf(out, " 0x%02X reg 0x%02X", r.addr, r.reg);
+              if(r.type == eRecRead) fprintf(out, " %u/%u:", (unsigned)r.got, (unsigned)r.len);
+              else fprintf(out, " %u:", (unsigned)r.len);
+              for(uint32_t j = 0; (j < r.got) && (j < 16); j++) fprintf(out, " %02X", r.data[j]);
+              if(r.got > 16) fprintf(out, " ...");
+              break;
+          default:
+              break;
+      }
+      fprintf(out, "\n");
+      pos = next;
+      t = r.timeUs;
+  }
+}
@@ -0,0 +1,233 @@
+/*!
+ * @file DFRobot_TMF8x01_Recorder.h
+ * @brief Records the traffic of a bus into a binary log, and replays a log to the unchanged driver.
+ * @n DFRobot_TMF8x01_Recorder sits between the driver and any other bus: every probe, register write and register read
+ * @n is passed on and written to the log with its time and data. Attached, it also records what millis()/micros()
+ * @n returned and the GPIO accesses, so the log holds everything the driver saw.
+ * @n DFRobot_TMF8x01_ReplayBus answers the driver from a log: reads return the recorded data, millis() the recorded
+ * @n time, and delay() returns at once, so a recording of minutes replays in milliseconds and gives the same results
+ * @n every time. A write or read the log does not hold stops the replay and is reported by getMismatchCount().
+ * @n
+ * @n Log format: a 16 bytes header(magic "TMFR", version, flags, micros() at the start), then the records. A record
+ * @n is one byte with the type in bits 0..3 and the time since the previous record in bits 4..7(15: a varint of the
+ * @n time - 15 follows, unit us), then the data of the type. Lengths are varints(7 bits per byte, LSB first).
+ * @n   eRecBegin:                       nothing
+ * @n   eRecProbe:     addr, ack
+ * @n   eRecWrite:     addr, reg, len, data[len]
+ * @n   eRecRead:      addr, reg, len, got, data[got]      got: the bytes really read
+ * @n   eRecClock:                       nothing, micros() returned the time of the record
+ * @n   eRecPinWrite:  pin, value
+ * @n   eRecPinRead:   pin, value
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_RECORDER_H
+#define __DFROBOT_TMF8X01_RECORDER_H
+
+#include "DFRobot_TMF8x01_Bus.h"
+#include <stdio.h>
+#include <vector>
+
+#define REC_MAGIC         0x52464D54    //"TMFR"
+#define REC_VERSION       1
+#define REC_HEADER_SIZE   16
+
+typedef enum{
+    eRecBegin = 0,
+    eRecProbe,
+    eRecWrite,
+    eRecRead,
+    eRecClock,
+    eRecPinWrite,
+    eRecPinRead,
+}eRecType_t;
+
+/**
+ * @struct sRecRecord_t
+ * @brief A decoded record of the log.
+ */
+typedef struct{
+  eRecType_t type;
+  uint64_t timeUs;        /**< micros() of the recording when the record was written*/
+  uint8_t addr;           /**< I2C address, or the pin of eRecPinWrite/eRecPinRead*/
+  uint8_t reg;            /**< first register, or the value of eRecProbe(ack)/eRecPinWrite/eRecPinRead*/
+  uint32_t len;           /**< bytes written or asked for*/
+  uint32_t got;           /**< eRecRead: bytes really read*/
+  const uint8_t *data;    /**< eRecWrite/eRecRead: the data, points into the log*/
+}sRecRecord_t;
+
+class DFRobot_TMF8x01_Recorder: public DFRobot_TMF8x01_Bus{
+public:
+  /**
+   * @fn DFRobot_TMF8x01_Recorder
+   * @brief Constructor.
+   * @param bus: The bus really doing the transfers, such as DFRobot_TMF8x01_LinuxBus or DFRobot_TMF8x01_FakeBus.
+   */
+  DFRobot_TMF8x01_Recorder(DFRobot_TMF8x01_Bus &bus);
+  ~DFRobot_TMF8x01_Recorder();
+
+  /**
+   * @fn open
+   * @brief Create the log and start recording. Without a log the recorder only passes the transfers on.
+   * @param path: The file, an old one is replaced.
+   * @return 0: success, -errno: failed.
+   */
+  int open(const char *path);
+
+  /**
+   * @fn close
+   * @brief Detach, write the rest of the log and close it.
+   */
+  void close();
+
+  /**
+   * @fn attach
+   * @brief Install the time and GPIO hooks of Arduino.h, they record and call the hooks in use before, so call it
+   * @n     after attach() of a simulated bus.
+   */
+  void attach();
+
+  /**
+   * @fn detach
+   * @brief Put the hooks in use before attach() back.
+   */
+  void detach();
+
+  /**
+   * @fn getRecordCount
+   * @brief get the number of records written.
+   */
+  uint32_t getRecordCount();
+
+  /**
+   * @fn getLogSize
+   * @brief get the size of the log, unit byte.
+   */
+  uint64_t getLogSize();
+
+  void begin();
+  bool probe(uint8_t addr);
+  void writeReg(uint8_t addr, uint8_t reg, const void *pBuf, size_t size);
+  uint8_t readReg(uint8_t addr, uint8_t reg, void *pBuf, size_t size);
+
+  uint64_t clock();
+  void delayUs(uint32_t us);
+  void pinMode(uint8_t pin, uint8_t mode);
+  void pinWrite(uint8_t pin, uint8_t val);
+  int pinRead(uint8_t pin);
+
+private:
+  void record(eRecType_t type, uint64_t t, const uint8_t *head, size_t headLen, const void *data, size_t dataLen);
+
+  DFRobot_TMF8x01_Bus *_pBus;
+  FILE *_fp;
+  sArduinoHooks_t _prev;
+  bool _attached;
+  uint64_t _last;
+  uint32_t _records;
+  uint64_t _size;
+};
+
+class DFRobot_TMF8x01_ReplayBus: public DFRobot_TMF8x01_Bus{
+public:
+  DFRobot_TMF8x01_ReplayBus();
+
+  /**
+   * @fn load
+   * @brief Read a log into memory and rewind.
+   * @param path: The file written by DFRobot_TMF8x01_Recorder.
+   * @return 0: success, -EPROTO: not a log of this version, other -errno: failed.
+   */
+  int load(const char *path);
+
+  /**
+   * @fn load
+   * @brief Take a log from memory, it is copied.
+   * @return 0: success, -EPROTO: not a log of this version.
+   */
+  int load(const void *log, size_t size);
+
+  /**
+   * @fn rewind
+   * @brief Start again at the first record, the clock at the start of the recording.
+   */
+  void rewind();
+
+  /**
+   * @fn attach
+   * @brief Install the time and GPIO hooks of Arduino.h: millis()/micros() return the recorded time, delay() only
+   * @n     advances it, digitalRead() returns the recorded level.
+   */
+  void attach();
+
+  /**
+   * @fn now
+   * @brief get the time of the replay, unit us.
+   */
+  uint64_t now();
+
+  /**
+   * @fn isEnd
+   * @brief true: every record was replayed, or the replay stopped at a mismatch.
+   */
+  bool isEnd();
+
+  /**
+   * @fn getPosition
+   * @brief get the number of records replayed.
+   */
+  uint32_t getPosition();
+
+  /**
+   * @fn getMismatchCount
+   * @brief get the number of bus accesses which differed from the log, the first one stops the replay.
+   */
+  uint32_t getMismatchCount();
+
+  /**
+   * @fn getDurationUs
+   * @brief get the time from the start of the recording to its last record, unit us.
+   */
+  uint64_t getDurationUs();
+
+  /**
+   * @fn dump
+   * @brief Print the records from the current position in text, the position does not move.
+   * @param out: The stream, such as stdout.
+   * @param maxRecords: The number of records to print at most.
+   */
+  void dump(FILE *out, uint32_t maxRecords);
+
+  void begin();
+  bool probe(uint8_t addr);
+  void writeReg(uint8_t addr, uint8_t reg, const void *pBuf, size_t size);
+  uint8_t readReg(uint8_t addr, uint8_t reg, void *pBuf, size_t size);
+
+  uint64_t clock();
+  void advance(uint32_t us);
+  void pinWrite(uint8_t pin, uint8_t val);
+  int pinRead(uint8_t pin);
+
+private:
+  bool peek(size_t pos, uint64_t t, sRecRecord_t *r, size_t *next);
+  bool peekBus(eRecType_t type, sRecRecord_t *r, size_t *next);
+  void consume(const sRecRecord_t &r, size_t next);
+  void mismatch();
+
+  std::vector<uint8_t> _log;
+  uint64_t _start;
+  uint64_t _now;
+  uint64_t _recTime;
+  uint64_t _end;
+  size_t _pos;
+  uint32_t _index;
+  uint32_t _mismatch;
+  bool _stopped;
+};
+
+#endif
@@ -0,0 +1,496 @@
+/*!
+ * @file DFRobot_TMF8x01_SampleLog.cpp
+ * @brief An append-only columnar sample log with block summaries and a time index.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include "DFRobot_TMF8x01_SampleLog.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define SLOG_MAX_BLOCK    (1UL << 20)
+
+//the columns of a block of n samples follow the 64 bytes summary, each on a multiple of 4 bytes.
+#define SLOG_COL_HOST(n)      (sizeof(sLogBlock_t))
+#define SLOG_COL_SYSCLOCK(n)  (sizeof(sLogBlock_t) + 4 * (size_t)(n))
+#define SLOG_COL_DIST(n)      (sizeof(sLogBlock_t) + 8 * (size_t)(n))
+#define SLOG_COL_REL(n)       (sizeof(sLogBlock_t) + 10 * (size_t)(n))
+#define SLOG_COL_STATUS(n)    (sizeof(sLogBlock_t) + 11 * (size_t)(n))
+
+static uint32_t blockSizeOf(uint32_t samples){
+  return (sizeof(sLogBlock_t) + (size_t)samples * SLOG_SAMPLE_SIZE + 63) & ~63UL;
+}
+
+static bool headerValid(const sLogHeader_t &h){
+  return (h.magic == SLOG_MAGIC) && (h.version == SLOG_VERSION) && (h.headerSize == sizeof(sLogHeader_t)) &&
+         h.blockSamples && (h.blockSamples <= SLOG_MAX_BLOCK) && (h.blockSize == blockSizeOf(h.blockSamples)) &&
+         (h.sampleCount <= (uint64_t)h.blockCount * h.blockSamples);
+}
+
+static int writeAll(int fd, const void *buf, size_t len, off_t offset){
+  const uint8_t *p = (const uint8_t *)buf;
+  while(len){
+      ssize_t n = pwrite(fd, p, len, offset);
+      if(n < 0){
+          if(errno == EINTR) continue;
+          return -errno;
+      }
+      p += n;
+      len -= n;
+      offset += n;
+  }
+  return 0;
+}
+
+static int readAll(int fd, void *buf, size_t len, off_t offset){
+  uint8_t *p = (uint8_t *)buf;
+  while(len){
+      ssize_t n = pread(fd, p, len, offset);
+      if(n < 0){
+          if(errno == EINTR) continue;
+          return -errno;
+      }
+      if(n == 0) return -EPROTO;
+      p += n;
+      len -= n;
+      offset += n;
+  }
+  return 0;
+}
+
+DFRobot_TMF8x01_SampleLogWriter::DFRobot_TMF8x01_SampleLogWriter()
+  :_fd(-1),_blk(NULL),_host(NULL),_sysclock(NULL),_dist(NULL),_rel(NULL),_status(NULL),_lastUs(0),_blockOpen(false){
+  memset(&_hdr, 0, sizeof(_hdr));
+}
+
+DFRobot_TMF8x01_SampleLogWriter::~DFRobot_TMF8x01_SampleLogWriter(){
+  end();
+}
+
+int DFRobot_TMF8x01_SampleLogWriter::begin(const char *path, uint32_t blockSamples){
+  struct stat st;
+  int err;
+  if((blockSamples == 0) || (blockSamples > SLOG_MAX_BLOCK)) return -EINVAL;
+  end();
+  _fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if(_fd < 0) return -errno;
+  if(fstat(_fd, &st) < 0){
+      err = -errno;
+      end();
+      return err;
+  }
+  _blockOpen = false;
+  _lastUs = 0;
+  if(st.st_size == 0){
+      memset(&_hdr, 0, sizeof(_hdr));
+      _hdr.magic = SLOG_MAGIC;
+      _hdr.version = SLOG_VERSION;
+      _hdr.headerSize = sizeof(sLogHeader_t);
+      _hdr.blockSamples = blockSamples;
+      _hdr.blockSize = blockSizeOf(blockSamples);
+      if((err = writeHeader()) != 0){
+          end();
+          return err;
+      }
+  }else if(((err = readAll(_fd, &_hdr, sizeof(_hdr), 0)) != 0) || !headerValid(_hdr)){
+      close(_fd);
+      _fd = -1;
+      return err ? err : -EPROTO;
+  }
+  _buf.assign(_hdr.blockSize, 0);
+  _blk = (sLogBlock_t *)_buf.data();
+  _host = (uint32_t *)(_buf.data() + SLOG_COL_HOST(_hdr.blockSamples));
+  _sysclock = (uint32_t *)(_buf.data() + SLOG_COL_SYSCLOCK(_hdr.blockSamples));
+  _dist = (uint16_t *)(_buf.data() + SLOG_COL_DIST(_hdr.blockSamples));
+  _rel = _buf.data() + SLOG_COL_REL(_hdr.blockSamples);
+  _status = _buf.data() + SLOG_COL_STATUS(_hdr.blockSamples);
+  if(_hdr.blockCount){
+      //the last block goes on where the header says, samples written after the header are dropped.
+      off_t pos = sizeof(sLogHeader_t) + (off_t)(_hdr.blockCount - 1) * _hdr.blockSize;
+      if((err = readAll(_fd, _buf.data(), _hdr.blockSize, pos)) != 0){
+          end();
+          return err;
+      }
+      if((_blk->magic != SLOG_BLOCK_MAGIC) || (_blk->firstIndex > _hdr.sampleCount) ||
+         (_hdr.sampleCount - _blk->firstIndex > _hdr.blockSamples)){
+          end();
+          return -EPROTO;
+      }
+      //the summary counted them too, it is made again from the samples kept.
+      _blk->count = _hdr.sampleCount - _blk->firstIndex;
+      _blk->distSum = 0;
+      _blk->distMin = 0xFFFF;
+      _blk->distMax = 0;
+      _blk->relMin = 0xFF;
+      _blk->relMax = 0;
+      _blk->statusMask = 0;
+      for(uint32_t i = 0; i < _blk->count; i++) summarize(i);
+      _lastUs = _blk->count ? (_blk->hostMin + _host[_blk->count - 1]) : _blk->hostMin;
+      _blk->hostMax = _lastUs;
+      _blockOpen = (_blk->count < _hdr.blockSamples);
+  }
+  return 0;
+}
+
+void DFRobot_TMF8x01_SampleLogWriter::end(){
+  if(_fd < 0) return;
+  flush();
+  close(_fd);
+  _fd = -1;
+  _blockOpen = false;
+}
+
+void DFRobot_TMF8x01_SampleLogWriter::resetBlock(uint64_t hostUs){
+  memset(_blk, 0, sizeof(sLogBlock_t));
+  _blk->magic = SLOG_BLOCK_MAGIC;
+  _blk->firstIndex = _hdr.sampleCount;
+  _blk->hostMin = _blk->hostMax = hostUs;
+  _blk->distMin = 0xFFFF;
+  _blk->relMin = 0xFF;
+}
+
+void DFRobot_TMF8x01_SampleLogWriter::summarize(uint32_t i){
+  if(i == 0) _blk->sysclockFirst = _sysclock[i];
+  _blk->sysclockLast = _sysclock[i];
+  _blk->distSum += _dist[i];
+  if(_dist[i] < _blk->distMin) _blk->distMin = _dist[i];
+  if(_dist[i] > _blk->distMax) _blk->distMax = _dist[i];
+  if(_rel[i] < _blk->relMin) _blk->relMin = _rel[i];
+  if(_rel[i] > _blk->relMax) _blk->relMax = _rel[i];
+  _blk->statusMask |= 1 << (_status[i] & 7);
+}
+
+int DFRobot_TMF8x01_SampleLogWriter::append(const sLogSample_t &sample){
+  uint64_t t = (sample.hostUs > _lastUs) ? sample.hostUs : _lastUs;
+  uint32_t i;
+  int err;
+
+  if(_fd < 0) return -EBADF;
+  if(_blockOpen && ((_blk->count == _hdr.blockSamples) || (t - _blk->hostMin > SLOG_MAX_SPAN_US))){
+      if((err = writeBlock()) != 0) return err;
+      _blockOpen = false;
+  }
+  if(!_blockOpen){
+      resetBlock(t);
+      if(_hdr.blockCount == 0) _hdr.createdUs = t;
+      _hdr.blockCount++;
+      _blockOpen = true;
+  }
+  i = _blk->count;
+  _host[i] = t - _blk->hostMin;
+  _sysclock[i] = sample.sysclock;
+  _dist[i] = sample.distance;
+  _rel[i] = sample.reliability;
+  _status[i] = sample.status;
+  _blk->hostMax = t;
+  summarize(i);
+  _blk->count = i + 1;
+  _hdr.sampleCount++;
+  _lastUs = t;
+  return 0;
+}
+
+int DFRobot_TMF8x01_SampleLogWriter::append(const DFRobot_TMF8x01::sSample_t &sample, uint64_t hostUs){
+  sLogSample_t s;
+  s.hostUs = hostUs;
+  s.sysclock = sample.sysclock;
+  s.distance = sample.distance;
+  s.reliability = sample.reliability;
+  s.status = sample.meastatus;
+  return append(s);
+}
+
+int DFRobot_TMF8x01_SampleLogWriter::writeBlock(){
+  off_t pos = sizeof(sLogHeader_t) + (off_t)(_hdr.blockCount - 1) * _hdr.blockSize;
+  int err = writeAll(_fd, _buf.data(), _hdr.blockSize, pos);
+  //the header last: a reader never counts samples whose block is not written.
+  if(err == 0) err = writeHeader();
+  return err;
+}
+
+int DFRobot_TMF8x01_SampleLogWriter::writeHeader(){
+  return writeAll(_fd, &_hdr, sizeof(_hdr), 0);
+}
+
+int DFRobot_TMF8x01_SampleLogWriter::flush(bool sync){
+  int err;
+  if(_fd < 0) return -EBADF;
+  err = _blockOpen ? writeBlock() : writeHeader();
+  if((err == 0) && sync && (fdatasync(_fd) < 0)) err = -errno;
+  return err;
+}
+
+uint64_t DFRobot_TMF8x01_SampleLogWriter::getSampleCount(){
+  return _hdr.sampleCount;
+}
+
+DFRobot_TMF8x01_SampleLogReader::DFRobot_TMF8x01_SampleLogReader()
+  :_fd(-1),_map(NULL),_mapSize(0){
+  memset(&_hdr, 0, sizeof(_hdr));
+}
+
+DFRobot_TMF8x01_SampleLogReader::~DFRobot_TMF8x01_SampleLogReader(){
+  end();
+}
+
+int DFRobot_TMF8x01_SampleLogReader::begin(const char *path){
+  int err;
+  end();
+  _fd = open(path, O_RDONLY | O_CLOEXEC);
+  if(_fd < 0) return -errno;
+  if((err = refresh()) != 0) end();
+  return err;
+}
+
+void DFRobot_TMF8x01_SampleLogReader::end(){
+  if(_map) munmap((void *)_map, _mapSize);
+  _map = NULL;
+  _mapSize = 0;
+  if(_fd >= 0) close(_fd);
+  _fd = -1;
+  memset(&_hdr, 0, sizeof(_hdr));
+}
+
+int DFRobot_TMF8x01_SampleLogReader::refresh(){
+  sLogHeader_t h;
+  struct stat st;
+  size_t need;
+  int err;
+
+  if(_fd < 0) return -EBADF;
+  if((err = readAll(_fd, &h, sizeof(h), 0)) != 0) return err;
+  if(!headerValid(h)) return -EPROTO;
+  need = sizeof(sLogHeader_t) + (size_t)h.blockCount * h.blockSize;
+  if(need > _mapSize){
+      void *p;
+      if(fstat(_fd, &st) < 0) return -errno;
+      if((size_t)st.st_size < need) return -EPROTO;
+      //map the whole file, the blocks the writer adds next are in it until it grows again.
+      p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, _fd, 0);
+      if(p == MAP_FAILED) return -errno;
+      if(_map) munmap((void *)_map, _mapSize);
+      _map = (const uint8_t *)p;
+      _mapSize = st.st_size;
+  }
+  _hdr = h;
+  return 0;
+}
+
+uint64_t DFRobot_TMF8x01_SampleLogReader::getSampleCount(){
+  return _hdr.sampleCount;
+}
+
+uint64_t DFRobot_TMF8x01_SampleLogReader::getBlockCount(){
+  return _hdr.blockCount;
+}
+
+const sLogBlock_t *DFRobot_TMF8x01_SampleLogReader::getBlock(uint64_t b){
+  if(b >= _hdr.blockCount) return NULL;
+  return (const sLogBlock_t *)(_map + sizeof(sLogHeader_t) + b * _hdr.blockSize);
+}
+
+bool DFRobot_TMF8x01_SampleLogReader::getColumns(uint64_t b, const uint32_t **host, const uint32_t **sysclock,
+                                                 const uint16_t **distance, const uint8_t **reliability, const uint8_t **status){
+  const uint8_t *p = (const uint8_t *)getBlock(b);
+  uint32_t n = _hdr.blockSamples;
+  if(!p) return false;
+  if(host) *host = (const uint32_t *)(p + SLOG_COL_HOST(n));
+  if(sysclock) *sysclock = (const uint32_t *)(p + SLOG_COL_SYSCLOCK(n));
+  if(distance) *distance = (const uint16_t *)(p + SLOG_COL_DIST(n));
+  if(reliability) *reliability = p + SLOG_COL_REL(n);
+  if(status) *status = p + SLOG_COL_STATUS(n);
+  return true;
+}
+
+//the samples of a block the header counts, the writer may have put more into the last one already.
+static inline uint32_t countOf(const sLogBlock_t *blk, uint64_t sampleCount){
+  uint64_t n = sampleCount - blk->firstIndex;
+  return (n < blk->count) ? n : blk->count;
+}
+
+//a filtered sample adds 0 to the sum, 0 to the max and 0xFFFF to the min, so the SIMD path has no branch.
+static uint32_t scanColumns(const uint16_t *dist, const uint8_t *rel, uint32_t n, uint8_t minReliability,
+                            uint64_t *sum, uint16_t *dmin, uint16_t *dmax){
+  uint32_t count = 0, i = 0;
+  uint64_t s = 0;
+  uint16_t mn = *dmin, mx = *dmax;
+#if defined(__SSE2__)
+  //SSE2 has no unsigned 16 bits min/max, the signed ones work on the values offset by 0x8000.
+  const __m128i bias = _mm_set1_epi16((short)0x8000);
+  const __m128i byteMask = _mm_set1_epi16(0x00FF);
+  const __m128i ones = _mm_set1_epi8((char)0xFF);
+  const __m128i vrel = _mm_set1_epi8((char)minReliability);
+  const __m128i zero = _mm_setzero_si128();
+  __m128i vmn = _mm_set1_epi16((short)(mn ^ 0x8000)), vmx = _mm_set1_epi16((short)(mx ^ 0x8000));
+  __m128i sumLo = zero, sumHi = zero;
+  uint16_t lane[8];
+  uint64_t half[2];
+  for(; i + 16 <= n; i += 16){
+      __m128i r = _mm_loadu_si128((const __m128i *)(rel + i));
+      __m128i ok = _mm_cmpeq_epi8(_mm_max_epu8(r, vrel), r);
+      __m128i ok0 = _mm_unpacklo_epi8(ok, ok), ok1 = _mm_unpackhi_epi8(ok, ok);
+      __m128i d0 = _mm_loadu_si128((const __m128i *)(dist + i));
+      __m128i d1 = _mm_loadu_si128((const __m128i *)(dist + i + 8));
+      __m128i h0 = _mm_and_si128(d0, ok0), h1 = _mm_and_si128(d1, ok1);
+      __m128i l0 = _mm_or_si128(d0, _mm_xor_si128(ok0, ones)), l1 = _mm_or_si128(d1, _mm_xor_si128(ok1, ones));
+      vmn = _mm_min_epi16(vmn, _mm_min_epi16(_mm_xor_si128(l0, bias), _mm_xor_si128(l1, bias)));
+      vmx = _mm_max_epi16(vmx, _mm_max_epi16(_mm_xor_si128(h0, bias), _mm_xor_si128(h1, bias)));
+      //the sum of 16 bits values by the 64 bits sums of bytes: low bytes + 256 * high bytes.
+      sumLo = _mm_add_epi64(sumLo, _mm_sad_epu8(_mm_and_si128(h0, byteMask), zero));
+      sumLo = _mm_add_epi64(sumLo, _mm_sad_epu8(_mm_and_si128(h1, byteMask), zero));
+      sumHi = _mm_add_epi64(sumHi, _mm_sad_epu8(_mm_srli_epi16(h0, 8), zero));
+      sumHi = _mm_add_epi64(sumHi, _mm_sad_epu8(_mm_srli_epi16(h1, 8), zero));
+      count += __builtin_popcount(_mm_movemask_epi8(ok));
+  }
+  sumLo = _mm_add_epi64(sumLo, _mm_slli_epi64(sumHi, 8));
+  _mm_storeu_si128((__m128i *)half, sumLo);
+  s = half[0] + half[1];
+  _mm_storeu_si128((__m128i *)lane, _mm_xor_si128(vmn, bias));
+  for(int k = 0; k < 8; k++) if(lane[k] < mn) mn = lane[k];
+  _mm_storeu_si128((__m128i *)lane, _mm_xor_si128(vmx, bias));
+  for(int k = 0; k < 8; k++) if(lane[k] > mx) mx = lane[k];
+#endif
+  for(; i < n; i++){
+      uint16_t d = dist[i];
+      if(rel[i] < minReliability) continue;
+      count++;
+      s += d;
+      if(d < mn) mn = d;
+      if(d > mx) mx = d;
+  }
+  *sum += s;
+  *dmin = mn;
+  *dmax = mx;
+  return count;
+}
+
+bool DFRobot_TMF8x01_SampleLogReader::getTimeRange(uint64_t *firstUs, uint64_t *lastUs){
+  const uint32_t *host = NULL;
+  const sLogBlock_t *last;
+  if(_hdr.sampleCount == 0) return false;
+  last = getBlock(_hdr.blockCount - 1);
+  getColumns(_hdr.blockCount - 1, &host, NULL, NULL, NULL, NULL);
+  *firstUs = getBlock(0)->hostMin;
+  *lastUs = last->hostMin + host[countOf(last, _hdr.sampleCount) - 1];
+  return true;
+}
+
+uint64_t DFRobot_TMF8x01_SampleLogReader::blockOf(uint64_t index){
+  uint64_t lo = 0, hi = _hdr.blockCount;
+  //the last block with firstIndex <= index.
+  while(hi - lo > 1){
+      uint64_t mid = (lo + hi) / 2;
+      if(getBlock(mid)->firstIndex <= index) lo = mid;
+      else hi = mid;
+  }
+  return lo;
+}
+
+uint64_t DFRobot_TMF8x01_SampleLogReader::find(uint64_t hostUs){
+  uint64_t lo = 0, hi = _hdr.blockCount;
+  const sLogBlock_t *blk;
+  const uint32_t *host = NULL;
+  uint32_t n, l, h;
+  uint64_t rel;
+
+  //the first block with a sample at or after hostUs, hostMax of the last block may count samples not in the header yet.
+  while(lo < hi){
+      uint64_t mid = (lo + hi) / 2;
+      if(getBlock(mid)->hostMax < hostUs) lo = mid + 1;
+      else hi = mid;
+  }
+  if(lo >= _hdr.blockCount) return _hdr.sampleCount;
+  blk = getBlock(lo);
+  getColumns(lo, &host, NULL, NULL, NULL, NULL);
+  n = countOf(blk, _hdr.sampleCount);
+  if(hostUs <= blk->hostMin) return blk->firstIndex;
+  rel = hostUs - blk->hostMin;
+  l = 0;
+  h = n;
+  while(l < h){
+      uint32_t mid = (l + h) / 2;
+      if(host[mid] < rel) l = mid + 1;
+      else h = mid;
+  }
+  return blk->firstIndex + l;
+}
+
+size_t DFRobot_TMF8x01_SampleLogReader::read(uint64_t index, sLogSample_t *out, size_t n){
+  size_t got = 0;
+  uint64_t b;
+  if((index >= _hdr.sampleCount) || (n == 0)) return 0;
+  b = blockOf(index);
+  while((got < n) && (b < _hdr.blockCount)){
+      const sLogBlock_t *blk = getBlock(b);
+      const uint32_t *host, *sysclock;
+      const uint16_t *dist;
+      const uint8_t *rel, *status;
+      uint32_t cnt = countOf(blk, _hdr.sampleCount);
+      getColumns(b, &host, &sysclock, &dist, &rel, &status);
+      for(uint32_t i = index - blk->firstIndex; (i < cnt) && (got < n); i++, got++){
+          out[got].hostUs = blk->hostMin + host[i];
+          out[got].sysclock = sysclock[i];
+          out[got].distance = dist[i];
+          out[got].reliability = rel[i];
+          out[got].status = status[i];
+      }
+      index = blk->firstIndex + cnt;
+      b++;
+  }
+  return got;
+}
+
+void DFRobot_TMF8x01_SampleLogReader::query(uint64_t fromUs, uint64_t toUs, sLogStats_t *stats, uint8_t minReliability){
+  uint64_t sum = 0;
+  uint16_t dmin = 0xFFFF, dmax = 0;
+
+  memset(stats, 0, sizeof(*stats));
+  stats->firstIndex = find(fromUs);
+  stats->endIndex = (toUs > fromUs) ? find(toUs) : stats->firstIndex;
+  if(stats->firstIndex >= stats->endIndex) return;
+
+  for(uint64_t b = blockOf(stats->firstIndex); b < _hdr.blockCount; b++){
+      const sLogBlock_t *blk = getBlock(b);
+      uint32_t cnt = countOf(blk, _hdr.sampleCount);
+      uint64_t lo, hi;
+      if(blk->firstIndex >= stats->endIndex) break;
+      lo = (stats->firstIndex > blk->firstIndex) ? stats->firstIndex - blk->firstIndex : 0;
+      hi = stats->endIndex - blk->firstIndex;
+      if(hi > cnt) hi = cnt;
+      if((lo == 0) && (hi == blk->count) && (minReliability <= blk->relMin)){
+          //the whole block, its summary is the answer.
+          stats->count += blk->count;
+          sum += blk->distSum;
+          if(blk->distMin < dmin) dmin = blk->distMin;
+          if(blk->distMax > dmax) dmax = blk->distMax;
+          stats->blocksSummary++;
+          continue;
+      }
+      if(minReliability > blk->relMax){
+          stats->blocksSummary++;
+          continue;
+      }
+      const uint16_t *dist;
+      const uint8_t *rel;
+      getColumns(b, NULL, NULL, &dist, &rel, NULL);
+      stats->count += scanColumns(dist + lo, rel + lo, hi - lo, minReliability, &sum, &dmin, &dmax);
+      stats->blocksScanned++;
+  }
+  if(stats->count){
+      stats->distMin = dmin;
+      stats->distMax = dmax;
+      stats->distMean = (double)sum / stats->count;
+  }
+}
@@ -0,0 +1,267 @@
+/*!
+ * @file DFRobot_TMF8x01_SampleLog.h
+ * @brief An append-only binary sample log in columns, for long recordings which are queried by time.
+ * @n The file is a 64 bytes header and blocks of a fixed size. A block holds up to blockSamples samples, column by
+ * @n column: host time(offset from the block start, unit us), sensor time, distance, reliability and measurement
+ * @n status, 12 bytes per sample. The summary in front of every block has its time span, the first sample number, and
+ * @n min/max/sum of the distance and the reliability, so a query uses it for the blocks wholly in the range and only
+ * @n reads the columns of the two blocks at its ends. The host time never goes back, so the summaries are the time
+ * @n index: the reader finds a time by a binary search on them, without a scan.
+ * @n The writer fills a block in memory and writes it when it is full, or at flush(). The header counts the samples
+ * @n written last, a reader which maps the file only uses those.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_SAMPLELOG_H
+#define __DFROBOT_TMF8X01_SAMPLELOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "DFRobot_TMF8x01.h"
+
+#define SLOG_MAGIC              0x4C464D54    //"TMFL"
+#define SLOG_BLOCK_MAGIC        0x4B4C4253    //"SBLK"
+#define SLOG_VERSION            1
+#define SLOG_DEFAULT_BLOCK      4096
+#define SLOG_SAMPLE_SIZE        12            //bytes of all columns of one sample
+#define SLOG_MAX_SPAN_US        0xFFFFFFFFULL //host time column is 32 bits from the block start
+
+/**
+ * @struct sLogSample_t
+ * @brief A sample as written and read.
+ */
+typedef struct{
+  uint64_t hostUs;       /**< host time, unit us, such as CLOCK_REALTIME, never smaller than the one before*/
+  uint32_t sysclock;     /**< sensor time stamp, unit 0.2us*/
+  uint16_t distance;     /**< distance after clock correction, unit mm*/
+  uint8_t reliability;   /**< 0..63, 63 is best*/
+  uint8_t status;        /**< measurement status*/
+}sLogSample_t;
+
+/**
+ * @struct sLogHeader_t
+ * @brief The first 64 bytes of the file.
+ */
+typedef struct{
+  uint32_t magic;        /**< SLOG_MAGIC*/
+  uint16_t version;
+  uint16_t headerSize;   /**< offset of the first block*/
+  uint32_t blockSamples; /**< samples per block*/
+  uint32_t blockSize;    /**< bytes per block, summary and columns*/
+  uint64_t sampleCount;  /**< samples written*/
+  uint64_t blockCount;   /**< blocks with samples, the last one may not be full*/
+  uint64_t createdUs;    /**< host time of the first sample*/
+  uint32_t reserved[6];
+}sLogHeader_t;
+
+/**
+ * @struct sLogBlock_t
+ * @brief The summary in front of a block, the columns follow it.
+ */
+typedef struct{
+  uint32_t magic;        /**< SLOG_BLOCK_MAGIC*/
+  uint32_t count;        /**< samples in the block*/
+  uint64_t firstIndex;   /**< number of the first sample of the block in the log*/
+  uint64_t hostMin;      /**< host time of the first sample, the base of the host time column*/
+  uint64_t hostMax;      /**< host time of the last sample*/
+  uint64_t distSum;
+  uint32_t sysclockFirst;
+  uint32_t sysclockLast;
+  uint16_t distMin;
+  uint16_t distMax;
+  uint8_t relMin;
+  uint8_t relMax;
+  uint8_t statusMask;    /**< bit n set: a sample with status n*/
+  uint8_t reserved[9];
+}sLogBlock_t;
+
+/**
+ * @struct sLogStats_t
+ * @brief The result of a query.
+ */
+typedef struct{
+  uint64_t count;        /**< samples in the range which passed the filter*/
+  uint64_t firstIndex;   /**< number of the first sample in the range*/
+  uint64_t endIndex;     /**< number after the last sample in the range*/
+  uint16_t distMin;
+  uint16_t distMax;
+  double distMean;
+  uint32_t blocksSummary; /**< blocks answered by their summary*/
+  uint32_t blocksScanned; /**< blocks whose columns were read*/
+}sLogStats_t;
+
+class DFRobot_TMF8x01_SampleLogWriter{
+public:
+  DFRobot_TMF8x01_SampleLogWriter();
+  ~DFRobot_TMF8x01_SampleLogWriter();
+
+  /**
+   * @fn begin
+   * @brief Open a log to append to, or create it.
+   * @param path: The file.
+   * @param blockSamples: The samples per block of a new log, an existing log keeps its own.
+   * @return 0: success, -EPROTO: the file is not a log of this version, other -errno: failed.
+   */
+  int begin(const char *path, uint32_t blockSamples = SLOG_DEFAULT_BLOCK);
+
+  /**
+   * @fn end
+   * @brief flush() and close the file.
+   */
+  void end();
+
+  /**
+   * @fn append
+   * @brief Add a sample. A host time smaller than the last one is taken as the last one.
+   * @return 0: success, -errno: writing the full block before failed, the sample is not added.
+   */
+  int append(const sLogSample_t &sample);
+
+  /**
+   * @fn append
+   * @brief Add a sample of the driver, from getLatestSample().
+   * @param sample: The sample.
+   * @param hostUs: The host time of the sample, unit us.
+   * @return 0: success, -errno: failed.
+   */
+  int append(const DFRobot_TMF8x01::sSample_t &sample, uint64_t hostUs);
+
+  /**
+   * @fn flush
+   * @brief Write the block being filled and the header, so readers see every sample appended so far.
+   * @param sync: true also wait for the disk(fdatasync).
+   * @return 0: success, -errno: failed.
+   */
+  int flush(bool sync = false);
+
+  /**
+   * @fn getSampleCount
+   * @brief get the number of samples in the log, appended ones included.
+   */
+  uint64_t getSampleCount();
+
+private:
+  void resetBlock(uint64_t hostUs);
+  void summarize(uint32_t i);
+  int writeBlock();
+  int writeHeader();
+
+  int _fd;
+  sLogHeader_t _hdr;
+  std::vector<uint8_t> _buf;
+  sLogBlock_t *_blk;
+  uint32_t *_host;
+  uint32_t *_sysclock;
+  uint16_t *_dist;
+  uint8_t *_rel;
+  uint8_t *_status;
+  uint64_t _lastUs;
+  bool _blockOpen;
+};
+
+class DFRobot_TMF8x01_SampleLogReader{
+public:
+  DFRobot_TMF8x01_SampleLogReader();
+  ~DFRobot_TMF8x01_SampleLogReader();
+
+  /**
+   * @fn begin
+   * @brief Map a log read-only.
+   * @param path: The file.
+   * @return 0: success, -EPROTO: not a log of this version, other -errno: failed.
+   */
+  int begin(const char *path);
+
+  /**
+   * @fn end
+   * @brief Unmap the log.
+   */
+  void end();
+
+  /**
+   * @fn refresh
+   * @brief Take the samples the writer added since begin() or the last refresh(), the file is mapped again if it grew.
+   * @return 0: success, -errno: failed.
+   */
+  int refresh();
+
+  /**
+   * @fn getSampleCount
+   * @brief get the number of samples.
+   */
+  uint64_t getSampleCount();
+
+  /**
+   * @fn getBlockCount
+   * @brief get the number of blocks.
+   */
+  uint64_t getBlockCount();
+
+  /**
+   * @fn getTimeRange
+   * @brief get the host time of the first and the last sample, unit us.
+   * @return false: the log is empty.
+   */
+  bool getTimeRange(uint64_t *firstUs, uint64_t *lastUs);
+
+  /**
+   * @fn find
+   * @brief Binary search of the first sample at or after a host time.
+   * @param hostUs: unit us.
+   * @return The number of the sample, getSampleCount() if there is none.
+   */
+  uint64_t find(uint64_t hostUs);
+
+  /**
+   * @fn read
+   * @brief Copy samples out of the columns.
+   * @param index: The number of the first sample.
+   * @param out: The samples.
+   * @param n: The size of out.
+   * @return The number of samples copied.
+   */
+  size_t read(uint64_t index, sLogSample_t *out, size_t n);
+
+  /**
+   * @fn query
+   * @brief Statistics of the distance of the samples in [fromUs, toUs) with at least minReliability.
+   * @param fromUs: The start of the range, host time, unit us.
+   * @param toUs: The end of the range, excluded.
+   * @param stats: The result.
+   * @param minReliability: 0: all samples.
+   */
+  void query(uint64_t fromUs, uint64_t toUs, sLogStats_t *stats, uint8_t minReliability = 0);
+
+  /**
+   * @fn getBlock
+   * @brief get the summary of a block.
+   * @param b: The block, less than getBlockCount().
+   * @return The summary in the mapping, NULL: no such block.
+   */
+  const sLogBlock_t *getBlock(uint64_t b);
+
+  /**
+   * @fn getColumns
+   * @brief get the columns of a block, for own processing of whole columns. Each has getBlock(b)->count values,
+   * @n     host is the offset from getBlock(b)->hostMin in us.
+   * @return false: no such block.
+   */
+  bool getColumns(uint64_t b, const uint32_t **host, const uint32_t **sysclock, const uint16_t **distance,
+                  const uint8_t **reliability, const uint8_t **status);
+
+private:
+  uint64_t blockOf(uint64_t index);
+
+  int _fd;
+  const uint8_t *_map;
+  size_t _mapSize;
+  sLogHeader_t _hdr;
+};
+
+#endif
@@ -0,0 +1,236 @@
+/*!
+ * @file DFRobot_TMF8x01_Shm.cpp
+ * @brief A sample ring in POSIX shared memory for many reader processes.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include "DFRobot_TMF8x01_Shm.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SHM_SAMPLE_WORDS  ((sizeof(sShmSample_t) + 7) / 8)
+
+static uint64_t monotonicNs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+DFRobot_TMF8x01_ShmPublisher::DFRobot_TMF8x01_ShmPublisher()
+  :_hdr(NULL),_slot(NULL),_size(0),_mask(0),_head(0){
+  _name[0] = '\0';
+}
+
+DFRobot_TMF8x01_ShmPublisher::~DFRobot_TMF8x01_ShmPublisher(){
+  end();
+}
+
+int DFRobot_TMF8x01_ShmPublisher::begin(const char *name, uint32_t capacity){
+  uint32_t cap = 1;
+  void *p;
+  int fd;
+  if((name == NULL) || (strlen(name) >= sizeof(_name)) || (capacity == 0) || (capacity > (1UL << 24))) return -EINVAL;
+  end();
+  while(cap < capacity) cap <<= 1;
+  //a new object: readers of the old one keep their mapping and do not see our slots half written.
+  shm_unlink(name);
+  fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+  if(fd < 0) return -errno;
+  _size = sizeof(sShmHeader_t) + (size_t)cap * sizeof(sShmSlot_t);
+  if(ftruncate(fd, _size) < 0){
+      int err = -errno;
+      close(fd);
+      shm_unlink(name);
+      return err;
+  }
+  p = mmap(NULL, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if(p == MAP_FAILED){
+      shm_unlink(name);
+      return -errno;
+  }
+  strcpy(_name, name);
+  _hdr = (sShmHeader_t *)p;
+  _slot = (sShmSlot_t *)(_hdr + 1);
+  _mask = cap - 1;
+  _head = 0;
+  //ftruncate gave zeros: every seq 0, head 0.
+  _hdr->version = SHM_VERSION;
+  _hdr->capacity = cap;
+  _hdr->slotSize = sizeof(sShmSlot_t);
+  __atomic_store_n(&_hdr->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+  return 0;
+}
+
+void DFRobot_TMF8x01_ShmPublisher::end(){
+  if(_hdr == NULL) return;
+  __atomic_store_n(&_hdr->closed, 1, __ATOMIC_RELEASE);
+  munmap(_hdr, _size);
+  shm_unlink(_name);
+  _hdr = NULL;
+  _slot = NULL;
+}
+
+uint64_t DFRobot_TMF8x01_ShmPublisher::publish(const sShmSample_t &sample){
+  uint64_t words[SHM_SAMPLE_WORDS];
+  sShmSlot_t *slot;
+  uint64_t n = _head;
+  if(_hdr == NULL) return 0;
+  memcpy(words, &sample, sizeof(sample));
+  ((sShmSample_t *)words)->index = n;
+  ((sShmSample_t *)words)->publishNs = monotonicNs();
+  slot = &_slot[n & _mask];
+  //odd: a reader copying this slot now drops the copy.
+  __atomic_store_n(&slot->seq, 2 * n + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  for(uint8_t i = 0; i < SHM_SAMPLE_WORDS; i++){
+      __atomic_store_n(&slot->words[i], words[i], __ATOMIC_RELAXED);
+  }
+  __atomic_store_n(&slot->seq, 2 * n + 2, __ATOMIC_RELEASE);
+  _head = n + 1;
+  __atomic_store_n(&_hdr->head, _head, __ATOMIC_RELEASE);
+  return n;
+}
+
+uint64_t DFRobot_TMF8x01_ShmPublisher::publish(uint16_t sensor, const DFRobot_TMF8x01::sSample_t &sample){
+  sShmSample_t s;
+  memset(&s, 0, sizeof(s));
+  s.sysclock = sample.sysclock;
+  s.hostMs = sample.hostMs;
+  s.sensor = sensor;
+  s.distance = sample.distance;
+  s.rawDistance = sample.rawDistance;
+  s.tid = sample.tid;
+  s.reliability = sample.reliability;
+  return publish(s);
+}
+
+uint64_t DFRobot_TMF8x01_ShmPublisher::getPublishCount(){
+  return _head;
+}
+
+uint32_t DFRobot_TMF8x01_ShmPublisher::getCapacity(){
+  return _mask + 1;
+}
+
+DFRobot_TMF8x01_ShmReader::DFRobot_TMF8x01_ShmReader()
+  :_hdr(NULL),_slot(NULL),_size(0),_mask(0),_next(0),_reads(0),_overruns(0){
+}
+
+DFRobot_TMF8x01_ShmReader::~DFRobot_TMF8x01_ShmReader(){
+  end();
+}
+
+int DFRobot_TMF8x01_ShmReader::begin(const char *name, bool fromOldest){
+  struct stat st;
+  const sShmHeader_t *hdr;
+  uint64_t head;
+  void *p;
+  int fd;
+  end();
+  fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+  if(fd < 0) return -errno;
+  if(fstat(fd, &st) < 0){
+      int err = -errno;
+      close(fd);
+      return err;
+  }
+  if((size_t)st.st_size < sizeof(sShmHeader_t)){
+      close(fd);
+      return -EAGAIN;
+  }
+  p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(p == MAP_FAILED) return -errno;
+  hdr = (const sShmHeader_t *)p;
+  if(__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC){
+      munmap(p, st.st_size);
+      return -EAGAIN;
+  }
+  if((hdr->version != SHM_VERSION) || (hdr->slotSize != sizeof(sShmSlot_t)) || (hdr->capacity & (hdr->capacity - 1)) ||
+     ((size_t)st.st_size < sizeof(sShmHeader_t) + (size_t)hdr->capacity * sizeof(sShmSlot_t))){
+      munmap(p, st.st_size);
+      return -EPROTO;
+  }
+  _hdr = hdr;
+  _slot = (const sShmSlot_t *)(hdr + 1);
+  _size = st.st_size;
+  _mask = hdr->capacity - 1;
+  head = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+  if(!fromOldest) _next = head;
+  else _next = (head > hdr->capacity) ? (head - hdr->capacity) : 0;
+  _reads = 0;
+  _overruns = 0;
+  return 0;
+}
+
+void DFRobot_TMF8x01_ShmReader::end(){
+  if(_hdr == NULL) return;
+  munmap((void *)_hdr, _size);
+  _hdr = NULL;
+  _slot = NULL;
+}
+
+uint32_t DFRobot_TMF8x01_ShmReader::read(sShmSample_t *samples, uint32_t max){
+  uint64_t words[SHM_SAMPLE_WORDS];
+  uint64_t head, seq0, seq1;
+  uint32_t got = 0;
+  if(_hdr == NULL) return 0;
+  head = __atomic_load_n(&_hdr->head, __ATOMIC_ACQUIRE);
+  if(head - _next > (uint64_t)_mask + 1){
+      _overruns += head - _next - (_mask + 1);
+      _next = head - (_mask + 1);
+  }
+  while((got < max) && (_next < head)){
+      const sShmSlot_t *slot = &_slot[_next & _mask];
+      seq0 = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+      for(uint8_t i = 0; i < SHM_SAMPLE_WORDS; i++){
+          words[i] = __atomic_load_n(&slot->words[i], __ATOMIC_RELAXED);
+      }
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      seq1 = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+      //the slot holds a later sample or is being written: the publisher lapped us, go on with the oldest sample left.
+      if((seq0 != 2 * _next + 2) || (seq1 != seq0)){
+          uint64_t oldest;
+          head = __atomic_load_n(&_hdr->head, __ATOMIC_ACQUIRE);
+          oldest = (head > (uint64_t)_mask + 1) ? (head - (_mask + 1)) : 0;
+          if(oldest <= _next) oldest = _next + 1;
+          _overruns += oldest - _next;
+          _next = oldest;
+          continue;
+      }
+      memcpy(&samples[got], words, sizeof(sShmSample_t));
+      got++;
+      _next++;
+  }
+  _reads += got;
+  return got;
+}
+
+uint64_t DFRobot_TMF8x01_ShmReader::getOverrunCount(){
+  return _overruns;
+}
+
+uint64_t DFRobot_TMF8x01_ShmReader::getReadCount(){
+  return _reads;
+}
+
+uint64_t DFRobot_TMF8x01_ShmReader::getLag(){
+  if(_hdr == NULL) return 0;
+  return __atomic_load_n(&_hdr->head, __ATOMIC_ACQUIRE) - _next;
+}
+
+bool DFRobot_TMF8x01_ShmReader::isClosed(){
+  if(_hdr == NULL) return true;
+  return __atomic_load_n(&_hdr->closed, __ATOMIC_ACQUIRE) != 0;
+}
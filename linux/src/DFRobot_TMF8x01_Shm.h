@@ -0,0 +1,185 @@
+/*!
+ * @file DFRobot_TMF8x01_Shm.h
+ * @brief A sample ring in POSIX shared memory: one process owns the sensors and publishes, any number of processes
+ * @n (logging, control, UI) map the ring read-only and tail it. The ring is a power of two slots of 64 bytes, every
+ * @n slot has a sequence word: 2n+1 while sample n is written into it, 2n+2 after. The head counter tells the readers
+ * @n how far the publisher is. A reader keeps its own position, so reading is a few loads and no system call, and
+ * @n the publisher never waits for anybody. A reader which falls more than the ring behind loses the oldest samples,
+ * @n they are counted by getOverrunCount().
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_SHM_H
+#define __DFROBOT_TMF8X01_SHM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "DFRobot_TMF8x01.h"
+
+#define SHM_MAGIC             0x31464D54    //"TMF1"
+#define SHM_VERSION           1
+#define SHM_DEFAULT_CAPACITY  4096
+#define SHM_SLOT_WORDS        7             //56 bytes of sample data in a 64 bytes slot
+
+/**
+ * @struct sShmSample_t
+ * @brief A sample in the ring.
+ */
+typedef struct{
+  uint64_t index;        /**< number of the sample in the ring, from 0, set by publish()*/
+  uint64_t publishNs;    /**< CLOCK_MONOTONIC when it was published, unit ns, set by publish()*/
+  uint32_t sysclock;     /**< sensor time stamp, unit 0.2us*/
+  uint32_t hostMs;       /**< millis() of the publisher when the result was read*/
+  uint16_t sensor;       /**< the sensor number given by the publisher*/
+  uint16_t distance;     /**< distance after clock correction, unit mm*/
+  uint16_t rawDistance;  /**< distance reported by the sensor, unit mm*/
+  uint8_t tid;           /**< transaction ID of the result*/
+  uint8_t reliability;   /**< 0..63, 63 is best*/
+}sShmSample_t;
+
+/**
+ * @struct sShmHeader_t
+ * @brief The first 128 bytes of the shared memory, the slots follow.
+ */
+typedef struct{
+  uint32_t magic;        /**< SHM_MAGIC, written last by the publisher*/
+  uint32_t version;
+  uint32_t capacity;     /**< number of slots, power of 2*/
+  uint32_t slotSize;
+  uint32_t closed;       /**< 1 after the publisher called end()*/
+  uint32_t reserved[11];
+  uint64_t head;         /**< number of samples published, on its own cache line*/
+  uint64_t reserved2[7];
+}sShmHeader_t;
+
+typedef struct{
+  uint64_t seq;
+  uint64_t words[SHM_SLOT_WORDS];
+}sShmSlot_t;
+
+class DFRobot_TMF8x01_ShmPublisher{
+public:
+  DFRobot_TMF8x01_ShmPublisher();
+  ~DFRobot_TMF8x01_ShmPublisher();
+
+  /**
+   * @fn begin
+   * @brief Create the ring. An old ring of the same name is removed first, its readers keep the old mapping.
+   * @param name: The POSIX shared memory name, such as "/tmf8x01".
+   * @param capacity: The number of samples in the ring, rounded up to a power of 2.
+   * @return 0: success, -errno: failed.
+   */
+  int begin(const char *name, uint32_t capacity = SHM_DEFAULT_CAPACITY);
+
+  /**
+   * @fn end
+   * @brief Mark the ring closed, unmap and remove it. The readers keep their mapping until they end too.
+   */
+  void end();
+
+  /**
+   * @fn publish
+   * @brief Write a sample into the next slot, never blocks. index and publishNs are set here.
+   * @return The index of the sample.
+   */
+  uint64_t publish(const sShmSample_t &sample);
+
+  /**
+   * @fn publish
+   * @brief Write a sample of the driver, from getLatestSample().
+   * @param sensor: The sensor number seen by the readers.
+   * @param sample: The sample.
+   * @return The index of the sample.
+   */
+  uint64_t publish(uint16_t sensor, const DFRobot_TMF8x01::sSample_t &sample);
+
+  /**
+   * @fn getPublishCount
+   * @brief get the number of samples published.
+   */
+  uint64_t getPublishCount();
+
+  /**
+   * @fn getCapacity
+   * @brief get the number of slots of the ring.
+   */
+  uint32_t getCapacity();
+
+private:
+  char _name[64];
+  sShmHeader_t *_hdr;
+  sShmSlot_t *_slot;
+  size_t _size;
+  uint32_t _mask;
+  uint64_t _head;
+};
+
+class DFRobot_TMF8x01_ShmReader{
+public:
+  DFRobot_TMF8x01_ShmReader();
+  ~DFRobot_TMF8x01_ShmReader();
+
+  /**
+   * @fn begin
+   * @brief Map the ring read-only.
+   * @param name: The name given to begin() of the publisher.
+   * @param fromOldest: true start with the oldest sample still in the ring, false only the samples published from now on.
+   * @return 0: success, -EAGAIN: the publisher is still creating it, -EPROTO: not a ring of this version, other -errno: failed.
+   */
+  int begin(const char *name, bool fromOldest = false);
+
+  /**
+   * @fn end
+   * @brief Unmap the ring.
+   */
+  void end();
+
+  /**
+   * @fn read
+   * @brief Copy the next samples, without system calls. Samples overwritten before they were read are skipped and counted.
+   * @param samples: Pointer to store the samples.
+   * @param max: The max number of samples.
+   * @return The number of samples copied, 0 if there is no new sample.
+   */
+  uint32_t read(sShmSample_t *samples, uint32_t max);
+
+  /**
+   * @fn getOverrunCount
+   * @brief get the number of samples this reader lost because the publisher overwrote them first.
+   */
+  uint64_t getOverrunCount();
+
+  /**
+   * @fn getReadCount
+   * @brief get the number of samples this reader copied.
+   */
+  uint64_t getReadCount();
+
+  /**
+   * @fn getLag
+   * @brief get the number of published samples this reader has not read yet.
+   */
+  uint64_t getLag();
+
+  /**
+   * @fn isClosed
+   * @brief The publisher called end(). The remaining samples can still be read, begin() again follows a new publisher.
+   */
+  bool isClosed();
+
+private:
+  const sShmHeader_t *_hdr;
+  const sShmSlot_t *_slot;
+  size_t _size;
+  uint32_t _mask;
+  uint64_t _next;
+  uint64_t _reads;
+  uint64_t _overruns;
+};
+
+#endif
@@ -11,11 +11,49 @@
   @url https://github.com/DFRobot/DFRobot_TMF8x01
 '''
 
+import os
 import sys
 import time
-import smbus
+try:
+  import fcntl
+except ImportError:
+  fcntl = None
 import RPi.GPIO as GPIO
 import Drv_TMF8x01 as drv
+try:
+  import smbus
+except ImportError:
+  smbus = None
+## The native part(setup.py build_ext --inplace), set TMF8X01_PURE_PYTHON=1 to use the pure Python code anyway.
+try:
+  import _tmf8x01 as _native
+except ImportError:
+  _native = None
+if os.environ.get("TMF8X01_PURE_PYTHON"):
+  _native = None
+
+## The RAM patches as bytes for the native download, made once.
+_patch_bytes = {}
+
+def _get_patch_bytes(l):
+  key = id(l)
+  if key not in _patch_bytes:
+    _patch_bytes[key] = bytes(bytearray(l))
+  return _patch_bytes[key]
+
+## The data of the records of a RAM patch without their lengths, made once.
+_patch_data = {}
+
+def _get_patch_data(l):
+  key = id(l)
+  if key not in _patch_data:
+    data = []
+    i = 0
+    while l[i] > 0:
+      data += l[i+1:i+1+l[i]]
+      i = i + 1 + l[i]
+    _patch_data[key] = data
+  return _patch_data[key]
 
 class DFRobot_TMF8x01:
   ePROXIMITY = 0
@@ -33,13 +71,19 @@ class DFRobot_TMF8x01:
   _distance = []
   _timestamp = 0
   _tid = 0
+  _raw_tid = None
   _calib_data = []
   _algo_state_data = []
   _measure_cmd_set = []
   _measure_cmd_flag = False
   
   result_dictKey = ['status', 'regContents','tid','resultNumber','resultInfo','disL','disH','syscolck0','syscolck1','syscolck2','syscolck3']
-  result_dict = {}
+  _result_dict = {}
+  _native = None
+  _bus_id = 1
+  _i2c_fd = None
+  _download_mode = 0
+  _download_retries = 2
   
   TMF8801_CALIB_DATA = [0x41,0x57,0x01,0xFD,0x04,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04]
   TMF8801_ALGO_STATE = [0xB1, 0xA9, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00]
@@ -95,6 +139,16 @@ class DFRobot_TMF8x01:
   CMDSET_BIT_CALIB = 0
   CMDSET_BIT_ALGO = 1
   
+  ## Enum patch download mode
+  eDOWNLOAD_RECORD = 0
+  eDOWNLOAD_BLOCK = 1
+  eDOWNLOAD_BLOCK_DEFERRED_ACK = 2
+
+  ## max data bytes of a bootloader command, of one in a smbus block write(32 bytes), the I2C_SLAVE ioctl of i2c-dev
+  BL_MAX_DATA = 128
+  SMBUS_MAX_DATA = 29
+  I2C_SLAVE = 0x0703
+
   ## Board status 
   STA_OK = 0x00
   STA_ERR = 0x01
@@ -108,10 +162,72 @@ class DFRobot_TMF8x01:
   def __init__(self, enPin, intPin, bus_id):
     self._en = enPin
     self._intPin = intPin
-    self._bus = smbus.SMBus(bus_id)
+    self._native = None
+    self._bus = None
+    self._bus_id = bus_id
+    self._i2c_fd = None
+    if _native is not None:
+      try:
+        self._native = _native.Device(bus_id, self._addr)
+      except (OSError, IOError):
+        self._native = None
+    if self._native is None:
+      self._bus = smbus.SMBus(bus_id)
     GPIO.setmode(GPIO.BCM)
     GPIO.setwarnings(False)
 
+  @property
+  def result_dict(self):
+    '''!
+      @brief The 11 bytes of the last result from the STATUS register, by name.
+    '''
+    if self._native is not None:
+      return dict(zip(self.result_dictKey, bytearray(self._native.result)))
+    return self._result_dict
+
+  @result_dict.setter
+  def result_dict(self, d):
+    self._result_dict = d
+
+  def is_native(self):
+    '''!
+      @brief The native part is used.
+      @return True: native, False: pure Python through smbus.
+    '''
+    return self._native is not None
+
+  def close(self):
+    '''!
+      @brief Close the /dev/i2c-N file of the block download. The sensor keeps running, the file is opened again by the
+      @n     next download that needs it.
+    '''
+    if (self._i2c_fd is not None) and (self._i2c_fd >= 0):
+      try:
+        os.close(self._i2c_fd)
+      except (OSError, IOError):
+        pass
+    self._i2c_fd = None
+
+  def set_download_mode(self, mode, retries = 2):
+    '''!
+      @brief Set how begin() downloads the RAM patch. The records of the patch go to consecutive RAM addresses,
+      @n     so they can be merged into fewer, longer bootloader commands.
+      @param mode:
+      @n     eDOWNLOAD_RECORD:             one 16 bytes record per write, the ACK is read after every write(default).
+      @n     eDOWNLOAD_BLOCK:              the records merged into writes of 128 bytes(29 bytes, the smbus block
+      @n                                   limit, if /dev/i2c-N can not be opened), the ACK after every write.
+      @n     eDOWNLOAD_BLOCK_DEFERRED_ACK: like eDOWNLOAD_BLOCK, the ACK is read only after the last write.
+      @n                                   A rejected write before the last is not seen, use it on a clean bus.
+      @param retries: Download again from the start this many times after a missing ACK or an I2C error, the last
+      @n     try is in eDOWNLOAD_RECORD.
+    '''
+    if mode not in (self.eDOWNLOAD_RECORD, self.eDOWNLOAD_BLOCK, self.eDOWNLOAD_BLOCK_DEFERRED_ACK):
+      self.last_operate_status = self.STA_ERR_PARAMETER
+      return
+    self._download_mode = mode
+    self._download_retries = max(0, retries)
+    self.last_operate_status = self.STA_OK
+
   def begin(self):
     '''!
       @brief    initialization sensor's interface, addr, ram config to running APP0 application.
@@ -154,6 +270,8 @@ class DFRobot_TMF8x01:
     self._write_bytes(self.REG_MTF8x01_ENABLE, rslt)
     self._measure_cmd_flag = False
     self._count = 0
+    if self._native is not None:
+      self._native.count = 0
   
   def wakeup(self):
     '''!
@@ -172,7 +290,7 @@ class DFRobot_TMF8x01:
     #else:
       #print("app0")
     if(self._measure_cmd_set[self.CMDSET_INDEX_CMD6] & (1<< self.CMDSET_BIT_INT)):
-      self.modifyCmdSet(self.CMDSET_INDEX_CMD6, self.CMDSET_BIT_INT, True)
+      self._modify_cmd_set(self.CMDSET_INDEX_CMD6, self.CMDSET_BIT_INT, True)
     if(self._set_caibration_mode(self._get_calibration_mode()) == False):
       return False
     return True
@@ -302,7 +420,7 @@ class DFRobot_TMF8x01:
     #print("start_measurement end")
     if(self._checkStatusRegister(0x55) != True):
       return False
-    while self._count < 4:
+    while self._get_count() < 4:
       if(self.is_data_ready()): 
         self.get_distance_mm()
       time.sleep(0.002)
@@ -321,12 +439,21 @@ class DFRobot_TMF8x01:
     self._count = 0
     self._timestamp = 1
     self._tid = 0
+    self._raw_tid = None
+    if self._native is not None:
+      self._native.count = 0
+      self._native.timestamp = 1
+      self._native.tid = 0
 
   def is_data_ready(self):
     '''!
       @brief  Waiting for data ready.
       @return if data is valid, return true, or return false.
     '''
+    if self._native is not None:
+      ready = self._native.poll(self._measure_cmd_set[self.CMDSET_INDEX_CMD6] & (1<<self.CMDSET_BIT_INT))
+      self.last_operate_status = self.STA_ERR_DEVICE_NOT_DETECTED if self._native.error else self.STA_OK
+      return ready
     tid = 0
     reliab = 0
     t = 0
@@ -338,7 +465,7 @@ class DFRobot_TMF8x01:
     if self.result_dict['regContents'] == 0x55:
       if self.result_dict['tid'] != self._tid:
         self._tid = self.result_dict['tid']
-        j = self.result_dict["syscolck3"] << 24 | self.result_dict["syscolck2"] << 16 | self.result_dict["syscolck2"] << 8 | self.result_dict["syscolck0"]
+        j = self.result_dict["syscolck3"] << 24 | self.result_dict["syscolck2"] << 16 | self.result_dict["syscolck1"] << 8 | self.result_dict["syscolck0"]
         if self._count < 4:
           self._host[self._count] = t*10000
           self._module[self._count] = (j*0.2)/100
@@ -368,11 +495,29 @@ class DFRobot_TMF8x01:
       
     return False
 
+  def read_result(self):
+    '''!
+      @brief  read the 11 bytes of the result registers from 0x1D as they are, without the clock correction of
+      @n      is_data_ready(). With the INT pin enabled the INT flag is cleared too, only after a new tid and only if
+      @n      it is set, a poll without a new result is one read.
+      @return [status, regContents(0x55: a result), tid, resultNumber, resultInfo, disL, disH, syscolck0..3]
+    '''
+    rslt = self._read_bytes(self.REG_MTF8x01_STATUS, 11)
+    if (rslt[1] == 0x55) and (rslt[2] != self._raw_tid):
+      self._raw_tid = rslt[2]
+      if self._measure_cmd_set[self.CMDSET_INDEX_CMD6] & (1<<self.CMDSET_BIT_INT):
+        status = self._read_bytes(self.REG_MTF8x01_INT_STATUS,1)
+        if status[0] & 0x01:
+          self._write_bytes(self.REG_MTF8x01_INT_STATUS,[0x01])
+    return rslt
+
   def get_distance_mm(self):
     '''!
       @brief  get distance, unit mm. Before using this function, you need to call is_data_ready.
       @return return distance value, unit mm.
     '''
+    if self._native is not None:
+      return self._native.distance(self._measure_cmd_set[self.CMDSET_INDEX_CMD6] & (1<<self.CMDSET_BIT_INT))
     rslt = self.result_dict["disH"] << 8 | self.result_dict["disL"]
     dis = rslt * self._timestamp
     if self._measure_cmd_set[self.CMDSET_INDEX_CMD6] & (1<<self.CMDSET_BIT_INT):
@@ -458,6 +603,136 @@ class DFRobot_TMF8x01:
   def _download_ram_patch(self):
     pass
 
+  def _get_count(self):
+    if self._native is not None:
+      return self._native.count
+    return self._count
+
+  def _download_patch(self, l):
+    '''!
+      @brief download the RAM patch l in the mode of set_download_mode(), with its retries.
+      @return download sucess return True, or return False
+    '''
+    if self._get_app_id() != 0x80:
+      if(self._load_bootloader() != True):
+        print("load Bootloader failed")
+        return False
+    mode = self._download_mode
+    for i in range(self._download_retries + 1):
+      if i > 0:
+        if i == self._download_retries:
+          mode = self.eDOWNLOAD_RECORD
+        if(self._restart_bootloader() != True):
+          continue
+      if(self._write_patch(l, mode) == True):
+        return self._wait_for_cpu_ready()
+    return False
+
+  def _write_patch(self, l, mode):
+    '''!
+      @brief bootloader commands of the patch download: reset, RAM address 0, the data, remap.
+      @return all commands acknowledged return True, or return False
+    '''
+    block = 0
+    ack = (mode != self.eDOWNLOAD_BLOCK_DEFERRED_ACK)
+    if mode != self.eDOWNLOAD_RECORD:
+      block = self._max_block()
+    if self._native is not None:
+      return self._native.download_patch(_get_patch_bytes(l), block, ack)
+    if(self._boot_command([0x14,0x01,0x29], True) != True):
+      return False
+    if(self._boot_command([0x43,0x02,0x00,0x00], True) != True):
+      return False
+    if block == 0:
+      i = 0
+      while l[i] > 0:
+        if(self._boot_command([0x41,l[i]] + l[i+1:i+1+l[i]], ack) != True):
+          return False
+        i = i + 1 + l[i]
+    else:
+      data = _get_patch_data(l)
+      for i in range(0, len(data), block):
+        buf = data[i:i+block]
+        if(self._boot_command([0x41,len(buf)] + buf, ack) != True):
+          return False
+    #deferred: only the last command is checked, an I2C error before it already failed.
+    if (ack != True) and (self._wait_status_ack() != True):
+      return False
+    self._write_bytes(0x08, [0x11,0x00,self._cal_check_sum([0x11,0x00])])
+    return self.last_operate_status == self.STA_OK
+
+  def _max_block(self):
+    '''!
+      @brief the data bytes of the longest bootloader command the bus can write.
+    '''
+    if (self._native is not None) or (self._open_i2c_dev() == True):
+      return self.BL_MAX_DATA
+    return self.SMBUS_MAX_DATA
+
+  def _open_i2c_dev(self):
+    '''!
+      @brief open /dev/i2c-N for the writes longer than a smbus block.
+      @return opened return True, or return False
+    '''
+    if self._i2c_fd is None:
+      self._i2c_fd = -1
+      if fcntl is not None:
+        try:
+          fd = os.open("/dev/i2c-%d"%self._bus_id, os.O_RDWR)
+          try:
+            fcntl.ioctl(fd, self.I2C_SLAVE, self._addr)
+            self._i2c_fd = fd
+          except (OSError, IOError):
+            os.close(fd)
+        except (OSError, IOError):
+          pass
+    return self._i2c_fd >= 0
+
+  def _boot_command(self, cmd, ack):
+    '''!
+      @brief write a bootloader command with its checksum, then wait for its ACK if ack.
+      @return sucess return True, or return False
+    '''
+    buf = cmd + [self._cal_check_sum(cmd)]
+    if len(buf) <= 32:
+      self._write_bytes(0x08, buf)
+    else:
+      self.last_operate_status = self.STA_ERR_DEVICE_NOT_DETECTED
+      try:
+        os.write(self._i2c_fd, bytes(bytearray([0x08] + buf)))
+        self.last_operate_status = self.STA_OK
+      except (OSError, IOError):
+        pass
+    if self.last_operate_status != self.STA_OK:
+      return False
+    if ack != True:
+      return True
+    return self._wait_status_ack()
+
+  def _wait_status_ack(self):
+    '''!
+      @brief wait for the ACK of the last bootloader command.
+      @return ACK in 10 ms return True, or return False
+    '''
+    t = time.time()
+    while True:
+      if(self._read_status_ack() == True):
+        return True
+      if (self.last_operate_status != self.STA_OK) or (time.time() - t > 0.01):
+        return False
+
+  def _restart_bootloader(self):
+    '''!
+      @brief after a failed download: enable the cpu again and make sure the bootloader runs.
+      @return Bootloader is running return True, or return False
+    '''
+    self._write_bytes(self.REG_MTF8x01_ENABLE, [0x01])
+    if(self._wait_for_cpu_ready() != True):
+      return False
+    if self._get_app_id() != 0x80:
+      return self._load_bootloader()
+    return True
+
   def _get_calibration_mode(self):
     mode = 0
     if(self._measure_cmd_set[self.CMDSET_INDEX_CMD7] & (1<< self.CMDSET_BIT_CALIB)):
@@ -561,7 +836,7 @@ class DFRobot_TMF8x01:
     sum = 0
     for i in l:
       sum += i
-    sum = sum ^ 0xff
+    sum = (sum ^ 0xff) & 0xff
     return sum
 
   def _read_status_ack(self):
@@ -597,7 +872,10 @@ class DFRobot_TMF8x01:
   def _write_bytes(self, reg, buf):
     self.last_operate_status = self.STA_ERR_DEVICE_NOT_DETECTED
     try:
-      self._bus.write_i2c_block_data(self._addr, reg, buf)
+      if self._native is not None:
+        self._native.write_bytes(reg, buf)
+      else:
+        self._bus.write_i2c_block_data(self._addr, reg, buf)
       self.last_operate_status = self.STA_OK
     except:
       pass
@@ -605,7 +883,10 @@ class DFRobot_TMF8x01:
   def _read_bytes(self, reg, len1):
     self.last_operate_status = self.STA_ERR_DEVICE_NOT_DETECTED
     try:
-      rslt = self._bus.read_i2c_block_data(self._addr, reg, len1)
+      if self._native is not None:
+        rslt = self._native.read_bytes(reg, len1)
+      else:
+        rslt = self._bus.read_i2c_block_data(self._addr, reg, len1)
       self.last_operate_status = self.STA_OK
       return rslt
     except:
@@ -639,43 +920,7 @@ class DFRobot_TMF8801(DFRobot_TMF8x01):
       @brief  download RAM patch.
       @return download sucess return True, or return False
     '''
-    if self._get_app_id() != 0x80:
-      if(self._load_bootloader() != True):
-        print("load Bootloader failed")
-        return False
-    bufList = [0x08,0x14,0x01,0x29]
-    bufList.append(self._cal_check_sum(bufList[1:]))
-    self._write_bytes(bufList[0],bufList[1:])
-    if(self._read_status_ack() != True):
-      return False
-    
-    bufList = [0x08,0x43,0x02,0x00,0x00]
-    bufList.append(self._cal_check_sum(bufList[1:]))
-    self._write_bytes(bufList[0],bufList[1:])
-    if(self._read_status_ack() != True):
-      return False
-    
-    
-    l = drv.DFRobot_TMF8801_initBuf
-    i = 0
-    flag = 0
-    while l[i] > 0:
-      bufList = [0x08,0x41]
-      flag = l[i]
-      bufList.append(flag)
-      i = i + 1
-      bufList = bufList + l[i:i+flag]
-      i = i + flag
-      bufList.append(self._cal_check_sum(bufList[1:]))
-      self._write_bytes(bufList[0],bufList[1:])
-      if(self._read_status_ack() != True):
-        return False
-    bufList = [0x08,0x11,0x00]
-    bufList.append(self._cal_check_sum(bufList[1:]))
-    self._write_bytes(bufList[0],bufList[1:])
-    if(self._wait_for_cpu_ready()):
-      return True
-    return False
+    return self._download_patch(drv.DFRobot_TMF8801_initBuf)
   
 class DFRobot_TMF8701(DFRobot_TMF8x01):
   def __init__(self,enPin = -1, intPin = -1, bus_id = 1):
@@ -718,40 +963,4 @@ class DFRobot_TMF8701(DFRobot_TMF8x01):
       @brief  download RAM patch.
       @return download sucess return True, or return False
     '''
-    if self._get_app_id() != 0x80:
-      if(self._load_bootloader() != True):
-        print("load Bootloader failed")
-        return False
-    bufList = [0x08,0x14,0x01,0x29]
-    bufList.append(self._cal_check_sum(bufList[1:]))
-    self._write_bytes(bufList[0],bufList[1:])
-    if(self._read_status_ack() != True):
-      return False
-    
-    bufList = [0x08,0x43,0x02,0x00,0x00]
-    bufList.append(self._cal_check_sum(bufList[1:]))
-    self._write_bytes(bufList[0],bufList[1:])
-    if(self._read_status_ack() != True):
-      return False
-    
-    
-    l = drv.DFRobot_TMF8801_initBuf
-    i = 0
-    flag = 0
-    while l[i] > 0:
-      bufList = [0x08,0x41]
-      flag = l[i]
-      bufList.append(flag)
-      i = i + 1
-      bufList = bufList + l[i:i+flag]
-      i = i + flag
-      bufList.append(self._cal_check_sum(bufList[1:]))
-      self._write_bytes(bufList[0],bufList[1:])
-      if(self._read_status_ack() != True):
-        return False
-    bufList = [0x08,0x11,0x00]
-    bufList.append(self._cal_check_sum(bufList[1:]))
-    self._write_bytes(bufList[0],bufList[1:])
-    if(self._wait_for_cpu_ready()):
-      return True
-    return False
+    return self._download_patch(drv.DFRobot_TMF8801_initBuf)
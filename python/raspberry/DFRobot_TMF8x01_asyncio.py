@@ -0,0 +1,236 @@
+# -*- coding:utf-8 -*-
+
+'''!
+  @file DFRobot_TMF8x01_asyncio.py
+  @brief asyncio variant of DFRobot_TMF8801 and DFRobot_TMF8701, Python 3.6 or later.
+  @n The blocking calls of the driver run on one worker thread per I2C bus, so the event loop never waits for the bus
+  @n and the sensors of a bus take turns like on the wire. An edge of the INT pin resolves the future a sensor waits
+  @n on, without the INT pin the result register is polled every poll_interval seconds. samples() is an async
+  @n generator with a bounded queue: when the consumer does not keep up the sensor is not read until there is room,
+  @n the results the sensor overwrote in the meantime are counted in lost.
+  @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license     The MIT License (MIT)
+  @author      Arya(xue.peng@dfrobot.com)
+  @version     V1.0
+  @date        2026-10-19
+  @url https://github.com/DFRobot/DFRobot_TMF8x01
+'''
+
+import asyncio
+import collections
+import concurrent.futures
+import functools
+import threading
+import RPi.GPIO as GPIO
+from DFRobot_TMF8x01 import DFRobot_TMF8801, DFRobot_TMF8701
+
+## A sample of samples(): distance in mm, transaction ID, loop.time() of the INT edge(or of the poll) before the
+## result was read, number of results the sensor overwrote before this one.
+TMF8x01Sample = collections.namedtuple("TMF8x01Sample", ["distance", "tid", "timestamp", "lost"])
+
+## One worker thread per I2C bus, shared by all the sensors on it.
+_bus_executor = {}
+_bus_executor_lock = threading.Lock()
+
+def _get_bus_executor(bus_id):
+  with _bus_executor_lock:
+    if bus_id not in _bus_executor:
+      _bus_executor[bus_id] = concurrent.futures.ThreadPoolExecutor(max_workers = 1)
+    return _bus_executor[bus_id]
+
+class DFRobot_TMF8x01_Async(object):
+  ## seconds between two reads of the result register when the INT pin is not used
+  poll_interval = 0.01
+  ## seconds to wait for an INT edge before the result register is read anyway, a lost edge costs no more
+  int_timeout = 1.0
+
+  def __init__(self, sensor, intPin, bus_id, executor = None):
+    '''!
+      @brief Wrap a DFRobot_TMF8801 or DFRobot_TMF8701.
+      @param sensor: The driver object, only used from the worker thread from now on.
+      @param intPin: The INT pin given to the driver, -1: not connected.
+      @param bus_id: The I2C bus, the sensors of a bus share its worker thread.
+      @param executor: A concurrent.futures executor for the bus calls instead of the worker thread of the bus.
+    '''
+    self.sensor = sensor
+    self.lost = 0
+    self._intPin = intPin
+    self._executor = executor if executor is not None else _get_bus_executor(bus_id)
+    self._loop = None
+    self._int_attached = False
+    self._int_pending = None
+    self._int_waiter = None
+    self._last_tid = None
+
+  async def run(self, func, *args, **kwargs):
+    '''!
+      @brief Call a blocking function on the worker thread of the bus, such as a method of the driver.
+      @return The return value of func.
+    '''
+    loop = asyncio.get_event_loop()
+    return await loop.run_in_executor(self._executor, functools.partial(func, *args, **kwargs))
+
+  async def begin(self):
+    '''!
+      @brief begin() of the driver: reset, RAM patch download, APP0.
+      @return initialization sucess return 0, fail return -1
+    '''
+    return await self.run(self.sensor.begin)
+
+  async def start_measurement(self, *args, **kwargs):
+    '''!
+      @brief start_measurement() of the driver with the same arguments. With an INT pin the pin is enabled first and
+      @n     its falling edges are watched.
+      @return enable measurement sucess return True, or return False
+    '''
+    if self._intPin > -1:
+      await self.run(self.sensor.enable_int_pin)
+    ok = await self.run(self.sensor.start_measurement, *args, **kwargs)
+    if ok and (self._intPin > -1):
+      self._attach_int()
+    self._last_tid = None
+    return ok
+
+  async def stop_measurement(self):
+    '''!
+      @brief stop_measurement() of the driver, the INT pin is not watched any more.
+    '''
+    self._detach_int()
+    await self.run(self.sensor.stop_measurement)
+
+  async def sleep(self):
+    '''!
+      @brief sleep() of the driver.
+    '''
+    self._detach_int()
+    await self.run(self.sensor.sleep)
+
+  async def wakeup(self):
+    '''!
+      @brief wakeup() of the driver. When it resumed the measurement the INT pin is enabled and watched again.
+      @return enter app0 return True, or return False.
+    '''
+    ok = await self.run(self.sensor.wakeup)
+    if ok and (self._intPin > -1) and self.sensor._measure_cmd_flag:
+      await self.run(self.sensor.enable_int_pin)
+      self._attach_int()
+    self._last_tid = None
+    return ok
+
+  async def close(self):
+    '''!
+      @brief Stop watching the INT pin and close the files of the driver, the measurement goes on.
+    '''
+    self._detach_int()
+    await self.run(self.sensor.close)
+
+  async def read_sample(self):
+    '''!
+      @brief Wait for the next result, the event loop runs meanwhile.
+      @return TMF8x01Sample
+    '''
+    loop = asyncio.get_event_loop()
+    while True:
+      if self._int_attached:
+        t = await self._wait_int(loop)
+      else:
+        await asyncio.sleep(self.poll_interval)
+        t = loop.time()
+      r = await self.run(self._fetch)
+      if r is None:
+        continue
+      distance, tid = r
+      lost = 0
+      if self._last_tid is not None:
+        lost = (tid - self._last_tid - 1) & 0xFF
+      self._last_tid = tid
+      self.lost += lost
+      return TMF8x01Sample(distance, tid, t, lost)
+
+  async def samples(self, maxsize = 4):
+    '''!
+      @brief async for sample in sensor.samples(): the results from now on.
+      @param maxsize: The results read ahead of the consumer, the sensor is not read while they wait.
+      @n     The sensor keeps only the latest result, what it measures meanwhile is counted in lost.
+    '''
+    queue = asyncio.Queue(maxsize)
+    task = asyncio.ensure_future(self._produce(queue))
+    try:
+      while True:
+        item = await queue.get()
+        if isinstance(item, Exception):
+          raise item
+        yield item
+    finally:
+      task.cancel()
+
+  async def _produce(self, queue):
+    try:
+      while True:
+        await queue.put(await self.read_sample())
+    except asyncio.CancelledError:
+      raise
+    except Exception as e:
+      await queue.put(e)
+
+  def _fetch(self):
+    '''!
+      @brief on the worker thread: the result if there is a new one.
+      @return (distance, tid) or None
+    '''
+    if self.sensor.is_data_ready() != True:
+      return None
+    return (self.sensor.get_distance_mm(), self.sensor.result_dict['tid'])
+
+  async def _wait_int(self, loop):
+    '''!
+      @brief wait for an INT edge after the last read, int_timeout at most.
+      @return loop.time() of the edge
+    '''
+    if self._int_pending is None:
+      self._int_waiter = loop.create_future()
+      try:
+        await asyncio.wait_for(self._int_waiter, self.int_timeout)
+      except asyncio.TimeoutError:
+        pass
+      finally:
+        self._int_waiter = None
+    t = self._int_pending if self._int_pending is not None else loop.time()
+    self._int_pending = None
+    return t
+
+  def _attach_int(self):
+    if self._int_attached:
+      return
+    self._loop = asyncio.get_event_loop()
+    self._int_pending = None
+    GPIO.add_event_detect(self._intPin, GPIO.FALLING, callback = self._on_edge)
+    self._int_attached = True
+
+  def _detach_int(self):
+    if not self._int_attached:
+      return
+    GPIO.remove_event_detect(self._intPin)
+    self._int_attached = False
+    if (self._int_waiter is not None) and (not self._int_waiter.done()):
+      self._int_waiter.set_result(None)
+
+  def _on_edge(self, channel):
+    '''!
+      @brief on the GPIO thread of RPi.GPIO: hand the edge to the event loop.
+    '''
+    self._loop.call_soon_threadsafe(self._int_fired, self._loop.time())
+
+  def _int_fired(self, t):
+    #the sensor keeps only the latest result, so the latest edge is its time.
+    self._int_pending = t
+    if (self._int_waiter is not None) and (not self._int_waiter.done()):
+      self._int_waiter.set_result(t)
+
+class DFRobot_TMF8801_Async(DFRobot_TMF8x01_Async):
+  def __init__(self, enPin = -1, intPin = -1, bus_id = 1, executor = None):
+    DFRobot_TMF8x01_Async.__init__(self, DFRobot_TMF8801(enPin, intPin, bus_id), intPin, bus_id, executor)
+
+class DFRobot_TMF8701_Async(DFRobot_TMF8x01_Async):
+  def __init__(self, enPin = -1, intPin = -1, bus_id = 1, executor = None):
+    DFRobot_TMF8x01_Async.__init__(self, DFRobot_TMF8701(enPin, intPin, bus_id), intPin, bus_id, executor)
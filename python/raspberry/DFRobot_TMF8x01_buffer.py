@@ -0,0 +1,194 @@
+# -*- coding:utf-8 -*-
+
+'''!
+  @file DFRobot_TMF8x01_buffer.py
+  @brief Buffered acquisition into a preallocated NumPy structured array, with the clock correction, filters and
+  @n statistics done on the whole buffer at once. The acquisition loop only copies the 11 result bytes and the host time
+  @n of every new result, the first 11 bytes of a record are laid out like the result registers from 0x1D, so the
+  @n fields are decoded by NumPy and not one by one in Python. Needs NumPy, the rest of the library does not.
+  @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license     The MIT License (MIT)
+  @author      Arya(xue.peng@dfrobot.com)
+  @version     V1.0
+  @date        2026-10-19
+  @url https://github.com/DFRobot/DFRobot_TMF8x01
+'''
+
+import time
+import numpy as np
+
+## A record of the buffer: the result registers as read, the host time, then the fields filled by process().
+SAMPLE_DTYPE = np.dtype([
+  ('status', 'u1'),        # 0x1D
+  ('contents', 'u1'),      # 0x1E, 0x55: a result
+  ('tid', 'u1'),           # transaction ID
+  ('number', 'u1'),        # result number
+  ('info', 'u1'),          # reliability(bit 0..5) and measurement status(bit 6..7)
+  ('distance', '<u2'),     # distance reported by the sensor, unit mm
+  ('sysclock', '<u4'),     # sensor time stamp, unit 0.2us
+  ('host', '<f8'),         # host time when the result was read, unit s
+  ('reliability', 'u1'),   # 0..63, 63 is best
+  ('meastatus', 'u1'),     # measurement status
+  ('corrected', '<f4'),    # distance after the clock correction, unit mm
+])
+
+RESULT_SIZE = 11
+SYSCLOCK_S = 0.2e-6
+
+_clock = time.monotonic if hasattr(time, "monotonic") else time.time
+
+class DFRobot_TMF8x01_Buffer(object):
+  def __init__(self, sensor, size = 4096):
+    '''!
+      @brief A buffer of size samples for a DFRobot_TMF8801 or DFRobot_TMF8701 which is measuring.
+      @param sensor: The driver, after start_measurement().
+      @param size: The number of samples, allocated now.
+    '''
+    self.sensor = sensor
+    self.data = np.zeros(size, dtype = SAMPLE_DTYPE)
+    self.count = 0
+    self.lost = 0
+    self._raw = self.data.view(np.uint8).reshape(size, SAMPLE_DTYPE.itemsize)
+    self._host = self.data['host']
+    self._stage = bytearray(0)
+    self._last_tid = None
+
+  def clear(self):
+    '''!
+      @brief Forget the samples, the array is kept.
+    '''
+    self.count = 0
+    self.lost = 0
+    self._last_tid = None
+
+  def append(self, result, host = None):
+    '''!
+      @brief Add a result read somewhere else, such as by read_result() of the driver.
+      @param result: The 11 bytes of the result registers.
+      @param host: The host time in s, now if None.
+      @return True: added, False: not a new result or the buffer is full.
+    '''
+    if (result[1] != 0x55) or (result[2] == self._last_tid) or (self.count >= len(self.data)):
+      return False
+    self._raw[self.count, :RESULT_SIZE] = result
+    self._host[self.count] = _clock() if host is None else host
+    self._last_tid = result[2]
+    self.count += 1
+    return True
+
+  def acquire(self, n = None, timeout = None, poll_interval = 0.001):
+    '''!
+      @brief Read the results of the sensor into the buffer. The loop keeps the bytes as read, they are decoded into
+      @n     data at once when it ends.
+      @param n: The number of samples to add, None: until the buffer is full.
+      @param timeout: Give up after this many seconds, None: no limit.
+      @param poll_interval: Sleep between two reads of the result registers, unit s, 0 does not sleep.
+      @return The number of samples added.
+    '''
+    end = len(self.data) if n is None else min(len(self.data), self.count + n)
+    want = end - self.count
+    if len(self._stage) < want * RESULT_SIZE:
+      self._stage = bytearray(want * RESULT_SIZE)
+    stage = self._stage
+    read = self.sensor.read_result
+    host = []
+    last = self._last_tid
+    k = 0
+    t0 = _clock()
+    while k < want:
+      r = read()
+      t = _clock()
+      if (r[1] == 0x55) and (r[2] != last):
+        stage[k*RESULT_SIZE:(k+1)*RESULT_SIZE] = r
+        host.append(t)
+        last = r[2]
+        k += 1
+        continue
+      if (timeout is not None) and (t - t0 > timeout):
+        break
+      if poll_interval > 0:
+        time.sleep(poll_interval)
+    if k:
+      i = self.count
+      self._raw[i:i+k, :RESULT_SIZE] = np.frombuffer(stage, dtype = np.uint8, count = k * RESULT_SIZE).reshape(k, RESULT_SIZE)
+      self._host[i:i+k] = host
+      self.count += k
+    self._last_tid = last
+    return k
+
+  def samples(self):
+    '''!
+      @brief The samples in the buffer, a view of data.
+    '''
+    return self.data[:self.count]
+
+  def process(self, window = 4):
+    '''!
+      @brief Decode reliability and meastatus, and correct the distance by the drift of the sensor clock: the host
+      @n     time over the sensor time of the last window periods, as is_data_ready() does with its 5 results. The
+      @n     samples before the first full window take the ratio of the first one.
+      @param window: The periods the ratio is taken over.
+      @return The samples, a view of data.
+    '''
+    s = self.samples()
+    n = len(s)
+    s['reliability'] = s['info'] & 0x3F
+    s['meastatus'] = s['info'] >> 6
+    ratio = np.ones(n)
+    if n > window:
+      #uint32 subtraction wraps like the sensor clock.
+      dm = (s['sysclock'][window:] - s['sysclock'][:-window]).astype(np.float64) * SYSCLOCK_S
+      dh = s['host'][window:] - s['host'][:-window]
+      r = np.ones(n - window)
+      np.divide(dh, dm, out = r, where = dm > 0)
+      ratio[window:] = r
+      ratio[:window] = r[0]
+    s['corrected'] = s['distance'] * ratio
+    tid = s['tid']
+    self.lost = int(((tid[1:] - tid[:-1] - 1) & 0xFF).sum()) if n > 1 else 0
+    return s
+
+  def valid(self, min_reliability = 0):
+    '''!
+      @brief Mask of the samples with a distance and at least this reliability, after process().
+    '''
+    s = self.samples()
+    return (s['distance'] > 0) & (s['reliability'] >= min_reliability)
+
+  def moving_average(self, k, field = 'corrected'):
+    '''!
+      @brief Mean of the last k samples of a field, after process().
+      @return An array of count - k + 1 values.
+    '''
+    v = self.samples()[field].astype(np.float64)
+    if len(v) < k:
+      return np.zeros(0)
+    c = np.cumsum(np.concatenate(([0.0], v)))
+    return (c[k:] - c[:-k]) / k
+
+  def median_filter(self, k, field = 'corrected'):
+    '''!
+      @brief Median of the last k samples of a field, after process(), removes single outliers.
+      @return An array of count - k + 1 values.
+    '''
+    v = np.ascontiguousarray(self.samples()[field])
+    if len(v) < k:
+      return np.zeros(0, dtype = v.dtype)
+    w = np.lib.stride_tricks.as_strided(v, shape = (len(v) - k + 1, k), strides = (v.strides[0], v.strides[0]))
+    return np.median(w, axis = 1)
+
+  def stats(self, min_reliability = 0):
+    '''!
+      @brief Statistics of the corrected distance of the valid samples, after process().
+      @return dict of count, mean, std, min, max, p50, p95(mm), rate(Hz from the host time), lost(results skipped).
+    '''
+    s = self.samples()
+    d = s['corrected'][self.valid(min_reliability)]
+    st = {'count': len(d), 'lost': self.lost, 'rate': 0.0}
+    if len(s) > 1 and s['host'][-1] > s['host'][0]:
+      st['rate'] = (len(s) - 1 + self.lost) / (s['host'][-1] - s['host'][0])
+    if len(d):
+      p = np.percentile(d, [50, 95])
+      st.update({'mean': float(d.mean()), 'std': float(d.std()), 'min': float(d.min()), 'max': float(d.max()),
+                 'p50': float(p[0]), 'p95': float(p[1])})
+    return st
@@ -0,0 +1,111 @@
+# -*- coding:utf-8 -*-
+'''!
+  @file asyncio_bench.py
+  @brief CPU time per sample of the busy loop of the demos and of DFRobot_TMF8x01_asyncio, with the INT pin and polled.
+  @n Each mode runs in its own process. The asyncio modes run a ticker next to the sensor which stands for the
+  @n network code, its worst lateness shows how long the event loop was held. Every mode runs with the native part
+  @n and with pure Python, on the simulated sensor(benchmark/fake/fake_i2c.c) the distance of every tid must be the
+  @n same in both within 1%, or within what the poll interval does to the clock correction.
+  @n usage: python3 asyncio_bench.py [samples] [bus_id] [int pin]
+  @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license     The MIT License (MIT)
+  @author      Arya(xue.peng@dfrobot.com)
+  @version     V1.0
+  @date        2026-10-19
+  @url https://github.com/DFRobot/DFRobot_TMF8x01
+'''
+from __future__ import print_function
+import os
+import sys
+import time
+
+sys.path.append(os.path.dirname(os.path.dirname(os.path.realpath(__file__))))
+import bench_common
+
+TICK = 0.01
+PERIOD = 0.1            #the measurement period of the sensor
+
+def busy(samples, bus_id, pin):
+  from DFRobot_TMF8x01 import DFRobot_TMF8801
+  tof = DFRobot_TMF8801(enPin = -1, intPin = -1, bus_id = bus_id)
+  if (tof.begin() != 0) or (tof.start_measurement(calib_m = tof.eMODE_NO_CALIB) != True):
+    print("busy poll: init failed")
+    return 1
+  c0 = time.process_time()
+  t0 = time.time()
+  got = 0
+  out = []
+  while got < samples:
+    if tof.is_data_ready() == True:
+      out.append((tof.result_dict['tid'], tof.get_distance_mm()))
+      got += 1
+  report("busy poll", tof, got, 0, time.time() - t0, time.process_time() - c0, None)
+  tof.stop_measurement()
+  bench_common.emit("distance", out)
+  return 0
+
+def aio(samples, bus_id, pin):
+  import asyncio
+  from DFRobot_TMF8x01_asyncio import DFRobot_TMF8801_Async
+  name = "asyncio int" if pin > -1 else "asyncio poll"
+
+  async def ticker(lag):
+    loop = asyncio.get_event_loop()
+    due = loop.time()
+    while True:
+      due += TICK
+      await asyncio.sleep(due - loop.time())
+      lag[0] = max(lag[0], loop.time() - due)
+
+  async def main():
+    tof = DFRobot_TMF8801_Async(enPin = -1, intPin = pin, bus_id = bus_id)
+    if (await tof.begin() != 0) or (await tof.start_measurement(calib_m = tof.sensor.eMODE_NO_CALIB) != True):
+      print("%s: init failed" % name)
+      return 1
+    lag = [0]
+    tick = asyncio.ensure_future(ticker(lag))
+    c0 = time.process_time()
+    t0 = time.time()
+    got = 0
+    out = []
+    async for s in tof.samples():
+      out.append((s[1], s[0]))
+      got += 1
+      if got == samples:
+        break
+    report(name, tof.sensor, got, tof.lost, time.time() - t0, time.process_time() - c0, lag[0])
+    tick.cancel()
+    await tof.stop_measurement()
+    bench_common.emit("distance", out)
+    return 0
+
+  return asyncio.get_event_loop().run_until_complete(main())
+
+def report(name, sensor, got, lost, wall, cpu, lag):
+  name += " native" if sensor.is_native() else " python"
+  print("%-19s: %d samples(%d lost) in %.2f s, cpu %.1f ms per sample, %.0f%% of a core%s" %
+        (name, got, lost, wall, cpu * 1000 / got, cpu * 100 / wall,
+         "" if lag is None else ", ticker late %.1f ms at most" % (lag * 1000)))
+
+if __name__ == "__main__":
+  samples = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+  bus_id = int(sys.argv[2]) if len(sys.argv) > 2 else 1
+  pin = int(sys.argv[3]) if len(sys.argv) > 3 else 22
+  mode = os.environ.get("TMF8X01_BENCH_CHILD")
+  if mode == "busy":
+    sys.exit(busy(samples, bus_id, pin))
+  if mode == "aio":
+    sys.exit(aio(samples, bus_id, pin))
+  runs = []
+  for title, mode, p in (("busy", "busy", -1), ("aio int", "aio", pin), ("aio poll", "aio", -1)):
+    argv = [sys.executable] + sys.argv[:1] + [str(samples), str(bus_id), str(p)]
+    for pure in (False, True):
+      runs.append((title + (" python" if pure else " native"), argv, bench_common.child_env(mode, pure)))
+  errors, results = bench_common.run_children(runs)
+  if bench_common.simulated():
+    from DFRobot_TMF8x01_asyncio import DFRobot_TMF8801_Async
+    #the clock correction takes the host time of the read over 4 periods, each end late by up to a poll interval.
+    poll = 2 * DFRobot_TMF8801_Async.poll_interval / (4 * PERIOD)
+    for title, tol in (("busy", 0.01), ("aio int", 0.01), ("aio poll", 0.01 + poll)):
+      errors += not bench_common.compare(results, title + " native", title + " python", "distance", tol)
+  sys.exit(bench_common.finish(errors))
@@ -0,0 +1,88 @@
+# -*- coding:utf-8 -*-
+'''!
+  @file bench_common.py
+  @brief The runs of a benchmark in processes of their own, and the check that they got the same results.
+  @n A run prints its results as a line "RESULTS <name> key:value ...", the other lines are passed on. On the
+  @n simulated sensor(benchmark/fake) a result depends only on its tid, so the native part and pure Python must
+  @n agree, on a real sensor the results of two runs differ and they are not compared.
+  @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license     The MIT License (MIT)
+  @author      Arya(xue.peng@dfrobot.com)
+  @version     V1.0
+  @date        2026-10-19
+  @url https://github.com/DFRobot/DFRobot_TMF8x01
+'''
+from __future__ import print_function
+import ctypes
+import os
+import subprocess
+import sys
+
+def simulated():
+  '''!
+    @brief benchmark/fake/fake_i2c.so is loaded.
+  '''
+  try:
+    return hasattr(ctypes.CDLL(None), "fake_ram")
+  except OSError:
+    return False
+
+def emit(name, pairs):
+  '''!
+    @brief print the results of a run, pairs: (key, value) of integers.
+  '''
+  print("RESULTS %s %s" % (name, " ".join("%d:%d" % (k, v) for k, v in pairs)))
+  sys.stdout.flush()
+
+def child_env(mode, pure):
+  '''!
+    @brief the environment of a run: TMF8X01_BENCH_CHILD = mode, pure Python if pure.
+  '''
+  env = dict(os.environ, TMF8X01_BENCH_CHILD = mode)
+  if pure:
+    env["TMF8X01_PURE_PYTHON"] = "1"
+  else:
+    env.pop("TMF8X01_PURE_PYTHON", None)
+  return env
+
+def run_children(runs):
+  '''!
+    @brief run each (title, argv, env) in turn.
+    @return (failed runs, {title: {name: {key: value}}})
+  '''
+  errors = 0
+  results = {}
+  for title, argv, env in runs:
+    got = {}
+    p = subprocess.Popen(argv, env = env, stdout = subprocess.PIPE, universal_newlines = True)
+    for line in p.stdout:
+      if line.startswith("RESULTS "):
+        f = line.split()
+        got[f[1]] = dict((int(k), int(v)) for k, v in (x.split(":") for x in f[2:]))
+      else:
+        sys.stdout.write(line)
+        sys.stdout.flush()
+    if p.wait() != 0:
+      errors += 1
+    results[title] = got
+  return errors, results
+
+def compare(results, a, b, name, tol = 0.0):
+  '''!
+    @brief the results name of the runs a and b are the same for every key both have, within tol * value.
+    @return True: the same and at least one key in common.
+  '''
+  ra = results.get(a, {}).get(name, {})
+  rb = results.get(b, {}).get(name, {})
+  keys = sorted(set(ra) & set(rb))
+  bad = [k for k in keys if abs(ra[k] - rb[k]) > tol * abs(ra[k])]
+  print("%s vs %s %-8s: %d in common, %d differ%s" % (a, b, name, len(keys), len(bad),
+        "" if not bad else ", key %d: %d != %d" % (bad[0], ra[bad[0]], rb[bad[0]])))
+  return (len(keys) > 0) and (len(bad) == 0)
+
+def finish(errors):
+  '''!
+    @brief print PASS or FAIL, the exit code.
+  '''
+  print("PASS" if errors == 0 else "FAIL")
+  return 1 if errors else 0
@@ -0,0 +1,133 @@
+# -*- coding:utf-8 -*-
+'''!
+  @file buffer_bench.py
+  @brief Samples per second of the per-call path(is_data_ready() + get_distance_mm()) and of DFRobot_TMF8x01_Buffer.
+  @n Acquisition: both poll without sleeping, so the numbers are the CPU cost of a sample as long as the sensor is
+  @n faster, set a short period to see it. Post-processing: the clock correction of the driver done sample by sample
+  @n in Python against process() and stats() over the same samples, repeated to a large buffer.
+  @n Each mode runs in its own process, with the native part and with pure Python. process() must give what the
+  @n per-sample correction gives within 1 mm, and on the simulated sensor(benchmark/fake/fake_i2c.c) the raw distance
+  @n of every tid must be the same in both modes, per call and buffered.
+  @n usage: python3 buffer_bench.py [samples] [bus_id] [period ms]
+  @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license     The MIT License (MIT)
+  @author      Arya(xue.peng@dfrobot.com)
+  @version     V1.0
+  @date        2026-10-19
+  @url https://github.com/DFRobot/DFRobot_TMF8x01
+'''
+from __future__ import print_function
+import os
+import sys
+import time
+
+sys.path.append(os.path.dirname(os.path.dirname(os.path.realpath(__file__))))
+import bench_common
+
+PROCESS_SAMPLES = 200000
+
+def per_sample_correction(host, sysclock, distance):
+  '''!
+    @brief the clock correction of is_data_ready() and get_distance_mm(), one sample at a time.
+  '''
+  h = [0] * 5
+  m = [0] * 5
+  ratio = 1
+  out = []
+  for i in range(len(distance)):
+    if i < 4:
+      h[i] = host[i] * 10000
+      m[i] = sysclock[i] * 0.2 / 100
+      continue
+    h[4] = host[i] * 10000
+    m[4] = sysclock[i] * 0.2 / 100
+    t2 = m[4] - m[0]
+    if t2 > 0:
+      ratio = (h[4] - h[0]) / t2
+    for j in range(4):
+      h[j] = h[j + 1]
+      m[j] = m[j + 1]
+    out.append(int(distance[i] * ratio))
+  return out
+
+def run(samples, bus_id, period):
+  import numpy as np
+  from DFRobot_TMF8x01 import DFRobot_TMF8801
+  from DFRobot_TMF8x01_buffer import DFRobot_TMF8x01_Buffer
+  tof = DFRobot_TMF8801(enPin = -1, intPin = -1, bus_id = bus_id)
+  name = "native" if tof.is_native() else "python"
+  tof._measure_cmd_set[5] = period
+  if (tof.begin() != 0) or (tof.start_measurement(calib_m = tof.eMODE_NO_CALIB) != True):
+    print("%s: init failed" % name)
+    return 1
+
+  c0 = time.process_time()
+  t0 = time.time()
+  got = 0
+  dist = []
+  raw = {}
+  while got < samples:
+    if tof.is_data_ready() == True:
+      dist.append(tof.get_distance_mm())
+      r = tof.result_dict
+      raw[r['tid']] = r['disH'] << 8 | r['disL']
+      got += 1
+  wall = time.time() - t0
+  cpu = time.process_time() - c0
+  print("%s per-call  : %7.0f samples/s, cpu %6.1f us per sample" % (name, got / wall, cpu * 1e6 / got))
+
+  buf = DFRobot_TMF8x01_Buffer(tof, samples)
+  c0 = time.process_time()
+  t0 = time.time()
+  got = buf.acquire(samples, poll_interval = 0)
+  buf.process()
+  wall = time.time() - t0
+  cpu = time.process_time() - c0
+  st = buf.stats()
+  print("%s buffered  : %7.0f samples/s, cpu %6.1f us per sample, mean %.1f mm, %d lost, sensor %.0f Hz" %
+        (name, got / wall, cpu * 1e6 / got, st.get('mean', 0), st['lost'], st['rate']))
+  tof.stop_measurement()
+  bench_common.emit("percall", sorted(raw.items()))
+  s = buf.samples()
+  bench_common.emit("buffer", sorted(dict(zip(s['tid'].tolist(), s['distance'].tolist())).items()))
+
+  #the acquired samples repeated, the clocks going on.
+  reps = PROCESS_SAMPLES // len(s) + 1
+  span = s['host'][-1] - s['host'][0] + (s['host'][1] - s['host'][0])
+  big = DFRobot_TMF8x01_Buffer(None, reps * len(s))
+  big.data['host'] = (s['host'][None, :] + span * np.arange(reps)[:, None]).ravel()
+  big.data['sysclock'] = (s['sysclock'][None, :] + np.uint32(span / 0.2e-6) * np.arange(reps, dtype = np.uint32)[:, None]).ravel()
+  for f in ('distance', 'info', 'tid', 'contents'):
+    big.data[f] = np.tile(s[f], reps)
+  big.count = len(big.data)
+  host = big.data['host'].tolist()
+  sysclock = big.data['sysclock'].tolist()
+  distance = big.data['distance'].tolist()
+  t0 = time.time()
+  out = per_sample_correction(host, sysclock, distance)
+  t1 = time.time() - t0
+  t0 = time.time()
+  big.process()
+  t2 = time.time() - t0
+  t0 = time.time()
+  big.stats()
+  big.median_filter(5)
+  t3 = time.time() - t0
+  diff = np.abs(big.data['corrected'][4:].astype(np.int64) - np.array(out)).max()
+  print("%s correction: per sample %8.0f samples/s, process() %9.0f samples/s(%d samples, max diff %d mm), stats()+median_filter(5) %9.0f samples/s" %
+        (name, len(out) / t1, big.count / t2, big.count, diff, big.count / t3))
+  return 0 if diff <= 1 else 1
+
+if __name__ == "__main__":
+  samples = int(sys.argv[1]) if len(sys.argv) > 1 else 1000
+  bus_id = int(sys.argv[2]) if len(sys.argv) > 2 else 1
+  period = int(sys.argv[3]) if len(sys.argv) > 3 else 1
+  if os.environ.get("TMF8X01_BENCH_CHILD"):
+    sys.exit(run(samples, bus_id, period))
+  argv = [sys.executable] + sys.argv[:1] + [str(samples), str(bus_id), str(period)]
+  errors, results = bench_common.run_children([("native", argv, bench_common.child_env("1", False)),
+                                               ("python", argv, bench_common.child_env("1", True))])
+  if bench_common.simulated():
+    errors += not bench_common.compare(results, "native", "python", "percall")
+    errors += not bench_common.compare(results, "native", "python", "buffer")
+  sys.exit(bench_common.finish(errors))
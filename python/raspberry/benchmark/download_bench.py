@@ -0,0 +1,95 @@
+# -*- coding:utf-8 -*-
+'''!
+  @file download_bench.py
+  @brief Time of the RAM patch download in each mode of set_download_mode(), with the native part and with pure Python.
+  @n Every round puts the sensor back to the bootloader and downloads the patch again, the last line of each run
+  @n is begin() as the service start sees it, in the fastest mode. The bus speed decides most of it: set the
+  @n i2c baudrate in /boot/config.txt the same as in service.
+  @n On the simulated sensor(benchmark/fake/fake_i2c.c, FAKE_I2C_HZ sets its bus clock) the RAM written by every mode
+  @n must be the patch, the same with the native part and with pure Python.
+  @n usage: python3 download_bench.py [rounds] [bus_id]
+  @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license     The MIT License (MIT)
+  @author      Arya(xue.peng@dfrobot.com)
+  @version     V1.0
+  @date        2026-10-19
+  @url https://github.com/DFRobot/DFRobot_TMF8x01
+'''
+from __future__ import print_function
+import ctypes
+import os
+import sys
+import time
+import zlib
+
+sys.path.append(os.path.dirname(os.path.dirname(os.path.realpath(__file__))))
+import bench_common
+
+def ram_crc():
+  '''!
+    @brief crc32 of the RAM written on the simulated sensor.
+  '''
+  fake = ctypes.CDLL(None)
+  buf = (ctypes.c_uint8 * 65536)()
+  n = fake.fake_ram(buf, len(buf))
+  return zlib.crc32(bytearray(buf[:n])) & 0xFFFFFFFF
+
+def run(rounds, bus_id):
+  import Drv_TMF8x01 as drv
+  from DFRobot_TMF8x01 import DFRobot_TMF8801, _get_patch_data
+  sim = bench_common.simulated()
+  patch = zlib.crc32(bytearray(_get_patch_data(drv.DFRobot_TMF8801_initBuf))) & 0xFFFFFFFF
+  crcs = []
+  tof = DFRobot_TMF8801(enPin = -1, intPin = -1, bus_id = bus_id)
+  name = "native" if tof.is_native() else "python"
+  modes = [("record", tof.eDOWNLOAD_RECORD), ("block", tof.eDOWNLOAD_BLOCK),
+           ("block deferred ack", tof.eDOWNLOAD_BLOCK_DEFERRED_ACK)]
+  cpuClock = time.process_time if hasattr(time, "process_time") else time.clock
+  base = 0
+  for title, mode in modes:
+    #no retry, a failure shows here instead of costing a second download.
+    tof.set_download_mode(mode, 0)
+    best = None
+    cpu = 0
+    for i in range(rounds):
+      if tof._load_bootloader() != True:
+        print("%s: load bootloader failed" % name)
+        return 1
+      c0 = cpuClock()
+      t0 = time.time()
+      ok = tof._download_ram_patch()
+      t = time.time() - t0
+      cpu += cpuClock() - c0
+      if ok != True:
+        print("%s %s: download failed" % (name, title))
+        return 1
+      best = t if (best is None) or (t < best) else best
+      if sim and (ram_crc() != patch):
+        print("%s %s: the RAM is not the patch" % (name, title))
+        return 1
+    if sim:
+      crcs.append((mode, ram_crc()))
+    if mode == tof.eDOWNLOAD_RECORD:
+      base = best
+    print("%s %-18s: best %7.1f ms, cpu %6.1f ms, %.2fx" % (name, title, best * 1000, cpu * 1000 / rounds, base / best))
+
+  tof._load_bootloader()
+  t0 = time.time()
+  if tof.begin() != 0:
+    print("%s: begin failed" % name)
+    return 1
+  print("%s begin(block deferred ack): %.1f ms" % (name, (time.time() - t0) * 1000))
+  bench_common.emit("ram", crcs)
+  return 0
+
+if __name__ == "__main__":
+  rounds = int(sys.argv[1]) if len(sys.argv) > 1 else 5
+  bus_id = int(sys.argv[2]) if len(sys.argv) > 2 else 1
+  if os.environ.get("TMF8X01_BENCH_CHILD"):
+    sys.exit(run(rounds, bus_id))
+  argv = [sys.executable] + sys.argv[:1] + [str(rounds), str(bus_id)]
+  errors, results = bench_common.run_children([("native", argv, bench_common.child_env("1", False)),
+                                               ("python", argv, bench_common.child_env("1", True))])
+  if bench_common.simulated():
+    errors += not bench_common.compare(results, "native", "python", "ram")
+  sys.exit(bench_common.finish(errors))
@@ -0,0 +1,68 @@
+# -*- coding:utf-8 -*-
+'''!
+  @file GPIO.py
+  @brief The calls of RPi.GPIO the driver makes, for the benchmarks on a host without it. Outputs do nothing, an edge
+  @n callback runs on a thread of its own like in RPi.GPIO, at each result of the sensor simulated by fake_i2c.so.
+  @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license     The MIT License (MIT)
+  @author      Arya(xue.peng@dfrobot.com)
+  @version     V1.0
+  @date        2026-10-19
+  @url https://github.com/DFRobot/DFRobot_TMF8x01
+'''
+import ctypes
+import threading
+import time
+
+BCM = 11
+OUT = 0
+IN = 1
+LOW = 0
+HIGH = 1
+PUD_UP = 22
+RISING = 31
+FALLING = 32
+
+_fake = ctypes.CDLL(None)
+_fake.fake_next_result_us.restype = ctypes.c_long
+_stops = {}
+
+def setmode(mode):
+  pass
+
+def setwarnings(flag):
+  pass
+
+def setup(pin, direction, pull_up_down = None):
+  pass
+
+def output(pin, value):
+  pass
+
+def cleanup(*args):
+  for stop in _stops.values():
+    stop.set()
+  _stops.clear()
+
+def _edges(pin, callback, stop):
+  while not stop.is_set():
+    us = _fake.fake_next_result_us()
+    if us < 0:
+      time.sleep(0.01)
+      continue
+    #just after the result, so that it is there when the callback reads it.
+    time.sleep(us / 1e6 + 0.0002)
+    if not stop.is_set():
+      callback(pin)
+
+def add_event_detect(pin, edge, callback = None, bouncetime = None):
+  stop = threading.Event()
+  _stops[pin] = stop
+  t = threading.Thread(target = _edges, args = (pin, callback, stop))
+  t.daemon = True
+  t.start()
+
+def remove_event_detect(pin):
+  stop = _stops.pop(pin, None)
+  if stop is not None:
+    stop.set()
@@ -0,0 +1,333 @@
+/*!
+ * @file fake_i2c.c
+ * @brief A TMF8801 on a simulated /dev/i2c-N for the benchmarks, loaded with LD_PRELOAD. open() of any /dev/i2c-N
+ * @n gives a descriptor of the simulated bus, its I2C_RDWR, I2C_SMBUS(the smbus module) and write() calls reach the
+ * @n registers of the sensor, all other descriptors go to the C library. Both paths of the driver, the native part
+ * @n and pure Python, see the same sensor:
+ * @n 1. The bootloader(app id 0x80) with its checksum and the ACK 00 00 FF at 0x08, it keeps the RAM patch
+ * @n    downloaded, RAM remap(0x11) starts the application(app id 0xC0).
+ * @n 2. The application measures with the period of CMD_DATA2 in ms(0: 100 ms) on the clock of the host. The result
+ * @n    of tid n has the distance 100 + 7 * n mm and confidence 63, its sysclock stamp is the time it was captured.
+ * @n    INT_STATUS bit 0 is set by each result and write-1-to-clear.
+ * @n build: gcc -shared -fPIC -O2 -o benchmark/fake/fake_i2c.so benchmark/fake/fake_i2c.c -ldl
+ * @n run:   LD_PRELOAD=$PWD/benchmark/fake/fake_i2c.so PYTHONPATH=benchmark/fake python3 benchmark/native_bench.py
+ * @n benchmark/fake also holds smbus and RPi.GPIO for a host without them, its GPIO edges come from the simulated INT.
+ * @n Environment: FAKE_I2C_HZ the bus clock(default 0: no bus time), FAKE_I2C_FAIL_CMD the number of a bootloader
+ * @n command to answer with an error, from 1.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#define FAKE_MAX_FDS            8
+#define FAKE_RAM_SIZE           65536
+#define REG_APPID               0x00
+#define REG_APPREQID            0x02
+#define REG_CMD_STAT            0x08           /* bootloader command and its ACK */
+#define REG_CMD_DATA2           0x0D           /* measurement period, ms */
+#define REG_COMMAND             0x10
+#define REG_STATUS              0x1D
+#define REG_ENABLE              0xE0
+#define REG_INT_STATUS          0xE1
+#define APP_BOOTLOADER          0x80
+#define APP_MEASURE             0xC0
+
+static int fakeFd[FAKE_MAX_FDS] = {-1, -1, -1, -1, -1, -1, -1, -1};
+static int started = 0;
+static uint8_t regs[256];
+static int app = APP_BOOTLOADER;
+static int measuring = 0;
+static uint8_t tid = 0;
+static uint64_t t0Us, nextUs;
+static uint32_t periodUs = 100000;
+static uint8_t ram[FAKE_RAM_SIZE];
+static unsigned ramAddr = 0, ramMax = 0;
+static unsigned long transfers = 0, bootCmds = 0, badCmds = 0;
+static long busHz = -1, failCmd = -1;
+
+static uint64_t nowNs(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int isFake(int fd){
+  if(fd < 0) return 0;
+  for(int i = 0; i < FAKE_MAX_FDS; i++){
+      if(fakeFd[i] == fd) return 1;
+  }
+  return 0;
+}
+
+/* the bus time of a transfer of len bytes: 9 clocks per byte and the address, 50 us for the rest. */
+static void busTime(unsigned len){
+  uint64_t end;
+  if(busHz < 0){
+      const char *e = getenv("FAKE_I2C_HZ");
+      busHz = e ? atol(e) : 0;
+      e = getenv("FAKE_I2C_FAIL_CMD");
+      failCmd = e ? atol(e) : -1;
+  }
+  if(busHz <= 0) return;
+  end = nowNs() + (uint64_t)(len + 1) * 9 * 1000000000ULL / busHz + 50000;
+  while(nowNs() < end);
+}
+
+/* the results which are due, only the latest is kept like on the sensor. */
+static void update(void){
+  uint64_t now = nowNs() / 1000, capture;
+  uint32_t clk;
+  uint16_t distance;
+  if(!measuring || (now < nextUs)) return;
+  while(nextUs <= now){
+      capture = nextUs;
+      nextUs += periodUs;
+      tid++;
+  }
+  clk = (uint32_t)((capture - t0Us) * 5) | 0x01;
+  distance = 100 + 7 * tid;
+  regs[REG_STATUS + 1] = 0x55;
+  regs[REG_STATUS + 2] = tid;
+  regs[REG_STATUS + 3] = tid;
+  regs[REG_STATUS + 4] = 63;
+  regs[REG_STATUS + 5] = distance & 0xFF;
+  regs[REG_STATUS + 6] = distance >> 8;
+  memcpy(&regs[REG_STATUS + 7], &clk, 4);
+  regs[REG_INT_STATUS] |= 0x01;
+}
+
+static void bootCommand(const uint8_t *d, int len){
+  uint8_t sum = 0;
+  bootCmds++;
+  for(int i = 0; i < len - 1; i++) sum += d[i];
+  sum ^= 0xFF;
+  if((len < 3) || (d[1] + 3 != len) || (sum != d[len - 1]) || (failCmd == (long)bootCmds)){
+      badCmds++;
+      regs[REG_CMD_STAT] = d[0];
+      regs[REG_CMD_STAT + 1] = 0x01;
+      regs[REG_CMD_STAT + 2] = 0x00;
+      return;
+  }
+  switch(d[0]){
+    case 0x11:
+      app = APP_MEASURE;
+      regs[REG_APPID] = APP_MEASURE;
+      regs[REG_ENABLE] = 0x41;
+      return;
+    case 0x14:
+      ramAddr = 0;
+      ramMax = 0;
+      break;
+    case 0x43:
+      ramAddr = d[2] | (d[3] << 8);
+      break;
+    case 0x41:
+      if(ramAddr + d[1] <= FAKE_RAM_SIZE){
+          memcpy(ram + ramAddr, d + 2, d[1]);
+          ramAddr += d[1];
+          if(ramAddr > ramMax) ramMax = ramAddr;
+      }
+      break;
+  }
+  regs[REG_CMD_STAT] = 0x00;
+  regs[REG_CMD_STAT + 1] = 0x00;
+  regs[REG_CMD_STAT + 2] = 0xFF;
+}
+
+static void command(uint8_t cmd){
+  switch(cmd){
+    case 0x02:
+      measuring = 1;
+      tid = 0;
+      periodUs = regs[REG_CMD_DATA2] ? regs[REG_CMD_DATA2] * 1000 : 100000;
+      t0Us = nowNs() / 1000;
+      nextUs = t0Us + periodUs;
+      regs[REG_STATUS + 1] = 0x55;
+      regs[REG_STATUS + 2] = 0;
+      break;
+    case 0xFF:
+      measuring = 0;
+      regs[REG_STATUS + 1] = 0;
+      break;
+    case 0x47:                                /* serial number */
+      regs[REG_STATUS + 1] = 0x47;
+      regs[0x28] = 1;
+      regs[0x29] = 2;
+      regs[0x2A] = 0x20;
+      regs[0x2B] = 0x41;
+      break;
+    default:
+      regs[REG_STATUS + 1] = cmd;
+      break;
+  }
+}
+
+static void onWrite(uint8_t reg, const uint8_t *d, int len){
+  for(int i = 0; i < len; i++){
+      uint8_t r = reg + i;
+      if(r == REG_INT_STATUS) regs[r] &= ~d[i];
+      else regs[r] = d[i];
+  }
+  if(reg == REG_ENABLE){
+      if(d[0] & 0x80){
+          app = APP_BOOTLOADER;
+          measuring = 0;
+          regs[REG_ENABLE] = 0x00;
+      }else if(d[0] & 0x01){
+          regs[REG_ENABLE] = 0x41;
+      }
+      regs[REG_APPID] = app;
+      return;
+  }
+  if(reg == REG_APPREQID){
+      app = d[0];
+      regs[REG_APPID] = app;
+      return;
+  }
+  if((app == APP_BOOTLOADER) && (reg == REG_CMD_STAT)){
+      bootCommand(d, len);
+      return;
+  }
+  if((app == APP_MEASURE) && (reg <= REG_COMMAND) && (reg + len > REG_COMMAND)) command(regs[REG_COMMAND]);
+}
+
+int open(const char *path, int flags, ...){
+  static int (*real)(const char *, int, ...);
+  va_list ap;
+  mode_t mode = 0;
+  int fd;
+  if(!real) real = dlsym(RTLD_NEXT, "open");
+  va_start(ap, flags);
+  if(flags & O_CREAT) mode = va_arg(ap, int);
+  va_end(ap);
+  if(strncmp(path, "/dev/i2c-", 9) != 0) return real(path, flags, mode);
+  for(int i = 0; i < FAKE_MAX_FDS; i++){
+      if(fakeFd[i] >= 0) continue;
+      fd = real("/dev/null", O_RDWR | (flags & O_CLOEXEC));
+      if(fd < 0) return fd;
+      fakeFd[i] = fd;
+      if(!started){
+          started = 1;
+          regs[REG_APPID] = APP_BOOTLOADER;
+          regs[REG_ENABLE] = 0x41;
+      }
+      return fd;
+  }
+  errno = EMFILE;
+  return -1;
+}
+int open64(const char *path, int flags, ...) __attribute__((alias("open")));
+
+int close(int fd){
+  static int (*real)(int);
+  if(!real) real = dlsym(RTLD_NEXT, "close");
+  for(int i = 0; i < FAKE_MAX_FDS; i++){
+      if(fakeFd[i] == fd) fakeFd[i] = -1;
+  }
+  return real(fd);
+}
+
+static int rdwr(struct i2c_rdwr_ioctl_data *d){
+  uint8_t ptr = 0;
+  for(unsigned i = 0; i < d->nmsgs; i++){
+      struct i2c_msg *m = &d->msgs[i];
+      busTime(m->len);
+      if(m->flags & I2C_M_RD){
+          for(int k = 0; k < m->len; k++) m->buf[k] = regs[(uint8_t)(ptr + k)];
+      }else if(m->len > 0){
+          ptr = m->buf[0];
+          if(m->len > 1) onWrite(ptr, m->buf + 1, m->len - 1);
+      }
+  }
+  return d->nmsgs;
+}
+
+static int smbus(struct i2c_smbus_ioctl_data *d){
+  uint8_t len;
+  if(d->size != I2C_SMBUS_I2C_BLOCK_DATA){
+      errno = EOPNOTSUPP;
+      return -1;
+  }
+  len = d->data->block[0];
+  if((len == 0) || (len > I2C_SMBUS_BLOCK_MAX)){
+      errno = EINVAL;
+      return -1;
+  }
+  busTime(len + 1);
+  if(d->read_write == I2C_SMBUS_READ){
+      for(int k = 0; k < len; k++) d->data->block[k + 1] = regs[(uint8_t)(d->command + k)];
+  }else{
+      onWrite(d->command, d->data->block + 1, len);
+  }
+  return 0;
+}
+
+int ioctl(int fd, unsigned long req, ...){
+  static int (*real)(int, unsigned long, ...);
+  va_list ap;
+  void *arg;
+  if(!real) real = dlsym(RTLD_NEXT, "ioctl");
+  va_start(ap, req);
+  arg = va_arg(ap, void *);
+  va_end(ap);
+  if(!isFake(fd)) return real(fd, req, arg);
+  if((req == I2C_SLAVE) || (req == I2C_SLAVE_FORCE)) return 0;
+  transfers++;
+  update();
+  if(req == I2C_RDWR) return rdwr(arg);
+  if(req == I2C_SMBUS) return smbus(arg);
+  errno = ENOTTY;
+  return -1;
+}
+
+ssize_t write(int fd, const void *buf, size_t n){
+  static ssize_t (*real)(int, const void *, size_t);
+  if(!real) real = dlsym(RTLD_NEXT, "write");
+  if(!isFake(fd)) return real(fd, buf, n);
+  transfers++;
+  busTime(n);
+  update();
+  if(n > 1) onWrite(((const uint8_t *)buf)[0], (const uint8_t *)buf + 1, n - 1);
+  return n;
+}
+
+/* for the benchmarks through ctypes.CDLL(None): the RAM the patch was written to, its size. */
+unsigned fake_ram(uint8_t *out, unsigned max){
+  unsigned n = (ramMax < max) ? ramMax : max;
+  memcpy(out, ram, n);
+  return n;
+}
+
+/* bootloader commands answered with an error. */
+unsigned long fake_bad(void){
+  return badCmds;
+}
+
+/* ioctl() and write() calls on the bus. */
+unsigned long fake_transfers(void){
+  return transfers;
+}
+
+/* us until the next result, -1 when not measuring. */
+long fake_next_result_us(void){
+  uint64_t now = nowNs() / 1000;
+  if(!measuring) return -1;
+  return (nextUs > now) ? (long)(nextUs - now) : 0;
+}
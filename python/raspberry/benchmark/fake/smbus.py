@@ -0,0 +1,61 @@
+# -*- coding:utf-8 -*-
+'''!
+  @file smbus.py
+  @brief The calls of the smbus module the driver makes, through the I2C_SMBUS ioctl of i2c-dev like the C module,
+  @n for a host without python-smbus. With fake_i2c.so loaded the ioctl reaches the simulated sensor.
+  @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license     The MIT License (MIT)
+  @author      Arya(xue.peng@dfrobot.com)
+  @version     V1.0
+  @date        2026-10-19
+  @url https://github.com/DFRobot/DFRobot_TMF8x01
+'''
+import ctypes
+import fcntl
+import os
+
+I2C_SLAVE = 0x0703
+I2C_SMBUS = 0x0720
+I2C_SMBUS_READ = 1
+I2C_SMBUS_WRITE = 0
+I2C_SMBUS_I2C_BLOCK_DATA = 8
+I2C_SMBUS_BLOCK_MAX = 32
+
+class _Data(ctypes.Union):
+  _fields_ = [('byte', ctypes.c_uint8), ('word', ctypes.c_uint16), ('block', ctypes.c_uint8 * (I2C_SMBUS_BLOCK_MAX + 2))]
+
+class _Ioctl(ctypes.Structure):
+  _fields_ = [('read_write', ctypes.c_uint8), ('command', ctypes.c_uint8), ('size', ctypes.c_uint32),
+              ('data', ctypes.POINTER(_Data))]
+
+class SMBus(object):
+  def __init__(self, bus):
+    self.fd = os.open("/dev/i2c-%d" % bus, os.O_RDWR)
+    self.addr = None
+
+  def close(self):
+    os.close(self.fd)
+
+  def _access(self, addr, rw, reg, data):
+    if addr != self.addr:
+      fcntl.ioctl(self.fd, I2C_SLAVE, addr)
+      self.addr = addr
+    msg = _Ioctl(rw, reg, I2C_SMBUS_I2C_BLOCK_DATA, ctypes.pointer(data))
+    fcntl.ioctl(self.fd, I2C_SMBUS, msg)
+
+  def read_i2c_block_data(self, addr, reg, length = I2C_SMBUS_BLOCK_MAX):
+    if (length < 1) or (length > I2C_SMBUS_BLOCK_MAX):
+      raise ValueError("Length must be 1..32")
+    data = _Data()
+    data.block[0] = length
+    self._access(addr, I2C_SMBUS_READ, reg, data)
+    return list(data.block[1:length + 1])
+
+  def write_i2c_block_data(self, addr, reg, vals):
+    if (len(vals) < 1) or (len(vals) > I2C_SMBUS_BLOCK_MAX):
+      raise OverflowError("Third argument must be a list of at least one, but not more than 32 integers")
+    data = _Data()
+    data.block[0] = len(vals)
+    for i, v in enumerate(vals):
+      data.block[i + 1] = v
+    self._access(addr, I2C_SMBUS_WRITE, reg, data)
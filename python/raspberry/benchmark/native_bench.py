@@ -0,0 +1,81 @@
+# -*- coding:utf-8 -*-
+'''!
+  @file native_bench.py
+  @brief Boot time and CPU per sample of the driver, with the native part and with pure Python(smbus).
+  @n Each mode runs in its own process: begin() with the RAM patch download, start_measurement(), then the samples
+  @n are polled the way the demos do. The boot CPU time counts only this process, not the time asleep, the poll time only the driver calls.
+  @n On the simulated sensor(benchmark/fake/fake_i2c.c) the raw distance of every tid must be the same in both modes,
+  @n and the corrected one within 1%.
+  @n usage: python3 native_bench.py [samples] [bus_id]
+  @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license     The MIT License (MIT)
+  @author      Arya(xue.peng@dfrobot.com)
+  @version     V1.0
+  @date        2026-10-19
+  @url https://github.com/DFRobot/DFRobot_TMF8x01
+'''
+from __future__ import print_function
+import os
+import sys
+import time
+
+sys.path.append(os.path.dirname(os.path.dirname(os.path.realpath(__file__))))
+import bench_common
+
+def run(samples, bus_id):
+  from DFRobot_TMF8x01 import DFRobot_TMF8801
+  tof = DFRobot_TMF8801(enPin = -1, intPin = -1, bus_id = bus_id)
+  mode = "native" if tof.is_native() else "python"
+
+  c0 = time.process_time() if hasattr(time, "process_time") else time.clock()
+  t0 = time.time()
+  if tof.begin() != 0:
+    print("%s: begin failed" % mode)
+    return 1
+  boot = time.time() - t0
+  bootCpu = (time.process_time() if hasattr(time, "process_time") else time.clock()) - c0
+  if tof.start_measurement(calib_m = tof.eMODE_NO_CALIB) != True:
+    print("%s: start_measurement failed" % mode)
+    return 1
+
+  #the driver calls only, the loop and the sleep between the polls are the same in both modes.
+  clock = time.perf_counter if hasattr(time, "perf_counter") else time.time
+  polls = 0
+  got = 0
+  cpu = 0
+  total = 0
+  raw = []
+  corrected = []
+  while got < samples:
+    polls += 1
+    c0 = clock()
+    if tof.is_data_ready():
+      d = tof.get_distance_mm()
+      total += d
+      got += 1
+      cpu += clock() - c0
+      r = tof.result_dict
+      raw.append((r['tid'], r['disH'] << 8 | r['disL']))
+      corrected.append((r['tid'], d))
+    else:
+      cpu += clock() - c0
+    time.sleep(0.001)
+  tof.stop_measurement()
+  bench_common.emit("raw", raw)
+  bench_common.emit("distance", corrected)
+  print("%s: begin %.1f ms(cpu %.1f ms), %d samples avg %d mm, %d polls, %.1f us per poll, %.1f us per sample" %
+        (mode, boot * 1000, bootCpu * 1000, got, total // got, polls, cpu * 1e6 / polls, cpu * 1e6 / got))
+  return 0
+
+if __name__ == "__main__":
+  samples = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+  bus_id = int(sys.argv[2]) if len(sys.argv) > 2 else 1
+  if os.environ.get("TMF8X01_BENCH_CHILD"):
+    sys.exit(run(samples, bus_id))
+  argv = [sys.executable] + sys.argv[:1] + [str(samples), str(bus_id)]
+  errors, results = bench_common.run_children([("native", argv, bench_common.child_env("1", False)),
+                                               ("python", argv, bench_common.child_env("1", True))])
+  if bench_common.simulated():
+    errors += not bench_common.compare(results, "native", "python", "raw")
+    errors += not bench_common.compare(results, "native", "python", "distance", 0.01)
+  sys.exit(bench_common.finish(errors))
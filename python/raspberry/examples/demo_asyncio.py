@@ -0,0 +1,63 @@
+# -*- coding:utf-8 -*-
+
+'''
+  @file demo_asyncio.py
+  @brief Read the distance in an asyncio program, next to other tasks, Python 3.6 or later.
+  @n The INT pin wakes the program up when a measurement is completed, no core is spent on polling. A second task
+  @n stands for the network code of a service and keeps running on time while the sensor is read.
+  @n
+  @n hardware conneted table:
+  @n -------------------------------------------------------
+  @n |  TMF8x01  |            MCU                           |
+  @n |------------------------------------------------------|
+  @n |    I2C    |       I2C Interface                      |
+  @n |------------------------------------------------------|
+  @n |    EN     |   not connected, floating                |
+  @n |------------------------------------------------------|
+  @n |    INT    |   to the GPIO 22 of raspberry(BCM)       |
+  @n |------------------------------------------------------|
+  @n |    PIN0   |   not connected, floating                |
+  @n |------------------------------------------------------|
+  @n |    PIN1   |    not connected, floating               |
+  @n |------------------------------------------------------|
+  @n
+  @Copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license     The MIT License (MIT)
+  @author [Arya](xue.peng@dfrobot.com)
+  @version  V1.0
+  @date  2026-10-19
+  @url https://github.com/DFRobot/DFRobot_TMF8x01
+'''
+
+import sys
+import os
+import asyncio
+
+sys.path.append(os.path.dirname(os.path.dirname(os.path.realpath(__file__))))
+from DFRobot_TMF8x01_asyncio import DFRobot_TMF8801_Async as tof
+#from DFRobot_TMF8x01_asyncio import DFRobot_TMF8701_Async as tof
+
+async def heartbeat():
+  n = 0
+  while True:
+    await asyncio.sleep(1)
+    n += 1
+    print("heartbeat %d" % n)
+
+async def main():
+  sensor = tof(enPin = -1, intPin = 22, bus_id = 1)    # Select bus 1, INT on GPIO 22
+  print("Initialization ranging sensor TMF8x01......", end = " ")
+  while(await sensor.begin() != 0):
+    print("Initialization failed")
+    await asyncio.sleep(1)
+  print("Initialization done.")
+
+  #the same arguments as start_measurement of DFRobot_TMF8801, mode = ... for DFRobot_TMF8701
+  await sensor.start_measurement(calib_m = sensor.sensor.eMODE_CALIB)
+  asyncio.ensure_future(heartbeat())
+
+  async for sample in sensor.samples():
+    print("Distance = %d mm, tid %d, %d lost" % (sample.distance, sample.tid, sample.lost))
+
+if __name__ == "__main__":
+  asyncio.get_event_loop().run_until_complete(main())
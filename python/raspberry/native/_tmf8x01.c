@@ -0,0 +1,425 @@
+/*!
+ * @file _tmf8x01.c
+ * @brief Native part of the Raspberry Pi driver, CPython C API only. DFRobot_TMF8x01.py uses it when it is built and
+ * @n falls back to smbus when it is not. A Device is the sensor on /dev/i2c-N: register access, the RAM patch download
+ * @n of the bootloader, and the result polling with decoding and clock correction, without a Python object per poll.
+ * @n build: python3 setup.py build_ext --inplace
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <structmember.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#define REG_MTF8x01_STATUS      0x1D
+#define REG_MTF8x01_INT_STATUS  0xE1
+#define REG_MTF8x01_CMD         0x08
+#define RESULT_SIZE             11
+#define MAX_WRITE               132
+#define BL_MAX_DATA             128           /* data bytes of one bootloader command */
+#define ACK_TIMEOUT_NS          10000000ULL
+
+#if PY_MAJOR_VERSION >= 3
+#define PyInt_FromLong PyLong_FromLong
+#endif
+
+typedef struct{
+  PyObject_HEAD
+  int fd;
+  int addr;
+  int error;                 /* the last access failed */
+  int count;                 /* results kept for the clock correction, 0..4 */
+  int tid;
+  double timestamp;          /* host time / sensor time of the last 4 periods */
+  double host[5];
+  double module[5];
+  uint8_t result[RESULT_SIZE];
+}DeviceObject;
+
+static uint64_t monotonicNs(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int i2cRead(DeviceObject *self, uint8_t reg, uint8_t *buf, uint16_t len){
+  struct i2c_msg msg[2];
+  struct i2c_rdwr_ioctl_data data;
+  msg[0].addr = self->addr;
+  msg[0].flags = 0;
+  msg[0].len = 1;
+  msg[0].buf = &reg;
+  msg[1].addr = self->addr;
+  msg[1].flags = I2C_M_RD;
+  msg[1].len = len;
+  msg[1].buf = buf;
+  data.msgs = msg;
+  data.nmsgs = 2;
+  self->error = (ioctl(self->fd, I2C_RDWR, &data) != 2);
+  return self->error ? -1 : 0;
+}
+
+static int i2cWrite(DeviceObject *self, uint8_t reg, const uint8_t *buf, uint16_t len){
+  uint8_t tmp[MAX_WRITE + 1];
+  struct i2c_msg msg;
+  struct i2c_rdwr_ioctl_data data;
+  if(len > MAX_WRITE){
+      errno = EINVAL;
+      self->error = 1;
+      return -1;
+  }
+  tmp[0] = reg;
+  memcpy(tmp + 1, buf, len);
+  msg.addr = self->addr;
+  msg.flags = 0;
+  msg.len = len + 1;
+  msg.buf = tmp;
+  data.msgs = &msg;
+  data.nmsgs = 1;
+  self->error = (ioctl(self->fd, I2C_RDWR, &data) != 1);
+  return self->error ? -1 : 0;
+}
+
+/* wait for the ACK 0x00 0x00 0xFF of the last bootloader command. */
+static int bootAck(DeviceObject *self){
+  uint8_t ack[3];
+  uint64_t t = monotonicNs();
+  do{
+      if(i2cRead(self, REG_MTF8x01_CMD, ack, sizeof(ack)) != 0) return -1;
+      if((ack[0] == 0x00) && (ack[1] == 0x00) && (ack[2] == 0xFF)) return 0;
+  }while((monotonicNs() - t) < ACK_TIMEOUT_NS);
+  return -1;
+}
+
+/* a bootloader command at 0x08: cmd, size, data, checksum, then the ACK if wait. */
+static int bootCommand(DeviceObject *self, const uint8_t *cmd, uint8_t len, int wait){
+  uint8_t buf[MAX_WRITE];
+  uint8_t sum = 0;
+  memcpy(buf, cmd, len);
+  for(uint8_t i = 0; i < len; i++) sum += cmd[i];
+  buf[len] = sum ^ 0xFF;
+  if(i2cWrite(self, REG_MTF8x01_CMD, buf, len + 1) != 0) return -1;
+  return wait ? bootAck(self) : 0;
+}
+
+static int Device_init(DeviceObject *self, PyObject *args, PyObject *kwds){
+  static char *kwlist[] = {"bus", "addr", NULL};
+  PyObject *bus;
+  char path[64];
+  int addr = 0x41;
+  if(!PyArg_ParseTupleAndKeywords(args, kwds, "O|i", kwlist, &bus, &addr)) return -1;
+  if(self->fd >= 0) close(self->fd);
+  self->fd = -1;
+#if PY_MAJOR_VERSION < 3
+  if(PyInt_Check(bus)){
+      snprintf(path, sizeof(path), "/dev/i2c-%ld", PyInt_AsLong(bus));
+  }else
+#endif
+  if(PyLong_Check(bus)){
+      snprintf(path, sizeof(path), "/dev/i2c-%ld", PyLong_AsLong(bus));
+  }else{
+      PyObject *s = PyObject_Str(bus);
+      if(s == NULL) return -1;
+#if PY_MAJOR_VERSION >= 3
+      snprintf(path, sizeof(path), "%s", PyUnicode_AsUTF8(s));
+#else
+      snprintf(path, sizeof(path), "%s", PyString_AsString(s));
+#endif
+      Py_DECREF(s);
+  }
+  self->fd = open(path, O_RDWR | O_CLOEXEC);
+  if(self->fd < 0){
+      PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+      return -1;
+  }
+  self->addr = addr;
+  self->error = 0;
+  self->count = 0;
+  self->tid = 0;
+  self->timestamp = 1;
+  memset(self->host, 0, sizeof(self->host));
+  memset(self->module, 0, sizeof(self->module));
+  memset(self->result, 0, sizeof(self->result));
+  return 0;
+}
+
+static PyObject *Device_new(PyTypeObject *type, PyObject *args, PyObject *kwds){
+  DeviceObject *self = (DeviceObject *)type->tp_alloc(type, 0);
+  (void)args;
+  (void)kwds;
+  if(self != NULL) self->fd = -1;
+  return (PyObject *)self;
+}
+
+static void Device_dealloc(DeviceObject *self){
+  if(self->fd >= 0) close(self->fd);
+  Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *Device_close(DeviceObject *self, PyObject *unused){
+  (void)unused;
+  if(self->fd >= 0) close(self->fd);
+  self->fd = -1;
+  Py_RETURN_NONE;
+}
+
+static PyObject *Device_read_bytes(DeviceObject *self, PyObject *args){
+  uint8_t buf[256];
+  int reg, len;
+  PyObject *list;
+  if(!PyArg_ParseTuple(args, "ii", &reg, &len)) return NULL;
+  if((len < 0) || (len > (int)sizeof(buf))){
+      PyErr_SetString(PyExc_ValueError, "length out of range");
+      return NULL;
+  }
+  if(i2cRead(self, reg, buf, len) != 0) return PyErr_SetFromErrno(PyExc_IOError);
+  list = PyList_New(len);
+  if(list == NULL) return NULL;
+  for(int i = 0; i < len; i++) PyList_SET_ITEM(list, i, PyInt_FromLong(buf[i]));
+  return list;
+}
+
+static PyObject *Device_write_bytes(DeviceObject *self, PyObject *args){
+  uint8_t buf[MAX_WRITE];
+  PyObject *seq, *fast;
+  Py_ssize_t len;
+  int reg;
+  if(!PyArg_ParseTuple(args, "iO", &reg, &seq)) return NULL;
+  fast = PySequence_Fast(seq, "data must be a sequence of bytes");
+  if(fast == NULL) return NULL;
+  len = PySequence_Fast_GET_SIZE(fast);
+  if(len > MAX_WRITE){
+      Py_DECREF(fast);
+      PyErr_SetString(PyExc_ValueError, "too many bytes");
+      return NULL;
+  }
+  for(Py_ssize_t i = 0; i < len; i++){
+      buf[i] = (uint8_t)PyLong_AsLong(PySequence_Fast_GET_ITEM(fast, i));
+  }
+  Py_DECREF(fast);
+  if(PyErr_Occurred()) return NULL;
+  if(i2cWrite(self, reg, buf, len) != 0) return PyErr_SetFromErrno(PyExc_IOError);
+  Py_RETURN_NONE;
+}
+
+static PyObject *Device_download_patch(DeviceObject *self, PyObject *args){
+  static const uint8_t bootloaderReset[] = {0x14, 0x01, 0x29};
+  static const uint8_t setAddress[] = {0x43, 0x02, 0x00, 0x00};
+  static const uint8_t ramRemap[] = {0x11, 0x00};
+  uint8_t cmd[MAX_WRITE];
+  const uint8_t *p;
+  Py_ssize_t size, i = 0;
+  int block = 0, ack = 1, ok = 0;
+  uint8_t len = 0;
+  Py_buffer patch;
+#if PY_MAJOR_VERSION >= 3
+  if(!PyArg_ParseTuple(args, "y*|ii", &patch, &block, &ack)) return NULL;
+#else
+  if(!PyArg_ParseTuple(args, "s*|ii", &patch, &block, &ack)) return NULL;
+#endif
+  if((block < 0) || (block > BL_MAX_DATA)){
+      PyBuffer_Release(&patch);
+      PyErr_SetString(PyExc_ValueError, "block out of range");
+      return NULL;
+  }
+  p = (const uint8_t *)patch.buf;
+  size = patch.len;
+  Py_BEGIN_ALLOW_THREADS
+  if((bootCommand(self, bootloaderReset, sizeof(bootloaderReset), 1) == 0) &&
+     (bootCommand(self, setAddress, sizeof(setAddress), 1) == 0)){
+      ok = 1;
+      /* records of [length, data...], a length of 0 ends the patch. The RAM address goes up by itself, so with a
+         block the data of the records is sent in commands of block bytes instead, the last one may be shorter. */
+      cmd[0] = 0x41;
+      while(ok && (i < size) && p[i]){
+          uint8_t n = p[i];
+          if((i + 1 + n > size) || (n > BL_MAX_DATA)){
+              ok = 0;
+              break;
+          }
+          i++;
+          while(n){
+              uint8_t room = (block ? block : n) - len;
+              uint8_t part = (n < room) ? n : room;
+              memcpy(cmd + 2 + len, p + i, part);
+              len += part;
+              i += part;
+              n -= part;
+              if(block && (len < block)) continue;
+              cmd[1] = len;
+              if(bootCommand(self, cmd, len + 2, ack) != 0){
+                  ok = 0;
+                  break;
+              }
+              len = 0;
+          }
+      }
+      if(ok && len){
+          cmd[1] = len;
+          ok = (bootCommand(self, cmd, len + 2, ack) == 0);
+      }
+      /* deferred: only the last command is checked, an I2C error before it already failed. */
+      if(ok && !ack) ok = (bootAck(self) == 0);
+      /* the remap resets the cpu, it does not ACK. */
+      if(ok){
+          uint8_t sum = (ramRemap[0] + ramRemap[1]) ^ 0xFF;
+          uint8_t buf[3] = {ramRemap[0], ramRemap[1], sum};
+          ok = (i2cWrite(self, REG_MTF8x01_CMD, buf, sizeof(buf)) == 0);
+      }
+  }
+  Py_END_ALLOW_THREADS
+  PyBuffer_Release(&patch);
+  return PyBool_FromLong(ok);
+}
+
+static void clearInt(DeviceObject *self, int always){
+  uint8_t val = 0;
+  if(i2cRead(self, REG_MTF8x01_INT_STATUS, &val, 1) != 0) return;
+  if(always || (val & 0x01)){
+      val |= 0x01;
+      i2cWrite(self, REG_MTF8x01_INT_STATUS, &val, 1);
+  }
+}
+
+static PyObject *Device_poll(DeviceObject *self, PyObject *args){
+  uint8_t r[RESULT_SIZE];
+  int intEnabled = 0;
+  double t;
+  if(!PyArg_ParseTuple(args, "|i", &intEnabled)) return NULL;
+  t = monotonicNs() / 1e9;
+  if(i2cRead(self, REG_MTF8x01_STATUS, r, sizeof(r)) != 0) Py_RETURN_FALSE;
+  if((r[1] == 0x55) && (r[2] != self->tid)){
+      /* the same steps as is_data_ready() of the Python class, host time in 0.1ms, sensor time 0.2us/100. */
+      uint32_t j = ((uint32_t)r[10] << 24) | ((uint32_t)r[9] << 16) | ((uint32_t)r[8] << 8) | r[7];
+      self->tid = r[2];
+      memcpy(self->result, r, sizeof(r));
+      if(self->count < 4){
+          self->host[self->count] = t * 10000;
+          self->module[self->count] = j * 0.2 / 100;
+          self->count++;
+      }else if(self->count == 4){
+          double t1, t2;
+          self->host[4] = t * 10000;
+          self->module[4] = j * 0.2 / 100;
+          t1 = self->host[4] - self->host[0];
+          t2 = self->module[4] - self->module[0];
+          self->timestamp = 1;
+          if(t2 > 0) self->timestamp = t1 / t2;
+          memmove(self->host, self->host + 1, sizeof(double) * 4);
+          memmove(self->module, self->module + 1, sizeof(double) * 4);
+          Py_RETURN_TRUE;
+      }else{
+          self->count = 0;
+      }
+  }
+  if(intEnabled) clearInt(self, 0);
+  Py_RETURN_FALSE;
+}
+
+static PyObject *Device_distance(DeviceObject *self, PyObject *args){
+  int intEnabled = 0;
+  double dis;
+  if(!PyArg_ParseTuple(args, "|i", &intEnabled)) return NULL;
+  dis = ((self->result[6] << 8) | self->result[5]) * self->timestamp;
+  if(intEnabled) clearInt(self, 1);
+  return PyInt_FromLong((long)dis);
+}
+
+static PyObject *Device_get_result(DeviceObject *self, void *closure){
+  (void)closure;
+#if PY_MAJOR_VERSION >= 3
+  return PyBytes_FromStringAndSize((const char *)self->result, sizeof(self->result));
+#else
+  return PyString_FromStringAndSize((const char *)self->result, sizeof(self->result));
+#endif
+}
+
+static PyMethodDef Device_methods[] = {
+  {"close", (PyCFunction)Device_close, METH_NOARGS, "close the i2c device"},
+  {"read_bytes", (PyCFunction)Device_read_bytes, METH_VARARGS, "read_bytes(reg, n) -> list, raises IOError"},
+  {"write_bytes", (PyCFunction)Device_write_bytes, METH_VARARGS, "write_bytes(reg, data), raises IOError"},
+  {"download_patch", (PyCFunction)Device_download_patch, METH_VARARGS,
+   "download_patch(patch, block=0, ack=True) -> bool, the bootloader must be running, patch is the bytes of\n"
+   "[length, data...] records. block 0 sends the records as they are, 1..128 sends the data in commands of block\n"
+   "bytes. ack False checks the ACK only after the last command."},
+  {"poll", (PyCFunction)Device_poll, METH_VARARGS, "poll(int_enabled) -> bool, is_data_ready() of the driver"},
+  {"distance", (PyCFunction)Device_distance, METH_VARARGS, "distance(int_enabled) -> int, get_distance_mm() of the driver"},
+  {NULL, NULL, 0, NULL}
+};
+
+static PyMemberDef Device_members[] = {
+  {"addr", T_INT, offsetof(DeviceObject, addr), 0, "7 bits I2C address"},
+  {"fd", T_INT, offsetof(DeviceObject, fd), READONLY, "file descriptor of the i2c device"},
+  {"error", T_INT, offsetof(DeviceObject, error), READONLY, "1 if the last access failed"},
+  {"count", T_INT, offsetof(DeviceObject, count), 0, "results kept for the clock correction"},
+  {"tid", T_INT, offsetof(DeviceObject, tid), 0, "transaction ID of the last result"},
+  {"timestamp", T_DOUBLE, offsetof(DeviceObject, timestamp), 0, "clock correction factor"},
+  {NULL, 0, 0, 0, NULL}
+};
+
+static PyGetSetDef Device_getset[] = {
+  {"result", (getter)Device_get_result, NULL, "the 11 bytes of the last result from 0x1D", NULL},
+  {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyTypeObject DeviceType = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+  "_tmf8x01.Device",
+};
+
+static PyMethodDef module_methods[] = {
+  {NULL, NULL, 0, NULL}
+};
+
+static int setupType(void){
+  DeviceType.tp_basicsize = sizeof(DeviceObject);
+  DeviceType.tp_flags = Py_TPFLAGS_DEFAULT;
+  DeviceType.tp_doc = "Device(bus, addr=0x41): a TMF8x01 on /dev/i2c-<bus>, or on the path given as bus";
+  DeviceType.tp_new = Device_new;
+  DeviceType.tp_init = (initproc)Device_init;
+  DeviceType.tp_dealloc = (destructor)Device_dealloc;
+  DeviceType.tp_methods = Device_methods;
+  DeviceType.tp_members = Device_members;
+  DeviceType.tp_getset = Device_getset;
+  return PyType_Ready(&DeviceType);
+}
+
+#if PY_MAJOR_VERSION >= 3
+static struct PyModuleDef moduledef = {
+  PyModuleDef_HEAD_INIT, "_tmf8x01", "Native part of the DFRobot TMF8x01 driver.", -1, module_methods,
+};
+
+PyMODINIT_FUNC PyInit__tmf8x01(void){
+  PyObject *m;
+  if(setupType() < 0) return NULL;
+  m = PyModule_Create(&moduledef);
+  if(m == NULL) return NULL;
+  Py_INCREF(&DeviceType);
+  PyModule_AddObject(m, "Device", (PyObject *)&DeviceType);
+  return m;
+}
+#else
+PyMODINIT_FUNC init_tmf8x01(void){
+  PyObject *m;
+  if(setupType() < 0) return;
+  m = Py_InitModule3("_tmf8x01", module_methods, "Native part of the DFRobot TMF8x01 driver.");
+  if(m == NULL) return;
+  Py_INCREF(&DeviceType);
+  PyModule_AddObject(m, "Device", (PyObject *)&DeviceType);
+}
+#endif
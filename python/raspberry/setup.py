@@ -0,0 +1,23 @@
+# -*- coding:utf-8 -*-
+'''!
+  @file setup.py
+  @brief Build the native part of the driver next to DFRobot_TMF8x01.py, it needs only the Python headers:
+  @n python3 setup.py build_ext --inplace
+  @n DFRobot_TMF8x01.py uses it when it is there, and the pure Python code when it is not.
+  @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license     The MIT License (MIT)
+  @author      Arya(xue.peng@dfrobot.com)
+  @version     V1.0
+  @date        2026-10-19
+  @url https://github.com/DFRobot/DFRobot_TMF8x01
+'''
+try:
+  from setuptools import setup, Extension
+except ImportError:
+  from distutils.core import setup, Extension
+
+setup(
+  name = "DFRobot_TMF8x01_native",
+  version = "1.0.0",
+  ext_modules = [Extension("_tmf8x01", ["native/_tmf8x01.c"], extra_compile_args = ["-O2", "-std=gnu99"])],
+)
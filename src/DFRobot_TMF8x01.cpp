@@ -11,6 +11,7 @@
  */
 #include <Arduino.h>
 #include "DFRobot_TMF8x01.h"
+#include "DFRobot_TMF8x01_Latency.h"
 
 
 #define REG_MTF8x01_ENABLE    0xE0
@@ -28,6 +29,7 @@
 #define REG_MTF8x01_CMD_DATA1   0X0E
 #define REG_MTF8x01_CMD_DATA0   0X0F
 #define REG_MTF8x01_COMMAND     0X10
+#define REG_MTF8x01_PREVIOUS    0X11
 #define REG_MTF8x01_FACTORYCALIB   0X20
 #define REG_MTF8x01_STATEDATAWR    0X2E
 #define REG_MTF8x01_STATUS         0x1D
@@ -44,15 +46,45 @@
 
 
 DFRobot_TMF8x01::DFRobot_TMF8x01(int enPin, int intPin,TwoWire &pWire)
-  :_en(enPin),_intPin(intPin),_initialize(false),_count(0), _config(0),_timestamp(0), _measureCmdFlag(false),_addr(0x41), _pWire(&pWire){
+  :_measureCmdFlag(false),_en(enPin),_intPin(intPin),_initialize(false),_count(0), _config(0),_timestamp(1),_standbyMeasure(false),_singleShotIterations(0),_histogramBuf(NULL),_histogramBufSize(0),_histogramCb(NULL),_addr(TMF8x01_I2C_ADDR), _pWire(&pWire)
+#if TMF8x01_USE_BUS
+  ,_pBus(NULL)
+#endif
+{
   memset(_hostTime, 0 ,sizeof(_hostTime));
   memset(_MoudleTime, 0 ,sizeof(_MoudleTime));
   memset(&_result, 0 ,sizeof(_result));
   memset(_measureCmdSet, 0 , sizeof(_measureCmdSet));
   memset(_calibData, 0 , sizeof(_calibData));
   memset(_algoStateData, 0 , sizeof(_algoStateData));
+#if TMF8x01_USE_SEQLOCK
+  _seq = 0;
+  memset(_sample, 0, sizeof(_sample));
+#endif
+#if TMF8x01_USE_LATENCY
+  _pLatency = NULL;
+#endif
 }
 
+#if TMF8x01_USE_BUS
+DFRobot_TMF8x01::DFRobot_TMF8x01(DFRobot_TMF8x01_Bus &bus, int enPin, int intPin)
+  :_measureCmdFlag(false),_en(enPin),_intPin(intPin),_initialize(false),_count(0), _config(0),_timestamp(1),_standbyMeasure(false),_singleShotIterations(0),_histogramBuf(NULL),_histogramBufSize(0),_histogramCb(NULL),_addr(TMF8x01_I2C_ADDR), _pWire(NULL),_pBus(&bus){
+  memset(_hostTime, 0 ,sizeof(_hostTime));
+  memset(_MoudleTime, 0 ,sizeof(_MoudleTime));
+  memset(&_result, 0 ,sizeof(_result));
+  memset(_measureCmdSet, 0 , sizeof(_measureCmdSet));
+  memset(_calibData, 0 , sizeof(_calibData));
+  memset(_algoStateData, 0 , sizeof(_algoStateData));
+#if TMF8x01_USE_SEQLOCK
+  _seq = 0;
+  memset(_sample, 0, sizeof(_sample));
+#endif
+#if TMF8x01_USE_LATENCY
+  _pLatency = NULL;
+#endif
+}
+#endif
+
 DFRobot_TMF8x01::~DFRobot_TMF8x01(){
   _pWire = NULL;
 }
@@ -60,19 +92,7 @@ DFRobot_TMF8x01::~DFRobot_TMF8x01(){
 int DFRobot_TMF8x01::begin(){
   _initialize = false;
   gpioInit();
-  if(_pWire == NULL){
-      DBG("IIC bus pointer is NULL.");
-      return -1;
-  } 
-  _pWire->begin();
-  if(!isI2CAddress(_addr)){
-      DBG("IIC addr is error.");
-      return -1;
-  }
-  sleep();
-  eEnableReg_t regValue;
-  regValue.value = 1;
-  writeReg(REG_MTF8x01_ENABLE, &regValue, sizeof(regValue));
+  if(!startCpu()) return -1;
   if(!waitForCpuReady()){
       DBG("waitForCpuReady is failed.")
       return false;
@@ -136,6 +156,44 @@ bool DFRobot_TMF8x01::wakeup(){
   return true;
 }
 
+void DFRobot_TMF8x01::enterStandby(){
+  //only clear pon, the RAM patch and all config stay in the sensor.
+  eEnableReg_t regValue;
+  _standbyMeasure = _measureCmdFlag;
+  if(_measureCmdFlag){
+      uint8_t data[] = {0xff};
+      writeReg(REG_MTF8x01_COMMAND, data, sizeof(data));
+      waitForCommand(0xff, 50);
+      _measureCmdFlag = false;
+  }
+  readReg(REG_MTF8x01_ENABLE, &regValue, sizeof(regValue));
+  regValue.pon = 0;
+  writeReg(REG_MTF8x01_ENABLE, &regValue, sizeof(regValue));
+}
+
+bool DFRobot_TMF8x01::exitStandby(){
+  eEnableReg_t regValue;
+  uint32_t t;
+  regValue.value = 1;
+  writeReg(REG_MTF8x01_ENABLE, &regValue, sizeof(regValue));
+  t = millis();
+  while(!IS_CPU_READY){
+      if((millis() - t) > 100){
+          DBG("waitForCpuReady is failed.")
+          return false;
+      }
+  }
+  if(!IS_APP0){
+      DBG("patch is lost, wakeup from bootloader.")
+      return wakeup();
+  }
+  //the sensor clock stops in standby, restart clock correction with the next samples.
+  _count = 0;
+  if(!_standbyMeasure) return true;
+  _standbyMeasure = false;
+  return restartMeasurement();
+}
+
 String DFRobot_TMF8x01::getSoftwareVersion(){
   String str = "";
   char testChr[10];
@@ -260,8 +318,31 @@ bool DFRobot_TMF8x01::setCalibrationData(uint8_t *data, uint8_t len){
 
 bool DFRobot_TMF8x01::setCaibrationMode(eCalibModeConfig_t mode){
   if((!_initialize) || _measureCmdFlag) return false;
+  writeMeasureCmd(mode);
+  
+  // for(int i = 0; i < sizeof(_measureCmdSet); i++){
+      // Serial.print(_measureCmdSet[i],HEX);
+      // Serial.print(", ");
+  // }
+  // Serial.println();
+  delay(600);
+  
+  if(!checkStatusRegister(0x55)){
+      return false;
+  }
+  //readReg(REG_MTF8x01_STATUS, &result, sizeof(result));
+  while(_count < 4){
+      if(isDataReady()){
+          getDistance_mm();
+      }
+      delay(2);
+  }
+  _measureCmdFlag = true;
+  return true;
+}
+
+void DFRobot_TMF8x01::writeMeasureCmd(eCalibModeConfig_t mode){
   uint8_t CalibCmd[] = {0x0B};
-  sResult_t result;
   switch(mode){
       case eModeCalib:
         modifyCmdSet(CMDSET_INDEX_CMD7,CMDSET_BIT_CALIB, true);
@@ -282,29 +363,78 @@ bool DFRobot_TMF8x01::setCaibrationMode(eCalibModeConfig_t mode){
         break;
 
   }
+  //the measure command sets the GPIO too, keep the config of pinConfig.
+  _measureCmdSet[CMDSET_INDEX_CMD5] = _config;
   writeReg(REG_MTF8x01_CMD_DATA7, _measureCmdSet, sizeof(_measureCmdSet));
-  
-  // for(int i = 0; i < sizeof(_measureCmdSet); i++){
-      // Serial.print(_measureCmdSet[i],HEX);
-      // Serial.print(", ");
-  // }
-  // Serial.println();
-  delay(600);
-  
-  if(!checkStatusRegister(0x55)){
-      return false;
+}
+
+bool DFRobot_TMF8x01::restartMeasurement(){
+  if(!_initialize) return false;
+  if(_measureCmdFlag){
+      /*Stop the running measurement and only wait until the device has taken the command, instead of stopMeasurement's fixed 50ms.*/
+      uint8_t data[] = {0xff};
+      writeReg(REG_MTF8x01_COMMAND, data, sizeof(data));
+      if(!waitForCommand(0xff, 50)) return false;
   }
-  //readReg(REG_MTF8x01_STATUS, &result, sizeof(result));
-  while(_count < 4){
-      if(isDataReady()){
-          getDistance_mm();
+  /*The calibration data shares the result registers, so it has to be written again in front of every measure command.*/
+  writeMeasureCmd((eCalibModeConfig_t)getCalibrationMode());
+  _measureCmdFlag = true;
+  return true;
+}
+
+bool DFRobot_TMF8x01::waitForCommand(uint8_t cmd, uint16_t timeoutMs){
+  uint8_t regValue = 0;
+  uint32_t t = millis();
+  do{
+      readReg(REG_MTF8x01_PREVIOUS, &regValue, 1);
+      if(regValue == cmd) return true;
+  }while((millis() - t) < timeoutMs);
+  return false;
+}
+
+uint16_t DFRobot_TMF8x01::getRawDistance(){
+  return (_result.disH << 8) | _result.disL;
+}
+
+bool DFRobot_TMF8x01::startSingleShot(){
+  if((!_initialize) || _measureCmdFlag) return false;
+  uint8_t period = _measureCmdSet[CMDSET_INDEX_PERIOD];
+  uint8_t iterH = _measureCmdSet[CMDSET_INDEX_ITERATIONS];
+  uint8_t iterL = _measureCmdSet[CMDSET_INDEX_ITERATIONS + 1];
+  //period 0 means the sensor does one measurement and then stays idle.
+  _measureCmdSet[CMDSET_INDEX_PERIOD] = 0;
+  if(_singleShotIterations){
+      _measureCmdSet[CMDSET_INDEX_ITERATIONS] = _singleShotIterations >> 8;
+      _measureCmdSet[CMDSET_INDEX_ITERATIONS + 1] = _singleShotIterations & 0xFF;
+  }
+  writeMeasureCmd((eCalibModeConfig_t)getCalibrationMode());
+  _measureCmdSet[CMDSET_INDEX_PERIOD] = period;
+  _measureCmdSet[CMDSET_INDEX_ITERATIONS] = iterH;
+  _measureCmdSet[CMDSET_INDEX_ITERATIONS + 1] = iterL;
+  return true;
+}
+
+bool DFRobot_TMF8x01::measureOnce(uint16_t *distance, uint16_t timeoutMs){
+  if(distance == NULL) return false;
+  if(!startSingleShot()) return false;
+  uint32_t t = millis();
+  if((_intPin > -1) && (_measureCmdSet[CMDSET_INDEX_CMD6] & (1<<CMDSET_BIT_INT))){
+      //no bus traffic until the INT pin goes low.
+      while(digitalRead(_intPin) != LOW){
+          if((millis() - t) > timeoutMs) return false;
       }
-      delay(2);
   }
-  _measureCmdFlag = true;
+  while(!isDataReady()){
+      if((millis() - t) > timeoutMs) return false;
+  }
+  *distance = getDistance_mm();
   return true;
 }
 
+void DFRobot_TMF8x01::setSingleShotIterations(uint16_t kIterations){
+  _singleShotIterations = kIterations;
+}
+
 uint8_t DFRobot_TMF8x01::getCalibrationMode(){
   uint8_t mode = 0;
   if(_measureCmdSet[CMDSET_INDEX_CMD7] & (1<< CMDSET_BIT_CALIB)){
@@ -320,61 +450,32 @@ void DFRobot_TMF8x01::stopMeasurement(){
   uint8_t data[] = {0xff};
   writeReg(REG_MTF8x01_COMMAND, data, sizeof(data));
   delay(50);
+  resetMeasurement();
+}
+
+void DFRobot_TMF8x01::resetMeasurement(){
+  //the state of a stopped measurement, also for DFRobot_TMF8x01_Coro::stopMeasurement().
   _measureCmdFlag = false;
   _count = 0;
   _timestamp = 1;
   memset(&_hostTime, 0, sizeof(_hostTime));
   memset(&_MoudleTime, 0, sizeof(_MoudleTime));
   memset(&_result, 0, sizeof(_result));
+#if TMF8x01_USE_LATENCY
+  //a new measurement may start the sensor clock again.
+  if(_pLatency) _pLatency->resync();
+#endif
 }
 
 bool DFRobot_TMF8x01::isDataReady(){
   sResult_t result;
-  uint32_t t,sysT;
-  double t1, t2;
+  uint32_t t;
 
   memset(&result, 0, sizeof(_result));
   t = millis();
   readReg(REG_MTF8x01_STATUS, &result, sizeof(result));
   //Serial.println(result.regContents,HEX);
-  if(result.regContents == 0x55){
-      DBG(result.regContents,HEX);
-      DBG(result.tid);
-      if(result.tid != _result.tid){
-          _result = result;
-#if defined(__AVR__)
-          memcpy(&sysT, &_result.sysclock0, 4);
-#else
-          sysT = ((_result.sysclock3 << 24) | (_result.sysclock2 << 16) | (_result.sysclock1 << 8) | _result.sysclock0) ;
-#endif
-          DBG(sysT,HEX);
-          DBG(t);
-          DBG(_result.sysclock3,HEX);
-          DBG(_result.sysclock2,HEX);
-          DBG(_result.sysclock1,HEX);
-          DBG(_result.sysclock0,HEX);
-          if(_count < 4){
-              _hostTime[_count] = t;
-              _MoudleTime[_count++] = sysT;
-          }else if(_count == 4){
-              _hostTime[_count] = t;
-              _MoudleTime[_count] = sysT;
-              if(_MoudleTime[4] > _MoudleTime[0] && (_hostTime[4] >= _hostTime[0])){
-                  t1 = (_hostTime[4] - _hostTime[0])*10;
-                  t2 = (_MoudleTime[4] - _MoudleTime[0])*0.2/100;
-                  if((double(t1/t2) >= 0.7) && (double(t1/t2) <= 1.3)){
-                      _timestamp = t1/t2;
-                  }
-              }
-              
-              for(int i = 0; i < 4; i++){
-                _hostTime[i] = _hostTime[i+1];
-                _MoudleTime[i] = _MoudleTime[i+1];
-              }
-          }else _count = 0;
-          return true;
-      }
-  }
+  if(takeResult(result, t)) return true;
   if(_measureCmdSet[CMDSET_INDEX_CMD6] & (1<<CMDSET_BIT_INT)){
       uint8_t val = 0;
       readReg(REG_MTF8x01_INT_STATUS, &val, 1);
@@ -387,6 +488,60 @@ bool DFRobot_TMF8x01::isDataReady(){
   return false;
 }
 
+uint32_t DFRobot_TMF8x01::getResultSysclock(){
+  uint32_t sysT;
+#if defined(__AVR__)
+  memcpy(&sysT, &_result.sysclock0, 4);
+#else
+  sysT = ((_result.sysclock3 << 24) | (_result.sysclock2 << 16) | (_result.sysclock1 << 8) | _result.sysclock0) ;
+#endif
+  return sysT;
+}
+
+bool DFRobot_TMF8x01::takeResult(const sResult_t &result, uint32_t t){
+  uint32_t sysT;
+  double t1, t2;
+
+  if(result.regContents != 0x55) return false;
+  DBG(result.regContents,HEX);
+  DBG(result.tid);
+  if(result.tid == _result.tid) return false;
+  _result = result;
+  sysT = getResultSysclock();
+  DBG(sysT,HEX);
+  DBG(t);
+  DBG(_result.sysclock3,HEX);
+  DBG(_result.sysclock2,HEX);
+  DBG(_result.sysclock1,HEX);
+  DBG(_result.sysclock0,HEX);
+  if(_count < 4){
+      _hostTime[_count] = t;
+      _MoudleTime[_count++] = sysT;
+  }else if(_count == 4){
+      _hostTime[_count] = t;
+      _MoudleTime[_count] = sysT;
+      if(_MoudleTime[4] > _MoudleTime[0] && (_hostTime[4] >= _hostTime[0])){
+          t1 = (_hostTime[4] - _hostTime[0])*10;
+          t2 = (_MoudleTime[4] - _MoudleTime[0])*0.2/100;
+          if((double(t1/t2) >= 0.7) && (double(t1/t2) <= 1.3)){
+              _timestamp = t1/t2;
+          }
+      }
+      
+      for(int i = 0; i < 4; i++){
+        _hostTime[i] = _hostTime[i+1];
+        _MoudleTime[i] = _MoudleTime[i+1];
+      }
+  }else _count = 0;
+#if TMF8x01_USE_LATENCY
+  if(_pLatency) _pLatency->onFetch(sysT, micros());
+#endif
+#if TMF8x01_USE_SEQLOCK
+  publishSample(t, sysT);
+#endif
+  return true;
+}
+
 uint16_t DFRobot_TMF8x01::getDistance_mm(){
   uint16_t rslt = (_result.disH << 8) | _result.disL;
   DBG(rslt);
@@ -410,6 +565,96 @@ uint16_t DFRobot_TMF8x01::getDistance_mm(){
   return rslt;
 }
 
+#if TMF8x01_USE_SEQLOCK
+void DFRobot_TMF8x01::publishSample(uint32_t hostMs, uint32_t sysclock){
+  sSample_t sample;
+  uint32_t words[sizeof(_sample) / 4];
+  uint32_t seq = _seq;
+  memset(words, 0, sizeof(words));
+  memset(&sample, 0, sizeof(sample));
+  sample.count = seq / 2 + 1;
+  sample.hostMs = hostMs;
+  sample.sysclock = sysclock;
+  sample.rawDistance = (_result.disH << 8) | _result.disL;
+  sample.distance = sample.rawDistance * _timestamp;
+  sample.tid = _result.tid;
+  sample.reliability = _result.resultInfo.reliability;
+  sample.meastatus = _result.resultInfo.meastatus;
+#if TMF8x01_USE_LATENCY
+  if(_pLatency) sample.hasCapture = _pLatency->getLastFetch(&sample.fetchUs, &sample.captureUs);
+#endif
+  memcpy(words, &sample, sizeof(sample));
+  //only the owner writes _seq. Odd: a reader copying now will retry.
+  __atomic_store_n(&_seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  for(uint8_t i = 0; i < sizeof(_sample) / 4; i++){
+      __atomic_store_n(&_sample[i], words[i], __ATOMIC_RELAXED);
+  }
+  __atomic_store_n(&_seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+bool DFRobot_TMF8x01::getLatestSample(sSample_t *sample){
+  uint32_t words[sizeof(_sample) / 4];
+  uint32_t seq0, seq1;
+  if(sample == NULL) return false;
+  do{
+      seq0 = __atomic_load_n(&_seq, __ATOMIC_ACQUIRE);
+      for(uint8_t i = 0; i < sizeof(_sample) / 4; i++){
+          words[i] = __atomic_load_n(&_sample[i], __ATOMIC_RELAXED);
+      }
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      seq1 = __atomic_load_n(&_seq, __ATOMIC_RELAXED);
+  }while((seq0 & 1) || (seq0 != seq1));
+  memcpy(sample, words, sizeof(*sample));
+  return seq0 != 0;
+}
+
+uint32_t DFRobot_TMF8x01::getSampleCount(){
+  return __atomic_load_n(&_seq, __ATOMIC_ACQUIRE) / 2;
+}
+#endif
+
+#if TMF8x01_USE_LATENCY
+void DFRobot_TMF8x01::setLatency(DFRobot_TMF8x01_Latency *latency){
+  _pLatency = latency;
+}
+
+DFRobot_TMF8x01_Latency *DFRobot_TMF8x01::getLatency(){
+  return _pLatency;
+}
+#endif
+
+bool DFRobot_TMF8x01::enableHistogramDump(uint8_t types){
+  if(!_initialize) return false;
+  uint8_t data[] = {types, 0x30};
+  writeReg(REG_MTF8x01_CMD_DATA0, data, sizeof(data));
+  if(!waitForCommand(0x30, 100)) return false;
+  return true;
+}
+
+void DFRobot_TMF8x01::setHistogramBuffer(uint8_t *buf, uint16_t size, pHistogramCallback_t cb){
+  _histogramBuf = buf;
+  _histogramBufSize = size;
+  _histogramCb = cb;
+}
+
+bool DFRobot_TMF8x01::readHistogram(uint8_t blocks){
+  if((!_initialize) || (_histogramBuf == NULL)) return false;
+  if(((uint16_t)blocks * HISTOGRAM_BLOCK_SIZE) > _histogramBufSize) return false;
+  for(uint8_t i = 0; i < blocks; i++){
+      uint8_t cmd = 0x80 + i;
+      uint32_t t = millis();
+      writeReg(REG_MTF8x01_COMMAND, &cmd, 1);
+      while(getRegContents() != cmd){
+          if((millis() - t) > 20) return false;
+      }
+      //burst read the whole block straight into the frame buffer.
+      readReg(REG_MTF8x01_RESULT_NUMBER, _histogramBuf + (uint16_t)i * HISTOGRAM_BLOCK_SIZE, HISTOGRAM_BLOCK_SIZE);
+  }
+  if(_histogramCb) _histogramCb(_histogramBuf, (uint16_t)blocks * HISTOGRAM_BLOCK_SIZE);
+  return true;
+}
+
 void DFRobot_TMF8x01::enableIntPin(){
   uint8_t val = 0x1;
   writeReg(REG_MTF8x01_INT_ENAB, &val, 1);
@@ -449,10 +694,18 @@ bool DFRobot_TMF8x01::powerDown(){
   if(_en < 0) return false;
   delay(1000);
   digitalWrite(_en, LOW);
+  _addr = TMF8x01_I2C_ADDR;
   delay(1000);
   return true;
 }
 
+bool DFRobot_TMF8x01::enableCpu(){
+  eEnableReg_t regValue;
+  regValue.value = 1;
+  writeReg(REG_MTF8x01_ENABLE, &regValue, sizeof(regValue));
+  return waitForCpuReady();
+}
+
 bool DFRobot_TMF8x01::loadApplication(){
   uint8_t regValue = 0xC0;
   writeReg(REG_MTF8x01_APPREQID, &regValue, 1);
@@ -510,24 +763,44 @@ uint8_t DFRobot_TMF8x01::getI2CAddress(){
   return _addr;
 }
 
+bool DFRobot_TMF8x01::modifyI2CAddress(uint8_t addr, uint8_t gpioCondition){
+  if((addr < 1) || (addr > 127)) return false;
+  if(!IS_APP0) return false;
+  //cmd_data1: GPIO condition, cmd_data0: new address in bit7~bit1, then command 0x49.
+  uint8_t data[] = {gpioCondition, (uint8_t)(addr << 1), 0x49};
+  writeReg(REG_MTF8x01_CMD_DATA1, data, sizeof(data));
+  uint8_t oldAddr = _addr;
+  _addr = addr;
+  if(waitForCommand(0x49, 100)) return true;
+  _addr = oldAddr;
+  return false;
+}
+
 void DFRobot_TMF8x01::pinConfig(ePin_t pin, ePinControl_t config){
   uint8_t data[] = {0x0f, 0, 0x0f};
   if((pin > ePINTotal) || (config > ePinOutputHigh)) return;
+  //PIN0 is bits 3:0 and PIN1 is bits 7:4 of the GPIO config, only the nibble of the pin is replaced.
   switch(pin){
       case ePIN0:
-           _config |= (((uint8_t)config) << 4);
+           _config = (_config & 0xF0) | ((uint8_t)config);
            break;
       case ePIN1:
-           _config |= ((uint8_t)config);
+           _config = (_config & 0x0F) | (((uint8_t)config) << 4);
            break;
       case ePINTotal:
            _config = ((uint8_t)config) << 4 | ((uint8_t)config);
            break;
   }
+  _measureCmdSet[CMDSET_INDEX_CMD5] = _config;
   data[1] = _config;
   writeReg(data[0], data+1, sizeof(data) - 1);
 }
 
+DFRobot_TMF8x01::ePinControl_t DFRobot_TMF8x01::getPinConfig(ePin_t pin){
+  if(pin == ePIN1) return (ePinControl_t)(_config >> 4);
+  return (ePinControl_t)(_config & 0x0F);
+}
+
 uint8_t DFRobot_TMF8x01::getCPUState(){
   eEnableReg_t regValue;
   readReg(REG_MTF8x01_ENABLE, &regValue, sizeof(regValue));
@@ -567,12 +840,11 @@ bool DFRobot_TMF8x01::checkStatusRegister(uint8_t status){
 }
 
 bool DFRobot_TMF8x01::isI2CAddress(uint8_t addr){
-  byte error, address;
   if((addr < 1) || (addr > 127)) return false;
-  _pWire->beginTransmission(addr);
-  error = _pWire->endTransmission();
-  if(error == 0) return true;
-  else return false;
+#if TMF8x01_USE_BUS
+  if(_pBus) return _pBus->probe(addr);
+#endif
+  return DFRobot_TMF8x01_WireBus::wireProbe(_pWire, addr);
 }
 
 uint8_t DFRobot_TMF8x01::calChecksum(uint8_t *data, uint8_t len){
@@ -587,7 +859,7 @@ uint8_t DFRobot_TMF8x01::calChecksum(uint8_t *data, uint8_t len){
 bool DFRobot_TMF8x01::readStatusACK(){
   uint32_t value = 0;
   readReg(0x08, &value, 3);
-  if(value = 0xFF0000) return true;
+  if(value == 0xFF0000) return true;
   else return false;
 }
 
@@ -647,48 +919,72 @@ uint8_t DFRobot_TMF8x01::getCharHex(char c){
 
 void DFRobot_TMF8x01::gpioInit(){
   if(_en > -1) {
+     //the sensor is back at the default address after EN low.
+     _addr = TMF8x01_I2C_ADDR;
      pinMode(_en, OUTPUT);
      digitalWrite(_en, LOW);
      delay(1000);
      digitalWrite(_en, HIGH);
      delay(1000);
   }
+}
+
+bool DFRobot_TMF8x01::startCpu(){
+  //the steps of begin() between EN and cpu ready, DFRobot_TMF8x01_Coro waits its own way around them.
   if(_intPin > -1){
       pinMode(_intPin, INPUT);
   }
+#if TMF8x01_USE_BUS
+  if((_pWire == NULL) && (_pBus == NULL)){
+#else
+  if(_pWire == NULL){
+#endif
+      DBG("IIC bus pointer is NULL.");
+      return false;
+  } 
+  busBegin();
+  if(!isI2CAddress(_addr)){
+      DBG("IIC addr is error.");
+      return false;
+  }
+  sleep();
+  eEnableReg_t regValue;
+  regValue.value = 1;
+  writeReg(REG_MTF8x01_ENABLE, &regValue, sizeof(regValue));
+  return true;
+}
+
+void DFRobot_TMF8x01::busBegin(){
+#if TMF8x01_USE_BUS
+  if(_pBus){
+      _pBus->begin();
+      return;
+  }
+#endif
+  _pWire->begin();
 }
 
 void DFRobot_TMF8x01::writeReg(uint8_t reg, const void* pBuf, size_t size){
   if(pBuf == NULL){
       DBG("pBuf ERROR!! : null pointer");
   }
-  
-  uint8_t * _pBuf = (uint8_t *)pBuf;
-
-  _pWire->beginTransmission(_addr);
-  _pWire->write(&reg,1);
-
-  for(uint16_t i = 0; i < size; i++){
-    _pWire->write(_pBuf[i]);
+#if TMF8x01_USE_BUS
+  if(_pBus){
+      _pBus->writeReg(_addr, reg, pBuf, size);
+      return;
   }
-  _pWire->endTransmission();
+#endif
+  DFRobot_TMF8x01_WireBus::wireWriteReg(_pWire, _addr, reg, pBuf, size);
 }
 
 uint8_t DFRobot_TMF8x01::readReg(uint8_t reg, void* pBuf, size_t size){
   if(pBuf == NULL){
     DBG("pBuf ERROR!! : null pointer");
   }
-  uint8_t * _pBuf = (uint8_t *)pBuf;
-  _pWire->beginTransmission(_addr);
-  _pWire->write(&reg, 1);
-  if( _pWire->endTransmission() != 0){
-      return 0;
-  }
-  _pWire->requestFrom(_addr, (uint8_t) size);
-  for(uint16_t i = 0; i < size; i++){
-    _pBuf[i] = _pWire->read();
-  }
-  return size;
+#if TMF8x01_USE_BUS
+  if(_pBus) return _pBus->readReg(_addr, reg, pBuf, size);
+#endif
+  return DFRobot_TMF8x01_WireBus::wireReadReg(_pWire, _addr, reg, pBuf, size);
 }
 
 
@@ -696,6 +992,17 @@ uint8_t DFRobot_TMF8x01::readReg(uint8_t reg, void* pBuf, size_t size){
 
 DFRobot_TMF8801::DFRobot_TMF8801(int enPin,int intPin,TwoWire &pWire)
   :DFRobot_TMF8x01(enPin,intPin,pWire){
+  initConfig();
+}
+
+#if TMF8x01_USE_BUS
+DFRobot_TMF8801::DFRobot_TMF8801(DFRobot_TMF8x01_Bus &bus, int enPin, int intPin)
+  :DFRobot_TMF8x01(bus,enPin,intPin){
+  initConfig();
+}
+#endif
+
+void DFRobot_TMF8801::initConfig(){
   String str = "0x01,0xA3,0x00,0x00,0x00,0x64,0x03,0x84,0x02";
   uint8_t len = 0;
   conversion(str,_measureCmdSet, len, sizeof(_measureCmdSet));
@@ -710,7 +1017,18 @@ bool DFRobot_TMF8801::startMeasurement(eCalibModeConfig_t cailbMode){
 }
 
 DFRobot_TMF8701::DFRobot_TMF8701(int enPin,int intPin,TwoWire &pWire)
-  :DFRobot_TMF8x01(enPin,intPin,pWire){
+  :DFRobot_TMF8x01(enPin,intPin,pWire),_disMode(eCOMBINE),_autoMode(false),_autoCount(0),_autoProximityMm(90),_autoDistanceMm(110){
+  initConfig();
+}
+
+#if TMF8x01_USE_BUS
+DFRobot_TMF8701::DFRobot_TMF8701(DFRobot_TMF8x01_Bus &bus, int enPin, int intPin)
+  :DFRobot_TMF8x01(bus,enPin,intPin),_disMode(eCOMBINE),_autoMode(false),_autoCount(0),_autoProximityMm(90),_autoDistanceMm(110){
+  initConfig();
+}
+#endif
+
+void DFRobot_TMF8701::initConfig(){
   String str = "0x03,0x23,0x00,0x00,0x00,0x64,0xff,0xff,0x02";
   uint8_t len = 0;
   conversion(str,_measureCmdSet, len, sizeof(_measureCmdSet));
@@ -723,6 +1041,57 @@ DFRobot_TMF8701::DFRobot_TMF8701(int enPin,int intPin,TwoWire &pWire)
 }
 
 bool DFRobot_TMF8701::startMeasurement(eCalibModeConfig_t cailbMode, eDistaceMode_t disMode){
+  setModeBits(disMode);
+  return setCaibrationMode(cailbMode);
+}
+
+bool DFRobot_TMF8701::setRangingMode(eDistaceMode_t disMode){
+  _autoCount = 0;
+  if(disMode == _disMode) return true;
+  setModeBits(disMode);
+  if(!_measureCmdFlag) return true;
+  return restartMeasurement();
+}
+
+DFRobot_TMF8701::eDistaceMode_t DFRobot_TMF8701::getRangingMode(){
+  return _disMode;
+}
+
+void DFRobot_TMF8701::setAutoRangingMode(bool enable, uint16_t proximityMm, uint16_t distanceMm){
+  _autoMode = enable;
+  _autoCount = 0;
+  if(proximityMm > distanceMm) proximityMm = distanceMm;
+  _autoProximityMm = proximityMm;
+  _autoDistanceMm = distanceMm;
+}
+
+bool DFRobot_TMF8701::isDataReady(){
+  if(!DFRobot_TMF8x01::isDataReady()) return false;
+  if(_autoMode && _measureCmdFlag){
+      uint16_t dis = getRawDistance();
+      switch(_disMode){
+          case ePROXIMITY:
+               /*0 means no target in 0~10cm, it's usually further away.*/
+               if((dis == 0) || (dis > _autoDistanceMm)) _autoCount++;
+               else _autoCount = 0;
+               if(_autoCount >= TMF8701_AUTO_SWITCH_COUNT) setRangingMode(eDISTANCE);
+               break;
+          case eDISTANCE:
+               if((dis != 0) && (dis < _autoProximityMm)) _autoCount++;
+               else _autoCount = 0;
+               if(_autoCount >= TMF8701_AUTO_SWITCH_COUNT) setRangingMode(ePROXIMITY);
+               break;
+          default:
+               /*Leave the hybrid mode with the first sample.*/
+               if(dis == 0) break;
+               setRangingMode((dis < _autoProximityMm) ? ePROXIMITY : eDISTANCE);
+               break;
+      }
+  }
+  return true;
+}
+
+void DFRobot_TMF8701::setModeBits(eDistaceMode_t disMode){
   uint8_t mode = (uint8_t)disMode;
   switch(mode){
       case ePROXIMITY: //0~10cm
@@ -740,56 +1109,37 @@ bool DFRobot_TMF8701::startMeasurement(eCalibModeConfig_t cailbMode, eDistaceMod
            modifyCmdSet(CMDSET_INDEX_CMD6,CMDSET_BIT_DISTANCE,true);
            modifyCmdSet(CMDSET_INDEX_CMD6,CMDSET_BIT_COMBINE,true);
            break;
+      default:
+           return;
   }
-  return setCaibrationMode(cailbMode);
+  _disMode = disMode;
 }
 
 //#if (defined(__AVR__) || defined(ESP8266))
 #include "drv/TMF8801_2.h"
 #include "drv/TMF8701_2.h"
-bool DFRobot_TMF8801::downloadRamPatch(){
-  uint8_t buf[20], len = 0;
-  uint8_t *addr = (uint8_t *)DFRobot_TMF8801_initBuf;
-  String str = "";
-  int flag = 0;
-  memset(buf,0, 20);
-  if(getAppId() != 0x80){
-      if(!loadBootloader()){
-          DBG("load Bootloader failed");
-          return false;
-      }
-  }
-  str = "0x08,0x14,0x01,0x29";
-  conversion(str, buf, len);
-  writeReg(buf[0], buf+1, len - 1);
-  if(!readStatusACK()) return false;
-  
-  str = "0x08,0x43,0x02,0x00,0x00";
-  conversion(str, buf, len);
-  writeReg(buf[0], buf+1, len - 1);
-  
-  buf[0] = 0x08;
-  buf[1] = 0x41;
-  while((flag = pgm_read_byte(addr++)) > 0){
-      buf[2] = flag;
-      memcpy_P(buf+3, addr, flag);
-      addr +=  flag;
-      buf[3 + flag] = calChecksum(buf+1, flag+2);
-      writeReg(buf[0], buf+1, 3+flag);
-      if(!readStatusACK()) return false;
-  }
+const uint8_t *DFRobot_TMF8801::getRamPatch(){
+  return DFRobot_TMF8801_initBuf;
+}
 
-  str = "0x08,0x11,0x00";//reset
-  conversion(str, buf, len);
-  writeReg(buf[0], buf+1, len - 1);
+const uint8_t *DFRobot_TMF8701::getRamPatch(){
+  return DFRobot_TMF8701_initBuf;
+}
+
+bool DFRobot_TMF8x01::downloadRamPatch(bool ack){
+  const uint8_t *addr = getRamPatch();
+  int8_t ret;
+  if(!startPatch(ack)) return false;
+  while((ret = writePatchRecord(&addr, ack)) > 0);
+  if(ret < 0) return false;
+  if(!finishPatch(ack)) return false;
   if(waitForCpuReady()) return true;
   else return false;
 }
-bool DFRobot_TMF8701::downloadRamPatch(){
+
+bool DFRobot_TMF8x01::startPatch(bool ack){
   uint8_t buf[20], len = 0;
-  uint8_t *addr = (uint8_t *)DFRobot_TMF8701_initBuf;
   String str = "";
-  int flag = 0;
   memset(buf,0, 20);
   if(getAppId() != 0x80){
       if(!loadBootloader()){
@@ -800,29 +1150,40 @@ bool DFRobot_TMF8701::downloadRamPatch(){
   str = "0x08,0x14,0x01,0x29";
   conversion(str, buf, len);
   writeReg(buf[0], buf+1, len - 1);
-  if(!readStatusACK()) return false;
+  if(ack && !readStatusACK()) return false;
   
   str = "0x08,0x43,0x02,0x00,0x00";
   conversion(str, buf, len);
   writeReg(buf[0], buf+1, len - 1);
-  
+  return true;
+}
+
+int8_t DFRobot_TMF8x01::writePatchRecord(const uint8_t **record, bool ack){
+  uint8_t buf[20];
+  uint8_t *addr = (uint8_t *)(*record);
+  int flag = pgm_read_byte(addr++);
+  if(flag <= 0) return 0;
   buf[0] = 0x08;
   buf[1] = 0x41;
-  while((flag = pgm_read_byte(addr++)) > 0){
-      buf[2] = flag;
-      memcpy_P(buf+3, addr, flag);
-      addr +=  flag;
-      buf[3 + flag] = calChecksum(buf+1, flag+2);
-      writeReg(buf[0], buf+1, 3+flag);
-      if(!readStatusACK()) return false;
-  }
-  
+  buf[2] = flag;
+  memcpy_P(buf+3, addr, flag);
+  addr +=  flag;
+  buf[3 + flag] = calChecksum(buf+1, flag+2);
+  writeReg(buf[0], buf+1, 3+flag);
+  *record = addr;
+  //without ack, the status is only checked once after the last record.
+  if(ack && !readStatusACK()) return -1;
+  return 1;
+}
+
+bool DFRobot_TMF8x01::finishPatch(bool ack){
+  uint8_t buf[20], len = 0;
+  String str = "";
+  if(!ack && !readStatusACK()) return false;
   str = "0x08,0x11,0x00";//reset
   conversion(str, buf, len);
   writeReg(buf[0], buf+1, len - 1);
-  if(waitForCpuReady()) return true;
-  else 
-      return false;
+  return true;
 }
 
 // #else
@@ -20,6 +20,7 @@
 #endif
 #include <Wire.h>
 #include<HardwareSerial.h>
+#include "DFRobot_TMF8x01_Bus.h"
 
 //Define DBG, change 0 to 1 open the DBG, 1 to 0 to close.  
 #if 0
@@ -28,8 +29,40 @@
 #define DBG(...)
 #endif
 
+//TMF8x01_USE_SEQLOCK 1 publishes every new result for reader threads, see getLatestSample(). 0 on AVR, there are no threads.
+#ifndef TMF8x01_USE_SEQLOCK
+#if defined(__AVR__)
+#define TMF8x01_USE_SEQLOCK   0
+#else
+#define TMF8x01_USE_SEQLOCK   1
+#endif
+#endif
+
+//TMF8x01_USE_LATENCY 1 lets setLatency() attach a DFRobot_TMF8x01_Latency tracker. 0 on AVR, it needs about 4KB RAM.
+#ifndef TMF8x01_USE_LATENCY
+#if defined(__AVR__)
+#define TMF8x01_USE_LATENCY   0
+#else
+#define TMF8x01_USE_LATENCY   1
+#endif
+#endif
+
+class DFRobot_TMF8x01_Manager;
+class DFRobot_TMF8x01_Coro;
+class DFRobot_TMF8x01_Latency;
+
 class DFRobot_TMF8x01{
 public:
+  friend class DFRobot_TMF8x01_Manager;
+  friend class DFRobot_TMF8x01_Coro;
+  friend class DFRobot_TMF8x01_EventLoop;
+  #define TMF8x01_I2C_ADDR   0x41
+
+  #define ADDR_CONDITION_NONE       0x00  /**< modifyI2CAddress without condition*/
+  #define ADDR_CONDITION_PIN0_LOW   0x01  /**< only the sensor with PIN0 at low level*/
+  #define ADDR_CONDITION_PIN0_HIGH  0x02  /**< only the sensor with PIN0 at high level*/
+  #define ADDR_CONDITION_PIN1_LOW   0x04  /**< only the sensor with PIN1 at low level*/
+  #define ADDR_CONDITION_PIN1_HIGH  0x08  /**< only the sensor with PIN1 at high level*/
   #define SENSOR_MTF8x01_CALIBRATION_SIZE   14
   #define MODEL_TMF8801      0x4120
   #define MODEL_TMF8701      0x5e10
@@ -50,6 +83,29 @@ public:
   #define CMDSET_BIT_INT          4
   #define CMDSET_BIT_COMBINE      5
 
+  #define CMDSET_INDEX_CMD5       2
+
+  #define HISTOGRAM_BLOCK_SIZE    128
+  #define HISTOGRAM_BLOCK_NUM     10
+
+  #define CMDSET_INDEX_PERIOD     5
+  #define CMDSET_INDEX_ITERATIONS 6
+
+  /**
+   * @brief The type of histogram callback function.
+   * @param frame: Pointer to the frame buffer set by setHistogramBuffer.
+   * @param len: The bytes of the frame.
+   */
+  typedef void (*pHistogramCallback_t)(uint8_t *frame, uint16_t len);
+
+  typedef enum{
+      eHistogramCalibration = 0x01,  /**< electrical calibration histograms*/
+      eHistogramProximity = 0x02,    /**< proximity histograms*/
+      eHistogramDistance = 0x04,     /**< distance histograms*/
+      eHistogramPileup = 0x10,       /**< pile-up corrected histograms*/
+      eHistogramSum = 0x20,          /**< summed histogram*/
+  }eHistogramType_t;
+
   typedef enum{
       ePIN0 = 0,  /**< the PIN0 pin of sensor*/
       ePIN1,      /**< the PIN1 pin of sensor*/
@@ -58,8 +114,8 @@ public:
 
   typedef enum{
       ePinInput = 0,        /**< input mode*/
-      ePinInputLow = 1,     /**< input LOW level*/
-      ePinInputHigh = 2,    /**< input HIGH level*/
+      ePinInputLow = 1,     /**< input LOW level, the VCSEL is stopped while the pin is low*/
+      ePinInputHigh = 2,    /**< input HIGH level, the VCSEL is stopped while the pin is high*/
       ePinOutputVCSEL = 3,  /**< output VCSEL signal*/
       ePinOutputLow = 4,    /**< output low level signal*/
       ePinOutputHigh = 5,   /**< output high level signal*/
@@ -107,6 +163,22 @@ public:
       uint8_t sysclock3;  /**< System clock/time stamp in units of 0.2 µs.*/
   }sResult_t;
 
+#if TMF8x01_USE_SEQLOCK
+  typedef struct{
+      uint32_t count;        /**< Number of the sample since the driver was created, starts at 1.*/
+      uint32_t hostMs;       /**< millis() when the result was read.*/
+      uint32_t sysclock;     /**< System clock/time stamp of the sensor in units of 0.2 µs.*/
+      uint32_t fetchUs;      /**< micros() when the result was read, 0 without setLatency().*/
+      uint32_t captureUs;    /**< The capture of the result on the micros() time line, valid if hasCapture.*/
+      uint16_t distance;     /**< Distance after clock correction, the value of getDistance_mm(), unit mm.*/
+      uint16_t rawDistance;  /**< Distance reported by the sensor, unit mm.*/
+      uint8_t tid;           /**< Transaction ID of the result.*/
+      uint8_t reliability;   /**< Reliability of object, 0..63 where 63 is best.*/
+      uint8_t meastatus;     /**< Status of the measurement.*/
+      bool hasCapture;       /**< A tracker of setLatency() knows the capture time, see DFRobot_TMF8x01_Latency.*/
+  }sSample_t;
+#endif
+
   /**
    * @fn DFRobot_TMF8x01
    * @brief DFRobot_TMF8x01 abstract class constructor.
@@ -115,6 +187,16 @@ public:
    * @param pWire : Objects of the TwoWire class. 
    */
   DFRobot_TMF8x01(int enPin, int intPin, TwoWire &pWire);
+#if TMF8x01_USE_BUS
+  /**
+   * @fn DFRobot_TMF8x01
+   * @brief DFRobot_TMF8x01 abstract class constructor with a transport other than TwoWire.
+   * @param bus: The transport, such as DFRobot_TMF8x01_WireBus or a Linux i2c-dev bus.
+   * @param enPin: The EN pin of sensor is connected to digital IO port of the MCU.
+   * @param intPin: The INT pin of sensor is connected to the exteral interrupt IO port of the MCU.
+   */
+  DFRobot_TMF8x01(DFRobot_TMF8x01_Bus &bus, int enPin, int intPin);
+#endif
   ~DFRobot_TMF8x01();
 
   /**
@@ -137,6 +219,20 @@ public:
    */
   bool wakeup();
 
+  /**
+   * @fn enterStandby
+   * @brief The sensor enter standby mode by clearing the pon bit of ENABLE register. The RAM patch and config are kept,
+   * @n so exitStandby can return to measuring within a few milliseconds.
+   */
+  void enterStandby();
+
+  /**
+   * @fn exitStandby
+   * @brief Leave standby mode, go straight back to APP0 and restart the measurement if it was running before enterStandby.
+   * @return sucess return true, or return false.
+   */
+  bool exitStandby();
+
   /**
    * @fn getUniqueID
    * @brief get a unique number of sensor .Each sensor has a unique identifier.
@@ -192,10 +288,11 @@ public:
 
   /**
    * @fn isDataReady
-   * @brief Waiting for data ready.
+   * @brief Waiting for data ready. It is virtual, a caller holding a DFRobot_TMF8x01 pointer(Manager, INT helpers)
+   * @n gets the work of the sensor class too, such as the automatic ranging mode of DFRobot_TMF8701.
    * @return if data is valid, return true, or return false.
    */
-  bool isDataReady();
+  virtual bool isDataReady();
 
   /**
    * @fn getDistance_mm
@@ -204,6 +301,92 @@ public:
    */
   uint16_t getDistance_mm();
 
+#if TMF8x01_USE_SEQLOCK
+  /**
+   * @fn getLatestSample
+   * @brief get the latest result found by isDataReady(). One thread runs the driver, any number of other threads may 
+   * @n call this function at the same time. It never blocks the owner: the sample is published by a seqlock, the reader 
+   * @n copies it again if the owner wrote during the copy. No other function of the driver is thread safe.
+   * @param sample: Pointer to store the sample.
+   * @return true: sample is valid, false: no result yet.
+   */
+  bool getLatestSample(sSample_t *sample);
+
+  /**
+   * @fn getSampleCount
+   * @brief get the number of published samples, a cheap check for a new sample from any thread.
+   * @return The count of the latest sample, 0 if none.
+   */
+  uint32_t getSampleCount();
+#endif
+
+#if TMF8x01_USE_LATENCY
+  /**
+   * @fn setLatency
+   * @brief Attach a tracker of the latency from capture to delivery, isDataReady() gives it every new result and
+   * @n getLatestSample() has the times of the result. See DFRobot_TMF8x01_Latency.h.
+   * @param latency: The tracker, NULL to detach.
+   */
+  void setLatency(DFRobot_TMF8x01_Latency *latency);
+
+  /**
+   * @fn getLatency
+   * @brief get the tracker attached by setLatency().
+   * @return NULL: none.
+   */
+  DFRobot_TMF8x01_Latency *getLatency();
+#endif
+
+  /**
+   * @fn measureOnce
+   * @brief Do one measurement and return the distance, the sensor stays idle after it. Can't be used while startMeasurement is running.
+   * @n If the INT pin is connected and enabled by enableIntPin(), the MCU waits for the INT pin without I2C traffic, 
+   * @n or the result register is polled without delay.
+   * @param distance: Pointer to store the distance, unit mm.
+   * @param timeoutMs: The max time to wait for the result, unit ms.
+   * @return sucess return true, or return false.
+   */
+  bool measureOnce(uint16_t *distance, uint16_t timeoutMs = 500);
+
+  /**
+   * @fn startSingleShot
+   * @brief Start one measurement and return at once, then use isDataReady() and getDistance_mm() to get the result.
+   * @return sucess return true, or return false.
+   */
+  bool startSingleShot();
+
+  /**
+   * @fn setSingleShotIterations
+   * @brief Set the iterations of single shot measurement. Fewer iterations give a shorter measurement and a lower accuracy.
+   * @param kIterations: the iterations in unit of 1000, 0 means using the same iterations as startMeasurement.
+   */
+  void setSingleShotIterations(uint16_t kIterations);
+
+  /**
+   * @fn enableHistogramDump
+   * @brief Let the sensor keep the raw TDC histograms of every measurement for readHistogram().
+   * @param types: The histograms to dump, OR of eHistogramType_t, 0 to disable the dump.
+   * @return sucess return true, or return false.
+   */
+  bool enableHistogramDump(uint8_t types);
+
+  /**
+   * @fn setHistogramBuffer
+   * @brief Set the frame buffer of readHistogram(), the blocks are read into it without copy.
+   * @param buf: Pointer to the frame buffer, its size should be HISTOGRAM_BLOCK_SIZE * blocks.
+   * @param size: The bytes of buf.
+   * @param cb: The function called with every complete frame, it can set another buffer to make a ring. NULL if not used.
+   */
+  void setHistogramBuffer(uint8_t *buf, uint16_t size, pHistogramCallback_t cb = NULL);
+
+  /**
+   * @fn readHistogram
+   * @brief Read one histogram frame, each block is 128 bytes read by burst reads.
+   * @param blocks: The blocks of one frame.
+   * @return sucess return true, or return false.
+   */
+  bool readHistogram(uint8_t blocks = HISTOGRAM_BLOCK_NUM);
+
   /**
    * @fn enableIntPin
    * @brief enable INT pin. If you call this function,which will report a interrupt
@@ -238,6 +421,16 @@ public:
    */
   uint8_t getI2CAddress();
 
+  /**
+   * @fn modifyI2CAddress
+   * @brief Move the sensor to a new I2C address by the address-change command. The address is back to 0x41 after 
+   * @n the EN pin goes low or the sensor power off.
+   * @param addr: The new 7 bits I2C address.
+   * @param gpioCondition: Only the sensor whose PIN0/PIN1 match this condition takes the new address, OR of ADDR_CONDITION_xxx.
+   * @return sucess return true, or return false.
+   */
+  bool modifyI2CAddress(uint8_t addr, uint8_t gpioCondition = ADDR_CONDITION_NONE);
+
   /**
    * @fn pinConfig
    * @brief Config the pin of sensor.
@@ -248,6 +441,14 @@ public:
    * @param config:  The config of pin, which is an enumerated variable of ePinControl_t.
    */
   void pinConfig(ePin_t pin, ePinControl_t config);
+
+  /**
+   * @fn getPinConfig
+   * @brief get the config of the pin of sensor.
+   * @param pin: ePIN0 or ePIN1.
+   * @return The config of pin, which is an enumerated variable of ePinControl_t.
+   */
+  ePinControl_t getPinConfig(ePin_t pin);
   
   /**
    * @fn getJunctionTemperature_C
@@ -257,8 +458,13 @@ public:
   int8_t getJunctionTemperature_C();
   
 protected:
-  virtual bool downloadRamPatch() = 0;
+  virtual const uint8_t *getRamPatch() = 0;
+  bool downloadRamPatch(bool ack = true);
+  bool startPatch(bool ack);
+  int8_t writePatchRecord(const uint8_t **record, bool ack);
+  bool finishPatch(bool ack);
   uint8_t  getCalibrationMode();
+  bool enableCpu();
   bool loadApplication();
   bool loadBootloader();
   bool waitForApplication();
@@ -278,12 +484,21 @@ protected:
   bool readStatusACK();
   void writeReg(uint8_t reg, const void* pBuf, size_t size);
   uint8_t readReg(uint8_t reg, void* pBuf, size_t size);
+  void busBegin();
   void gpioInit();
+  bool startCpu();
+  void resetMeasurement();
   bool setCaibrationMode(eCalibModeConfig_t cailbMode);
+  void writeMeasureCmd(eCalibModeConfig_t cailbMode);
+  bool restartMeasurement();
+  bool waitForCommand(uint8_t cmd, uint16_t timeoutMs);
+  uint16_t getRawDistance();
   uint8_t _measureCmdSet[9];
   uint8_t _calibData[14];
   uint8_t _algoStateData[11];
   
+  bool _measureCmdFlag;
+
 private:
   int _en;
   int _intPin;
@@ -291,17 +506,39 @@ private:
   uint8_t _count;
   uint8_t _config;
   double _timestamp;
-  bool _measureCmdFlag;
+  bool _standbyMeasure;
+  uint16_t _singleShotIterations;
+  uint8_t *_histogramBuf;
+  uint16_t _histogramBufSize;
+  pHistogramCallback_t _histogramCb;
   uint8_t _addr;
   TwoWire *_pWire;
+#if TMF8x01_USE_BUS
+  DFRobot_TMF8x01_Bus *_pBus;
+#endif
   uint32_t _hostTime[5];
   uint32_t _MoudleTime[5];
   sResult_t _result;
+  //a result block read by isDataReady() or by a loop of the host(DFRobot_TMF8x01_EventLoop): a new tid is taken,
+  //the clock correction, the latency tracker and the seqlock are updated, t is millis() of the read.
+  bool takeResult(const sResult_t &result, uint32_t t);
+  uint32_t getResultSysclock();
+#if TMF8x01_USE_SEQLOCK
+  void publishSample(uint32_t hostMs, uint32_t sysclock);
+  uint32_t _seq;                                          //odd while the owner writes _sample, sample count = _seq / 2
+  uint32_t _sample[(sizeof(sSample_t) + 3) / 4];
+#endif
+#if TMF8x01_USE_LATENCY
+  DFRobot_TMF8x01_Latency *_pLatency;
+#endif
 };
 
 class DFRobot_TMF8801: public DFRobot_TMF8x01{
 public:
   DFRobot_TMF8801(int enPin = -1, int intPin = -1, TwoWire &pWire = Wire);
+#if TMF8x01_USE_BUS
+  DFRobot_TMF8801(DFRobot_TMF8x01_Bus &bus, int enPin = -1, int intPin = -1);
+#endif
  /**
   * @fn startMeasurement
   * @brief Config measurement params to enable measurement. Need to call stopMeasurement to stop ranging action.
@@ -315,9 +552,9 @@ public:
   */
   bool startMeasurement(eCalibModeConfig_t cailbMode = eModeCalib);
 protected:
-  bool downloadRamPatch();
+  const uint8_t *getRamPatch();
 private:
-  
+  void initConfig();
 };
 
 class DFRobot_TMF8701: public DFRobot_TMF8x01{
@@ -329,6 +566,9 @@ public:
   }eDistaceMode_t;
 
   DFRobot_TMF8701(int enPin = -1, int intPin = -1, TwoWire &pWire = Wire);
+#if TMF8x01_USE_BUS
+  DFRobot_TMF8701(DFRobot_TMF8x01_Bus &bus, int enPin = -1, int intPin = -1);
+#endif
   /**
    * @fn startMeasurement
    * @brief Config measurement params to enable measurement. Need to call stopMeasurement to stop ranging action.
@@ -345,8 +585,54 @@ public:
    * @retval      true:  enable measurement sucess.
    */
   bool startMeasurement(eCalibModeConfig_t cailbMode = eModeCalib, eDistaceMode_t disMode = eCOMBINE);
+
+  /**
+   * @fn setRangingMode
+   * @brief Switch the ranging mode of a running measurement. Only the measure command is sent again, 
+   * @n without the 600ms start delay and the warm-up samples of startMeasurement.
+   * @param disMode : the ranging mode of TMF8701 sensor.
+   * @n     ePROXIMITY: Raing in PROXIMITY mode,ranging range 0~10cm
+   * @n     eDISTANCE: Raing in distance mode,ranging range 10~60cm
+   * @n     eCOMBINE:  Raing in PROXIMITY and DISTANCE hybrid mode,ranging range 0~60cm
+   * @return status:
+   * @retval      false:  switch failed.
+   * @retval      true:  switch sucess.
+   */
+  bool setRangingMode(eDistaceMode_t disMode);
+
+  /**
+   * @fn getRangingMode
+   * @brief get the current ranging mode.
+   * @return ePROXIMITY, eDISTANCE or eCOMBINE
+   */
+  eDistaceMode_t getRangingMode();
+
+  /**
+   * @fn setAutoRangingMode
+   * @brief Pick PROXIMITY or DISTANCE mode automatically from recent distances. The switch is done in isDataReady() 
+   * @n after TMF8701_AUTO_SWITCH_COUNT samples in a row are out of the hysteresis band.
+   * @param enable: true enable automatic mode, false disable it.
+   * @param proximityMm: switch to PROXIMITY mode when the distance is below this value, unit mm.
+   * @param distanceMm: switch to DISTANCE mode when the distance is above this value or no target in PROXIMITY mode, unit mm.
+   */
+  void setAutoRangingMode(bool enable, uint16_t proximityMm = 90, uint16_t distanceMm = 110);
+
+  /**
+   * @fn isDataReady
+   * @brief Waiting for data ready, and switch the ranging mode if automatic mode is enabled.
+   * @return if data is valid, return true, or return false.
+   */
+  bool isDataReady();
 protected:
-  bool downloadRamPatch();
+  const uint8_t *getRamPatch();
 private:
+  #define TMF8701_AUTO_SWITCH_COUNT   3
+  void initConfig();
+  void setModeBits(eDistaceMode_t disMode);
+  eDistaceMode_t _disMode;
+  bool _autoMode;
+  uint8_t _autoCount;
+  uint16_t _autoProximityMm;
+  uint16_t _autoDistanceMm;
 };
 #endif
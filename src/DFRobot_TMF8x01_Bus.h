@@ -0,0 +1,136 @@
+/*!
+ * @file DFRobot_TMF8x01_Bus.h
+ * @brief The I2C transport of the driver. Without a bus object the driver calls TwoWire directly through the inline
+ * @n functions of DFRobot_TMF8x01_WireBus, the same code as before and no virtual call. A bus object replaces it by
+ * @n any transport, such as Linux i2c-dev, a simulator, or a DMA I2C peripheral.
+ * @n TMF8x01_USE_BUS 0 removes the bus objects from the driver, it is the default on AVR.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_BUS_H
+#define __DFROBOT_TMF8X01_BUS_H
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+#include <Wire.h>
+
+#if defined(BUFFER_LENGTH)
+#define TMF8x01_WIRE_BUFFER_SIZE  BUFFER_LENGTH
+#elif defined(I2C_BUFFER_LENGTH)
+#define TMF8x01_WIRE_BUFFER_SIZE  I2C_BUFFER_LENGTH
+#else
+#define TMF8x01_WIRE_BUFFER_SIZE  32
+#endif
+
+#ifndef TMF8x01_USE_BUS
+#if defined(__AVR__)
+#define TMF8x01_USE_BUS   0
+#else
+#define TMF8x01_USE_BUS   1
+#endif
+#endif
+
+class DFRobot_TMF8x01_Bus{
+public:
+  virtual ~DFRobot_TMF8x01_Bus(){}
+
+  /**
+   * @fn begin
+   * @brief init the bus, it is called by begin() of the driver.
+   */
+  virtual void begin() = 0;
+
+  /**
+   * @fn probe
+   * @brief Check if a device acknowledges the address.
+   * @param addr: 7 bits I2C address.
+   * @return true: the address is acknowledged, false: no device.
+   */
+  virtual bool probe(uint8_t addr) = 0;
+
+  /**
+   * @fn writeReg
+   * @brief Write registers.
+   * @param addr: 7 bits I2C address.
+   * @param reg: The first register.
+   * @param pBuf: Pointer to the data.
+   * @param size: The length of data.
+   */
+  virtual void writeReg(uint8_t addr, uint8_t reg, const void *pBuf, size_t size) = 0;
+
+  /**
+   * @fn readReg
+   * @brief Read registers.
+   * @param addr: 7 bits I2C address.
+   * @param reg: The first register.
+   * @param pBuf: Pointer to store the data.
+   * @param size: The length of data.
+   * @return The bytes really read, less than size on a short read, 0 on error.
+   */
+  virtual uint8_t readReg(uint8_t addr, uint8_t reg, void *pBuf, size_t size) = 0;
+};
+
+class DFRobot_TMF8x01_WireBus: public DFRobot_TMF8x01_Bus{
+public:
+  /**
+   * @fn DFRobot_TMF8x01_WireBus
+   * @brief Constructor.
+   * @param wire: The TwoWire object, default Wire.
+   */
+  DFRobot_TMF8x01_WireBus(TwoWire &wire = Wire):_pWire(&wire){}
+
+  void begin(){ _pWire->begin(); }
+  bool probe(uint8_t addr){ return wireProbe(_pWire, addr); }
+  void writeReg(uint8_t addr, uint8_t reg, const void *pBuf, size_t size){ wireWriteReg(_pWire, addr, reg, pBuf, size); }
+  uint8_t readReg(uint8_t addr, uint8_t reg, void *pBuf, size_t size){ return wireReadReg(_pWire, addr, reg, pBuf, size); }
+
+  static inline bool wireProbe(TwoWire *wire, uint8_t addr){
+    wire->beginTransmission(addr);
+    return wire->endTransmission() == 0;
+  }
+
+  static inline void wireWriteReg(TwoWire *wire, uint8_t addr, uint8_t reg, const void *pBuf, size_t size){
+    uint8_t *_pBuf = (uint8_t *)pBuf;
+    wire->beginTransmission(addr);
+    wire->write(&reg, 1);
+    for(uint16_t i = 0; i < size; i++){
+      wire->write(_pBuf[i]);
+    }
+    wire->endTransmission();
+  }
+
+  static inline uint8_t wireReadReg(TwoWire *wire, uint8_t addr, uint8_t reg, void *pBuf, size_t size){
+    uint8_t *_pBuf = (uint8_t *)pBuf;
+    size_t count = 0;
+    //the register address auto increments, so a block larger than the Wire buffer is read in several requests.
+    while(count < size){
+        uint8_t len = ((size - count) > TMF8x01_WIRE_BUFFER_SIZE) ? TMF8x01_WIRE_BUFFER_SIZE : (size - count);
+        uint8_t r = reg + count;
+        wire->beginTransmission(addr);
+        wire->write(&r, 1);
+        if(wire->endTransmission() != 0){
+            return 0;
+        }
+        //a short read leaves the rest of the buffer untouched, the caller gets the bytes really read.
+        uint8_t n = wire->requestFrom(addr, len);
+        for(uint8_t i = 0; i < n; i++){
+          _pBuf[count++] = wire->read();
+        }
+        if(n != len) return count;
+    }
+    return size;
+  }
+
+private:
+  TwoWire *_pWire;
+};
+
+#endif
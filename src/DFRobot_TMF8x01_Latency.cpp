@@ -0,0 +1,245 @@
+/*!
+ * @file DFRobot_TMF8x01_Latency.cpp
+ * @brief Define the basic structure of class DFRobot_TMF8x01_Latency
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <Arduino.h>
+#include "DFRobot_TMF8x01_Latency.h"
+
+#define LATENCY_SUB_MASK    ((1u << LATENCY_SUB_BITS) - 1)
+//the two clocks disagree by more than 1/8 of the time between two results and this: the sensor clock jumped.
+#define LATENCY_RESYNC_US   500000
+
+DFRobot_TMF8x01_LatencyHistogram::DFRobot_TMF8x01_LatencyHistogram(){
+  reset();
+}
+
+uint16_t DFRobot_TMF8x01_LatencyHistogram::bucketOf(uint32_t us){
+  uint8_t e;
+  if(us <= LATENCY_SUB_MASK) return us;
+  e = sizeof(unsigned long) * 8 - 1 - __builtin_clzl((unsigned long)us);
+  //power of two e, then the LATENCY_SUB_BITS bits below its top bit.
+  return ((e - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS) | ((us >> (e - LATENCY_SUB_BITS)) & LATENCY_SUB_MASK);
+}
+
+uint32_t DFRobot_TMF8x01_LatencyHistogram::lowOf(uint16_t index){
+  uint8_t g = index >> LATENCY_SUB_BITS;
+  if(g == 0) return index;
+  return (uint32_t)((1u << LATENCY_SUB_BITS) | (index & LATENCY_SUB_MASK)) << (g - 1);
+}
+
+uint32_t DFRobot_TMF8x01_LatencyHistogram::highOf(uint16_t index){
+  uint8_t g = index >> LATENCY_SUB_BITS;
+  if(g == 0) return index;
+  return lowOf(index) + (((uint32_t)1 << (g - 1)) - 1);
+}
+
+void DFRobot_TMF8x01_LatencyHistogram::record(uint32_t us){
+  if((_count == 0) || (us < _min)) _min = us;
+  if(us > _max) _max = us;
+  _sum += us;
+  _bucket[bucketOf(us)]++;
+  _count++;
+}
+
+void DFRobot_TMF8x01_LatencyHistogram::reset(){
+  _count = 0;
+  _min = 0;
+  _max = 0;
+  _sum = 0;
+  memset(_bucket, 0, sizeof(_bucket));
+}
+
+uint32_t DFRobot_TMF8x01_LatencyHistogram::getCount(){
+  return _count;
+}
+
+uint32_t DFRobot_TMF8x01_LatencyHistogram::getMin(){
+  return _min;
+}
+
+uint32_t DFRobot_TMF8x01_LatencyHistogram::getMax(){
+  return _max;
+}
+
+uint32_t DFRobot_TMF8x01_LatencyHistogram::getMean(){
+  if(_count == 0) return 0;
+  return _sum / _count;
+}
+
+uint32_t DFRobot_TMF8x01_LatencyHistogram::getPercentile(float percent){
+  uint32_t count = _count, rank, sum = 0;
+  double r;
+  if(count == 0) return 0;
+  if(percent >= 100) return _max;
+  if(percent < 0) percent = 0;
+  r = (double)percent * count / 100;
+  rank = r;
+  if((rank < r) || (rank == 0)) rank++;
+  for(uint16_t i = 0; i < LATENCY_BUCKETS; i++){
+      sum += _bucket[i];
+      if(sum < rank) continue;
+      uint32_t v = highOf(i);
+      if(v > _max) v = _max;
+      if(v < _min) v = _min;
+      return v;
+  }
+  //a record() in progress counted the sample but not its bucket yet.
+  return _max;
+}
+
+uint32_t DFRobot_TMF8x01_LatencyHistogram::getBucket(uint16_t index, uint32_t *lowUs, uint32_t *highUs){
+  if(index >= LATENCY_BUCKETS) return 0;
+  if(lowUs) *lowUs = lowOf(index);
+  if(highUs) *highUs = highOf(index);
+  return _bucket[index];
+}
+
+DFRobot_TMF8x01_Latency::DFRobot_TMF8x01_Latency()
+  :_intUs(0),_intPending(false),_fetched(false),_fetchUs(0),_captureUs(0),_hasCapture(false){
+  resync();
+}
+
+void DFRobot_TMF8x01_Latency::onInt(uint32_t us){
+  _intUs = us;
+  _intPending = true;
+}
+
+double DFRobot_TMF8x01_Latency::residual(const sPoint_t &p){
+  return p.oUs - _slope * p.sUs;
+}
+
+bool DFRobot_TMF8x01_Latency::onFetch(uint32_t sysclock, uint32_t fetchUs, uint32_t *captureUs){
+  bool hasInt = _intPending;
+  uint32_t intUs = _intUs;
+  uint32_t refUs = fetchUs;
+  sPoint_t p;
+  double base, lat;
+
+  _intPending = false;
+  //an edge after the read belongs to the next result.
+  if(hasInt && ((int32_t)(fetchUs - intUs) >= 0)){
+      _hist[eIntToFetch].record(fetchUs - intUs);
+      refUs = intUs;
+  }else hasInt = false;
+  _fetched = true;
+  _fetchUs = fetchUs;
+  _hasCapture = false;
+  //bit 0 of the stamp is 0: the sensor clock is not valid.
+  if(!(sysclock & 0x01)) return false;
+
+  if(_synced){
+      uint32_t dt = sysclock - _lastSysclock;
+      uint32_t dh = refUs - _lastRefUs;
+      double expect = dt / 5.0;
+      double diff = (dh > expect) ? (dh - expect) : (expect - dh);
+      if(diff > expect / 8 + LATENCY_RESYNC_US){
+          resync();
+      }else{
+          _ticks += dt;
+          _hostUs += dh;
+      }
+  }
+  if(!_synced){
+      _synced = true;
+      _ticks = 0;
+      _hostUs = 0;
+  }
+  _lastSysclock = sysclock;
+  _lastRefUs = refUs;
+
+  //the samples with the least delay lie on a line over sensor time, its slope is the drift.
+  p.sUs = _ticks / 5.0;
+  p.oUs = (double)_hostUs - p.sUs;
+  if((_segCount == 0) || (residual(p) < residual(_segMin))) _segMin = p;
+  if(++_segCount >= LATENCY_SEGMENT){
+      _minA = _minB;
+      _minB = _segMin;
+      _segCount = 0;
+      if(_segDone < 2) _segDone++;
+      if((_segDone == 2) && (_minB.sUs > _minA.sUs)) _slope = (_minB.oUs - _minA.oUs) / (_minB.sUs - _minA.sUs);
+  }
+  if(_segDone < 2) return false;
+
+  base = residual(_minB);
+  if(_segCount && (residual(_segMin) < base)) base = residual(_segMin);
+  lat = residual(p) - base;
+  if(lat < 0) lat = 0;
+  if(hasInt) _hist[eCaptureToInt].record(lat + 0.5);
+  _captureUs = refUs - (uint32_t)(lat + 0.5);
+  _hasCapture = true;
+  if(captureUs) *captureUs = _captureUs;
+  return true;
+}
+
+void DFRobot_TMF8x01_Latency::onDelivery(uint32_t nowUs){
+  if(!_fetched) return;
+  onDelivery(_fetchUs, _captureUs, _hasCapture, nowUs);
+}
+
+void DFRobot_TMF8x01_Latency::onDelivery(uint32_t fetchUs, uint32_t captureUs, bool hasCapture, uint32_t nowUs){
+  if((int32_t)(nowUs - fetchUs) < 0) return;
+  _hist[eFetchToDelivery].record(nowUs - fetchUs);
+  if(hasCapture && ((int32_t)(nowUs - captureUs) >= 0)) _hist[eCaptureToDelivery].record(nowUs - captureUs);
+}
+
+#if TMF8x01_USE_SEQLOCK
+void DFRobot_TMF8x01_Latency::onDelivery(const DFRobot_TMF8x01::sSample_t &sample, uint32_t nowUs){
+  onDelivery(sample.fetchUs, sample.captureUs, sample.hasCapture, nowUs);
+}
+#endif
+
+bool DFRobot_TMF8x01_Latency::getLastFetch(uint32_t *fetchUs, uint32_t *captureUs){
+  if(fetchUs) *fetchUs = _fetchUs;
+  if(captureUs) *captureUs = _captureUs;
+  return _hasCapture;
+}
+
+DFRobot_TMF8x01_LatencyHistogram *DFRobot_TMF8x01_Latency::getHistogram(eLatencyStage_t stage){
+  if(stage >= eLatencyStageNum) return NULL;
+  return &_hist[stage];
+}
+
+bool DFRobot_TMF8x01_Latency::getSummary(eLatencyStage_t stage, sLatencySummary_t *summary){
+  DFRobot_TMF8x01_LatencyHistogram *h = getHistogram(stage);
+  if((h == NULL) || (summary == NULL)) return false;
+  summary->count = h->getCount();
+  summary->minUs = h->getMin();
+  summary->meanUs = h->getMean();
+  summary->p50Us = h->getPercentile(50);
+  summary->p90Us = h->getPercentile(90);
+  summary->p99Us = h->getPercentile(99);
+  summary->p999Us = h->getPercentile(99.9);
+  summary->maxUs = h->getMax();
+  return true;
+}
+
+bool DFRobot_TMF8x01_Latency::getDriftPpm(int32_t *ppm){
+  if((_segDone < 2) || (ppm == NULL)) return false;
+  *ppm = (1.0 / (1.0 + _slope) - 1.0) * 1e6;
+  return true;
+}
+
+void DFRobot_TMF8x01_Latency::reset(){
+  for(uint8_t i = 0; i < eLatencyStageNum; i++) _hist[i].reset();
+}
+
+void DFRobot_TMF8x01_Latency::resync(){
+  _synced = false;
+  _lastSysclock = 0;
+  _lastRefUs = 0;
+  _ticks = 0;
+  _hostUs = 0;
+  _slope = 0;
+  _segCount = 0;
+  _segDone = 0;
+  memset(&_segMin, 0, sizeof(_segMin));
+  memset(&_minA, 0, sizeof(_minA));
+  memset(&_minB, 0, sizeof(_minB));
+}
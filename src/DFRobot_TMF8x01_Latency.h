@@ -0,0 +1,246 @@
+/*!
+ * @file DFRobot_TMF8x01_Latency.h
+ * @brief How old a distance is when the application gets it. Every sample is taken apart into the time from the
+ * @n capture by the sensor to the INT edge, from the INT edge to the fetch by isDataReady(), and from the fetch to the
+ * @n delivery to the consumer, plus capture to delivery as a whole. Each goes into a log-linear histogram of a fixed
+ * @n size, so the tail(p99, p99.9, max) is seen and not only the mean, without any allocation.
+ * @n The sensor and the MCU share no clock. The sysclock stamp of a result is put on the micros() time line by a
+ * @n drift and an offset, both from the lower edge of the samples: the offset makes the fastest samples of the last
+ * @n LATENCY_SEGMENT * 2 results 0. So capture to INT is the delay on top of the best case, the fixed delay of the
+ * @n sensor firmware is not in it, and capture to delivery is short by the same amount.
+ * @n TMF8x01_USE_LATENCY 0 removes it from the driver, it is the default on AVR(about 4KB RAM per tracker).
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_LATENCY_H
+#define __DFROBOT_TMF8X01_LATENCY_H
+
+#include "DFRobot_TMF8x01.h"
+
+//linear sub-buckets per power of two = 2^LATENCY_SUB_BITS, a value is known within 1/2^LATENCY_SUB_BITS.
+#ifndef LATENCY_SUB_BITS
+#define LATENCY_SUB_BITS    3
+#endif
+#define LATENCY_BUCKETS     ((32 - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS)
+//results per segment of the clock mapping, the drift is taken from the fastest samples of two segments.
+#ifndef LATENCY_SEGMENT
+#define LATENCY_SEGMENT     32
+#endif
+
+class DFRobot_TMF8x01_LatencyHistogram{
+public:
+  DFRobot_TMF8x01_LatencyHistogram();
+
+  /**
+   * @fn record
+   * @brief Count a latency.
+   * @param us: unit us.
+   */
+  void record(uint32_t us);
+
+  /**
+   * @fn reset
+   * @brief Clear all counts.
+   */
+  void reset();
+
+  /**
+   * @fn getCount
+   * @brief get the number of latencies recorded since the last reset().
+   */
+  uint32_t getCount();
+
+  /**
+   * @fn getMin
+   * @brief get the smallest latency, unit us, 0 if none.
+   */
+  uint32_t getMin();
+
+  /**
+   * @fn getMax
+   * @brief get the largest latency, unit us, exact.
+   */
+  uint32_t getMax();
+
+  /**
+   * @fn getMean
+   * @brief get the mean latency, unit us, exact.
+   */
+  uint32_t getMean();
+
+  /**
+   * @fn getPercentile
+   * @brief get the latency which percent of the samples do not exceed, the upper end of its bucket.
+   * @param percent: 0..100, such as 99.9.
+   * @return unit us, 0 if none.
+   */
+  uint32_t getPercentile(float percent);
+
+  /**
+   * @fn getBucket
+   * @brief get a bucket, to print or merge the histogram.
+   * @param index: 0..LATENCY_BUCKETS - 1.
+   * @param lowUs: The smallest latency of the bucket, NULL if not needed.
+   * @param highUs: The largest latency of the bucket, NULL if not needed.
+   * @return The count of the bucket.
+   */
+  uint32_t getBucket(uint16_t index, uint32_t *lowUs = NULL, uint32_t *highUs = NULL);
+
+private:
+  static uint16_t bucketOf(uint32_t us);
+  static uint32_t lowOf(uint16_t index);
+  static uint32_t highOf(uint16_t index);
+
+  uint32_t _count;
+  uint32_t _min;
+  uint32_t _max;
+  uint64_t _sum;
+  uint32_t _bucket[LATENCY_BUCKETS];
+};
+
+class DFRobot_TMF8x01_Latency{
+public:
+  typedef enum{
+      eCaptureToInt = 0,   /**< capture by the sensor(sysclock stamp) to the INT edge, above the best case*/
+      eIntToFetch,         /**< INT edge to the result read by isDataReady()*/
+      eFetchToDelivery,    /**< result read to onDelivery()*/
+      eCaptureToDelivery,  /**< the whole age of the sample at onDelivery(), above the best case*/
+      eLatencyStageNum,
+  }eLatencyStage_t;
+
+  /**
+   * @struct sLatencySummary_t
+   * @brief The numbers of one histogram, unit us.
+   */
+  typedef struct{
+      uint32_t count;
+      uint32_t minUs;
+      uint32_t meanUs;
+      uint32_t p50Us;
+      uint32_t p90Us;
+      uint32_t p99Us;
+      uint32_t p999Us;
+      uint32_t maxUs;
+  }sLatencySummary_t;
+
+  DFRobot_TMF8x01_Latency();
+
+  /**
+   * @fn onInt
+   * @brief The INT edge of the sensor, call it from the interrupt handler. The next result fetched takes this time,
+   * @n without it only eFetchToDelivery and eCaptureToDelivery are recorded.
+   * @param us: micros() of the edge.
+   */
+  void onInt(uint32_t us);
+
+  /**
+   * @fn onFetch
+   * @brief A new result was read, called by isDataReady() of the sensor attached by setLatency().
+   * @param sysclock: The time stamp of the result, unit 0.2us.
+   * @param fetchUs: micros() after the read.
+   * @param captureUs: Pointer to store the capture on the micros() time line, NULL if not needed.
+   * @return true: captureUs is known, false: the drift is not known yet(the first LATENCY_SEGMENT * 2 results).
+   */
+  bool onFetch(uint32_t sysclock, uint32_t fetchUs, uint32_t *captureUs = NULL);
+
+  /**
+   * @fn onDelivery
+   * @brief The consumer got the last result fetched, in the thread which runs the driver.
+   * @param nowUs: micros() of the delivery.
+   */
+  void onDelivery(uint32_t nowUs);
+
+  /**
+   * @fn onDelivery
+   * @brief The consumer got a result, in any thread. Only the delivering thread may call onDelivery().
+   * @param fetchUs: micros() after the read of the result.
+   * @param captureUs: The capture of the result on the micros() time line.
+   * @param hasCapture: false: captureUs is not known, eCaptureToDelivery is not recorded.
+   * @param nowUs: micros() of the delivery.
+   */
+  void onDelivery(uint32_t fetchUs, uint32_t captureUs, bool hasCapture, uint32_t nowUs);
+
+#if TMF8x01_USE_SEQLOCK
+  /**
+   * @fn onDelivery
+   * @brief The consumer got a sample of getLatestSample(), in any thread.
+   */
+  void onDelivery(const DFRobot_TMF8x01::sSample_t &sample, uint32_t nowUs);
+#endif
+
+  /**
+   * @fn getLastFetch
+   * @brief get the times of the last result fetched.
+   * @return true: captureUs is known.
+   */
+  bool getLastFetch(uint32_t *fetchUs, uint32_t *captureUs);
+
+  /**
+   * @fn getHistogram
+   * @brief get the histogram of a stage, to read it bucket by bucket.
+   * @return NULL: no such stage.
+   */
+  DFRobot_TMF8x01_LatencyHistogram *getHistogram(eLatencyStage_t stage);
+
+  /**
+   * @fn getSummary
+   * @brief get count, min, mean, p50, p90, p99, p99.9 and max of a stage.
+   * @return false: no such stage.
+   */
+  bool getSummary(eLatencyStage_t stage, sLatencySummary_t *summary);
+
+  /**
+   * @fn getDriftPpm
+   * @brief get the drift of the sensor clock against micros(), positive: the sensor clock runs fast.
+   * @return false: not known yet.
+   */
+  bool getDriftPpm(int32_t *ppm);
+
+  /**
+   * @fn reset
+   * @brief Clear the histograms of all stages, the clock mapping is kept. The histograms have one writer each(the
+   * @n driver thread, the delivering thread), reset() and the getters do not lock, a sample recorded at the same
+   * @n time may be lost or counted half.
+   */
+  void reset();
+
+  /**
+   * @fn resync
+   * @brief Forget the clock mapping, such as after the sensor restarted. A jump of the sensor clock does it too.
+   */
+  void resync();
+
+private:
+  typedef struct{
+      double sUs;          //sensor time since the sync, nominal us
+      double oUs;          //host time minus sensor time
+  }sPoint_t;
+  double residual(const sPoint_t &p);
+
+  DFRobot_TMF8x01_LatencyHistogram _hist[eLatencyStageNum];
+  volatile uint32_t _intUs;
+  volatile bool _intPending;
+  //clock mapping, only the driver thread
+  bool _synced;
+  uint32_t _lastSysclock;
+  uint32_t _lastRefUs;
+  uint64_t _ticks;         //sensor time since the sync, unit 0.2us
+  uint64_t _hostUs;        //host time since the sync
+  double _slope;           //d(host - sensor)/d(sensor)
+  uint16_t _segCount;
+  uint8_t _segDone;
+  sPoint_t _segMin;        //fastest sample of the segment being filled
+  sPoint_t _minA;          //fastest samples of the two segments before
+  sPoint_t _minB;
+  bool _fetched;
+  uint32_t _fetchUs;
+  uint32_t _captureUs;
+  bool _hasCapture;
+};
+
+#endif
@@ -0,0 +1,645 @@
+/*!
+ * @file DFRobot_TMF8x01_Manager.cpp
+ * @brief Define the basic structure of class DFRobot_TMF8x01_Manager
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#include <Arduino.h>
+#include "DFRobot_TMF8x01_Manager.h"
+#include "DFRobot_TMF8x01_Latency.h"
+
+#define REG_MTF8x01_CMD_DATA1 0x0E
+#define REG_MTF8x01_COMMAND   0x10
+#define REG_MTF8x01_PREVIOUS  0x11
+#define REG_MTF8x01_ENABLE    0xE0
+#define REG_MTF8x01_INT_STATUS    0xE1
+
+DFRobot_TMF8x01_Manager::DFRobot_TMF8x01_Manager(uint8_t baseAddr)
+  :_slot(-1),_bootStartMeasure(false),_bootCailbMode(DFRobot_TMF8x01::eModeCalib),
+   _slotNum(0),_curSlot(0),_slotPending(0),_slotStopping(0),_slotTimeout(0),_roundTime(0),_slotStart(0),_roundStart(0),_schedStart(0),_schedActive(false),
+   _syncMaster(-1),_syncMcuPin(-1),_syncPin(DFRobot_TMF8x01::ePIN0),_syncMask(0),
+   _intPin(-1),_intMask(0),_intOrder(eIntPriority),_intNext(0),_intFlag(false),_intMicros(0),
+   _num(0),_baseAddr(baseAddr),_ready(0){
+  memset(_sensor, 0, sizeof(_sensor));
+  memset(_neighbor, 0, sizeof(_neighbor));
+  memset(_lastDistance, 0, sizeof(_lastDistance));
+  resetIntLatency();
+  memset(_schedCount, 0, sizeof(_schedCount));
+  memset(_bootReport, 0, sizeof(_bootReport));
+  for(uint8_t i = 0; i < MANAGER_MAX_SENSORS; i++) _selPin[i] = -1;
+}
+
+bool DFRobot_TMF8x01_Manager::addSensor(DFRobot_TMF8x01 *sensor, int selPin){
+  if((sensor == NULL) || (_num >= MANAGER_MAX_SENSORS)) return false;
+  if(sensor->_en < 0){
+      DBG("sensor has no EN pin.");
+      return false;
+  }
+  _selPin[_num] = selPin;
+  _sensor[_num++] = sensor;
+  return true;
+}
+
+uint8_t DFRobot_TMF8x01_Manager::getSensorNum(){
+  return _num;
+}
+
+DFRobot_TMF8x01 *DFRobot_TMF8x01_Manager::getSensor(uint8_t index){
+  if(index >= _num) return NULL;
+  return _sensor[index];
+}
+
+void DFRobot_TMF8x01_Manager::resetAll(){
+  for(uint8_t i = 0; i < _num; i++){
+      pinMode(_sensor[i]->_en, OUTPUT);
+      digitalWrite(_sensor[i]->_en, LOW);
+      _sensor[i]->_addr = TMF8x01_I2C_ADDR;
+      _sensor[i]->_initialize = false;
+  }
+}
+
+uint16_t DFRobot_TMF8x01_Manager::begin(){
+  _ready = 0;
+  //all sensors are at 0x41 after reset, only one of them may leave reset at a time.
+  resetAll();
+  for(uint8_t i = 0; i < _num; i++){
+      if(beginSensor(i)) _ready |= (1 << i);
+      else digitalWrite(_sensor[i]->_en, LOW);
+  }
+  return _ready;
+}
+
+bool DFRobot_TMF8x01_Manager::beginSensor(uint8_t index){
+  DFRobot_TMF8x01 *s = _sensor[index];
+  if(s->begin() != 0){
+      DBG("begin failed.");
+      return false;
+  }
+  if(!s->modifyI2CAddress(_baseAddr + index)){
+      DBG("modify I2C address failed.");
+      return false;
+  }
+  return true;
+}
+
+uint16_t DFRobot_TMF8x01_Manager::beginBroadcast(){
+  if(_num == 0) return 0;
+  DFRobot_TMF8x01 *s0 = _sensor[0];
+  for(uint8_t i = 0; i < _num; i++){
+      if((_selPin[i] < 0) || (_sensor[i]->getRamPatch() != s0->getRamPatch())) return begin();
+  }
+  _ready = 0;
+  resetAll();
+  for(uint8_t i = 0; i < _num; i++){
+      pinMode(_selPin[i], OUTPUT);
+      digitalWrite(_selPin[i], LOW);
+      if(_sensor[i]->_intPin > -1) pinMode(_sensor[i]->_intPin, INPUT);
+  }
+  delay(MANAGER_EN_DELAY_MS);
+  for(uint8_t i = 0; i < _num; i++){
+      digitalWrite(_sensor[i]->_en, HIGH);
+  }
+  delay(MANAGER_EN_DELAY_MS);
+
+  /*All sensors answer at 0x41 now. Writes reach every sensor, reads are the wired-AND of all answers: cpu ready(0x41),
+    app id(0xC0/0x80) and the deferred status(00 00 FF, a sensor with an error breaks the checksum byte) only match when
+    every sensor matches, but a sensor which does not answer at all is not seen. The bootloader has no address of its own,
+    so every sensor is checked again by itself below, at its new address.*/
+  s0->busBegin();
+  bool broadcast = s0->enableCpu();
+  if(broadcast && (s0->getAppId() == 0x80)){
+      broadcast = s0->downloadRamPatch(/*ack =*/false);
+  }
+  if(broadcast) broadcast = s0->waitForApplication();
+
+  //select one sensor at a time by PIN0, only the selected one takes its address.
+  for(uint8_t i = 0; broadcast && (i < _num); i++){
+      DFRobot_TMF8x01 *s = _sensor[i];
+      uint8_t data[] = {ADDR_CONDITION_PIN0_HIGH, (uint8_t)((_baseAddr + i) << 1), 0x49};
+      digitalWrite(_selPin[i], HIGH);
+      //the app id at 0x41 is the wired-AND of the sensors left there, one sensor stuck in the bootloader would fail all
+      //of them: the command goes out without it and the sensor is checked at its new address.
+      s->_addr = TMF8x01_I2C_ADDR;
+      s->writeReg(REG_MTF8x01_CMD_DATA1, data, sizeof(data));
+      s->_addr = _baseAddr + i;
+      if(s->waitForCommand(0x49, 100) && (s->getAppId() == 0xC0)){
+          s->_initialize = true;
+          _ready |= (1 << i);
+      }else{
+          s->_addr = TMF8x01_I2C_ADDR;
+      }
+      digitalWrite(_selPin[i], LOW);
+  }
+  //PIN0 is free again, such as for the sync line of beginSync().
+  for(uint8_t i = 0; i < _num; i++){
+      pinMode(_selPin[i], INPUT);
+  }
+
+  //the sensors that failed are still at 0x41 or not answering, bring them up one by one.
+  for(uint8_t i = 0; i < _num; i++){
+      if(!(_ready & (1 << i))) digitalWrite(_sensor[i]->_en, LOW);
+  }
+  for(uint8_t i = 0; i < _num; i++){
+      if(_ready & (1 << i)) continue;
+      DBG("broadcast failed, begin one by one.");
+      if(beginSensor(i)) _ready |= (1 << i);
+      else digitalWrite(_sensor[i]->_en, LOW);
+  }
+  return _ready;
+}
+
+uint16_t DFRobot_TMF8x01_Manager::beginOverlapped(bool startMeasure, DFRobot_TMF8x01::eCalibModeConfig_t cailbMode){
+  uint32_t t0;
+  bool pending = true;
+  _ready = 0;
+  _slot = -1;
+  _bootStartMeasure = startMeasure;
+  _bootCailbMode = cailbMode;
+  if(_num == 0) return 0;
+  resetAll();
+  for(uint8_t i = 0; i < _num; i++){
+      if(_sensor[i]->_intPin > -1) pinMode(_sensor[i]->_intPin, INPUT);
+  }
+  _sensor[0]->busBegin();
+  //one EN low time for all sensors.
+  delay(MANAGER_EN_DELAY_MS);
+  t0 = millis();
+  for(uint8_t i = 0; i < _num; i++){
+      memset(&_bootReport[i], 0, sizeof(sBootReport_t));
+      _bootState[i] = eBootWaitSlot;
+      _bootNext[i] = t0;
+      _bootStepStart[i] = t0;
+  }
+  while(pending){
+      uint32_t idle = 0xFFFFFFFF;
+      bool stepped = false;
+      pending = false;
+      for(uint8_t i = 0; i < _num; i++){
+          uint32_t now = millis();
+          int32_t left = _bootNext[i] - now;
+          if((_bootState[i] == eBootDone) || (_bootState[i] == eBootFailed)) continue;
+          pending = true;
+          //nothing to do until the sensor at 0x41 has moved to its own address.
+          if((_bootState[i] == eBootWaitSlot) && (_slot >= 0)) continue;
+          if(left > 0){
+              if((uint32_t)left < idle) idle = left;
+              continue;
+          }
+          stepped = true;
+          if(!bootStep(i, now)){
+              DBG("boot failed.");
+              digitalWrite(_sensor[i]->_en, LOW);
+              _sensor[i]->_addr = TMF8x01_I2C_ADDR;
+              _bootState[i] = eBootFailed;
+              if(_slot == (int8_t)i) _slot = -1;
+          }
+          if(_bootState[i] == eBootDone){
+              _ready |= (1 << i);
+              _bootReport[i].total = millis() - t0;
+          }
+      }
+      //every sensor waits, sleep until the first one is due instead of spinning on millis().
+      if(pending && !stepped) delay((idle == 0xFFFFFFFF) ? 1 : idle);
+  }
+  return _ready;
+}
+
+void DFRobot_TMF8x01_Manager::bootNext(uint8_t index, uint8_t state, uint32_t now, uint16_t waitMs){
+  uint16_t used = now - _bootStepStart[index];
+  switch(_bootState[index]){
+      case eBootWaitSlot: _bootReport[index].slotWait += used; break;
+      case eBootPower:
+      case eBootCpu:      _bootReport[index].power += used; break;
+      case eBootPatch:    _bootReport[index].patch += used; break;
+      case eBootApp:      _bootReport[index].app += used; break;
+      case eBootAddress:  _bootReport[index].address += used; break;
+      default:            _bootReport[index].start += used; break;
+  }
+  _bootState[index] = state;
+  _bootStepStart[index] = now;
+  _bootNext[index] = now + waitMs;
+}
+
+bool DFRobot_TMF8x01_Manager::bootStep(uint8_t index, uint32_t now){
+  DFRobot_TMF8x01 *s = _sensor[index];
+  switch(_bootState[index]){
+      case eBootWaitSlot:
+           //every sensor is at 0x41 after reset, so only one of them may be powered until it has its own address.
+           if(_slot >= 0) return true;
+           _slot = index;
+           digitalWrite(s->_en, HIGH);
+           bootNext(index, eBootPower, now, MANAGER_EN_DELAY_MS);
+           break;
+      case eBootPower:{
+           DFRobot_TMF8x01::eEnableReg_t regValue;
+           regValue.value = 1;
+           s->writeReg(REG_MTF8x01_ENABLE, &regValue, sizeof(regValue));
+           bootNext(index, eBootCpu, now, 1);
+           break;
+      }
+      case eBootCpu:
+           if(s->getCPUState() != 0x41){
+               if((now - _bootStepStart[index]) > 100) return false;
+               _bootNext[index] = now + 1;
+               break;
+           }
+           if(s->getAppId() == 0xC0){
+               bootNext(index, eBootAddress, now);
+               break;
+           }
+           if(!s->startPatch(/*ack =*/true)) return false;
+           _patchRecord[index] = s->getRamPatch();
+           bootNext(index, eBootPatch, now);
+           break;
+      case eBootPatch:{
+           //one record per step, so the waits of the other sensors are served in between.
+           int8_t ret = s->writePatchRecord(&_patchRecord[index], /*ack =*/true);
+           if(ret < 0) return false;
+           if(ret > 0) break;
+           if(!s->finishPatch(/*ack =*/true)) return false;
+           bootNext(index, eBootApp, now, 1);
+           break;
+      }
+      case eBootApp:
+           if(s->getAppId() != 0xC0){
+               if((now - _bootStepStart[index]) > 100) return false;
+               _bootNext[index] = now + 1;
+               break;
+           }
+           bootNext(index, eBootAddress, now);
+           break;
+      case eBootAddress:
+           if(!s->modifyI2CAddress(_baseAddr + index)) return false;
+           s->_initialize = true;
+           _slot = -1;
+           if(!_bootStartMeasure){
+               bootNext(index, eBootDone, millis());
+               break;
+           }
+           bootNext(index, eBootStart, millis());
+           break;
+      case eBootStart:
+           //the measure command needs about 600ms before the first result, the other sensors are served meanwhile.
+           s->_count = 0;
+           s->writeMeasureCmd(_bootCailbMode);
+           bootNext(index, eBootResult, now, 5);
+           break;
+      case eBootResult:
+           //the same 4 warm-up results as setCaibrationMode, they feed the clock correction.
+           if(s->_count < 4){
+               if((now - _bootStepStart[index]) > 2000) return false;
+               if(s->isDataReady()) s->getDistance_mm();
+               _bootNext[index] = now + 2;
+               break;
+           }
+           s->_measureCmdFlag = true;
+           bootNext(index, eBootDone, now);
+           break;
+      default:
+           break;
+  }
+  return true;
+}
+
+bool DFRobot_TMF8x01_Manager::getBootReport(uint8_t index, sBootReport_t *report){
+  if((index >= _num) || (report == NULL)) return false;
+  *report = _bootReport[index];
+  return true;
+}
+
+uint16_t DFRobot_TMF8x01_Manager::startMeasurement(DFRobot_TMF8x01::eCalibModeConfig_t cailbMode){
+  uint16_t measuring = 0;
+  for(uint8_t i = 0; i < _num; i++){
+      if(!(_ready & (1 << i))) continue;
+      if(!_sensor[i]->_measureCmdFlag) _sensor[i]->setCaibrationMode(cailbMode);
+      if(_sensor[i]->_measureCmdFlag) measuring |= (1 << i);
+  }
+  return measuring;
+}
+
+void DFRobot_TMF8x01_Manager::stopMeasurement(){
+  for(uint8_t i = 0; i < _num; i++){
+      if(_sensor[i]->_measureCmdFlag) _sensor[i]->stopMeasurement();
+  }
+}
+
+uint16_t DFRobot_TMF8x01_Manager::isDataReady(){
+  uint16_t ready = 0;
+  //sensors stopped by themselves are skipped too.
+  for(uint8_t i = 0; i < _num; i++){
+      if(!_sensor[i]->_measureCmdFlag) continue;
+      if(_sensor[i]->isDataReady()) ready |= (1 << i);
+  }
+  return ready;
+}
+
+uint16_t DFRobot_TMF8x01_Manager::getDistance_mm(uint8_t index){
+  if(index >= _num) return 0;
+  return _sensor[index]->getDistance_mm();
+}
+
+bool DFRobot_TMF8x01_Manager::setNeighbors(uint8_t index, uint16_t neighborMask){
+  if(index >= MANAGER_MAX_SENSORS) return false;
+  neighborMask &= ~(1 << index);
+  for(uint8_t i = 0; i < MANAGER_MAX_SENSORS; i++){
+      if(neighborMask & (1 << i)) _neighbor[i] |= (1 << index);
+      else _neighbor[i] &= ~(1 << index);
+  }
+  _neighbor[index] = neighborMask;
+  return true;
+}
+
+uint16_t DFRobot_TMF8x01_Manager::getNeighbors(uint8_t index){
+  if(index >= MANAGER_MAX_SENSORS) return 0;
+  return _neighbor[index];
+}
+
+uint8_t DFRobot_TMF8x01_Manager::beginSchedule(uint16_t maxRate, uint16_t slotTimeoutMs){
+  uint8_t order[MANAGER_MAX_SENSORS];
+  uint8_t degree[MANAGER_MAX_SENSORS];
+  uint8_t slotOf[MANAGER_MAX_SENSORS];
+  uint8_t n = 0;
+  uint16_t num = 0;
+  _schedActive = false;
+  _slotNum = 0;
+  stopMeasurement();
+  //sensors with the most neighbors get their slots first, it needs less slots.
+  for(uint8_t i = 0; i < _num; i++){
+      _slotMask[i] = 0;
+      if(!(_ready & (1 << i))) continue;
+      uint16_t m = _neighbor[i] & _ready;
+      degree[i] = 0;
+      while(m){ degree[i] += m & 1; m >>= 1; }
+      uint8_t j = n++;
+      while((j > 0) && (degree[order[j - 1]] < degree[i])){
+          order[j] = order[j - 1];
+          j--;
+      }
+      order[j] = i;
+  }
+  if(n == 0) return 0;
+  for(uint8_t k = 0; k < n; k++){
+      uint8_t i = order[k];
+      uint32_t used = 0;
+      for(uint8_t m = 0; m < k; m++){
+          if(_neighbor[i] & (1 << order[m])) used |= (1UL << slotOf[order[m]]);
+      }
+      slotOf[i] = 0;
+      while(used & (1UL << slotOf[i])) slotOf[i]++;
+      if(slotOf[i] + 1 > _slotNum) _slotNum = slotOf[i] + 1;
+      _slotMask[i] = 1 << slotOf[i];
+      _schedCount[i] = 0;
+  }
+  //a sensor also runs in every other slot without a neighbor in it, an isolated sensor in every slot.
+  for(uint8_t s = 0; s < _slotNum; s++){
+      for(uint8_t k = 0; k < n; k++){
+          uint8_t i = order[k];
+          bool clear = true;
+          for(uint8_t m = 0; clear && (m < n); m++){
+              if((_neighbor[i] & (1 << order[m])) && (_slotMask[order[m]] & (1 << s))) clear = false;
+          }
+          if(clear) _slotMask[i] |= (1 << s);
+      }
+  }
+  for(uint8_t k = 0; k < n; k++){
+      uint16_t m = _slotMask[order[k]];
+      while(m){ num += m & 1; m >>= 1; }
+  }
+  //the samples of one round of all slots.
+  _roundTime = maxRate ? (num * 1000UL + maxRate - 1) / maxRate : 0;
+  _slotTimeout = slotTimeoutMs;
+  _slotPending = 0;
+  _slotStopping = 0;
+  _curSlot = 0;
+  _schedStart = _roundStart = millis();
+  _schedActive = true;
+  return _slotNum;
+}
+
+void DFRobot_TMF8x01_Manager::startSlot(uint32_t now){
+  _slotStart = now;
+  for(uint8_t i = 0; i < _num; i++){
+      if(!(_ready & (1 << i)) || !(_slotMask[i] & (1 << _curSlot))) continue;
+      if(_sensor[i]->startSingleShot()) _slotPending |= (1 << i);
+  }
+}
+
+void DFRobot_TMF8x01_Manager::nextSlot(uint32_t now){
+  if(++_curSlot >= _slotNum){
+      _curSlot = 0;
+      _roundStart += _roundTime;
+      if((int32_t)(now - _roundStart) > 0) _roundStart = now;
+  }
+}
+
+uint16_t DFRobot_TMF8x01_Manager::schedule(){
+  uint16_t ready = 0;
+  uint32_t now = millis();
+  if(_slotStopping){
+      //a sensor which timed out may still emit, the next slot waits until it took the stop command.
+      for(uint8_t i = 0; i < _num; i++){
+          uint8_t prev = 0;
+          if(!(_slotStopping & (1 << i))) continue;
+          _sensor[i]->readReg(REG_MTF8x01_PREVIOUS, &prev, 1);
+          if(prev == 0xFF) _slotStopping &= ~(1 << i);
+      }
+      if(_slotStopping && ((now - _slotStart) > _slotTimeout)){
+          DBG("stop timeout");
+          _slotStopping = 0;
+      }
+      if(_slotStopping) return ready;
+      nextSlot(now);
+  }else if(_slotPending){
+      for(uint8_t i = 0; i < _num; i++){
+          if(!(_slotPending & (1 << i))) continue;
+          if(_sensor[i]->isDataReady()){
+              ready |= (1 << i);
+              _slotPending &= ~(1 << i);
+              _schedCount[i]++;
+          }
+      }
+      if(_slotPending && ((now - _slotStart) > _slotTimeout)){
+          uint8_t cmd = 0xFF;
+          DBG("slot timeout");
+          for(uint8_t i = 0; i < _num; i++){
+              if(_slotPending & (1 << i)) _sensor[i]->writeReg(REG_MTF8x01_COMMAND, &cmd, 1);
+          }
+          _slotStopping = _slotPending;
+          _slotPending = 0;
+          _slotStart = now;
+          return ready;
+      }
+      if(_slotPending) return ready;
+      //the slot is finished, no neighbor emits any more.
+      nextSlot(now);
+  }
+  if(!_schedActive) return ready;
+  if((_curSlot == 0) && ((int32_t)(now - _roundStart) < 0)) return ready;
+  startSlot(now);
+  //no sensor of the slot started, the other slots must not wait on it.
+  if(!_slotPending) nextSlot(now);
+  return ready;
+}
+
+void DFRobot_TMF8x01_Manager::endSchedule(){
+  _schedActive = false;
+  while(_slotPending || _slotStopping) schedule();
+}
+
+float DFRobot_TMF8x01_Manager::getScheduledRate(uint8_t index){
+  uint32_t t = millis() - _schedStart;
+  if((index >= _num) || (t == 0)) return 0;
+  return _schedCount[index] * 1000.0 / t;
+}
+
+bool DFRobot_TMF8x01_Manager::setSyncMaster(uint8_t index, DFRobot_TMF8x01::ePin_t pin){
+  if((index >= _num) || (pin == DFRobot_TMF8x01::ePINTotal)) return false;
+  _syncMaster = index;
+  _syncMcuPin = -1;
+  _syncPin = pin;
+  return true;
+}
+
+bool DFRobot_TMF8x01_Manager::setSyncMasterPin(int mcuPin, DFRobot_TMF8x01::ePin_t pin){
+  if((mcuPin < 0) || (pin == DFRobot_TMF8x01::ePINTotal)) return false;
+  _syncMaster = -1;
+  _syncMcuPin = mcuPin;
+  _syncPin = pin;
+  //the line is high until setSyncGate(), the followers start in phase.
+  pinMode(_syncMcuPin, OUTPUT);
+  digitalWrite(_syncMcuPin, HIGH);
+  return true;
+}
+
+uint16_t DFRobot_TMF8x01_Manager::beginSync(uint16_t followerMask, eSyncPhase_t phase, DFRobot_TMF8x01::eCalibModeConfig_t cailbMode){
+  DFRobot_TMF8x01::ePinControl_t config;
+  uint16_t mask = 0;
+  if((_syncMaster < 0) && (_syncMcuPin < 0)) return 0;
+  if(_syncMaster >= 0) followerMask &= ~(1 << _syncMaster);
+  followerMask &= _ready;
+  //the sensors start free running, the sync pins are set after the first results so setCaibrationMode() never waits on the line.
+  if(_syncMaster >= 0){
+      DFRobot_TMF8x01 *m = _sensor[_syncMaster];
+      if(!m->_measureCmdFlag && !m->setCaibrationMode(cailbMode)) return 0;
+      if(m->getPinConfig(_syncPin) != DFRobot_TMF8x01::ePinOutputVCSEL) m->pinConfig(_syncPin, DFRobot_TMF8x01::ePinOutputVCSEL);
+      mask |= (1 << _syncMaster);
+  }
+  //the follower stops its VCSEL while the line is at the other level.
+  config = (phase == eSyncInPhase) ? DFRobot_TMF8x01::ePinInputLow : DFRobot_TMF8x01::ePinInputHigh;
+  for(uint8_t i = 0; i < _num; i++){
+      if(!(followerMask & (1 << i))) continue;
+      if(!_sensor[i]->_measureCmdFlag && !_sensor[i]->setCaibrationMode(cailbMode)) continue;
+      _sensor[i]->pinConfig(_syncPin, config);
+      mask |= (1 << i);
+  }
+  _syncMask |= mask;
+  return _syncMask;
+}
+
+void DFRobot_TMF8x01_Manager::setSyncGate(bool high){
+  if(_syncMcuPin < 0) return;
+  digitalWrite(_syncMcuPin, high ? HIGH : LOW);
+}
+
+void DFRobot_TMF8x01_Manager::endSync(){
+  for(uint8_t i = 0; i < _num; i++){
+      if(_syncMask & (1 << i)) _sensor[i]->pinConfig(_syncPin, DFRobot_TMF8x01::ePinInput);
+  }
+  if(_syncMcuPin > -1) pinMode(_syncMcuPin, INPUT);
+  _syncMask = 0;
+}
+
+uint16_t DFRobot_TMF8x01_Manager::beginSharedInt(int intPin, uint16_t candidateMask, eIntOrder_t order){
+  if(intPin < 0) return 0;
+  _intPin = intPin;
+  _intOrder = order;
+  _intNext = 0;
+  _intFlag = false;
+  _intMask = candidateMask & _ready;
+  pinMode(_intPin, INPUT);
+  for(uint8_t i = 0; i < _num; i++){
+      if(!(_intMask & (1 << i))) continue;
+      _sensor[i]->enableIntPin();
+      //the INT bit of the measure command is only taken by a new measure command.
+      if(_sensor[i]->_measureCmdFlag) _sensor[i]->restartMeasurement();
+  }
+  resetIntLatency();
+  return _intMask;
+}
+
+void DFRobot_TMF8x01_Manager::notifyInt(){
+  if(!_intFlag){
+      _intMicros = micros();
+      _intFlag = true;
+  }
+}
+
+uint16_t DFRobot_TMF8x01_Manager::handleSharedInt(uint8_t maxFetch){
+  uint16_t ready = 0;
+  uint8_t fetched = 0;
+  uint32_t edge;
+  if((_intPin < 0) || (_intMask == 0)) return 0;
+  if(!_intFlag && (digitalRead(_intPin) != LOW)) return 0;
+  noInterrupts();
+  edge = _intFlag ? _intMicros : micros();
+  _intFlag = false;
+  interrupts();
+  do{
+      uint16_t pass = 0;
+      uint8_t start = (_intOrder == eIntRoundRobin) ? _intNext : 0;
+      for(uint8_t k = 0; k < _num; k++){
+          uint8_t i = (start + k) % _num;
+          uint8_t val = 0;
+          DFRobot_TMF8x01 *s = _sensor[i];
+          if(!(_intMask & (1 << i))) continue;
+          s->readReg(REG_MTF8x01_INT_STATUS, &val, 1);
+          if(!(val & 0x01)) continue;
+          //clear before reading, a result arriving meanwhile pulls the line again.
+          s->writeReg(REG_MTF8x01_INT_STATUS, &val, 1);
+#if TMF8x01_USE_LATENCY
+          if(s->_pLatency) s->_pLatency->onInt(edge);
+#endif
+          if(!s->isDataReady()) continue;
+          _lastDistance[i] = s->getRawDistance() * s->_timestamp;
+          ready |= (1 << i);
+          pass |= (1 << i);
+          _intNext = (i + 1) % _num;
+
+          uint32_t us = micros() - edge;
+          sIntLatency_t *l = &_latency[i];
+          if((l->count == 0) || (us < l->minUs)) l->minUs = us;
+          if(us > l->maxUs) l->maxUs = us;
+          _latencySum[i] += us;
+          l->count++;
+          if(maxFetch && (++fetched >= maxFetch)) return ready;
+      }
+      //the line is held low by a sensor which is not a candidate.
+      if(pass == 0) break;
+      //the sensors of the next pass fired while the line was low, their edge is unknown.
+      edge = micros();
+  }while(digitalRead(_intPin) == LOW);
+  return ready;
+}
+
+uint16_t DFRobot_TMF8x01_Manager::getLastDistance_mm(uint8_t index){
+  if(index >= _num) return 0;
+  return _lastDistance[index];
+}
+
+bool DFRobot_TMF8x01_Manager::getIntLatency(uint8_t index, sIntLatency_t *latency){
+  if((index >= _num) || (latency == NULL)) return false;
+  *latency = _latency[index];
+  //64 bits, the division is left to the reader and out of the INT path.
+  if(latency->count) latency->avgUs = _latencySum[index] / latency->count;
+  return true;
+}
+
+void DFRobot_TMF8x01_Manager::resetIntLatency(){
+  memset(_latency, 0, sizeof(_latency));
+  memset(_latencySum, 0, sizeof(_latencySum));
+}
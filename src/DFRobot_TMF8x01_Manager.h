@@ -0,0 +1,377 @@
+/*!
+ * @file DFRobot_TMF8x01_Manager.h
+ * @brief Run several TMF8x01 sensors on one I2C bus. Every sensor has its own EN pin, the manager brings them up
+ * @n one at a time and moves each to a unique I2C address, then runs them all from one object.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2026-10-19
+ * @url https://github.com/DFRobot/DFRobot_TMF8x01
+ */
+#ifndef __DFROBOT_TMF8X01_MANAGER_H
+#define __DFROBOT_TMF8X01_MANAGER_H
+
+#include "DFRobot_TMF8x01.h"
+
+//MANAGER_MAX_SENSORS the sensors one manager holds, at most 16(the sensor masks are 16 bits). Every one costs about
+//63 bytes RAM on AVR, 8 there. Set it for the library too, such as -DMANAGER_MAX_SENSORS=4 in the build flags.
+#ifndef MANAGER_MAX_SENSORS
+#if defined(__AVR__)
+#define MANAGER_MAX_SENSORS   8
+#else
+#define MANAGER_MAX_SENSORS   16
+#endif
+#endif
+#if (MANAGER_MAX_SENSORS < 1) || (MANAGER_MAX_SENSORS > 16)
+#error "MANAGER_MAX_SENSORS must be 1..16"
+#endif
+
+class DFRobot_TMF8x01_Manager{
+public:
+  /**
+   * @fn DFRobot_TMF8x01_Manager
+   * @brief Constructor.
+   * @param baseAddr: The I2C address of the first sensor, the sensor n gets baseAddr + n.
+   */
+  DFRobot_TMF8x01_Manager(uint8_t baseAddr = 0x42);
+
+  #define MANAGER_EN_DELAY_MS   10
+
+  /**
+   * @struct sBootReport_t
+   * @brief The time of every bring-up step of a sensor in beginOverlapped(), unit ms. The steps of one sensor run one after 
+   * @n another, so their sum is the critical path of the sensor, slotWait is the time it waited for 0x41 to be free.
+   */
+  typedef struct{
+      uint16_t slotWait;   /**< waiting for the other sensors to leave 0x41*/
+      uint16_t power;      /**< EN settle and cpu ready*/
+      uint16_t patch;      /**< RAM patch download*/
+      uint16_t app;        /**< waiting for APP0*/
+      uint16_t address;    /**< moving to its own address*/
+      uint16_t start;      /**< calibration and measure command until the first result*/
+      uint16_t total;      /**< from beginOverlapped until ready*/
+  }sBootReport_t;
+
+  typedef enum{
+      eSyncInPhase = 0,    /**< the followers measure while the sync line is high(the master emits)*/
+      eSyncAntiPhase,      /**< the followers measure while the sync line is low(the master does not emit)*/
+  }eSyncPhase_t;
+
+  typedef enum{
+      eIntPriority = 0,    /**< every pass checks the sensors from index 0, the lower index is served first*/
+      eIntRoundRobin,      /**< every pass starts after the last served sensor, no sensor starves*/
+  }eIntOrder_t;
+
+  /**
+   * @struct sIntLatency_t
+   * @brief The time from the falling edge of the shared INT line to the sample of a sensor is fetched, unit us.
+   */
+  typedef struct{
+      uint32_t count;      /**< samples fetched by handleSharedInt*/
+      uint32_t minUs;
+      uint32_t maxUs;
+      uint32_t avgUs;
+  }sIntLatency_t;
+
+  /**
+   * @fn addSensor
+   * @brief Add a sensor to the manager, the sensor must have its own EN pin.
+   * @param sensor: Pointer to DFRobot_TMF8801 or DFRobot_TMF8701 object.
+   * @param selPin: The IO pin of MCU connected to PIN0 of the sensor, it selects the sensor in beginBroadcast. -1 if not connected.
+   * @return sucess return true, or return false.
+   */
+  bool addSensor(DFRobot_TMF8x01 *sensor, int selPin = -1);
+
+  /**
+   * @fn getSensorNum
+   * @brief get the number of sensors.
+   * @return number of sensors.
+   */
+  uint8_t getSensorNum();
+
+  /**
+   * @fn getSensor
+   * @brief get a sensor.
+   * @param index: The index of sensor, in the order of addSensor.
+   * @return Pointer to the sensor, NULL if index is error.
+   */
+  DFRobot_TMF8x01 *getSensor(uint8_t index);
+
+  /**
+   * @fn begin
+   * @brief Hold all sensors in reset by EN pin, then init them one at a time and move each to its own address.
+   * @return The bit n is 1 if sensor n is ready.
+   */
+  uint16_t begin();
+
+  /**
+   * @fn beginBroadcast
+   * @brief Bring up all sensors with one RAM patch download. All sensors leave reset together at 0x41 and every patch record 
+   * @n is written once for all of them. Then sensors are selected one at a time by their PIN0, moved to their own address and checked
+   * @n there one by one. Every sensor needs a selPin and the same sensor type, or begin() is used. Sensors that fail are brought up again
+   * @n by begin() one by one. The selPins are inputs again when it returns.
+   * @return The bit n is 1 if sensor n is ready.
+   */
+  uint16_t beginBroadcast();
+
+  /**
+   * @fn beginOverlapped
+   * @brief Bring up all sensors with every step scheduled across sensors: while one sensor waits for EN settle, cpu ready, 
+   * @n APP0 or its first result, the other sensors get their patch download or commands. Only one sensor uses 0x41 at a time.
+   * @param startMeasure: true also start measurement, the 600ms start delay of every sensor overlaps with the others.
+   * @param cailbMode: The cailibration mode of startMeasure.
+   * @return The bit n is 1 if sensor n is ready(measuring if startMeasure is true).
+   */
+  uint16_t beginOverlapped(bool startMeasure = true, DFRobot_TMF8x01::eCalibModeConfig_t cailbMode = DFRobot_TMF8x01::eModeCalib);
+
+  /**
+   * @fn getBootReport
+   * @brief get the time of every bring-up step of sensor n in the last beginOverlapped().
+   * @param index: The index of sensor.
+   * @param report: Pointer to store the report.
+   * @return sucess return true, or return false.
+   */
+  bool getBootReport(uint8_t index, sBootReport_t *report);
+
+  /**
+   * @fn startMeasurement
+   * @brief Start measurement of all sensors which are ready.
+   * @param cailbMode: Is an enumerated variable of eCalibModeConfig_t, which is to config measurement cailibration mode.
+   * @return The bit n is 1 if sensor n is measuring.
+   */
+  uint16_t startMeasurement(DFRobot_TMF8x01::eCalibModeConfig_t cailbMode = DFRobot_TMF8x01::eModeCalib);
+
+  /**
+   * @fn stopMeasurement
+   * @brief Stop measurement of all sensors.
+   */
+  void stopMeasurement();
+
+  /**
+   * @fn isDataReady
+   * @brief Check every measuring sensor once.
+   * @return The bit n is 1 if sensor n has new data, use getDistance_mm(n) to get it.
+   */
+  uint16_t isDataReady();
+
+  /**
+   * @fn getDistance_mm
+   * @brief get distance of sensor n, unit mm.
+   * @param index: The index of sensor.
+   * @return return distance value, unit mm.
+   */
+  uint16_t getDistance_mm(uint8_t index);
+
+  /**
+   * @fn setNeighbors
+   * @brief Set the sensors which see the VCSEL light of sensor n, the relation is set for both sides. beginSchedule() 
+   * @n never lets two neighbors measure at the same time.
+   * @param index: The index of sensor.
+   * @param neighborMask: The bit m is 1 if sensor m is a neighbor of sensor n.
+   * @return sucess return true, or return false.
+   */
+  bool setNeighbors(uint8_t index, uint16_t neighborMask);
+
+  /**
+   * @fn getNeighbors
+   * @brief get the neighbors of sensor n.
+   * @param index: The index of sensor.
+   * @return The bit m is 1 if sensor m is a neighbor of sensor n.
+   */
+  uint16_t getNeighbors(uint8_t index);
+
+  /**
+   * @fn beginSchedule
+   * @brief Stop the continuous measurement of all sensors and split the ready sensors into time slots, sensors in one 
+   * @n slot are not neighbors. A sensor also runs in every other slot without a neighbor in it, a sensor without neighbors
+   * @n in every slot. Every call of schedule() then runs the slots one after another with single shot measurement.
+   * @param maxRate: The max samples per second of all sensors together, 0 means as fast as possible.
+   * @param slotTimeoutMs: The max time of one slot, a sensor without result in this time loses the sample of the round,
+   * @n it is stopped and the next slot waits until it took the stop command(at most slotTimeoutMs again).
+   * @return The number of slots, 0 means no sensor is ready.
+   */
+  uint8_t beginSchedule(uint16_t maxRate = 0, uint16_t slotTimeoutMs = 200);
+
+  /**
+   * @fn schedule
+   * @brief Run the schedule one step, never blocks. Call it in loop().
+   * @return The bit n is 1 if sensor n has new data, use getDistance_mm(n) to get it.
+   */
+  uint16_t schedule();
+
+  /**
+   * @fn endSchedule
+   * @brief Stop the schedule, the running slot is finished or stopped first.
+   */
+  void endSchedule();
+
+  /**
+   * @fn getScheduledRate
+   * @brief get the samples per second of sensor n since beginSchedule().
+   * @param index: The index of sensor.
+   * @return samples per second.
+   */
+  float getScheduledRate(uint8_t index);
+
+  /**
+   * @fn setSyncMaster
+   * @brief Sensor n drives the sync line by its VCSEL signal, the sync pin of all sensors of the group is connected together.
+   * @param index: The index of sensor.
+   * @param pin: The pin of sensor connected to the sync line, ePIN0 or ePIN1.
+   * @return sucess return true, or return false.
+   */
+  bool setSyncMaster(uint8_t index, DFRobot_TMF8x01::ePin_t pin = DFRobot_TMF8x01::ePIN0);
+
+  /**
+   * @fn setSyncMasterPin
+   * @brief An IO pin of MCU drives the sync line, use setSyncGate() to pace the followers.
+   * @param mcuPin: The IO pin of MCU.
+   * @param pin: The pin of sensor connected to the sync line, ePIN0 or ePIN1.
+   * @return sucess return true, or return false.
+   */
+  bool setSyncMasterPin(int mcuPin, DFRobot_TMF8x01::ePin_t pin = DFRobot_TMF8x01::ePIN0);
+
+  /**
+   * @fn beginSync
+   * @brief Start the master(if it is a sensor) and the followers, then config their sync pins. From now on the sensors are
+   * @n paced by the sync line without any I2C command. Call it once for every group of followers with its own phase.
+   * @param followerMask: The bit n is 1 if sensor n follows the sync line.
+   * @param phase: The phase of the followers to the sync line, which is an enumerated variable of eSyncPhase_t.
+   * @param cailbMode: The cailibration mode of the measurement.
+   * @return The bit n is 1 if sensor n is measuring in sync.
+   */
+  uint16_t beginSync(uint16_t followerMask, eSyncPhase_t phase = eSyncAntiPhase, DFRobot_TMF8x01::eCalibModeConfig_t cailbMode = DFRobot_TMF8x01::eModeCalib);
+
+  /**
+   * @fn setSyncGate
+   * @brief Drive the sync line by the MCU pin set by setSyncMasterPin().
+   * @param high: true: the line is high, eSyncInPhase followers measure, false: the line is low, eSyncAntiPhase followers measure.
+   */
+  void setSyncGate(bool high);
+
+  /**
+   * @fn endSync
+   * @brief Set the sync pin of all sensors to input without effect, the sensors keep measuring free.
+   */
+  void endSync();
+
+  /**
+   * @fn beginSharedInt
+   * @brief The open-drain INT pins of several sensors are wired together to one external interrupt pin of MCU. Enable
+   * @n INT of every candidate sensor, attach notifyInt() to the falling edge of intPin by a function of the sketch.
+   * @param intPin: The IO pin of MCU connected to the shared INT line.
+   * @param candidateMask: The bit n is 1 if the INT pin of sensor n is connected to the line.
+   * @param order: The order to check the sensors, which is an enumerated variable of eIntOrder_t.
+   * @return The bit n is 1 if sensor n is a ready candidate.
+   */
+  uint16_t beginSharedInt(int intPin, uint16_t candidateMask = 0xFFFF, eIntOrder_t order = eIntPriority);
+
+  /**
+   * @fn notifyInt
+   * @brief Call it in the interrupt function of the shared INT line, it only saves the time.
+   */
+  void notifyInt();
+
+  /**
+   * @fn handleSharedInt
+   * @brief Check INT_STATUS of the candidates after notifyInt(), fetch and clear the sensors which fired. The INT line
+   * @n is checked again after every pass, because a sensor firing while the line is low gives no new edge.
+   * @param maxFetch: The max samples to fetch in one call, 0 means until the line is released.
+   * @return The bit n is 1 if sensor n has new data, use getLastDistance_mm(n) to get it.
+   */
+  uint16_t handleSharedInt(uint8_t maxFetch = 0);
+
+  /**
+   * @fn getLastDistance_mm
+   * @brief get the distance fetched by handleSharedInt(), no I2C transfer.
+   * @param index: The index of sensor.
+   * @return return distance value, unit mm.
+   */
+  uint16_t getLastDistance_mm(uint8_t index);
+
+  /**
+   * @fn getIntLatency
+   * @brief get the interrupt to sample latency of sensor n.
+   * @param index: The index of sensor.
+   * @param latency: Pointer to store the latency.
+   * @return sucess return true, or return false.
+   */
+  bool getIntLatency(uint8_t index, sIntLatency_t *latency);
+
+  /**
+   * @fn resetIntLatency
+   * @brief Clear the latency of all sensors.
+   */
+  void resetIntLatency();
+
+protected:
+  typedef enum{
+      eBootWaitSlot = 0,
+      eBootPower,
+      eBootCpu,
+      eBootPatch,
+      eBootApp,
+      eBootAddress,
+      eBootStart,
+      eBootResult,
+      eBootDone,
+      eBootFailed,
+  }eBootState_t;
+
+  bool beginSensor(uint8_t index);
+  void resetAll();
+  bool bootStep(uint8_t index, uint32_t now);
+  void bootNext(uint8_t index, uint8_t state, uint32_t now, uint16_t waitMs = 0);
+
+  uint8_t _bootState[MANAGER_MAX_SENSORS];
+  uint32_t _bootNext[MANAGER_MAX_SENSORS];
+  uint32_t _bootStepStart[MANAGER_MAX_SENSORS];
+  const uint8_t *_patchRecord[MANAGER_MAX_SENSORS];
+  sBootReport_t _bootReport[MANAGER_MAX_SENSORS];
+  int8_t _slot;
+  bool _bootStartMeasure;
+  DFRobot_TMF8x01::eCalibModeConfig_t _bootCailbMode;
+
+  void startSlot(uint32_t now);
+  void nextSlot(uint32_t now);
+
+  uint16_t _neighbor[MANAGER_MAX_SENSORS];
+  uint16_t _slotMask[MANAGER_MAX_SENSORS];
+  uint32_t _schedCount[MANAGER_MAX_SENSORS];
+  uint8_t _slotNum;
+  uint8_t _curSlot;
+  uint16_t _slotPending;
+  uint16_t _slotStopping;
+  uint16_t _slotTimeout;
+  uint16_t _roundTime;
+  uint32_t _slotStart;
+  uint32_t _roundStart;
+  uint32_t _schedStart;
+  bool _schedActive;
+
+  int8_t _syncMaster;
+  int _syncMcuPin;
+  DFRobot_TMF8x01::ePin_t _syncPin;
+  uint16_t _syncMask;
+
+  int _intPin;
+  uint16_t _intMask;
+  eIntOrder_t _intOrder;
+  uint8_t _intNext;
+  volatile bool _intFlag;
+  volatile uint32_t _intMicros;
+  uint16_t _lastDistance[MANAGER_MAX_SENSORS];
+  uint64_t _latencySum[MANAGER_MAX_SENSORS];
+  sIntLatency_t _latency[MANAGER_MAX_SENSORS];
+
+  int _selPin[MANAGER_MAX_SENSORS];
+
+  DFRobot_TMF8x01 *_sensor[MANAGER_MAX_SENSORS];
+  uint8_t _num;
+  uint8_t _baseAddr;
+  uint16_t _ready;
+};
+
+#endif